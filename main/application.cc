@@ -21,12 +21,14 @@ constexpr int64_t kTouchStartAckTimeoutUs = 700'000; // 700ms
 #include "learning/user_profile.h"
 #include "mcp_server.h"
 #include "pet_system.h"
+#include "persistent_store.h"
 #include "settings.h"
 
 #include <arpa/inet.h>
 #include <cJSON.h>
 #include <cstring>
 #include <driver/gpio.h>
+#include <esp_app_desc.h>
 #include <esp_log.h>
 #include <esp_timer.h>
 #include <font_awesome.h>
@@ -90,6 +92,10 @@ void Application::CheckAssetsVersion() {
   Settings settings("assets", true);
   // Check if there is a new assets need to be downloaded
   std::string download_url = settings.GetString("download_url");
+  if (download_url.empty()) {
+    // 继续上次被中断的下载
+    download_url = assets.GetPendingDownloadUrl();
+  }
 
   if (!download_url.empty()) {
     settings.EraseKey("download_url");
@@ -363,33 +369,7 @@ void Application::StopListening() {
   });
 }
 
-void Application::Start() {
-  auto &board = Board::GetInstance();
-  SetDeviceState(kDeviceStateStarting);
-
-  /* Setup the display */
-  auto display = board.GetDisplay();
-
-  // Print board name/version info
-  display->SetChatMessage("system", SystemInfo::GetUserAgent().c_str());
-
-  /* Setup the audio service */
-  auto codec = board.GetAudioCodec();
-  audio_service_.Initialize(codec);
-  audio_service_.Start();
-
-  AudioServiceCallbacks callbacks;
-  callbacks.on_send_queue_available = [this]() {
-    xEventGroupSetBits(event_group_, MAIN_EVENT_SEND_AUDIO);
-  };
-  callbacks.on_wake_word_detected = [this](const std::string &wake_word) {
-    xEventGroupSetBits(event_group_, MAIN_EVENT_WAKE_WORD_DETECTED);
-  };
-  callbacks.on_vad_change = [this](bool speaking) {
-    xEventGroupSetBits(event_group_, MAIN_EVENT_VAD_CHANGE);
-  };
-  audio_service_.SetCallbacks(callbacks);
-
+void Application::InitializeLearning() {
   // 🧠 初始化事件总线和学习系统（NVS存储）
   ESP_LOGI(TAG, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
   ESP_LOGI(TAG, "🧠 初始化智能学习系统 (NVS存储):");
@@ -402,14 +382,16 @@ void Application::Start() {
   //   ESP_LOGE(TAG, "  ❌ 事件总线初始化失败");
   // }
 
-  // ⚠️  已禁用学习系统以节省CPU和内存资源
-  // auto &user_profile = xiaozhi::UserProfile::GetInstance();
-  // if (user_profile.Initialize()) {
-  //   ESP_LOGI(TAG, "  ✅ 用户画像加载成功 (7d互动: %u次)",
-  //            user_profile.GetInteractionCount7d());
-  // } else {
-  //   ESP_LOGW(TAG, "  ⚠️  用户画像加载失败，使用默认值");
-  // }
+  // 用户画像为增量模型，每轮对话 O(1) 更新，常驻开启
+  auto &user_profile = xiaozhi::UserProfile::GetInstance();
+  if (user_profile.Initialize()) {
+    ESP_LOGI(TAG, "  ✅ 用户画像加载成功 (7d互动: %lu次)",
+             user_profile.GetInteractionCount7d());
+  } else {
+    ESP_LOGW(TAG, "  ⚠️  用户画像加载失败，使用默认值");
+  }
+
+  // ⚠️  已禁用其余学习系统以节省CPU和内存资源
 
   // auto &decision_engine = xiaozhi::DecisionEngine::GetInstance();
   // if (decision_engine.Initialize()) {
@@ -442,20 +424,75 @@ void Application::Start() {
   //   ESP_LOGW(TAG, "  ⚠️  情绪记忆系统初始化失败，使用默认值");
   // }
   
-  ESP_LOGI(TAG, "  ⚠️  事件总线和学习系统已禁用以节省内存");
-
-  // 📡 注册事件监听器（已禁用，学习系统已关闭）
-  // event_bus.Subscribe(xiaozhi::LOGIC_EVENT, xiaozhi::LOGIC_CONVERSATION_END,
-  //                     [&user_profile](void *event_data) {
-  //                       ESP_LOGI(TAG, "🎧 Event received: CONVERSATION_END");
-  //                       ESP_LOGI(TAG,
-  //                                "  📊 User stats: 7d互动=%u次, 最爱话题=%s",
-  //                                user_profile.GetInteractionCount7d(),
-  //                                user_profile.GetFavoriteTopic());
-  //                     });
-  // ESP_LOGI(TAG, "  ✅ 注册事件监听器: CONVERSATION_END");
+  ESP_LOGI(TAG, "  ⚠️  决策引擎、自适应行为和情绪记忆已禁用以节省内存");
+
+  // 📡 对话结束时更新用户画像（快速路径内联分发，不额外创建任务）
+  xiaozhi::EventBus::GetInstance()
+      .SubscribeFast<xiaozhi::EventType::kConversationEnd>(
+          [](const xiaozhi::FastEvent &event, void *ctx) {
+            const auto &conversation =
+                event.As<xiaozhi::EventType::kConversationEnd>();
+            static_cast<xiaozhi::UserProfile *>(ctx)->RecordInteraction(
+                conversation.topic, conversation.duration_ms);
+          },
+          &user_profile, xiaozhi::DispatchMode::kInline);
+  ESP_LOGI(TAG, "  ✅ 注册事件监听器: CONVERSATION_END");
 
   ESP_LOGI(TAG, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
+}
+
+Application::ProtocolType Application::GetCachedProtocolType() {
+  // 协议配置由 Ota::CheckVersion 写入 NVS，两者都有时无法判断上次用的是哪个
+  bool mqtt = !Settings("mqtt", false).GetString("endpoint").empty();
+  bool websocket = !Settings("websocket", false).GetString("url").empty();
+  if (mqtt == websocket) {
+    return kProtocolNone;
+  }
+  return mqtt ? kProtocolMqtt : kProtocolWebsocket;
+}
+
+bool Application::CheckNewVersionInBackground(Ota &ota) {
+  // 后台检查只访问网络，不改变设备状态；升级和激活交回 Start 在前台处理
+  if (!ota.CheckVersion()) {
+    ESP_LOGW(TAG, "Background version check failed, using the cached config");
+    return false;
+  }
+  has_server_time_ = ota.HasServerTime();
+  if (ota.HasNewVersion() || ota.HasActivationCode() ||
+      ota.HasActivationChallenge()) {
+    return true;
+  }
+  ota.MarkCurrentVersionValid();
+  xEventGroupSetBits(event_group_, MAIN_EVENT_CHECK_NEW_VERSION_DONE);
+  return false;
+}
+
+void Application::Start() {
+  auto &board = Board::GetInstance();
+  SetDeviceState(kDeviceStateStarting);
+
+  /* Setup the display */
+  auto display = board.GetDisplay();
+
+  // Print board name/version info
+  display->SetChatMessage("system", SystemInfo::GetUserAgent().c_str());
+
+  /* Setup the audio service */
+  auto codec = board.GetAudioCodec();
+  audio_service_.Initialize(codec);
+  audio_service_.Start();
+
+  AudioServiceCallbacks callbacks;
+  callbacks.on_send_queue_available = [this]() {
+    xEventGroupSetBits(event_group_, MAIN_EVENT_SEND_AUDIO);
+  };
+  callbacks.on_wake_word_detected = [this](const std::string &wake_word) {
+    xEventGroupSetBits(event_group_, MAIN_EVENT_WAKE_WORD_DETECTED);
+  };
+  callbacks.on_vad_change = [this](bool speaking) {
+    xEventGroupSetBits(event_group_, MAIN_EVENT_VAD_CHANGE);
+  };
+  audio_service_.SetCallbacks(callbacks);
 
   // 🎯 显示音频处理配置摘要
   ESP_LOGI(TAG, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
@@ -494,39 +531,94 @@ void Application::Start() {
   /* Start the clock timer to update the status bar */
   esp_timer_start_periodic(clock_timer_handle_, 1000000);
 
-  /* Wait for the network to be ready */
-  board.StartNetwork();
-
-  // Update the status bar immediately to show the network state
-  display->UpdateStatusBar(true);
+  // 🚀 启动阶段并行执行：联网的同时加载资源、唤醒词模型和 MCP 工具
+  // 有待下载的资源时，资源要在联网后下载再应用，唤醒词模型也随之延后
+  auto &assets = Assets::GetInstance();
+  bool assets_pending = false;
+  if (assets.partition_valid()) {
+    Settings settings("assets", false);
+    assets_pending = !settings.GetString("download_url").empty() ||
+                     !assets.GetPendingDownloadUrl().empty();
+  }
+  // 已缓存上次 OTA 下发的协议配置时，版本检查移出关键路径，在后台进行
+  ProtocolType cached_protocol = GetCachedProtocolType();
+
+  auto learning = boot_.AddStage(
+      "learning", []() { InitializeLearning(); }, {}, 4096);
+  auto mcp = boot_.AddStage(
+      "mcp",
+      []() {
+        // Add MCP common tools before initializing the protocol
+        auto &mcp_server = McpServer::GetInstance();
+        mcp_server.AddCommonTools();
+        mcp_server.AddUserOnlyTools();
+
+        // 🐾 电子宠物系统：状态按时间惰性计算，没有周期性后台任务
+        ESP_LOGI(TAG, "  ℹ️  宠物系统：仅支持手动查询（说'宠物状态'）");
+        PetSystem::GetInstance().Start();
+      },
+      {}, 6144);
+  auto assets_apply = assets_pending
+      ? boot_.AddStage("assets", nullptr)
+      : boot_.AddStage("assets", [this]() { CheckAssetsVersion(); }, {}, 6144);
+  auto wake_word = assets_pending
+      ? boot_.AddStage("wake_word", nullptr, {assets_apply})
+      : boot_.AddStage(
+            "wake_word",
+            [this]() {
+              if (audio_service_.PrepareWakeWordDetection()) {
+                boot_.Mark("wake_word_loaded");
+              }
+            },
+            {assets_apply}, 6144);
 
-  // Check for new assets version
-  CheckAssetsVersion();
+  /* Wait for the network to be ready */
+  auto network = boot_.AddStage("network", [&board, display]() {
+    board.StartNetwork();
+    // Update the status bar immediately to show the network state
+    display->UpdateStatusBar(true);
+  });
+  auto assets_update = boot_.AddStage(
+      "assets_update",
+      [this, assets_pending]() {
+        if (assets_pending) {
+          CheckAssetsVersion();
+        }
+      },
+      {network});
 
   // Check for new firmware version or get the MQTT broker address
+  // 后台检查的阶段引用了这里的局部变量，Start 返回前总会等待它结束
   Ota ota;
-  CheckNewVersion(ota);
+  bool ota_needs_foreground = false;
+  auto ota_check = cached_protocol != kProtocolNone
+      ? boot_.AddStage(
+            "ota",
+            [this, &ota, &ota_needs_foreground]() {
+              ota_needs_foreground = CheckNewVersionInBackground(ota);
+            },
+            {assets_update}, 8192)
+      : boot_.AddStage("ota", [this, &ota]() { CheckNewVersion(ota); },
+                       {assets_update});
+  boot_.Run();
 
   // Initialize the protocol
   display->SetStatus(Lang::Strings::LOADING_PROTOCOL);
-
-  // Add MCP common tools before initializing the protocol
-  auto &mcp_server = McpServer::GetInstance();
-  mcp_server.AddCommonTools();
-  mcp_server.AddUserOnlyTools();
-
-  // 🐾 已禁用电子宠物系统以节省CPU和内存资源
-  // auto &pet_system = PetSystem::GetInstance();
-  // ESP_LOGI(TAG, "  ℹ️  宠物系统：仅支持手动查询（说'宠物状态'）");
-  // pet_system.Start();
-  ESP_LOGI(TAG, "  ⚠️  宠物系统已禁用以节省资源");
-
-  if (ota.HasMqttConfig()) {
-    protocol_ = std::make_unique<MqttProtocol>();
-  } else if (ota.HasWebsocketConfig()) {
+  boot_.Wait(mcp);
+  boot_.Wait(learning);
+
+  if (cached_protocol == kProtocolNone) {
+    cached_protocol = ota.HasMqttConfig()        ? kProtocolMqtt
+                      : ota.HasWebsocketConfig() ? kProtocolWebsocket
+                                                 : kProtocolNone;
+    has_server_time_ = ota.HasServerTime();
+  }
+  if (cached_protocol == kProtocolWebsocket) {
     protocol_ = std::make_unique<WebsocketProtocol>();
   } else {
-    ESP_LOGW(TAG, "No protocol specified in the OTA config, using MQTT");
+    if (cached_protocol == kProtocolNone) {
+      ESP_LOGW(TAG, "No protocol specified in the OTA config, using MQTT");
+    }
     protocol_ = std::make_unique<MqttProtocol>();
   }
 
@@ -603,16 +695,12 @@ void Application::Start() {
               ESP_LOGI(TAG, "音频播放完成，用时 %d ms", wait_count * 100);
             }
 
-            // 🧠 记录对话（已禁用，学习系统已关闭）
-            // auto &profile = xiaozhi::UserProfile::GetInstance();
-            // profile.RecordInteraction("chat", 5000); // 假设5秒对话
-            // profile.CheckAutoSave();
-
-            // 📡 发布对话结束事件（事件总线）
-            auto &event_bus = xiaozhi::EventBus::GetInstance();
-            event_bus.Publish(xiaozhi::LOGIC_EVENT,
-                              xiaozhi::LOGIC_CONVERSATION_END, nullptr);
-            ESP_LOGI(TAG, "📡 Event published: CONVERSATION_END");
+            // 📡 发布对话结束事件（用户画像在订阅者中更新）
+            xiaozhi::ConversationEventData conversation = {};
+            strncpy(conversation.topic, "chat", sizeof(conversation.topic) - 1);
+            xiaozhi::EventBus::GetInstance()
+                .PublishFast<xiaozhi::EventType::kConversationEnd>(conversation);
+            ESP_LOGD(TAG, "📡 Event published: CONVERSATION_END");
 
             // Ensure microphone is unmuted for the next turn
             audio_service_.SetInputMute(false);
@@ -639,8 +727,8 @@ void Application::Start() {
         ESP_LOGI(TAG, ">> %s", text->valuestring);
         Schedule([this, display, message = std::string(text->valuestring)]() {
           display->SetChatMessage("user", message.c_str());
-          // 🐾 记录聊天（已禁用，宠物系统已关闭）
-          // PetSystem::GetInstance().RecordChat();
+          // 🐾 记录聊天（每日任务统计）
+          PetSystem::GetInstance().RecordChat();
         });
       }
     } else if (strcmp(type->valuestring, "llm") == 0) {
@@ -698,14 +786,23 @@ void Application::Start() {
     }
   });
   bool protocol_started = protocol_->Start();
+  boot_.Mark("protocol_started");
 
   SystemInfo::PrintHeapStats();
+  // 后台检查发现新版本或需要激活时，在进入待机之前回到前台按原流程处理，
+  // 升级和激活的设备状态不会与待机交错，升级也不会占用主循环
+  boot_.Wait(ota_check);
+  if (ota_needs_foreground) {
+    CheckNewVersion(ota);
+  }
+  // 进入待机会启动唤醒词检测，必须等后台的预加载结束
+  boot_.Wait(wake_word);
   SetDeviceState(kDeviceStateIdle);
+  boot_.Mark("wake_word_ready");
 
-  has_server_time_ = ota.HasServerTime();
   if (protocol_started) {
-    std::string message =
-        std::string(Lang::Strings::VERSION) + ota.GetCurrentVersion();
+    std::string message = std::string(Lang::Strings::VERSION) +
+                          esp_app_get_description()->version;
     display->ShowNotification(message.c_str());
     display->SetChatMessage("system", "");
     // Play the success sound to indicate the device is ready
@@ -833,6 +930,8 @@ void Application::AbortSpeaking(AbortReason reason) {
   }
   // Ensure immediate silence by resetting the decoder
   audio_service_.ResetDecoder();
+  // Drop queued tool calls and let long-running ones stop early
+  McpServer::GetInstance().CancelToolCalls();
 }
 
 void Application::SetListeningMode(ListeningMode mode) {
@@ -949,6 +1048,7 @@ void Application::Reboot() {
   }
   protocol_.reset();
   audio_service_.Stop();
+  PersistentStore::GetInstance().Flush();
 
   vTaskDelay(pdMS_TO_TICKS(1000));
   esp_restart();
@@ -983,15 +1083,17 @@ bool Application::UpgradeFirmware(Ota &ota, const std::string &url) {
   audio_service_.Stop();
   vTaskDelay(pdMS_TO_TICKS(1000));
 
-  bool upgrade_success = ota.StartUpgradeFromUrl(
-      upgrade_url, [display](int progress, size_t speed) {
-        std::thread([display, progress, speed]() {
-          char buffer[32];
-          snprintf(buffer, sizeof(buffer), "%d%% %uKB/s", progress,
-                   speed / 1024);
-          display->SetChatMessage("system", buffer);
-        }).detach();
-      });
+  auto progress_callback = [display](int progress, size_t speed) {
+    std::thread([display, progress, speed]() {
+      char buffer[32];
+      snprintf(buffer, sizeof(buffer), "%d%% %uKB/s", progress, speed / 1024);
+      display->SetChatMessage("system", buffer);
+    }).detach();
+  };
+  // 未指定 URL 时先尝试服务器下发的差量补丁，失败再下载完整镜像
+  bool upgrade_success =
+      url.empty() ? ota.StartUpgrade(progress_callback)
+                  : ota.StartUpgradeFromUrl(url, progress_callback);
 
   if (!upgrade_success) {
     // Upgrade failed, restart audio service and continue running
@@ -1049,7 +1151,7 @@ bool Application::CanEnterSleepMode() {
   return true;
 }
 
-void Application::SendMcpMessage(const std::string &payload) {
+void Application::SendMcpMessage(std::string payload) {
   if (protocol_ == nullptr) {
     return;
   }
@@ -1064,6 +1166,23 @@ void Application::SendMcpMessage(const std::string &payload) {
   }
 }
 
+void Application::SendMcpMessage(std::string head,
+                                 std::shared_ptr<ImageContent> image,
+                                 std::string tail) {
+  if (protocol_ == nullptr) {
+    return;
+  }
+
+  if (xTaskGetCurrentTaskHandle() == main_event_loop_task_handle_) {
+    protocol_->SendMcpMessage(head, image->data(), tail);
+  } else {
+    Schedule([this, head = std::move(head), image = std::move(image),
+              tail = std::move(tail)]() {
+      protocol_->SendMcpMessage(head, image->data(), tail);
+    });
+  }
+}
+
 void Application::SetAecMode(AecMode mode) {
   aec_mode_ = mode;
   Schedule([this]() {
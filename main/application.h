@@ -16,6 +16,7 @@
 #include "audio_service.h"
 #include "device_state_event.h"
 #include "touch_handler.h"
+#include "boot_orchestrator.h"
 
 
 #define MAIN_EVENT_SCHEDULE (1 << 0)
@@ -27,6 +28,8 @@
 #define MAIN_EVENT_CLOCK_TICK (1 << 6)
 
 
+class ImageContent;
+
 enum AecMode {
     kAecOff,
     kAecOnDeviceSide,
@@ -59,7 +62,9 @@ public:
     void WakeWordInvoke(const std::string& wake_word);
     bool UpgradeFirmware(Ota& ota, const std::string& url = "");
     bool CanEnterSleepMode();
-    void SendMcpMessage(const std::string& payload);
+    void SendMcpMessage(std::string payload);
+    // 发送 head + base64(image) + tail，图片在协议层分片编码
+    void SendMcpMessage(std::string head, std::shared_ptr<ImageContent> image, std::string tail);
     void SetAecMode(AecMode mode);
     AecMode GetAecMode() const { return aec_mode_; }
     void PlaySound(const std::string_view& sound);
@@ -67,6 +72,12 @@ public:
     void OnTouchDetected();
 
 private:
+    enum ProtocolType {
+        kProtocolNone,
+        kProtocolMqtt,
+        kProtocolWebsocket,
+    };
+
     Application();
     ~Application();
 
@@ -93,9 +104,13 @@ private:
     int clock_ticks_ = 0;
     TaskHandle_t check_new_version_task_handle_ = nullptr;
     TaskHandle_t main_event_loop_task_handle_ = nullptr;
+    BootOrchestrator boot_;
 
     void OnWakeWordDetected();
     void CheckNewVersion(Ota& ota);
+    bool CheckNewVersionInBackground(Ota& ota);
+    static void InitializeLearning();
+    static ProtocolType GetCachedProtocolType();
     void CheckAssetsVersion();
     void ShowActivationCode(const std::string& code, const std::string& message);
     void SetListeningMode(ListeningMode mode);
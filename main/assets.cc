@@ -1,4 +1,6 @@
 #include "assets.h"
+#include "assets_format.h"
+#include "assets_downloader.h"
 #include "board.h"
 #include "display.h"
 #include "application.h"
@@ -6,19 +8,19 @@
 #include "emote_display.h"
 
 #include <esp_log.h>
+#include <esp_rom_crc.h>
 #include <spi_flash_mmap.h>
 #include <esp_timer.h>
 #include <cbin_font.h>
+#include <cstring>
 
 
 #define TAG "Assets"
 
-struct mmap_assets_table {
-    char asset_name[32];          /*!< Name of the asset */
-    uint32_t asset_size;          /*!< Size of the asset */
-    uint32_t asset_offset;        /*!< Offset of the asset */
-    uint16_t asset_width;         /*!< Width of the asset */
-    uint16_t asset_height;        /*!< Height of the asset */
+enum : uint8_t {
+    kVerifyUnknown = 0,
+    kVerifyPassed = 1,
+    kVerifyFailed = 2,
 };
 
 
@@ -41,10 +43,19 @@ uint32_t Assets::CalculateChecksum(const char* data, uint32_t length) {
     return checksum & 0xFFFF;
 }
 
+void Assets::ResetTable() {
+    format_ = TableFormat::kNone;
+    table_ = nullptr;
+    data_ = nullptr;
+    data_size_ = 0;
+    file_count_ = 0;
+    verify_state_.reset();
+}
+
 bool Assets::InitializePartition() {
     partition_valid_ = false;
     checksum_valid_ = false;
-    assets_.clear();
+    ResetTable();
 
     partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_ANY, ESP_PARTITION_SUBTYPE_ANY, "assets");
     if (partition_ == nullptr) {
@@ -69,6 +80,52 @@ bool Assets::InitializePartition() {
 
     partition_valid_ = true;
 
+    // 上次下载未完成，分区内容新旧混杂，等待续传
+    if (!AssetsDownloader::GetPendingUrl().empty()) {
+        ESP_LOGW(TAG, "The assets download was interrupted, waiting to resume");
+        return false;
+    }
+
+    if (memcmp(mmap_root_, ASSETS_V2_MAGIC, 4) == 0) {
+        checksum_valid_ = InitializeIndexedTable();
+    } else {
+        checksum_valid_ = InitializeLegacyTable();
+    }
+    return checksum_valid_;
+}
+
+bool Assets::InitializeIndexedTable() {
+    auto header = (const mmap_assets_header_v2*)mmap_root_;
+    if (header->version != ASSETS_V2_VERSION) {
+        ESP_LOGE(TAG, "Unsupported assets format version %u", header->version);
+        return false;
+    }
+    if (!CheckAssetsHeaderV2(*header, partition_->size)) {
+        ESP_LOGE(TAG, "The assets table (%lu files) is out of the partition bounds", header->file_count);
+        return false;
+    }
+
+    // 只校验名称表，资源数据在首次访问时校验
+    auto start_time = esp_timer_get_time();
+    uint32_t table_size = header->file_count * sizeof(mmap_assets_table_v2);
+    uint32_t calculated_crc = esp_rom_crc32_le(0, (const uint8_t*)(mmap_root_ + header->table_offset), table_size);
+    auto end_time = esp_timer_get_time();
+    if (calculated_crc != header->table_crc32) {
+        ESP_LOGE(TAG, "The table CRC32 (0x%08lx) does not match the stored one (0x%08lx)", calculated_crc, header->table_crc32);
+        return false;
+    }
+
+    table_ = mmap_root_ + header->table_offset;
+    data_ = mmap_root_ + header->data_offset;
+    data_size_ = header->data_length;
+    file_count_ = header->file_count;
+    verify_state_.reset(new std::atomic<uint8_t>[file_count_]());
+    format_ = TableFormat::kIndexed;
+    ESP_LOGI(TAG, "Indexed assets table: %lu files, verified in %d us", file_count_, int(end_time - start_time));
+    return true;
+}
+
+bool Assets::InitializeLegacyTable() {
     uint32_t stored_files = *(uint32_t*)(mmap_root_ + 0);
     uint32_t stored_chksum = *(uint32_t*)(mmap_root_ + 4);
     uint32_t stored_len = *(uint32_t*)(mmap_root_ + 8);
@@ -78,6 +135,7 @@ bool Assets::InitializePartition() {
         return false;
     }
 
+    // v1 没有逐个资源的校验信息，只能保留全量校验
     auto start_time = esp_timer_get_time();
     uint32_t calculated_checksum = CalculateChecksum(mmap_root_ + 12, stored_len);
     auto end_time = esp_timer_get_time();
@@ -88,17 +146,86 @@ bool Assets::InitializePartition() {
         return false;
     }
 
-    checksum_valid_ = true;
+    if ((uint64_t)stored_files * sizeof(mmap_assets_table) > stored_len) {
+        ESP_LOGE(TAG, "The assets table (%lu files) exceeds the stored length", stored_files);
+        return false;
+    }
 
-    for (uint32_t i = 0; i < stored_files; i++) {
-        auto item = (const mmap_assets_table*)(mmap_root_ + 12 + i * sizeof(mmap_assets_table));
-        auto asset = Asset{
-            .size = static_cast<size_t>(item->asset_size),
-            .offset = static_cast<size_t>(12 + sizeof(mmap_assets_table) * stored_files + item->asset_offset)
-        };
-        assets_[item->asset_name] = asset;
+    table_ = mmap_root_ + 12;
+    data_ = table_ + sizeof(mmap_assets_table) * stored_files;
+    data_size_ = mmap_root_ + 12 + stored_len - data_;
+    file_count_ = stored_files;
+    format_ = TableFormat::kLegacy;
+    return true;
+}
+
+bool Assets::FindAsset(const std::string& name, AssetEntry& entry) const {
+    if (name.size() >= ASSETS_NAME_MAX_LEN) {
+        return false;
     }
-    return checksum_valid_;
+
+    if (format_ == TableFormat::kIndexed) {
+        auto table = (const mmap_assets_table_v2*)table_;
+        auto item = FindAssetV2(table, file_count_, name.c_str());
+        if (item == nullptr) {
+            return false;
+        }
+        if ((uint64_t)item->asset_offset + item->asset_size > data_size_) {
+            ESP_LOGE(TAG, "The asset %s is out of the partition bounds", name.c_str());
+            return false;
+        }
+        entry.data = data_ + item->asset_offset;
+        entry.size = item->asset_size;
+        entry.crc32 = item->asset_crc32;
+        entry.index = static_cast<int>(item - table);
+        return true;
+    }
+
+    if (format_ == TableFormat::kLegacy) {
+        auto table = (const mmap_assets_table*)table_;
+        for (uint32_t i = 0; i < file_count_; i++) {
+            const auto& item = table[i];
+            if (strncmp(name.c_str(), item.asset_name, ASSETS_NAME_MAX_LEN) != 0) {
+                continue;
+            }
+            if ((uint64_t)item.asset_offset + 2 + item.asset_size > data_size_) {
+                ESP_LOGE(TAG, "The asset %s is out of the partition bounds", name.c_str());
+                return false;
+            }
+            auto data = data_ + item.asset_offset;
+            if (data[0] != 'Z' || data[1] != 'Z') {
+                ESP_LOGE(TAG, "The asset %s is not valid with magic %02x%02x", name.c_str(), data[0], data[1]);
+                return false;
+            }
+            entry.data = data + 2;
+            entry.size = item.asset_size;
+            entry.crc32 = 0;
+            entry.index = static_cast<int>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Assets::VerifyAsset(const std::string& name, const AssetEntry& entry) {
+    if (format_ != TableFormat::kIndexed) {
+        return true;
+    }
+
+    auto& state = verify_state_[entry.index];
+    uint8_t current = state.load(std::memory_order_acquire);
+    if (current == kVerifyUnknown) {
+        auto start_time = esp_timer_get_time();
+        uint32_t crc = esp_rom_crc32_le(0, (const uint8_t*)entry.data, entry.size);
+        current = crc == entry.crc32 ? kVerifyPassed : kVerifyFailed;
+        state.store(current, std::memory_order_release);
+        if (current == kVerifyFailed) {
+            ESP_LOGE(TAG, "The asset %s CRC32 (0x%08lx) does not match the stored one (0x%08lx)", name.c_str(), crc, entry.crc32);
+        } else {
+            ESP_LOGD(TAG, "Verified asset %s (%u bytes) in %d us", name.c_str(), entry.size, int(esp_timer_get_time() - start_time));
+        }
+    }
+    return current == kVerifyPassed;
 }
 
 bool Assets::Apply() {
@@ -369,7 +496,11 @@ bool Assets::Apply() {
 
 bool Assets::Download(std::string url, std::function<void(int progress, size_t speed)> progress_callback) {
     ESP_LOGI(TAG, "Downloading new version of assets from %s", url.c_str());
-    
+    if (partition_ == nullptr) {
+        ESP_LOGE(TAG, "No assets partition found");
+        return false;
+    }
+
     // 取消当前资源分区的内存映射
     if (mmap_handle_ != 0) {
         esp_partition_munmap(mmap_handle_);
@@ -377,120 +508,16 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
         mmap_root_ = nullptr;
     }
     checksum_valid_ = false;
-    assets_.clear();
-
-    // 下载新的资源文件
-    auto network = Board::GetInstance().GetNetwork();
-    auto http = network->CreateHttp(0);
-    
-    if (!http->Open("GET", url)) {
-        ESP_LOGE(TAG, "Failed to open HTTP connection");
-        return false;
-    }
+    ResetTable();
 
-    if (http->GetStatusCode() != 200) {
-        ESP_LOGE(TAG, "Failed to get assets, status code: %d", http->GetStatusCode());
+    // 下载失败时保留断点，下次调用时续传
+    AssetsDownloader downloader(partition_);
+    if (!downloader.Download(url, progress_callback)) {
+        // 还没开始写入时旧资源仍然完整，恢复映射
+        InitializePartition();
         return false;
     }
 
-    size_t content_length = http->GetBodyLength();
-    if (content_length == 0) {
-        ESP_LOGE(TAG, "Failed to get content length");
-        return false;
-    }
-
-    if (content_length > partition_->size) {
-        ESP_LOGE(TAG, "Assets file size (%u) is larger than partition size (%lu)", content_length, partition_->size);
-        return false;
-    }
-
-    // 定义扇区大小为4KB（ESP32的标准扇区大小）
-    const size_t SECTOR_SIZE = esp_partition_get_main_flash_sector_size();
-    
-    // 计算需要擦除的扇区数量
-    size_t sectors_to_erase = (content_length + SECTOR_SIZE - 1) / SECTOR_SIZE; // 向上取整
-    size_t total_erase_size = sectors_to_erase * SECTOR_SIZE;
-    
-    ESP_LOGI(TAG, "Sector size: %u, content length: %u, sectors to erase: %u, total erase size: %u", 
-             SECTOR_SIZE, content_length, sectors_to_erase, total_erase_size);
-    
-    // 写入新的资源文件到分区，一边erase一边写入
-    char buffer[512];
-    size_t total_written = 0;
-    size_t recent_written = 0;
-    size_t current_sector = 0;
-    auto last_calc_time = esp_timer_get_time();
-    
-    while (true) {
-        int ret = http->Read(buffer, sizeof(buffer));
-        if (ret < 0) {
-            ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
-            return false;
-        }
-
-        if (ret == 0) {
-            break;
-        }
-
-        // 检查是否需要擦除新的扇区
-        size_t write_end_offset = total_written + ret;
-        size_t needed_sectors = (write_end_offset + SECTOR_SIZE - 1) / SECTOR_SIZE;
-        
-        // 擦除需要的新扇区
-        while (current_sector < needed_sectors) {
-            size_t sector_start = current_sector * SECTOR_SIZE;
-            size_t sector_end = (current_sector + 1) * SECTOR_SIZE;
-            
-            // 确保擦除范围不超过分区大小
-            if (sector_end > partition_->size) {
-                ESP_LOGE(TAG, "Sector end (%u) exceeds partition size (%lu)", sector_end, partition_->size);
-                return false;
-            }
-            
-            ESP_LOGD(TAG, "Erasing sector %u (offset: %u, size: %u)", current_sector, sector_start, SECTOR_SIZE);
-            esp_err_t err = esp_partition_erase_range(partition_, sector_start, SECTOR_SIZE);
-            if (err != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to erase sector %u at offset %u: %s", current_sector, sector_start, esp_err_to_name(err));
-                return false;
-            }
-            
-            current_sector++;
-        }
-
-        // 写入数据到分区
-        esp_err_t err = esp_partition_write(partition_, total_written, buffer, ret);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to write to assets partition at offset %u: %s", total_written, esp_err_to_name(err));
-            return false;
-        }
-
-        total_written += ret;
-        recent_written += ret;
-
-        // 计算进度和速度
-        if (esp_timer_get_time() - last_calc_time >= 1000000 || total_written == content_length || ret == 0) {
-            size_t progress = total_written * 100 / content_length;
-            size_t speed = recent_written; // 每秒的字节数
-            ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %u B/s, Sectors erased: %u", 
-                     progress, total_written, content_length, speed, current_sector);
-            if (progress_callback) {
-                progress_callback(progress, speed);
-            }
-            last_calc_time = esp_timer_get_time();
-            recent_written = 0; // 重置最近写入的字节数
-        }
-    }
-    
-    http->Close();
-
-    if (total_written != content_length) {
-        ESP_LOGE(TAG, "Downloaded size (%u) does not match expected size (%u)", total_written, content_length);
-        return false;
-    }
-
-    ESP_LOGI(TAG, "Assets download completed, total written: %u bytes, total sectors erased: %u", 
-             total_written, current_sector);
-
     // 重新初始化资源分区
     if (!InitializePartition()) {
         ESP_LOGE(TAG, "Failed to re-initialize assets partition");
@@ -500,18 +527,20 @@ bool Assets::Download(std::string url, std::function<void(int progress, size_t s
     return true;
 }
 
+std::string Assets::GetPendingDownloadUrl() {
+    return AssetsDownloader::GetPendingUrl();
+}
+
 bool Assets::GetAssetData(const std::string& name, void*& ptr, size_t& size) {
-    auto asset = assets_.find(name);
-    if (asset == assets_.end()) {
+    AssetEntry entry;
+    if (!FindAsset(name, entry)) {
         return false;
     }
-    auto data = (const char*)(mmap_root_ + asset->second.offset);
-    if (data[0] != 'Z' || data[1] != 'Z') {
-        ESP_LOGE(TAG, "The asset %s is not valid with magic %02x%02x", name.c_str(), data[0], data[1]);
+    if (!VerifyAsset(name, entry)) {
         return false;
     }
 
-    ptr = static_cast<void*>(const_cast<char*>(data + 2));
-    size = asset->second.size;
+    ptr = static_cast<void*>(const_cast<char*>(entry.data));
+    size = entry.size;
     return true;
 }
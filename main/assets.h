@@ -1,7 +1,8 @@
 #ifndef ASSETS_H
 #define ASSETS_H
 
-#include <map>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <functional>
 
@@ -10,11 +11,6 @@
 #include <model_path.h>
 
 
-struct Asset {
-    size_t size;
-    size_t offset;
-};
-
 class Assets {
 public:
     static Assets& GetInstance() {
@@ -27,6 +23,11 @@ public:
     bool Apply();
     bool GetAssetData(const std::string& name, void*& ptr, size_t& size);
 
+    /**
+     * @brief 上次下载被中断时返回其 URL，用于续传
+     */
+    std::string GetPendingDownloadUrl();
+
     inline bool partition_valid() const { return partition_valid_; }
     inline bool checksum_valid() const { return checksum_valid_; }
     inline std::string default_assets_url() const { return default_assets_url_; }
@@ -36,7 +37,26 @@ private:
     Assets(const Assets&) = delete;
     Assets& operator=(const Assets&) = delete;
 
+    // 资源表中的一项，直接指向映射区域
+    struct AssetEntry {
+        const char* data;
+        size_t size;
+        uint32_t crc32;
+        int index;
+    };
+
+    enum class TableFormat {
+        kNone,
+        kLegacy,    // v1：全量校验和 + 未排序的表，数据带 "ZZ" 前缀
+        kIndexed,   // v2：排序表 + 表 CRC32 + 每个资源独立 CRC32，数据对齐
+    };
+
     bool InitializePartition();
+    bool InitializeLegacyTable();
+    bool InitializeIndexedTable();
+    void ResetTable();
+    bool FindAsset(const std::string& name, AssetEntry& entry) const;
+    bool VerifyAsset(const std::string& name, const AssetEntry& entry);
     uint32_t CalculateChecksum(const char* data, uint32_t length);
 
     const esp_partition_t* partition_ = nullptr;
@@ -46,7 +66,15 @@ private:
     bool checksum_valid_ = false;
     std::string default_assets_url_;
     srmodel_list_t* models_list_ = nullptr;
-    std::map<std::string, Asset> assets_;
+
+    // 资源表直接在映射区域中查找，启动时不复制到堆上
+    TableFormat format_ = TableFormat::kNone;
+    const char* table_ = nullptr;
+    const char* data_ = nullptr;
+    size_t data_size_ = 0;
+    uint32_t file_count_ = 0;
+    // v2 每个资源的惰性校验状态：0 未校验，1 通过，2 失败
+    std::unique_ptr<std::atomic<uint8_t>[]> verify_state_;
 };
 
 #endif
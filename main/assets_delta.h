@@ -0,0 +1,73 @@
+#ifndef ASSETS_DELTA_H
+#define ASSETS_DELTA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include "assets_format.h"
+
+/*
+ * v2 差量下载计划：新旧两张表中名称、大小、CRC32 和位置都相同的资源不需要重新下载。
+ * 相邻且都可复用的资源之间只有对齐填充，合并成连续区间后，把完全落在区间内的扇区
+ * 标记到 clean_sectors；[0, head_size) 覆盖的扇区总是最后重写，不会被标记。
+ * 两张表都必须已经通过 CRC32 校验。不依赖 ESP-IDF，可以在主机上测试。
+ */
+inline void MarkReusableSectors(const mmap_assets_header_v2& new_header, const mmap_assets_table_v2* new_entries,
+                                const mmap_assets_header_v2& old_header, const mmap_assets_table_v2* old_entries,
+                                size_t sector_size, size_t total_size, size_t head_size,
+                                std::vector<bool>& clean_sectors) {
+    auto old_end = old_entries + old_header.file_count;
+
+    struct Span {
+        size_t start;
+        size_t end;
+        bool reusable;
+    };
+    std::vector<Span> spans;
+    spans.reserve(new_header.file_count);
+    for (uint32_t i = 0; i < new_header.file_count; i++) {
+        const auto& entry = new_entries[i];
+        size_t start = new_header.data_offset + entry.asset_offset;
+        // 两张表都按名称排序，直接二分查找
+        auto old = std::lower_bound(old_entries, old_end, entry, [](const mmap_assets_table_v2& a, const mmap_assets_table_v2& b) {
+            return strncmp(a.asset_name, b.asset_name, ASSETS_NAME_MAX_LEN) < 0;
+        });
+        bool reusable = old != old_end && strncmp(old->asset_name, entry.asset_name, ASSETS_NAME_MAX_LEN) == 0 &&
+            old->asset_size == entry.asset_size && old->asset_crc32 == entry.asset_crc32 &&
+            old_header.data_offset + old->asset_offset == start && entry.asset_size > 0;
+        spans.push_back({start, start + entry.asset_size, reusable});
+    }
+    std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) { return a.start < b.start; });
+
+    auto mark_clean = [&](size_t start, size_t end) {
+        for (size_t sector = (start + sector_size - 1) / sector_size; sector < clean_sectors.size(); sector++) {
+            size_t sector_end = std::min((sector + 1) * sector_size, total_size);
+            if (sector_end > end) {
+                break;
+            }
+            clean_sectors[sector] = sector * sector_size >= head_size;
+        }
+    };
+    bool merging = false;
+    size_t merge_start = 0;
+    size_t merge_end = 0;
+    for (const auto& span : spans) {
+        if (span.reusable && merging && span.start >= merge_end && span.start - merge_end < new_header.alignment) {
+            merge_end = span.end;
+            continue;
+        }
+        if (merging) {
+            mark_clean(merge_start, merge_end);
+        }
+        merging = span.reusable;
+        merge_start = span.start;
+        merge_end = span.end;
+    }
+    if (merging) {
+        mark_clean(merge_start, merge_end);
+    }
+}
+
+#endif // ASSETS_DELTA_H
@@ -0,0 +1,505 @@
+#include "assets_downloader.h"
+#include "assets_delta.h"
+#include "assets_format.h"
+#include "board.h"
+#include "settings.h"
+
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#define TAG "AssetsDownloader"
+
+// 每块包含的扇区数，两块轮流使用
+#define BLOCK_SECTORS           2
+// 至少写入这么多字节后才保存一次断点，避免频繁写 NVS
+#define PROGRESS_SAVE_INTERVAL  (64 * 1024)
+
+static const char* kSettingsNamespace = "assets";
+
+
+AssetsDownloader::AssetsDownloader(const esp_partition_t* partition)
+    : partition_(partition), sector_size_(esp_partition_get_main_flash_sector_size()) {
+}
+
+AssetsDownloader::~AssetsDownloader() {
+    StopWriter();
+}
+
+std::string AssetsDownloader::GetPendingUrl() {
+    Settings settings(kSettingsNamespace);
+    return settings.GetString("dl_url");
+}
+
+void AssetsDownloader::ClearProgress() {
+    Settings settings(kSettingsNamespace, true);
+    settings.EraseKey("dl_url");
+    settings.EraseKey("dl_size");
+    settings.EraseKey("dl_id");
+    settings.EraseKey("dl_offset");
+}
+
+void AssetsDownloader::LoadProgress(const std::string& url) {
+    Settings settings(kSettingsNamespace, true);
+    std::string pending_url = settings.GetString("dl_url");
+    if (!pending_url.empty()) {
+        bool same_target = pending_url == url &&
+            static_cast<size_t>(settings.GetInt("dl_size")) == total_size_ &&
+            static_cast<uint32_t>(settings.GetInt("dl_id")) == target_id_;
+        if (same_target && range_supported_) {
+            resume_offset_ = settings.GetInt("dl_offset");
+            ESP_LOGI(TAG, "Resuming interrupted download at offset %u", resume_offset_);
+        } else {
+            // 分区里混有另一个镜像的部分内容，旧资源表已不可信
+            allow_delta_ = false;
+            ESP_LOGW(TAG, "Discarding interrupted download of %s", pending_url.c_str());
+        }
+    }
+
+    // 开始写入前先记下断点，中断后启动时据此判断分区内容不完整
+    settings.SetString("dl_url", url);
+    settings.SetInt("dl_size", total_size_);
+    settings.SetInt("dl_id", static_cast<int32_t>(target_id_));
+    settings.SetInt("dl_offset", resume_offset_);
+    saved_offset_ = resume_offset_;
+    committed_offset_.store(resume_offset_);
+}
+
+void AssetsDownloader::SaveProgress(bool force) {
+    size_t offset = committed_offset_.load();
+    if (offset <= saved_offset_ || (!force && offset - saved_offset_ < PROGRESS_SAVE_INTERVAL)) {
+        return;
+    }
+    Settings settings(kSettingsNamespace, true);
+    settings.SetInt("dl_offset", offset);
+    saved_offset_ = offset;
+}
+
+bool AssetsDownloader::FetchHead(const std::string& url) {
+    auto network = Board::GetInstance().GetNetwork();
+    auto http = network->CreateHttp(0);
+    http->SetHeader("Range", "bytes=0-" + std::to_string(sector_size_ - 1));
+    if (!http->Open("GET", url)) {
+        ESP_LOGE(TAG, "Failed to open HTTP connection");
+        return false;
+    }
+
+    int status_code = http->GetStatusCode();
+    if (status_code == 206) {
+        range_supported_ = true;
+        // Content-Range: bytes 0-4095/123456
+        std::string content_range = http->GetResponseHeader("Content-Range");
+        auto slash = content_range.rfind('/');
+        if (slash != std::string::npos) {
+            total_size_ = strtoul(content_range.c_str() + slash + 1, nullptr, 10);
+        }
+    } else if (status_code == 200) {
+        range_supported_ = false;
+        total_size_ = http->GetBodyLength();
+        ESP_LOGW(TAG, "The server does not support Range, downloading the whole file");
+    } else {
+        ESP_LOGE(TAG, "Failed to get assets, status code: %d", status_code);
+        return false;
+    }
+
+    if (total_size_ == 0) {
+        ESP_LOGE(TAG, "Failed to get content length");
+        return false;
+    }
+    if (total_size_ > partition_->size) {
+        ESP_LOGE(TAG, "Assets file size (%u) is larger than partition size (%lu)", total_size_, partition_->size);
+        return false;
+    }
+
+    head_.resize(std::min(sector_size_, total_size_));
+    size_t received = 0;
+    while (received < head_.size()) {
+        int ret = http->Read(reinterpret_cast<char*>(head_.data()) + received, head_.size() - received);
+        if (ret <= 0) {
+            ESP_LOGE(TAG, "Failed to read assets header: %d", ret);
+            return false;
+        }
+        received += ret;
+    }
+
+    if (head_.size() >= sizeof(mmap_assets_header_v2) && memcmp(head_.data(), ASSETS_V2_MAGIC, 4) == 0) {
+        target_id_ = reinterpret_cast<const mmap_assets_header_v2*>(head_.data())->table_crc32;
+    } else if (head_.size() >= 12) {
+        memcpy(&target_id_, head_.data() + 4, sizeof(target_id_));
+    }
+
+    if (range_supported_) {
+        http->Close();
+    } else {
+        head_http_ = std::move(http);
+    }
+    return true;
+}
+
+bool AssetsDownloader::FetchBytes(const std::string& url, size_t start, size_t end, std::vector<uint8_t>& out) {
+    auto network = Board::GetInstance().GetNetwork();
+    auto http = network->CreateHttp(0);
+    http->SetHeader("Range", "bytes=" + std::to_string(start) + "-" + std::to_string(end - 1));
+    if (!http->Open("GET", url) || http->GetStatusCode() != 206) {
+        ESP_LOGE(TAG, "Failed to fetch bytes %u-%u", start, end - 1);
+        return false;
+    }
+
+    out.resize(end - start);
+    size_t received = 0;
+    while (received < out.size()) {
+        int ret = http->Read(reinterpret_cast<char*>(out.data()) + received, out.size() - received);
+        if (ret <= 0) {
+            return false;
+        }
+        received += ret;
+    }
+    http->Close();
+    return true;
+}
+
+bool AssetsDownloader::FetchTableSectors() {
+    // 资源表超出第一个扇区时，把表覆盖的扇区都取回并入 head_，与头部一起最后写入
+    if (head_.size() < sizeof(mmap_assets_header_v2) || memcmp(head_.data(), ASSETS_V2_MAGIC, 4) != 0) {
+        return false;
+    }
+    mmap_assets_header_v2 header;
+    memcpy(&header, head_.data(), sizeof(header));
+    size_t table_end = header.table_offset + header.file_count * sizeof(mmap_assets_table_v2);
+    if (header.version != ASSETS_V2_VERSION || table_end > total_size_) {
+        return false;
+    }
+    if (table_end <= head_.size()) {
+        return true;
+    }
+    if (!range_supported_) {
+        ESP_LOGW(TAG, "The assets table ends at %u, beyond the first sector; it is written before the header",
+                 table_end);
+        return false;
+    }
+    size_t head_end = std::min((table_end + sector_size_ - 1) / sector_size_ * sector_size_, total_size_);
+    std::vector<uint8_t> rest;
+    if (!FetchBytes(url_, head_.size(), head_end, rest)) {
+        ESP_LOGW(TAG, "Failed to fetch the assets table; it is written before the header");
+        return false;
+    }
+    head_.insert(head_.end(), rest.begin(), rest.end());
+    return true;
+}
+
+bool AssetsDownloader::BuildDeltaPlan(std::vector<bool>& clean_sectors) {
+    // 新镜像的资源表即差量清单
+    if (head_.size() < sizeof(mmap_assets_header_v2) || memcmp(head_.data(), ASSETS_V2_MAGIC, 4) != 0) {
+        return false;
+    }
+    mmap_assets_header_v2 new_header;
+    memcpy(&new_header, head_.data(), sizeof(new_header));
+    size_t new_table_size = new_header.file_count * sizeof(mmap_assets_table_v2);
+    size_t new_table_end = new_header.table_offset + new_table_size;
+    if (new_header.version != ASSETS_V2_VERSION || new_table_end > total_size_) {
+        return false;
+    }
+
+    if (new_table_end > head_.size()) {
+        return false;
+    }
+    std::vector<uint8_t> new_table(head_.begin() + new_header.table_offset, head_.begin() + new_table_end);
+    if (esp_rom_crc32_le(0, new_table.data(), new_table_size) != new_header.table_crc32) {
+        ESP_LOGW(TAG, "The downloaded assets table is corrupted");
+        return false;
+    }
+
+    // 当前分区中的旧资源表
+    mmap_assets_header_v2 old_header;
+    if (esp_partition_read(partition_, 0, &old_header, sizeof(old_header)) != ESP_OK ||
+        memcmp(old_header.magic, ASSETS_V2_MAGIC, 4) != 0 || old_header.version != ASSETS_V2_VERSION ||
+        old_header.alignment != new_header.alignment) {
+        return false;
+    }
+    size_t old_table_size = old_header.file_count * sizeof(mmap_assets_table_v2);
+    if (old_header.table_offset + old_table_size > partition_->size) {
+        return false;
+    }
+    std::vector<uint8_t> old_table(old_table_size);
+    if (esp_partition_read(partition_, old_header.table_offset, old_table.data(), old_table_size) != ESP_OK ||
+        esp_rom_crc32_le(0, old_table.data(), old_table_size) != old_header.table_crc32) {
+        return false;
+    }
+
+    MarkReusableSectors(new_header, reinterpret_cast<const mmap_assets_table_v2*>(new_table.data()),
+                        old_header, reinterpret_cast<const mmap_assets_table_v2*>(old_table.data()),
+                        sector_size_, total_size_, head_.size(), clean_sectors);
+    return true;
+}
+
+void AssetsDownloader::BuildPlan() {
+    size_t sectors = (total_size_ + sector_size_ - 1) / sector_size_;
+    std::vector<bool> clean_sectors(sectors, false);
+    bool table_ready = FetchTableSectors();
+    bool delta = range_supported_ && allow_delta_ && table_ready && BuildDeltaPlan(clean_sectors);
+
+    // 头部和资源表所在的扇区已在 head_ 中，最后写入
+    plan_.clear();
+    size_t clean_count = 0;
+    for (size_t sector = (head_.size() + sector_size_ - 1) / sector_size_; sector < sectors; sector++) {
+        if (clean_sectors[sector]) {
+            clean_count++;
+            continue;
+        }
+        size_t start = sector * sector_size_;
+        size_t end = std::min(start + sector_size_, total_size_);
+        if (!plan_.empty() && plan_.back().end == start) {
+            plan_.back().end = end;
+        } else {
+            plan_.push_back({start, end});
+        }
+    }
+
+    planned_bytes_ = head_.size();
+    done_bytes_ = head_.size();
+    for (const auto& range : plan_) {
+        planned_bytes_ += range.end - range.start;
+        if (range.start < resume_offset_) {
+            done_bytes_ += std::min(range.end, resume_offset_) - range.start;
+        }
+    }
+
+    if (delta) {
+        ESP_LOGI(TAG, "Delta plan: %u of %u sectors unchanged, %u bytes to download in %u ranges",
+                 clean_count, sectors, planned_bytes_ - done_bytes_, plan_.size());
+    } else {
+        ESP_LOGI(TAG, "Full download: %u bytes, %u already written", total_size_, done_bytes_);
+    }
+}
+
+bool AssetsDownloader::StartWriter() {
+    size_t block_size = BLOCK_SECTORS * sector_size_;
+    free_queue_ = xQueueCreate(2, sizeof(uint8_t*));
+    write_queue_ = xQueueCreate(2, sizeof(Block));
+    writer_done_ = xSemaphoreCreateBinary();
+    if (free_queue_ == nullptr || write_queue_ == nullptr || writer_done_ == nullptr) {
+        ESP_LOGE(TAG, "Failed to create writer queues");
+        return false;
+    }
+    for (auto& buffer : buffers_) {
+        buffer.reset(new (std::nothrow) uint8_t[block_size]);
+        if (!buffer) {
+            ESP_LOGE(TAG, "Failed to allocate %u bytes for the write buffer", block_size);
+            return false;
+        }
+        uint8_t* data = buffer.get();
+        xQueueSend(free_queue_, &data, 0);
+    }
+
+    if (xTaskCreate([](void* arg) {
+            static_cast<AssetsDownloader*>(arg)->WriterTask();
+            vTaskDelete(NULL);
+        }, "assets_writer", 4096, this, 5, nullptr) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create writer task");
+        return false;
+    }
+    writer_started_ = true;
+    return true;
+}
+
+// 也用于清理 StartWriter 中途失败时已创建的对象，只有写入任务已启动时才等待它退出
+void AssetsDownloader::StopWriter() {
+    if (writer_started_) {
+        Block stop = {nullptr, 0, 0};
+        xQueueSend(write_queue_, &stop, portMAX_DELAY);
+        xSemaphoreTake(writer_done_, portMAX_DELAY);
+        writer_started_ = false;
+    }
+    if (writer_done_ != nullptr) {
+        vSemaphoreDelete(writer_done_);
+        writer_done_ = nullptr;
+    }
+    if (write_queue_ != nullptr) {
+        vQueueDelete(write_queue_);
+        write_queue_ = nullptr;
+    }
+    if (free_queue_ != nullptr) {
+        vQueueDelete(free_queue_);
+        free_queue_ = nullptr;
+    }
+    current_ = nullptr;
+    current_length_ = 0;
+}
+
+void AssetsDownloader::WriterTask() {
+    Block block;
+    while (xQueueReceive(write_queue_, &block, portMAX_DELAY) == pdTRUE && block.data != nullptr) {
+        if (!write_failed_.load()) {
+            // 块总是从扇区边界开始，整块一次擦除
+            size_t erase_size = (block.length + sector_size_ - 1) / sector_size_ * sector_size_;
+            esp_err_t err = esp_partition_erase_range(partition_, block.offset, erase_size);
+            if (err == ESP_OK) {
+                err = esp_partition_write(partition_, block.offset, block.data, block.length);
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to write %u bytes at offset %u: %s", block.length, block.offset, esp_err_to_name(err));
+                write_failed_.store(true);
+            } else {
+                committed_offset_.store(block.offset + block.length);
+            }
+        }
+        xQueueSend(free_queue_, &block.data, portMAX_DELAY);
+    }
+    xSemaphoreGive(writer_done_);
+}
+
+bool AssetsDownloader::SubmitBlock(size_t length) {
+    if (current_ == nullptr) {
+        return true;
+    }
+    Block block = {current_, current_offset_, length};
+    current_ = nullptr;
+    current_length_ = 0;
+    xQueueSend(write_queue_, &block, portMAX_DELAY);
+    return !write_failed_.load();
+}
+
+void AssetsDownloader::ReportProgress(size_t bytes, bool force) {
+    done_bytes_ += bytes;
+    recent_bytes_ += bytes;
+    auto now = esp_timer_get_time();
+    if (!force && now - last_report_time_ < 1000000) {
+        return;
+    }
+    int progress = planned_bytes_ > 0 ? done_bytes_ * 100 / planned_bytes_ : 100;
+    ESP_LOGI(TAG, "Progress: %d%% (%u/%u), Speed: %u B/s", progress, done_bytes_, planned_bytes_, recent_bytes_);
+    if (progress_callback_) {
+        progress_callback_(progress, recent_bytes_);
+    }
+    last_report_time_ = now;
+    recent_bytes_ = 0;
+}
+
+bool AssetsDownloader::StreamBody(Http* http, size_t start, size_t end) {
+    size_t block_size = BLOCK_SECTORS * sector_size_;
+    size_t offset = start;
+
+    while (offset < end) {
+        if (current_ == nullptr) {
+            xQueueReceive(free_queue_, &current_, portMAX_DELAY);
+            current_length_ = 0;
+        }
+        if (current_length_ == 0) {
+            current_offset_ = offset;
+        }
+        size_t want = std::min(block_size - current_length_, end - offset);
+        int ret = http->Read(reinterpret_cast<char*>(current_) + current_length_, want);
+        if (ret <= 0) {
+            ESP_LOGE(TAG, "Failed to read HTTP data: %d", ret);
+            return false;
+        }
+        current_length_ += ret;
+        offset += ret;
+        ReportProgress(ret, false);
+
+        if (current_length_ == block_size && !SubmitBlock(current_length_)) {
+            return false;
+        }
+        SaveProgress(false);
+    }
+    return true;
+}
+
+bool AssetsDownloader::StreamRange(const std::string& url, const Range& range) {
+    size_t start = std::max(range.start, resume_offset_);
+    if (start >= range.end) {
+        return true;
+    }
+    // 区间不连续时先把未满的块写出去
+    if (current_ != nullptr && current_offset_ + current_length_ != start && !SubmitBlock(current_length_)) {
+        return false;
+    }
+
+    auto network = Board::GetInstance().GetNetwork();
+    auto http = network->CreateHttp(0);
+    http->SetHeader("Range", "bytes=" + std::to_string(start) + "-" + std::to_string(range.end - 1));
+    if (!http->Open("GET", url)) {
+        ESP_LOGE(TAG, "Failed to open HTTP connection");
+        return false;
+    }
+    if (http->GetStatusCode() != 206) {
+        ESP_LOGE(TAG, "Range request failed, status code: %d", http->GetStatusCode());
+        return false;
+    }
+    bool ok = StreamBody(http.get(), start, range.end);
+    http->Close();
+    return ok;
+}
+
+bool AssetsDownloader::Download(const std::string& url, ProgressCallback progress_callback) {
+    url_ = url;
+    progress_callback_ = progress_callback;
+    last_report_time_ = esp_timer_get_time();
+
+    if (!FetchHead(url)) {
+        return false;
+    }
+    LoadProgress(url);
+    BuildPlan();
+
+    if (!StartWriter()) {
+        StopWriter();
+        return false;
+    }
+
+    bool ok = true;
+    if (range_supported_) {
+        for (const auto& range : plan_) {
+            if (!StreamRange(url, range)) {
+                ok = false;
+                break;
+            }
+        }
+    } else {
+        ok = StreamBody(head_http_.get(), head_.size(), total_size_);
+        head_http_->Close();
+        head_http_.reset();
+    }
+    if (ok && current_ != nullptr) {
+        ok = SubmitBlock(current_length_);
+    }
+    StopWriter();
+    ok = ok && !write_failed_.load();
+
+    if (!ok) {
+        SaveProgress(true);
+        ESP_LOGE(TAG, "Download interrupted at offset %u, it will be resumed next time", committed_offset_.load());
+        return false;
+    }
+
+    // 其余扇区都已写好，最后写入头部和资源表：先写表的后续扇区，第一个扇区放在最后，
+    // 在此之前旧头部一直有效（旧表若被覆盖，CRC 不符，下次按全量下载）
+    esp_err_t err = ESP_OK;
+    size_t first_size = std::min(sector_size_, head_.size());
+    if (head_.size() > first_size) {
+        size_t rest_size = head_.size() - first_size;
+        err = esp_partition_erase_range(partition_, first_size,
+                                        (rest_size + sector_size_ - 1) / sector_size_ * sector_size_);
+        if (err == ESP_OK) {
+            err = esp_partition_write(partition_, first_size, head_.data() + first_size, rest_size);
+        }
+    }
+    if (err == ESP_OK) {
+        err = esp_partition_erase_range(partition_, 0, sector_size_);
+    }
+    if (err == ESP_OK) {
+        err = esp_partition_write(partition_, 0, head_.data(), first_size);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write assets header: %s", esp_err_to_name(err));
+        return false;
+    }
+    ClearProgress();
+    ReportProgress(0, true);
+    ESP_LOGI(TAG, "Assets download completed, %u bytes written", planned_bytes_);
+    return true;
+}
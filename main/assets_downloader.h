@@ -0,0 +1,109 @@
+#ifndef ASSETS_DOWNLOADER_H
+#define ASSETS_DOWNLOADER_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+class Http;
+
+/**
+ * @brief 资源分区下载引擎
+ *
+ * - 网络读取和 Flash 写入重叠：两块按扇区对齐的缓冲区轮流由下载方填充、
+ *   由写入任务整块擦除并写入
+ * - 断点续传：已写入的位置定期保存到 NVS，下次用 HTTP Range 从该位置继续
+ * - 差量更新：新旧镜像都是 v2 格式时，先取回新镜像的资源表作为清单，
+ *   名称、大小、CRC32 和位置都未变的资源所在扇区不再下载和改写
+ * - 头部和资源表所在的扇区最后写入，其中第一个扇区放在最后，中断后旧表仍在，
+ *   差量计划可以重算；服务器不支持 Range 时只能顺序写入，表超出第一个扇区的
+ *   部分会先于头部写入。下载未完成期间 Assets 不会使用分区内容
+ */
+class AssetsDownloader {
+public:
+    using ProgressCallback = std::function<void(int progress, size_t speed)>;
+
+    explicit AssetsDownloader(const esp_partition_t* partition);
+    ~AssetsDownloader();
+
+    bool Download(const std::string& url, ProgressCallback progress_callback);
+
+    /**
+     * @brief 上次下载被中断、尚未完成时返回其 URL
+     */
+    static std::string GetPendingUrl();
+
+private:
+    // 待下载区间 [start, end)，按镜像内偏移
+    struct Range {
+        size_t start;
+        size_t end;
+    };
+
+    struct Block {
+        uint8_t* data;
+        size_t offset;
+        size_t length;
+    };
+
+    bool FetchHead(const std::string& url);
+    bool FetchBytes(const std::string& url, size_t start, size_t end, std::vector<uint8_t>& out);
+    bool FetchTableSectors();
+    void LoadProgress(const std::string& url);
+    void SaveProgress(bool force);
+    static void ClearProgress();
+    void BuildPlan();
+    bool BuildDeltaPlan(std::vector<bool>& clean_sectors);
+
+    bool StartWriter();
+    void StopWriter();
+    void WriterTask();
+    bool SubmitBlock(size_t length);
+    bool StreamBody(Http* http, size_t start, size_t end);
+    bool StreamRange(const std::string& url, const Range& range);
+    void ReportProgress(size_t bytes, bool force);
+
+    const esp_partition_t* partition_;
+    size_t sector_size_;
+    std::string url_;
+    ProgressCallback progress_callback_;
+
+    // 新镜像信息
+    size_t total_size_ = 0;
+    uint32_t target_id_ = 0;         // v2 为表 CRC32，v1 为全量校验和
+    bool range_supported_ = false;
+    bool allow_delta_ = true;
+    std::vector<uint8_t> head_;      // 头部和资源表所在的扇区
+    std::unique_ptr<Http> head_http_; // 服务器不支持 Range 时继续读取的连接
+
+    // 下载计划与进度
+    std::vector<Range> plan_;
+    size_t planned_bytes_ = 0;
+    size_t done_bytes_ = 0;
+    size_t resume_offset_ = 0;       // 此偏移之前的计划区间已写入
+    size_t saved_offset_ = 0;
+    size_t recent_bytes_ = 0;
+    int64_t last_report_time_ = 0;
+
+    // 双缓冲写入
+    std::unique_ptr<uint8_t[]> buffers_[2];
+    uint8_t* current_ = nullptr;
+    size_t current_offset_ = 0;
+    size_t current_length_ = 0;
+    QueueHandle_t free_queue_ = nullptr;
+    QueueHandle_t write_queue_ = nullptr;
+    SemaphoreHandle_t writer_done_ = nullptr;
+    bool writer_started_ = false;
+    std::atomic<bool> write_failed_{false};
+    std::atomic<size_t> committed_offset_{0};
+};
+
+#endif // ASSETS_DOWNLOADER_H
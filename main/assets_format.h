@@ -0,0 +1,95 @@
+#ifndef ASSETS_FORMAT_H
+#define ASSETS_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * v1 资源容器：
+ *   [files u32][checksum u32][length u32][table: files * 44B][data]
+ * 每个资源数据前有 "ZZ" 前缀，checksum 是 table + data 的 16 位累加和。
+ */
+struct mmap_assets_table {
+    char asset_name[32];          /*!< Name of the asset */
+    uint32_t asset_size;          /*!< Size of the asset */
+    uint32_t asset_offset;        /*!< Offset of the asset */
+    uint16_t asset_width;         /*!< Width of the asset */
+    uint16_t asset_height;        /*!< Height of the asset */
+};
+
+/*
+ * v2 资源容器：
+ *   [header 32B][table: file_count * 48B，按名称字节序排序][padding][data]
+ * 名称表可以在映射区域内直接二分查找；启动时只校验表的 CRC32，
+ * 每个资源的 CRC32 在首次访问时校验；数据按 alignment 对齐，没有 "ZZ" 前缀，
+ * 图片和字体可以直接从映射地址使用。
+ */
+#define ASSETS_V2_MAGIC         "AST2"
+#define ASSETS_V2_VERSION       2
+#define ASSETS_NAME_MAX_LEN     32
+
+struct mmap_assets_header_v2 {
+    char magic[4];                /*!< "AST2" */
+    uint16_t version;             /*!< Format version, 2 */
+    uint16_t header_size;         /*!< Size of this header */
+    uint32_t file_count;          /*!< Number of table entries */
+    uint32_t table_offset;        /*!< Offset of the table from partition start */
+    uint32_t data_offset;         /*!< Offset of the data area from partition start */
+    uint32_t data_length;         /*!< Length of the data area */
+    uint32_t table_crc32;         /*!< CRC32 of the whole table */
+    uint16_t alignment;           /*!< Alignment of every asset in the data area */
+    uint16_t reserved;
+};
+
+struct mmap_assets_table_v2 {
+    char asset_name[ASSETS_NAME_MAX_LEN];   /*!< Name of the asset, NUL padded */
+    uint32_t asset_size;          /*!< Size of the asset */
+    uint32_t asset_offset;        /*!< Offset of the asset from data_offset */
+    uint32_t asset_crc32;         /*!< CRC32 of the asset data */
+    uint16_t asset_width;         /*!< Width of the asset */
+    uint16_t asset_height;        /*!< Height of the asset */
+};
+
+static_assert(sizeof(mmap_assets_header_v2) == 32, "v2 header layout");
+static_assert(sizeof(mmap_assets_table_v2) == 48, "v2 table entry layout");
+
+/*
+ * v2 头部的范围检查：表和数据区都必须落在分区内，表在数据区之前。
+ * 不校验 CRC32，调用方拿到表的位置后自行校验。
+ */
+inline bool CheckAssetsHeaderV2(const mmap_assets_header_v2& header, uint64_t partition_size) {
+    if (memcmp(header.magic, ASSETS_V2_MAGIC, 4) != 0 || header.version != ASSETS_V2_VERSION ||
+        header.header_size < sizeof(mmap_assets_header_v2)) {
+        return false;
+    }
+    uint64_t table_end = header.table_offset + (uint64_t)header.file_count * sizeof(mmap_assets_table_v2);
+    uint64_t data_end = (uint64_t)header.data_offset + header.data_length;
+    return header.table_offset >= header.header_size && table_end <= header.data_offset &&
+           data_end <= partition_size;
+}
+
+/*
+ * 在按名称字节序排序的 v2 表中二分查找，找不到时返回 nullptr。
+ * 表项的数据范围由调用方对照 data_length 检查。
+ */
+inline const mmap_assets_table_v2* FindAssetV2(const mmap_assets_table_v2* table, uint32_t file_count,
+                                               const char* name) {
+    int low = 0;
+    int high = static_cast<int>(file_count) - 1;
+    while (low <= high) {
+        int mid = low + (high - low) / 2;
+        int cmp = strncmp(name, table[mid].asset_name, ASSETS_NAME_MAX_LEN);
+        if (cmp == 0) {
+            return &table[mid];
+        }
+        if (cmp < 0) {
+            high = mid - 1;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return nullptr;
+}
+
+#endif // ASSETS_FORMAT_H
@@ -44,6 +44,7 @@ void AudioService::Initialize(AudioCodec *codec) {
   /* Setup the audio codec */
   opus_decoder_ = std::make_unique<OpusDecoderWrapper>(
       codec->output_sample_rate(), 1, OPUS_FRAME_DURATION_MS);
+  speech_analyzer_.Configure(codec->output_sample_rate());
   opus_encoder_ =
       std::make_unique<OpusEncoderWrapper>(16000, 1, OPUS_FRAME_DURATION_MS);
   opus_encoder_->SetComplexity(
@@ -380,6 +381,13 @@ void AudioService::AudioOutputTask() {
                                AUDIO_POWER_CHECK_INTERVAL_MS * 1000);
       codec_->EnableOutput(true);
     }
+    // 在送入 codec 前发布，OutputData 阻塞期间读者看到的就是正在播放的这一帧；
+    // 分析帧跨越帧边界时从它实际开始的时刻算起
+    if (!task->features.empty()) {
+      speech_features_.Publish(
+          esp_timer_get_time() + task->features_offset_ms * 1000,
+          task->features.data(), task->features.size());
+    }
     codec_->OutputData(task->pcm);
 
     /* Update the last output time */
@@ -426,6 +434,12 @@ void AudioService::OpusCodecTask() {
 
       SetDecodeSampleRate(packet->sample_rate, packet->frame_duration);
       if (opus_decoder_->Decode(std::move(packet->payload), task->pcm)) {
+        // 在重采样前分析，采样率更低，计算量更小
+        if (speech_analysis_enabled_) {
+          task->features_offset_ms = speech_analyzer_.Process(
+              task->pcm.data(), task->pcm.size(), task->features);
+        }
+
         // Resample if the sample rate is different
         if (opus_decoder_->sample_rate() != codec_->output_sample_rate()) {
           static int resample_log_count = 0;
@@ -514,6 +528,7 @@ void AudioService::SetDecodeSampleRate(int sample_rate, int frame_duration) {
   opus_decoder_.reset();
   opus_decoder_ =
       std::make_unique<OpusDecoderWrapper>(sample_rate, 1, frame_duration);
+  speech_analyzer_.Configure(sample_rate);
 
   auto codec = Board::GetInstance().GetAudioCodec();
   if (opus_decoder_->sample_rate() != codec->output_sample_rate()) {
@@ -597,7 +612,7 @@ std::unique_ptr<AudioStreamPacket> AudioService::PopWakeWordPacket() {
   return nullptr;
 }
 
-void AudioService::EnableWakeWordDetection(bool enable) {
+bool AudioService::PrepareWakeWordDetection() {
   // 如果 wake_word_ 为空且 models_list_ 也为空，尝试从 model 分区加载模型
   if (!wake_word_ && !models_list_) {
     ESP_LOGI(TAG, "尝试从 model 分区加载唤醒词模型...");
@@ -629,28 +644,36 @@ void AudioService::EnableWakeWordDetection(bool enable) {
   }
 
   if (!wake_word_) {
+    return false;
+  }
+
+  if (!wake_word_initialized_) {
+    ESP_LOGI(TAG, "📦 正在初始化唤醒词检测（AFE WakeWord）...");
+    if (!wake_word_->Initialize(codec_, models_list_)) {
+      ESP_LOGE(TAG, "❌ 唤醒词初始化失败");
+      return false;
+    }
+    wake_word_initialized_ = true;
+    ESP_LOGI(TAG, "✅ 唤醒词检测初始化完成");
+
+    // 设置唤醒词检测回调
+    wake_word_->OnWakeWordDetected([this](const std::string &wake_word) {
+      // 唤醒词检测回调（Barge-in 功能已禁用）
+      if (callbacks_.on_wake_word_detected) {
+        callbacks_.on_wake_word_detected(wake_word);
+      }
+    });
+  }
+  return true;
+}
+
+void AudioService::EnableWakeWordDetection(bool enable) {
+  if (enable ? !PrepareWakeWordDetection() : !wake_word_) {
     return;
   }
 
   ESP_LOGI(TAG, "%s wake word detection", enable ? "👂 启用唤醒词检测" : "⏸️  禁用唤醒词检测");
   if (enable) {
-    if (!wake_word_initialized_) {
-      ESP_LOGI(TAG, "📦 正在初始化唤醒词检测（AFE WakeWord）...");
-      if (!wake_word_->Initialize(codec_, models_list_)) {
-        ESP_LOGE(TAG, "❌ 唤醒词初始化失败");
-        return;
-      }
-      wake_word_initialized_ = true;
-      ESP_LOGI(TAG, "✅ 唤醒词检测初始化完成");
-
-      // 设置唤醒词检测回调
-      wake_word_->OnWakeWordDetected([this](const std::string &wake_word) {
-        // 唤醒词检测回调（Barge-in 功能已禁用）
-        if (callbacks_.on_wake_word_detected) {
-          callbacks_.on_wake_word_detected(wake_word);
-        }
-      });
-    }
     wake_word_->Start();
     xEventGroupSetBits(event_group_, AS_EVENT_WAKE_WORD_RUNNING);
     ESP_LOGI(TAG, "✅ 唤醒词检测已启动");
@@ -1,6 +1,7 @@
 #ifndef AUDIO_SERVICE_H
 #define AUDIO_SERVICE_H
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <deque>
@@ -21,6 +22,7 @@
 #include "audio_processor.h"
 #include "processors/audio_debugger.h"
 #include "protocol.h"
+#include "speech_analyzer.h"
 #include "wake_word.h"
 
 /*
@@ -71,6 +73,10 @@ struct AudioTask {
   AudioTaskType type;
   std::vector<int16_t> pcm;
   uint32_t timestamp;
+  // 播放任务的语音特征，每 20ms 一个，见 SpeechAnalyzer::Pack
+  std::vector<uint32_t> features;
+  // 第一个特征相对本帧开头的开始时间（ms），上一帧遗留的样本使其为负
+  int features_offset_ms = 0;
 };
 
 struct DebugStatistics {
@@ -102,9 +108,16 @@ public:
   bool IsAfeWakeWord();
 
   void EnableWakeWordDetection(bool enable);
+  // 加载模型并初始化唤醒词检测器但不启动；启动阶段提前调用，进入待机时无需再等待
+  bool PrepareWakeWordDetection();
   void EnableVoiceProcessing(bool enable);
   void EnableAudioTesting(bool enable);
   void EnableDeviceAec(bool enable);
+  // 分析播放的语音，供动作和表情跟随说话节奏；默认关闭
+  void EnableSpeechAnalysis(bool enable) { speech_analysis_enabled_ = enable; }
+  const SpeechFeatureChannel &speech_features() const {
+    return speech_features_;
+  }
 
   void SetCallbacks(AudioServiceCallbacks &callbacks);
 
@@ -131,6 +144,9 @@ private:
   OpusResampler input_resampler_;
   OpusResampler reference_resampler_;
   OpusResampler output_resampler_;
+  SpeechAnalyzer speech_analyzer_;
+  SpeechFeatureChannel speech_features_;
+  std::atomic<bool> speech_analysis_enabled_{false};
   DebugStatistics debug_statistics_;
   srmodel_list_t *models_list_ = nullptr;
 
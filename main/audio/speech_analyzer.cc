@@ -0,0 +1,205 @@
+#include "speech_analyzer.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <esp_timer.h>
+
+// 低于此响度视为静音，不计算基频和重音
+#define SPEECH_GATE_DB -45.0f
+// 响度超过慢速平均值这么多 dB 视为重音
+#define SPEECH_ONSET_DB 4.0f
+// 两次重音之间至少间隔的分析帧数（100ms）
+#define SPEECH_ONSET_REFRACTORY_HOPS 5
+
+void SpeechAnalyzer::Configure(int sample_rate) {
+  sample_rate_ = sample_rate;
+  decimation_ = sample_rate >= 16000 ? sample_rate / 8000 : 1;
+  decimated_rate_ = sample_rate / decimation_;
+  hop_samples_ = sample_rate * SPEECH_HOP_MS / 1000;
+  Reset();
+}
+
+void SpeechAnalyzer::Reset() {
+  energy_ = 0;
+  count_ = 0;
+  decimate_sum_ = 0;
+  decimate_count_ = 0;
+  history_fill_ = 0;
+  slow_db_ = -60.0f;
+  hops_since_onset_ = SPEECH_ONSET_REFRACTORY_HOPS;
+}
+
+int SpeechAnalyzer::Process(const int16_t *pcm, size_t samples,
+                            std::vector<uint32_t> &hops) {
+  int offset_ms = -count_ * 1000 / sample_rate_;
+  for (size_t i = 0; i < samples; i++) {
+    int32_t sample = pcm[i];
+    energy_ += sample * sample;
+    decimate_sum_ += sample;
+    if (++decimate_count_ == decimation_) {
+      // 当前帧写在历史的后半部分，缩小到 12 位保证自相关用 32 位整数不会溢出
+      int index = count_ / decimation_;
+      if (index < kWindow) {
+        history_[kMaxLag + index] = (decimate_sum_ / decimation_) >> 4;
+      }
+      decimate_sum_ = 0;
+      decimate_count_ = 0;
+    }
+    if (++count_ == hop_samples_) {
+      hops.push_back(FinishHop());
+    }
+  }
+  return offset_ms;
+}
+
+uint32_t SpeechAnalyzer::FinishHop() {
+  SpeechFeatures features;
+  float db = energy_ > 0
+                 ? 10.0f * log10f(static_cast<float>(energy_) / count_ /
+                                  (32768.0f * 32768.0f))
+                 : -100.0f;
+  float level = (db + 50.0f) * 255.0f / 40.0f;
+  features.level = level < 0 ? 0 : (level > 255 ? 255 : uint8_t(level));
+  features.active = db > SPEECH_GATE_DB;
+
+  if (history_fill_ < 2) {
+    history_fill_++;
+  } else if (features.active) {
+    features.pitch_hz = EstimatePitch();
+  }
+
+  if (hops_since_onset_ < SPEECH_ONSET_REFRACTORY_HOPS) {
+    hops_since_onset_++;
+  }
+  if (features.active && db - slow_db_ > SPEECH_ONSET_DB &&
+      hops_since_onset_ >= SPEECH_ONSET_REFRACTORY_HOPS) {
+    onset_count_++;
+    hops_since_onset_ = 0;
+  }
+  slow_db_ += (db < -60.0f ? -60.0f - slow_db_ : db - slow_db_) * 0.15f;
+  features.onset_count = onset_count_;
+
+  // 当前帧移入历史，作为下一帧自相关的延迟部分
+  memcpy(history_, history_ + kWindow, kMaxLag * sizeof(history_[0]));
+  energy_ = 0;
+  count_ = 0;
+  return Pack(features);
+}
+
+float SpeechAnalyzer::Correlation(int lag, int32_t r0) const {
+  // 延迟 lag 的归一化自相关的平方，负相关返回 0
+  const int16_t *x = history_ + kMaxLag;
+  int32_t r = 0;
+  int32_t lagged_energy = 0;
+  for (int n = 0; n < kWindow; n++) {
+    r += x[n] * x[n - lag];
+    lagged_energy += x[n - lag] * x[n - lag];
+  }
+  if (r <= 0 || lagged_energy == 0) {
+    return 0;
+  }
+  return float(r) * float(r) / (float(r0) * float(lagged_energy));
+}
+
+uint16_t SpeechAnalyzer::EstimatePitch() const {
+  // 70..400Hz 范围内归一化自相关最大的延迟
+  const int16_t *x = history_ + kMaxLag;
+  int32_t r0 = 0;
+  for (int n = 0; n < kWindow; n++) {
+    r0 += x[n] * x[n];
+  }
+  if (r0 == 0) {
+    return 0;
+  }
+
+  int min_lag = decimated_rate_ / 400;
+  int max_lag = decimated_rate_ / 70;
+  if (max_lag > kMaxLag) {
+    max_lag = kMaxLag;
+  }
+
+  float best = 0;
+  int best_lag = 0;
+  for (int lag = min_lag; lag <= max_lag; lag++) {
+    float score = Correlation(lag, r0);
+    if (score > best) {
+      best = score;
+      best_lag = lag;
+    }
+  }
+  // 归一化相关系数 0.3 以下视为清音
+  if (best < 0.09f) {
+    return 0;
+  }
+
+  // 周期的整数倍相关性几乎一样高，相近时取最短的周期，避免报成低八度
+  for (int divisor = 3; divisor >= 2; divisor--) {
+    int center = (best_lag + divisor / 2) / divisor;
+    for (int lag = center - 1; lag <= center + 1; lag++) {
+      if (lag >= min_lag && Correlation(lag, r0) > best * 0.8f) {
+        return decimated_rate_ / lag;
+      }
+    }
+  }
+  return decimated_rate_ / best_lag;
+}
+
+uint32_t SpeechAnalyzer::Pack(const SpeechFeatures &features) {
+  uint32_t pitch = features.pitch_hz > 1023 ? 1023 : features.pitch_hz;
+  return features.level | (pitch << 8) | (uint32_t(features.onset_count) << 18) |
+         (uint32_t(features.active) << 26);
+}
+
+SpeechFeatures SpeechAnalyzer::Unpack(uint32_t word) {
+  SpeechFeatures features;
+  features.level = word & 0xFF;
+  features.pitch_hz = (word >> 8) & 0x3FF;
+  features.onset_count = (word >> 18) & 0xFF;
+  features.active = (word >> 26) & 1;
+  return features;
+}
+
+void SpeechFeatureChannel::Publish(int64_t start_us, const uint32_t *hops,
+                                   size_t count) {
+  if (count > SPEECH_MAX_HOPS_PER_FRAME) {
+    count = SPEECH_MAX_HOPS_PER_FRAME;
+  }
+  uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  start_ms_.store(uint32_t(start_us / 1000), std::memory_order_relaxed);
+  count_.store(count, std::memory_order_relaxed);
+  for (size_t i = 0; i < count; i++) {
+    hops_[i].store(hops[i], std::memory_order_relaxed);
+  }
+  sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void SpeechFeatureChannel::Clear() { Publish(0, nullptr, 0); }
+
+bool SpeechFeatureChannel::Read(SpeechFeatures &out) const {
+  uint32_t now_ms = uint32_t(esp_timer_get_time() / 1000);
+  for (int attempt = 0; attempt < 4; attempt++) {
+    uint32_t sequence = sequence_.load(std::memory_order_acquire);
+    if (sequence & 1) {
+      continue;
+    }
+    uint32_t start_ms = start_ms_.load(std::memory_order_relaxed);
+    uint32_t count = count_.load(std::memory_order_relaxed);
+    int32_t elapsed = int32_t(now_ms - start_ms);
+    uint32_t index = elapsed > 0 ? elapsed / SPEECH_HOP_MS : 0;
+    uint32_t word = 0;
+    if (count > 0 && index < count + 2) {
+      word = hops_[index < count ? index : count - 1].load(
+          std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == sequence) {
+      out = SpeechAnalyzer::Unpack(word);
+      return out.active;
+    }
+  }
+  out = SpeechFeatures();
+  return false;
+}
@@ -0,0 +1,97 @@
+#ifndef SPEECH_ANALYZER_H
+#define SPEECH_ANALYZER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 每个分析帧 20ms，即特征以 50Hz 更新
+#define SPEECH_HOP_MS 20
+#define SPEECH_MAX_HOPS_PER_FRAME 8
+
+/**
+ * 一个分析帧的语音特征
+ * level: 响度，-50..-10 dBFS 映射到 0..255
+ * pitch_hz: 粗略基频，清音或静音时为 0
+ * onset_count: 累计的重音（音节起始）计数，读取方比较前后两次的值判断新重音
+ * active: 响度高于噪声门限
+ */
+struct SpeechFeatures {
+  uint8_t level = 0;
+  uint16_t pitch_hz = 0;
+  uint8_t onset_count = 0;
+  bool active = false;
+};
+
+/**
+ * 播放路径上的轻量语音分析
+ *
+ * 在 OpusCodecTask 中对解码后的 PCM 按 20ms 分帧，计算 RMS 响度、重音和基频。
+ * 基频在降采样到约 8kHz 的信号上做自相关，只在有声音时计算，每秒约 50 次、
+ * 每次约 3 万次 32 位整数乘加。结果打包为 32 位字，随 AudioTask 进入播放队列。
+ */
+class SpeechAnalyzer {
+public:
+  void Configure(int sample_rate);
+  void Reset();
+
+  // 分析 PCM，每凑满 20ms 追加一个打包后的特征字到 hops。分析帧跨越 PCM 段的边界，
+  // 返回 hops 中第一个分析帧相对 pcm[0] 的开始时间（ms），上一段遗留样本使其为负
+  int Process(const int16_t *pcm, size_t samples, std::vector<uint32_t> &hops);
+
+  static uint32_t Pack(const SpeechFeatures &features);
+  static SpeechFeatures Unpack(uint32_t word);
+
+private:
+  static constexpr int kWindow = 160;   // 降采样后一帧的样本数（8kHz 下 20ms）
+  static constexpr int kMaxLag = 160;
+  static constexpr int kHistory = kWindow + kMaxLag;
+
+  int sample_rate_ = 16000;
+  int decimation_ = 2;
+  int decimated_rate_ = 8000;
+  int hop_samples_ = 320;
+
+  // 当前分析帧的累计值
+  int64_t energy_ = 0;
+  int count_ = 0;
+  int32_t decimate_sum_ = 0;
+  int decimate_count_ = 0;
+
+  // 降采样后的历史，最新的 kWindow 个样本是当前帧
+  int16_t history_[kHistory] = {};
+  int history_fill_ = 0;
+
+  float slow_db_ = -60.0f;
+  int hops_since_onset_ = 0;
+  uint8_t onset_count_ = 0;
+
+  uint32_t FinishHop();
+  float Correlation(int lag, int32_t r0) const;
+  uint16_t EstimatePitch() const;
+};
+
+/**
+ * 语音特征的无锁发布通道
+ *
+ * 单写者（音频输出任务）在每帧 PCM 送入 codec 前发布该帧的特征和第一个特征的开始时间，
+ * 多个读者（动作任务、眼睛渲染）用顺序锁读取当前正在播放的那一帧。
+ * 读者不会阻塞写者，延迟不超过 I2S DMA 缓冲的深度加一个分析帧。
+ */
+class SpeechFeatureChannel {
+public:
+  void Publish(int64_t start_us, const uint32_t *hops, size_t count);
+  void Clear();
+
+  // 读取当前时刻对应的特征；播放停止超过 2 个分析帧时返回 inactive
+  bool Read(SpeechFeatures &out) const;
+
+private:
+  std::atomic<uint32_t> sequence_{0};
+  std::atomic<uint32_t> start_ms_{0};
+  std::atomic<uint32_t> count_{0};
+  std::atomic<uint32_t> hops_[SPEECH_MAX_HOPS_PER_FRAME] = {};
+};
+
+#endif
@@ -10,6 +10,8 @@ public:
     virtual bool SetHMirror(bool enabled) = 0;
     virtual bool SetVFlip(bool enabled) = 0;
     virtual std::string Explain(const std::string& question) = 0;
+    // 低帧率持续预览，不支持的摄像头返回 false
+    virtual bool SetViewfinder(bool enabled, int fps) { return false; }
 };
 
 #endif // CAMERA_H
@@ -0,0 +1,200 @@
+#include "choreography.h"
+#include "assets.h"
+
+#include <esp_log.h>
+#include <mbedtls/base64.h>
+
+#include <cctype>
+#include <cstring>
+
+#define TAG "Choreography"
+
+// 每个舵机参数的字节数
+static size_t ParamSize(uint8_t type) {
+    switch (type) {
+    case kMotionMove:
+        return 2;
+    case kMotionOscillate:
+    case kMotionBezier:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static int16_t ReadInt16(const uint8_t* p) {
+    return (int16_t)(p[0] | (p[1] << 8));
+}
+
+static uint16_t ReadUint16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+ChoreographyPlayer::ChoreographyPlayer(ServoMotionEngine& engine, int servo_count, uint16_t servo_mask)
+    : engine_(engine), servo_count_(servo_count), servo_mask_(servo_mask) {
+}
+
+void ChoreographyPlayer::SetBias(int servo, int bias) {
+    if (servo >= 0 && servo < servo_count_) {
+        bias_[servo] = bias;
+    }
+}
+
+bool ChoreographyPlayer::Validate(const uint8_t* data, size_t size, int servo_count, std::string& error) {
+    if (size < sizeof(choreography_header) || memcmp(data, CHOREOGRAPHY_MAGIC, 4) != 0) {
+        error = "Invalid choreography header";
+        return false;
+    }
+    if (data[4] != CHOREOGRAPHY_VERSION) {
+        error = "Unsupported choreography version: " + std::to_string(data[4]);
+        return false;
+    }
+    if (data[5] != servo_count) {
+        error = "Choreography is for " + std::to_string(data[5]) + " servos, robot has " + std::to_string(servo_count);
+        return false;
+    }
+
+    int count = ReadUint16(data + 6);
+    size_t offset = sizeof(choreography_header);
+    for (int i = 0; i < count; i++) {
+        if (size - offset < sizeof(choreography_segment)) {
+            error = "Truncated segment " + std::to_string(i);
+            return false;
+        }
+        const uint8_t* p = data + offset;
+        uint8_t type = p[0];
+        uint16_t mask = ReadUint16(p + 2);
+        if (type > kMotionBezier || p[1] >= kMotionEaseCount || (mask >> servo_count) != 0) {
+            error = "Invalid segment " + std::to_string(i);
+            return false;
+        }
+        if (type == kMotionOscillate && ReadUint16(p + 6) == 0) {
+            error = "Oscillate segment " + std::to_string(i) + " has no period";
+            return false;
+        }
+        offset += sizeof(choreography_segment);
+        size_t params = ParamSize(type) * __builtin_popcount(mask);
+        if (size - offset < params) {
+            error = "Truncated segment " + std::to_string(i);
+            return false;
+        }
+        offset += params;
+    }
+    if (offset != size) {
+        error = "Trailing data after last segment";
+        return false;
+    }
+    return true;
+}
+
+bool ChoreographyPlayer::Play(const uint8_t* data, size_t size, int repeat,
+                              const std::function<bool()>& cancelled) {
+    std::string error;
+    if (!Validate(data, size, servo_count_, error)) {
+        ESP_LOGW(TAG, "%s", error.c_str());
+        return false;
+    }
+
+    int count = ReadUint16(data + 6);
+    for (int r = 0; r < repeat; r++) {
+        const uint8_t* p = data + sizeof(choreography_header);
+        for (int i = 0; i < count; i++) {
+            MotionSegment segment;
+            segment.type = (MotionSegmentType)p[0];
+            segment.ease = (MotionEase)p[1];
+            uint16_t mask = ReadUint16(p + 2);
+            segment.duration_ms = ReadUint16(p + 4);
+            segment.period_ms = ReadUint16(p + 6);
+            p += sizeof(choreography_segment);
+
+            for (int servo = 0; servo < servo_count_; servo++) {
+                if (!(mask & (1 << servo))) {
+                    continue;
+                }
+                if (segment.type == kMotionMove) {
+                    segment.target[servo] = ReadInt16(p) + bias_[servo];
+                } else if (segment.type == kMotionOscillate) {
+                    segment.amplitude[servo] = ReadInt16(p);
+                    segment.offset[servo] = ReadInt16(p + 2) + bias_[servo];
+                    segment.phase[servo] = ReadUint16(p + 4);
+                } else if (segment.type == kMotionBezier) {
+                    segment.control1[servo] = ReadInt16(p) + bias_[servo];
+                    segment.control2[servo] = ReadInt16(p + 2) + bias_[servo];
+                    segment.target[servo] = ReadInt16(p + 4) + bias_[servo];
+                }
+                p += ParamSize(segment.type);
+            }
+            // 未连接的舵机不参与，段仍然占用原来的时长
+            segment.mask = mask & servo_mask_;
+            if (cancelled && cancelled()) {
+                return false;
+            }
+            if (!engine_.Submit(segment)) {
+                // 被 Cancel 打断
+                return false;
+            }
+        }
+    }
+    engine_.WaitIdle();
+    return true;
+}
+
+bool ChoreographyLibrary::Upload(const std::string& name, const std::string& base64, std::string& error) {
+    if (name.empty() || name.size() > 27) {
+        error = "Name must be 1-27 characters";
+        return false;
+    }
+    for (char c : name) {
+        if (!isalnum((unsigned char)c) && c != '_' && c != '-') {
+            error = "Name may only contain letters, digits, '_' and '-'";
+            return false;
+        }
+    }
+
+    size_t size = 0;
+    auto input = reinterpret_cast<const unsigned char*>(base64.data());
+    if (mbedtls_base64_decode(nullptr, 0, &size, input, base64.size()) == MBEDTLS_ERR_BASE64_INVALID_CHARACTER) {
+        error = "Invalid base64 data";
+        return false;
+    }
+    if (size == 0 || size > kMaxSequenceSize) {
+        error = "Sequence must be 1-" + std::to_string(kMaxSequenceSize) + " bytes";
+        return false;
+    }
+    auto sequence = std::make_shared<std::vector<uint8_t>>(size);
+    if (mbedtls_base64_decode(sequence->data(), size, &size, input, base64.size()) != 0) {
+        error = "Invalid base64 data";
+        return false;
+    }
+    sequence->resize(size);
+    if (!ChoreographyPlayer::Validate(sequence->data(), sequence->size(), servo_count_, error)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (uploads_.size() >= kMaxUploads && uploads_.find(name) == uploads_.end()) {
+        error = "Too many uploaded sequences";
+        return false;
+    }
+    uploads_[name] = std::move(sequence);
+    ESP_LOGI(TAG, "Uploaded choreography %s, %u bytes", name.c_str(), (unsigned)size);
+    return true;
+}
+
+std::shared_ptr<const uint8_t> ChoreographyLibrary::Find(const std::string& name, size_t& size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = uploads_.find(name);
+        if (it != uploads_.end()) {
+            size = it->second->size();
+            return std::shared_ptr<const uint8_t>(it->second, it->second->data());
+        }
+    }
+
+    // 资源分区常驻映射，不需要释放
+    void* ptr = nullptr;
+    if (!Assets::GetInstance().GetAssetData(name + ".chor", ptr, size)) {
+        return nullptr;
+    }
+    return std::shared_ptr<const uint8_t>(static_cast<const uint8_t*>(ptr), [](const uint8_t*) {});
+}
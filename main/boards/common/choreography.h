@@ -0,0 +1,109 @@
+#ifndef _CHOREOGRAPHY_H_
+#define _CHOREOGRAPHY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "servo_motion_engine.h"
+
+/*
+ * 动作编排格式（小端）：8 字节头 + 若干轨迹段
+ *   magic "XZCH", u8 version, u8 servo_count, u16 segment_count
+ * 每段 8 字节段头 {u8 type, u8 ease, u16 mask, u16 duration_ms, u16 period_ms}，
+ * 后跟 mask 中每个舵机的参数（按舵机编号升序）：
+ *   MOVE：i16 target
+ *   OSCILLATE：i16 amplitude, i16 offset, u16 phase（65536 为一周）
+ *   HOLD：无
+ *   BEZIER：i16 control1, i16 control2, i16 target
+ * type/ease 的取值与 MotionSegmentType/MotionEase 一致。多点路径就是连续的 MOVE 或 BEZIER 段。
+ * 由 scripts/choreography.py 从 JSON 编译生成，放进资源分区时文件名为 <name>.chor。
+ */
+#define CHOREOGRAPHY_MAGIC      "XZCH"
+#define CHOREOGRAPHY_VERSION    1
+
+struct choreography_header {
+    char magic[4];
+    uint8_t version;
+    uint8_t servo_count;
+    uint16_t segment_count;
+};
+
+struct choreography_segment {
+    uint8_t type;
+    uint8_t ease;
+    uint16_t mask;
+    uint16_t duration_ms;
+    uint16_t period_ms;
+};
+
+/**
+ * @brief 动作编排解释器
+ *
+ * 逐段解码并提交给运动引擎，引擎队列满时等待，所以整段序列以固定内存流式播放，
+ * 段与段之间由引擎无缝衔接，时序不受调用方任务调度影响。
+ */
+class ChoreographyPlayer {
+public:
+    /**
+     * @param servo_mask 机器人实际连接的舵机，序列中其他舵机的参数被忽略
+     */
+    ChoreographyPlayer(ServoMotionEngine& engine, int servo_count, uint16_t servo_mask);
+
+    /**
+     * @brief 设置舵机的位置偏移，加到 MOVE/BEZIER 的目标和控制点以及 OSCILLATE 中心上
+     */
+    void SetBias(int servo, int bias);
+
+    /**
+     * @brief 检查序列格式和长度，舵机数必须与机器人一致
+     */
+    static bool Validate(const uint8_t* data, size_t size, int servo_count, std::string& error);
+
+    /**
+     * @brief 播放序列 repeat 遍并等待完成；被引擎 Cancel 打断时立即返回 false
+     * @param cancelled 每提交一段前检查，返回 true 时停止提交并返回 false，
+     *                  已在引擎队列中的段由调用方 Cancel
+     */
+    bool Play(const uint8_t* data, size_t size, int repeat = 1,
+              const std::function<bool()>& cancelled = nullptr);
+
+private:
+    ServoMotionEngine& engine_;
+    int servo_count_;
+    uint16_t servo_mask_;
+    int16_t bias_[MOTION_MAX_SERVOS] = {};
+};
+
+/**
+ * @brief 动作编排库：通过 MCP 上传到内存的序列和资源分区中的 <name>.chor
+ */
+class ChoreographyLibrary {
+public:
+    static constexpr size_t kMaxSequenceSize = 4096;
+    static constexpr size_t kMaxUploads = 8;
+
+    explicit ChoreographyLibrary(int servo_count) : servo_count_(servo_count) {}
+
+    /**
+     * @brief 保存 base64 编码的序列，同名覆盖
+     */
+    bool Upload(const std::string& name, const std::string& base64, std::string& error);
+
+    /**
+     * @brief 查找序列，上传的优先；返回的指针在持有期间有效，即使序列被覆盖
+     */
+    std::shared_ptr<const uint8_t> Find(const std::string& name, size_t& size);
+
+private:
+    int servo_count_;
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> uploads_;
+};
+
+#endif // _CHOREOGRAPHY_H_
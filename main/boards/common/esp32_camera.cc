@@ -9,6 +9,7 @@
 #include <esp_log.h>
 #include <esp_heap_caps.h>
 #include <cstring>
+#include <algorithm>
 
 #define TAG "Esp32Camera"
 
@@ -24,9 +25,44 @@ Esp32Camera::Esp32Camera(const camera_config_t& config) {
     if (s->id.PID == GC0308_PID) {
         s->set_hmirror(s, 0);  // 这里控制摄像头镜像 写1镜像 写0不镜像
     }
+
+    if (!StartEncoder()) {
+        ESP_LOGE(TAG, "Failed to start JPEG encoder");
+    }
 }
 
 Esp32Camera::~Esp32Camera() {
+    viewfinder_running_ = false;
+    while (viewfinder_task_ != nullptr) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    if (encoder_task_ != nullptr) {
+        WaitForEncoderIdle();
+        vTaskDelete(encoder_task_);
+        encoder_task_ = nullptr;
+    }
+    if (free_chunks_ != nullptr) {
+        vQueueDelete(free_chunks_);
+    }
+    if (filled_chunks_ != nullptr) {
+        vQueueDelete(filled_chunks_);
+    }
+    if (encoder_event_group_ != nullptr) {
+        vEventGroupDelete(encoder_event_group_);
+    }
+    if (chunk_pool_ != nullptr) {
+        heap_caps_free(chunk_pool_);
+    }
+    if (preview_buffer_size_ != 0) {
+        // 先撤下预览，显示端不能再引用即将释放的缓冲区
+        auto display = dynamic_cast<LvglDisplay*>(Board::GetInstance().GetDisplay());
+        if (display != nullptr) {
+            display->SetPreviewImage(nullptr);
+        }
+    }
+    for (auto buffer : preview_buffers_) {
+        heap_caps_free(buffer);
+    }
     if (fb_) {
         esp_camera_fb_return(fb_);
         fb_ = nullptr;
@@ -34,20 +70,146 @@ Esp32Camera::~Esp32Camera() {
     esp_camera_deinit();
 }
 
+/**
+ * @brief 创建常驻的 JPEG 编码任务和分块缓冲池
+ *
+ * 缓冲池在构造时一次性分配，编码任务把 JPEG 输出写满一个缓冲块后
+ * 通过 filled_chunks_ 交给发送方，发送方写完后再通过 free_chunks_ 归还，
+ * 整个过程中数据块不再重复分配和拷贝，缓冲池用尽时编码任务自然阻塞形成背压。
+ */
+bool Esp32Camera::StartEncoder() {
+    chunk_pool_ = (uint8_t*)heap_caps_aligned_alloc(16, JPEG_CHUNK_POOL_SIZE * JPEG_CHUNK_BUFFER_SIZE, MALLOC_CAP_SPIRAM);
+    if (chunk_pool_ == nullptr) {
+        return false;
+    }
+    free_chunks_ = xQueueCreate(JPEG_CHUNK_POOL_SIZE, sizeof(JpegChunk));
+    // 额外一个位置用于结束标记
+    filled_chunks_ = xQueueCreate(JPEG_CHUNK_POOL_SIZE + 1, sizeof(JpegChunk));
+    encoder_event_group_ = xEventGroupCreate();
+    if (free_chunks_ == nullptr || filled_chunks_ == nullptr || encoder_event_group_ == nullptr) {
+        return false;
+    }
+    for (int i = 0; i < JPEG_CHUNK_POOL_SIZE; i++) {
+        JpegChunk chunk = {
+            .data = chunk_pool_ + i * JPEG_CHUNK_BUFFER_SIZE,
+            .len = 0
+        };
+        xQueueSend(free_chunks_, &chunk, 0);
+    }
+    xEventGroupSetBits(encoder_event_group_, ENCODER_EVENT_IDLE);
+
+    // JPEG 编码约需 500ms 和 8KB 堆内存，编码器本身在堆上创建，任务栈只需容纳调用链
+    BaseType_t ret = xTaskCreate([](void* arg) {
+        auto camera = (Esp32Camera*)arg;
+        camera->EncoderTask();
+    }, "jpeg_encoder", 4096, this, 2, &encoder_task_);
+    return ret == pdPASS;
+}
+
+void Esp32Camera::EncoderTask() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        auto start_time = esp_timer_get_time();
+        encoding_chunk_ = {};
+        bool ok = image_to_jpeg_cb(fb_->buf, fb_->len, fb_->width, fb_->height, fb_->format, 80,
+            [](void* arg, size_t index, const void* data, size_t len) -> size_t {
+            auto camera = (Esp32Camera*)arg;
+            return camera->OnJpegData(data, len);
+        }, this);
+        if (!ok) {
+            ESP_LOGE(TAG, "JPEG encode failed");
+        }
+        // 拍下的帧已经编码完，取景模式可以继续替换 fb_
+        frame_pinned_ = false;
+        // 发送编码失败时残留的部分数据，然后发送结束标记；
+        // 耗时在结束标记之前写入，发送方收到结束标记时读到的就是本次的值
+        OnJpegData(nullptr, 0);
+        encode_us_ = esp_timer_get_time() - start_time;
+        JpegChunk end = {};
+        xQueueSend(filled_chunks_, &end, portMAX_DELAY);
+
+        xEventGroupSetBits(encoder_event_group_, ENCODER_EVENT_IDLE);
+    }
+}
+
+size_t Esp32Camera::OnJpegData(const void* data, size_t len) {
+    if (data == nullptr) {
+        // 图像结束，交出未写满的缓冲块
+        if (encoding_chunk_.data != nullptr && encoding_chunk_.len > 0) {
+            xQueueSend(filled_chunks_, &encoding_chunk_, portMAX_DELAY);
+        } else if (encoding_chunk_.data != nullptr) {
+            xQueueSend(free_chunks_, &encoding_chunk_, portMAX_DELAY);
+        }
+        encoding_chunk_ = {};
+        return 0;
+    }
+
+    auto src = (const uint8_t*)data;
+    size_t remaining = len;
+    while (remaining > 0) {
+        if (encoding_chunk_.data == nullptr) {
+            xQueueReceive(free_chunks_, &encoding_chunk_, portMAX_DELAY);
+            encoding_chunk_.len = 0;
+        }
+        size_t n = std::min(remaining, JPEG_CHUNK_BUFFER_SIZE - encoding_chunk_.len);
+        memcpy(encoding_chunk_.data + encoding_chunk_.len, src, n);
+        encoding_chunk_.len += n;
+        src += n;
+        remaining -= n;
+        if (encoding_chunk_.len == JPEG_CHUNK_BUFFER_SIZE) {
+            xQueueSend(filled_chunks_, &encoding_chunk_, portMAX_DELAY);
+            encoding_chunk_ = {};
+        }
+    }
+    return len;
+}
+
+void Esp32Camera::WaitForEncoderIdle() {
+    if (encoder_event_group_ != nullptr) {
+        xEventGroupWaitBits(encoder_event_group_, ENCODER_EVENT_IDLE, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+}
+
+// 丢弃本次编码剩余的所有数据块并归还到缓冲池，直到收到结束标记
+void Esp32Camera::DrainChunks() {
+    JpegChunk chunk;
+    while (xQueueReceive(filled_chunks_, &chunk, portMAX_DELAY) == pdPASS) {
+        if (chunk.data == nullptr) {
+            break;
+        }
+        xQueueSend(free_chunks_, &chunk, portMAX_DELAY);
+    }
+}
+
 void Esp32Camera::SetExplainUrl(const std::string& url, const std::string& token) {
     explain_url_ = url;
     explain_token_ = token;
 }
 
 bool Esp32Camera::Capture() {
-    if (encoder_thread_.joinable()) {
-        encoder_thread_.join();
-    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 编码任务仍在读取 fb_ 时不能归还帧缓冲
+    WaitForEncoderIdle();
 
     auto start_time = esp_timer_get_time();
     int frames_to_get = 2;
     // Try to get a stable frame
-    for (int i = 0; i < frames_to_get; i++) {
+    if (!GrabFrames(frames_to_get)) {
+        return false;
+    }
+    auto end_time = esp_timer_get_time();
+    capture_us_ = end_time - start_time;
+    ESP_LOGI(TAG, "Camera captured %d frames in %d ms", frames_to_get, int(capture_us_ / 1000));
+    // 在 Explain 编码之前，取景模式不能用新的一帧替换拍下的这一帧
+    frame_pinned_ = true;
+
+    // 显示预览图片
+    return UpdatePreview();
+}
+
+bool Esp32Camera::GrabFrames(int count) {
+    for (int i = 0; i < count; i++) {
         if (fb_ != nullptr) {
             esp_camera_fb_return(fb_);
         }
@@ -57,32 +219,112 @@ bool Esp32Camera::Capture() {
             return false;
         }
     }
-    auto end_time = esp_timer_get_time();
-    ESP_LOGI(TAG, "Camera captured %d frames in %d ms", frames_to_get, int((end_time - start_time) / 1000));
+    return true;
+}
 
-    // 显示预览图片
+// 摄像头输出大端 RGB565，每次处理一个 32 位字（两个像素）完成字节交换。
+// 交换和拷贝合并为一遍：驱动的帧缓冲在下一次取帧时就会归还，编码器也需要原始字节序，
+// 预览不能直接引用它，每帧仍有一次整帧拷贝
+static void SwapRgb565(const uint8_t* src, uint8_t* dst, size_t len) {
+    auto src32 = (const uint32_t*)src;
+    auto dst32 = (uint32_t*)dst;
+    size_t words = len / 4;
+    for (size_t i = 0; i < words; i++) {
+        uint32_t v = src32[i];
+        dst32[i] = ((v & 0x00FF00FF) << 8) | ((v >> 8) & 0x00FF00FF);
+    }
+    if (len & 2) {
+        auto src16 = (const uint16_t*)(src + words * 4);
+        auto dst16 = (uint16_t*)(dst + words * 4);
+        *dst16 = __builtin_bswap16(*src16);
+    }
+}
+
+/**
+ * @brief 把当前帧显示为预览图
+ *
+ * 预览图使用两个常驻的 PSRAM 缓冲区轮流写入：正在显示的缓冲区在被下一帧替换之前
+ * 不会被改写，因此不需要每次拍照都重新分配整帧内存，LVGL 也不会读到写了一半的数据。
+ */
+bool Esp32Camera::UpdatePreview() {
     auto display = dynamic_cast<LvglDisplay*>(Board::GetInstance().GetDisplay());
-    if (display != nullptr) {
-        auto data = (uint8_t*)heap_caps_malloc(fb_->len, MALLOC_CAP_SPIRAM);
-        if (data == nullptr) {
+    if (display == nullptr || fb_->format != PIXFORMAT_RGB565) {
+        return true;
+    }
+
+    if (preview_buffer_size_ != fb_->len) {
+        // 分辨率变化时先撤下旧预览，再重新分配双缓冲
+        display->SetPreviewImage(nullptr);
+        for (auto& buffer : preview_buffers_) {
+            heap_caps_free(buffer);
+            buffer = (uint8_t*)heap_caps_aligned_alloc(4, fb_->len, MALLOC_CAP_SPIRAM);
+        }
+        if (preview_buffers_[0] == nullptr || preview_buffers_[1] == nullptr) {
             ESP_LOGE(TAG, "Failed to allocate memory for preview image");
+            preview_buffer_size_ = 0;
             return false;
         }
+        preview_buffer_size_ = fb_->len;
+    }
 
-        auto src = (uint16_t*)fb_->buf;
-        auto dst = (uint16_t*)data;
-        size_t pixel_count = fb_->len / 2;
-        for (size_t i = 0; i < pixel_count; i++) {
-            // 交换每个16位字内的字节
-            dst[i] = __builtin_bswap16(src[i]);
-        }
+    preview_index_ ^= 1;
+    auto data = preview_buffers_[preview_index_];
+    SwapRgb565(fb_->buf, data, fb_->len);
+
+    auto& dsc = preview_dscs_[preview_index_];
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.header.magic = LV_IMAGE_HEADER_MAGIC;
+    dsc.header.cf = LV_COLOR_FORMAT_RGB565;
+    dsc.header.w = fb_->width;
+    dsc.header.h = fb_->height;
+    dsc.header.stride = fb_->width * 2;
+    dsc.data_size = fb_->len;
+    dsc.data = data;
+    display->SetPreviewImage(std::make_unique<LvglSourceImage>(&dsc));
+    return true;
+}
 
-        auto image = std::make_unique<LvglAllocatedImage>(data, fb_->len, fb_->width, fb_->height, fb_->width * 2, LV_COLOR_FORMAT_RGB565);
-        display->SetPreviewImage(std::move(image));
+bool Esp32Camera::SetViewfinder(bool enabled, int fps) {
+    if (!enabled) {
+        viewfinder_running_ = false;
+        return true;
+    }
+
+    viewfinder_interval_ms_ = 1000 / std::clamp(fps, 1, MAX_VIEWFINDER_FPS);
+    viewfinder_running_ = true;
+    if (viewfinder_task_ != nullptr) {
+        return true;
+    }
+    BaseType_t ret = xTaskCreate([](void* arg) {
+        auto camera = (Esp32Camera*)arg;
+        camera->ViewfinderTask();
+        camera->viewfinder_task_ = nullptr;
+        vTaskDelete(NULL);
+    }, "viewfinder", 4096, this, 1, &viewfinder_task_);
+    if (ret != pdPASS) {
+        viewfinder_running_ = false;
+        return false;
     }
     return true;
 }
 
+// 取景模式：低帧率持续刷新预览，每次只取一帧；
+// 编码任务工作时、或拍下的帧还没有被 Explain 编码时跳过
+void Esp32Camera::ViewfinderTask() {
+    ESP_LOGI(TAG, "Viewfinder started, interval=%d ms", viewfinder_interval_ms_.load());
+    while (viewfinder_running_) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool encoder_idle = xEventGroupGetBits(encoder_event_group_) & ENCODER_EVENT_IDLE;
+            if (encoder_idle && !frame_pinned_ && GrabFrames(1)) {
+                UpdatePreview();
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(viewfinder_interval_ms_));
+    }
+    ESP_LOGI(TAG, "Viewfinder stopped");
+}
+
 bool Esp32Camera::SetHMirror(bool enabled) {
     sensor_t *s = esp_camera_sensor_get();
     if (s == nullptr) {
@@ -125,9 +367,10 @@ bool Esp32Camera::SetVFlip(bool enabled) {
  * 问题对图像进行AI分析并返回结果。
  * 
  * 实现特点：
- * - 使用独立线程编码JPEG，与主线程分离
+ * - 使用常驻编码任务编码JPEG，与调用线程并行
  * - 采用分块传输编码(chunked transfer encoding)优化内存使用
- * - 通过队列机制实现编码线程和发送线程的数据同步
+ * - 编码输出写入预分配的缓冲池，按 8KB 大块交给发送方，无逐块分配和拷贝
+ * - 统计采集、编码、首字节发送和服务器响应各阶段耗时
  * - 支持设备ID、客户端ID和认证令牌的HTTP头部配置
  * 
  * @param question 要向AI提出的关于图像的问题，将作为表单字段发送
@@ -137,40 +380,33 @@ bool Esp32Camera::SetVFlip(bool enabled) {
  *                  {"success": false, "message": "错误信息"}
  * 
  * @note 调用此函数前必须先调用SetExplainUrl()设置服务器URL
- * @note 函数会等待之前的编码线程完成后再开始新的处理
+ * @note 函数会等待之前的编码任务完成后再开始新的处理
  * @warning 如果摄像头缓冲区为空或网络连接失败，将返回错误信息
  */
 std::string Esp32Camera::Explain(const std::string& question) {
     if (explain_url_.empty()) {
         throw std::runtime_error("Image explain URL or token is not set");
     }
-
-    // 创建局部的 JPEG 队列, 40 entries is about to store 512 * 40 = 20480 bytes of JPEG data
-    QueueHandle_t jpeg_queue = xQueueCreate(40, sizeof(JpegChunk));
-    if (jpeg_queue == nullptr) {
-        ESP_LOGE(TAG, "Failed to create JPEG queue");
-        throw std::runtime_error("Failed to create JPEG queue");
+    if (encoder_task_ == nullptr) {
+        throw std::runtime_error("JPEG encoder is not available");
+    }
+    if (fb_ == nullptr) {
+        throw std::runtime_error("No captured frame");
     }
 
-    // We spawn a thread to encode the image to JPEG using optimized encoder (cost about 500ms and 8KB SRAM)
-    encoder_thread_ = std::thread([this, jpeg_queue]() {
-        image_to_jpeg_cb(fb_->buf, fb_->len, fb_->width, fb_->height, fb_->format, 80,
-            [](void* arg, size_t index, const void* data, size_t len) -> size_t {
-            auto jpeg_queue = (QueueHandle_t)arg;
-            JpegChunk chunk = {
-                .data = (uint8_t*)heap_caps_aligned_alloc(16, len, MALLOC_CAP_SPIRAM),
-                .len = len
-            };
-            memcpy(chunk.data, data, len);
-            xQueueSend(jpeg_queue, &chunk, portMAX_DELAY);
-            return len;
-        }, jpeg_queue);
-    });
+    // 通知常驻编码任务开始编码当前帧，与下面的 HTTP 连接建立并行进行
+    auto start_time = esp_timer_get_time();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        WaitForEncoderIdle();
+        xEventGroupClearBits(encoder_event_group_, ENCODER_EVENT_IDLE);
+        xTaskNotifyGive(encoder_task_);
+    }
 
     auto network = Board::GetInstance().GetNetwork();
     auto http = network->CreateHttp(3);
     // 构造multipart/form-data请求体
-    std::string boundary = "----ESP32_CAMERA_BOUNDARY";
+    static constexpr const char* kBoundary = "----ESP32_CAMERA_BOUNDARY";
 
     // 配置HTTP客户端，使用分块传输编码
     http->SetHeader("Device-Id", SystemInfo::GetMacAddress().c_str());
@@ -178,71 +414,71 @@ std::string Esp32Camera::Explain(const std::string& question) {
     if (!explain_token_.empty()) {
         http->SetHeader("Authorization", "Bearer " + explain_token_);
     }
-    http->SetHeader("Content-Type", "multipart/form-data; boundary=" + boundary);
+    http->SetHeader("Content-Type", std::string("multipart/form-data; boundary=") + kBoundary);
     http->SetHeader("Transfer-Encoding", "chunked");
     if (!http->Open("POST", explain_url_)) {
         ESP_LOGE(TAG, "Failed to connect to explain URL");
-        // Clear the queue
-        encoder_thread_.join();
-        JpegChunk chunk;
-        while (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) == pdPASS) {
-            if (chunk.data != nullptr) {
-                heap_caps_free(chunk.data);
-            } else {
-                break;
-            }
-        }
-        vQueueDelete(jpeg_queue);
+        // 归还编码任务输出的所有数据块
+        DrainChunks();
         throw std::runtime_error("Failed to connect to explain URL");
     }
-    
-    {
-        // 第一块：question字段
-        std::string question_field;
-        question_field += "--" + boundary + "\r\n";
-        question_field += "Content-Disposition: form-data; name=\"question\"\r\n";
-        question_field += "\r\n";
-        question_field += question + "\r\n";
-        http->Write(question_field.c_str(), question_field.size());
-    }
+
     {
-        // 第二块：文件字段头部
-        std::string file_header;
-        file_header += "--" + boundary + "\r\n";
-        file_header += "Content-Disposition: form-data; name=\"file\"; filename=\"camera.jpg\"\r\n";
-        file_header += "Content-Type: image/jpeg\r\n";
-        file_header += "\r\n";
-        http->Write(file_header.c_str(), file_header.size());
+        // 第一、二块：question字段和文件字段头部合并为一次写入
+        char header[256];
+        int prefix_len = snprintf(header, sizeof(header),
+            "--%s\r\n"
+            "Content-Disposition: form-data; name=\"question\"\r\n"
+            "\r\n", kBoundary);
+        int suffix_len = snprintf(header + prefix_len, sizeof(header) - prefix_len,
+            "\r\n--%s\r\n"
+            "Content-Disposition: form-data; name=\"file\"; filename=\"camera.jpg\"\r\n"
+            "Content-Type: image/jpeg\r\n"
+            "\r\n", kBoundary);
+        std::string form_header;
+        form_header.reserve(prefix_len + question.size() + suffix_len);
+        form_header.append(header, prefix_len);
+        form_header.append(question);
+        form_header.append(header + prefix_len, suffix_len);
+        http->Write(form_header.data(), form_header.size());
     }
 
-    // 第三块：JPEG数据
+    // 第三块：JPEG数据，每次写入一个完整的缓冲块
     size_t total_sent = 0;
+    int64_t first_byte_us = 0;
     while (true) {
         JpegChunk chunk;
-        if (xQueueReceive(jpeg_queue, &chunk, portMAX_DELAY) != pdPASS) {
+        if (xQueueReceive(filled_chunks_, &chunk, portMAX_DELAY) != pdPASS) {
             ESP_LOGE(TAG, "Failed to receive JPEG chunk");
             break;
         }
         if (chunk.data == nullptr) {
             break; // The last chunk
         }
+        if (McpServer::IsToolCallCancelled()) {
+            // 调用已被取消（例如用户打断说话），不再上传，归还剩余的数据块
+            xQueueSend(free_chunks_, &chunk, portMAX_DELAY);
+            DrainChunks();
+            http->Close();
+            throw std::runtime_error("Tool call cancelled");
+        }
+        if (first_byte_us == 0) {
+            first_byte_us = esp_timer_get_time() - start_time;
+        }
         http->Write((const char*)chunk.data, chunk.len);
         total_sent += chunk.len;
-        heap_caps_free(chunk.data);
+        xQueueSend(free_chunks_, &chunk, portMAX_DELAY);
     }
-    // Wait for the encoder thread to finish
-    encoder_thread_.join();
-    // 清理队列
-    vQueueDelete(jpeg_queue);
 
     {
         // 第四块：multipart尾部
-        std::string multipart_footer;
-        multipart_footer += "\r\n--" + boundary + "--\r\n";
-        http->Write(multipart_footer.c_str(), multipart_footer.size());
+        char footer[64];
+        int footer_len = snprintf(footer, sizeof(footer), "\r\n--%s--\r\n", kBoundary);
+        http->Write(footer, footer_len);
     }
     // 结束块
     http->Write("", 0);
+    auto upload_end_time = esp_timer_get_time();
 
     if (http->GetStatusCode() != 200) {
         ESP_LOGE(TAG, "Failed to upload photo, status code: %d", http->GetStatusCode());
@@ -251,10 +487,14 @@ std::string Esp32Camera::Explain(const std::string& question) {
 
     std::string result = http->ReadAll();
     http->Close();
+    auto response_us = esp_timer_get_time() - upload_end_time;
 
     // Get remain task stack size
     size_t remain_stack_size = uxTaskGetStackHighWaterMark(nullptr);
     ESP_LOGI(TAG, "Explain image size=%dx%d, compressed size=%d, remain stack size=%d, question=%s\n%s",
         fb_->width, fb_->height, total_sent, remain_stack_size, question.c_str(), result.c_str());
+    ESP_LOGI(TAG, "Explain timing: capture=%dms encode=%dms first_byte=%dms upload=%dms response=%dms",
+        int(capture_us_ / 1000), int(encode_us_.load() / 1000), int(first_byte_us / 1000),
+        int((upload_end_time - start_time) / 1000), int(response_us / 1000));
     return result;
 }
@@ -3,14 +3,24 @@
 
 #include <esp_camera.h>
 #include <lvgl.h>
-#include <thread>
 #include <memory>
+#include <mutex>
+#include <atomic>
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/event_groups.h>
 
 #include "camera.h"
 
+// JPEG 输出在编码任务和 HTTP 发送之间通过固定的缓冲池流转，不再逐块分配/拷贝
+#define JPEG_CHUNK_POOL_SIZE 4
+#define JPEG_CHUNK_BUFFER_SIZE (8 * 1024)
+
+#define ENCODER_EVENT_IDLE (1 << 0)
+
+#define MAX_VIEWFINDER_FPS 10
+
 struct JpegChunk {
     uint8_t* data;
     size_t len;
@@ -19,9 +29,43 @@ struct JpegChunk {
 class Esp32Camera : public Camera {
 private:
     camera_fb_t* fb_ = nullptr;
+    std::mutex mutex_;
     std::string explain_url_;
     std::string explain_token_;
-    std::thread encoder_thread_;
+
+    // 常驻 JPEG 编码任务与分块缓冲池
+    TaskHandle_t encoder_task_ = nullptr;
+    EventGroupHandle_t encoder_event_group_ = nullptr;
+    QueueHandle_t free_chunks_ = nullptr;
+    QueueHandle_t filled_chunks_ = nullptr;
+    uint8_t* chunk_pool_ = nullptr;
+    JpegChunk encoding_chunk_ = {};
+
+    // 预览双缓冲，轮流写入，正在显示的缓冲区不会被改写
+    uint8_t* preview_buffers_[2] = {nullptr, nullptr};
+    lv_img_dsc_t preview_dscs_[2] = {};
+    size_t preview_buffer_size_ = 0;
+    int preview_index_ = 0;
+
+    // 低帧率取景模式
+    TaskHandle_t viewfinder_task_ = nullptr;
+    std::atomic<bool> viewfinder_running_ = false;
+    std::atomic<int> viewfinder_interval_ms_ = 200;
+    // Capture 拍下的帧在 Explain 编码完之前保持不变
+    std::atomic<bool> frame_pinned_ = false;
+
+    // 各阶段耗时统计 (us)
+    int64_t capture_us_ = 0;
+    std::atomic<int64_t> encode_us_ = 0;
+
+    bool GrabFrames(int count);
+    bool UpdatePreview();
+    void ViewfinderTask();
+    bool StartEncoder();
+    void EncoderTask();
+    size_t OnJpegData(const void* data, size_t len);
+    void WaitForEncoderIdle();
+    void DrainChunks();
 
 public:
     Esp32Camera(const camera_config_t& config);
@@ -33,6 +77,7 @@ public:
     virtual bool SetHMirror(bool enabled) override;
     virtual bool SetVFlip(bool enabled) override;
     virtual std::string Explain(const std::string& question);
+    virtual bool SetViewfinder(bool enabled, int fps) override;
 };
 
-#endif // ESP32_CAMERA_H
\ No newline at end of file
+#endif // ESP32_CAMERA_H
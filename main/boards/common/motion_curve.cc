@@ -0,0 +1,122 @@
+#include "motion_curve.h"
+
+#include <cmath>
+
+// Q15 正弦表，一周 256 个点，多一个点便于插值
+static const int16_t kSinTable[257] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790, 27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767, 32757, 32728, 32678, 32609, 32521, 32412, 32285, 32137, 31971, 31785, 31580, 31356, 31113, 30852, 30571,
+    30273, 29956, 29621, 29268, 28898, 28510, 28105, 27683, 27245, 26790, 26319, 25832, 25329, 24811, 24279, 23731,
+    23170, 22594, 22005, 21403, 20787, 20159, 19519, 18868, 18204, 17530, 16846, 16151, 15446, 14732, 14010, 13279,
+    12539, 11793, 11039, 10278, 9512, 8739, 7962, 7179, 6393, 5602, 4808, 4011, 3212, 2410, 1608, 804,
+    0, -804, -1608, -2410, -3212, -4011, -4808, -5602, -6393, -7179, -7962, -8739, -9512, -10278, -11039, -11793,
+    -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159, -20787, -21403, -22005, -22594,
+    -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790, -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956,
+    -30273, -30571, -30852, -31113, -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+    -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580, -31356, -31113, -30852, -30571,
+    -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683, -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731,
+    -23170, -22594, -22005, -21403, -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+    -12539, -11793, -11039, -10278, -9512, -8739, -7962, -7179, -6393, -5602, -4808, -4011, -3212, -2410, -1608, -804,
+    0,
+};
+
+// Q15 缓动表，进度 0..1 均分 32 段，与 Otto 原有的浮点曲线一致
+// 回弹曲线会超出 32767，所以用 int32_t
+static const int32_t kEaseTable[kMotionEaseCount][33] = {
+    // kMotionEaseLinear
+    {0, 1024, 2048, 3072, 4096, 5120, 6144, 7168, 8192, 9216, 10240, 11264, 12288, 13312, 14336, 15360,
+     16384, 17408, 18432, 19456, 20480, 21504, 22528, 23552, 24576, 25600, 26624, 27648, 28672, 29696, 30720, 31744,
+     32767},
+    // kMotionEaseInOut：三次贝塞尔 S 型曲线
+    {0, 33, 229, 655, 1376, 2425, 3834, 5570, 7667, 9994, 12550, 15106, 17596, 19955, 22150, 24117,
+     25853, 27393, 28671, 29752, 30604, 31292, 31817, 32177, 32439, 32603, 32701, 32734, 32767, 32767, 32767, 32767,
+     32767},
+    // kMotionEaseIn
+    {0, 1, 8, 27, 64, 125, 216, 343, 512, 729, 1000, 1331, 1728, 2197, 2744, 3375,
+     4096, 4913, 5832, 6859, 8000, 9261, 10648, 12167, 13824, 15625, 17575, 19682, 21951, 24388, 26999, 29790,
+     32767},
+    // kMotionEaseOut
+    {0, 2977, 5768, 8379, 10816, 13085, 15192, 17142, 18943, 20600, 22119, 23506, 24767, 25908, 26935, 27854,
+     28671, 29392, 30023, 30570, 31039, 31436, 31767, 32038, 32255, 32424, 32551, 32642, 32703, 32740, 32759, 32766,
+     32767},
+    // kMotionEaseInBack
+    {0, -52, -196, -417, -698, -1024, -1377, -1741, -2102, -2441, -2743, -2993, -3172, -3267, -3259, -3133,
+     -2874, -2463, -1886, -1126, -168, 1007, 2412, 4066, 5983, 8180, 10674, 13480, 16615, 20095, 23936, 28155,
+     32767},
+    // kMotionEaseOutBack
+    {0, 4612, 8831, 12672, 16152, 19287, 22093, 24587, 26784, 28701, 30355, 31760, 32935, 33893, 34653, 35230,
+     35641, 35900, 36026, 36034, 35939, 35760, 35510, 35208, 34869, 34508, 34144, 33791, 33465, 33184, 32963, 32819,
+     32767},
+    // kMotionEaseOutBounce
+    {0, 242, 968, 2178, 3872, 6050, 8712, 11858, 15488, 19601, 24199, 29281, 31775, 29377, 27463, 26033,
+     25087, 24625, 24647, 25153, 26143, 27617, 29575, 32017, 31871, 31057, 30727, 30881, 31519, 32641, 32327, 32305,
+     32767},
+};
+
+int32_t MotionCurve::Sin(uint16_t phase) {
+    int index = phase >> 8;
+    int32_t frac = phase & 0xFF;
+    int32_t a = kSinTable[index];
+    int32_t b = kSinTable[index + 1];
+    return a + (((b - a) * frac) >> 8);
+}
+
+int32_t MotionCurve::Ease(MotionEase ease, int32_t t) {
+    if (t <= 0) {
+        return 0;
+    }
+    if (t >= 32768) {
+        return 32768;
+    }
+    if (ease >= kMotionEaseCount) {
+        ease = kMotionEaseInOut;
+    }
+    // 32 段，每段 1024
+    const int32_t* table = kEaseTable[ease];
+    int index = t >> 10;
+    int32_t frac = t & 0x3FF;
+    int32_t a = table[index];
+    int32_t b = table[index + 1];
+    return a + (((b - a) * frac) >> 10);
+}
+
+// 伯恩斯坦基函数都是 Q15 的三次方（Q45），四项加权和在 int64 内不会溢出
+int32_t MotionCurve::Bezier(int32_t p0, int32_t p1, int32_t p2, int32_t p3, int32_t u) {
+    if (u < 0) {
+        u = 0;
+    } else if (u > 32768) {
+        u = 32768;
+    }
+    int64_t s = 32768 - u;
+    int64_t sum = s * s * s * p0 + 3 * s * s * u * p1 + 3 * s * u * u * p2 + (int64_t)u * u * u * p3;
+    return (int32_t)((sum + ((int64_t)1 << 44)) >> 45);
+}
+
+uint16_t MotionCurve::PhaseFromRadians(double radians) {
+    double turns = radians / (2 * M_PI);
+    turns -= std::floor(turns);
+    return (uint16_t)(int32_t)std::lround(turns * 65536.0);
+}
+
+int MotionCurve::Evaluate(const MotionSegment& segment, const int16_t* start, int64_t elapsed, int servo) {
+    if (segment.type == kMotionMove || segment.type == kMotionBezier) {
+        int64_t duration = (int64_t)segment.duration_ms * 1000;
+        int32_t t = elapsed >= duration ? 32768 : (int32_t)((elapsed << 15) / duration);
+        if (segment.type == kMotionBezier) {
+            return Bezier(start[servo], segment.control1[servo], segment.control2[servo],
+                          segment.target[servo], Ease(segment.ease, t));
+        }
+        int32_t delta = segment.target[servo] - start[servo];
+        return start[servo] + ((delta * Ease(segment.ease, t) + (1 << 14)) >> 15);
+    }
+    if (segment.type == kMotionOscillate && segment.period_ms > 0) {
+        int64_t period = (int64_t)segment.period_ms * 1000;
+        uint16_t phase = (uint16_t)(((elapsed % period) << 16) / period);
+        int32_t value = segment.amplitude[servo] * Sin((uint16_t)(phase + segment.phase[servo]));
+        return 90 + segment.offset[servo] + ((value + (1 << 14)) >> 15);
+    }
+    return start[servo];
+}
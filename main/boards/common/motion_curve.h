@@ -0,0 +1,82 @@
+#ifndef _MOTION_CURVE_H_
+#define _MOTION_CURVE_H_
+
+#include <cstdint>
+
+// 引擎支持的最大舵机数
+#define MOTION_MAX_SERVOS 12
+// 引擎节拍周期，与舵机 PWM 周期一致
+#define MOTION_TICK_MS 20
+
+// 缓动曲线，编号与 Otto/Dog 的 EaseType 一致
+enum MotionEase : uint8_t {
+    kMotionEaseLinear = 0,
+    kMotionEaseInOut = 1,
+    kMotionEaseIn = 2,
+    kMotionEaseOut = 3,
+    kMotionEaseInBack = 4,
+    kMotionEaseOutBack = 5,
+    kMotionEaseOutBounce = 6,
+    kMotionEaseCount,
+};
+
+/**
+ * @brief 轨迹段
+ *
+ * kMotionMove：mask 中的舵机从段开始时的位置按 ease 曲线移动到 target
+ * kMotionOscillate：position = 90 + offset + amplitude * sin(2π * t / period + phase)
+ * kMotionHold：保持当前位置 duration_ms
+ * kMotionBezier：从段开始时的位置经控制点 control1、control2 到 target 的三次贝塞尔曲线，
+ *                曲线参数按 ease 随时间推进
+ * 相位以 65536 为一周。
+ */
+enum MotionSegmentType : uint8_t {
+    kMotionMove,
+    kMotionOscillate,
+    kMotionHold,
+    kMotionBezier,
+};
+
+struct MotionSegment {
+    MotionSegmentType type = kMotionHold;
+    MotionEase ease = kMotionEaseLinear;
+    uint16_t mask = 0;
+    uint32_t duration_ms = 0;
+    uint32_t period_ms = 0;
+    int16_t target[MOTION_MAX_SERVOS] = {};
+    int16_t amplitude[MOTION_MAX_SERVOS] = {};
+    int16_t offset[MOTION_MAX_SERVOS] = {};
+    uint16_t phase[MOTION_MAX_SERVOS] = {};
+    int16_t control1[MOTION_MAX_SERVOS] = {};
+    int16_t control2[MOTION_MAX_SERVOS] = {};
+};
+
+/**
+ * @brief 轨迹段的 Q15 定点计算
+ *
+ * 不依赖 ESP-IDF，运动引擎和主机端测试共用，scripts/choreography.py 的模拟器与这里逐位一致。
+ */
+class MotionCurve {
+public:
+    // Q15 定点正弦，phase 以 65536 为一周
+    static int32_t Sin(uint16_t phase);
+    // Q15 定点缓动，t 为 Q15 进度（0..32768），回弹曲线的结果可以超出 0..32768
+    static int32_t Ease(MotionEase ease, int32_t t);
+    // Q15 三次贝塞尔，u 为 Q15 曲线参数（0..32768）
+    static int32_t Bezier(int32_t p0, int32_t p1, int32_t p2, int32_t p3, int32_t u);
+
+    // 弧度转换为引擎相位
+    static uint16_t PhaseFromRadians(double radians);
+
+    /**
+     * @brief 段开始后 elapsed 微秒时舵机的位置
+     *
+     * 移动段和贝塞尔段结束后停在目标，振荡段结束后继续振荡（用于过渡），保持段停在 start。
+     */
+    static int Evaluate(const MotionSegment& segment, const int16_t* start, int64_t elapsed, int servo);
+
+    // 段结束时是否精确落到 target
+    static bool EndsAtTarget(MotionSegmentType type) { return type == kMotionMove || type == kMotionBezier; }
+};
+
+#endif // _MOTION_CURVE_H_
@@ -0,0 +1,246 @@
+#include "motion_safety.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#define TAG "MotionSafety"
+
+// 降额的下限（Q8），电压最低或最热时仍保留的速度
+#define MIN_SUPPLY_SCALE 96
+#define MIN_THERMAL_SCALE 77
+// 读取电压的间隔，与遥测的记录间隔相同
+#define SUPPLY_INTERVAL_MS (MotionSafety::kTelemetryTicks * MOTION_TICK_MS)
+
+
+MotionSafety::MotionSafety(int servo_count, const Config& config)
+    : servo_count_(servo_count), config_(config) {
+    std::fill(neutral_, neutral_ + MOTION_MAX_SERVOS, 90);
+}
+
+void MotionSafety::SetSupplyVoltageSource(std::function<int()> source, int empty_mv) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    supply_source_ = std::move(source);
+    empty_mv_ = empty_mv;
+}
+
+void MotionSafety::SetNeutral(int servo, int position) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    neutral_[servo] = position;
+}
+
+int MotionSafety::ThermalScale(int servo) const {
+    float heat = heat_[servo];
+    if (heat <= config_.heat_warn) {
+        return 256;
+    }
+    if (heat >= config_.heat_limit) {
+        return MIN_THERMAL_SCALE;
+    }
+    return 256 - (int)((256 - MIN_THERMAL_SCALE) * (heat - config_.heat_warn) /
+                       (config_.heat_limit - config_.heat_warn));
+}
+
+void MotionSafety::UpdateSupply() {
+    int mv = supply_source_ ? supply_source_() : 0;
+    if (mv <= 0) {
+        supply_mv_ = 0;
+        average_mv_ = 0;
+        supply_scale_ = 256;
+        return;
+    }
+    supply_mv_ = mv;
+    if (average_mv_ == 0) {
+        average_mv_ = mv;
+    } else {
+        average_mv_ += (mv - average_mv_) * SUPPLY_INTERVAL_MS / (config_.supply_tau_s * 1000.0f);
+    }
+
+    // 负载造成的跌落：静止时的电压由电量决定，不代表欠压风险
+    int sag = (int)average_mv_ - mv;
+    int target;
+    if (empty_mv_ > 0 && mv <= empty_mv_) {
+        target = MIN_SUPPLY_SCALE;
+    } else if (sag <= config_.sag_warn_mv) {
+        target = 256;
+    } else if (sag >= config_.sag_limit_mv) {
+        target = MIN_SUPPLY_SCALE;
+    } else {
+        target = 256 - (256 - MIN_SUPPLY_SCALE) * (sag - config_.sag_warn_mv) /
+                           (config_.sag_limit_mv - config_.sag_warn_mv);
+    }
+
+    // 降额立即响应，恢复缓慢跟随，避免负载间隙的回升让降额来回跳
+    int previous = supply_scale_;
+    if (target < supply_scale_) {
+        supply_scale_ = target;
+    } else {
+        supply_scale_ += (target - supply_scale_ + 7) / 8;
+    }
+    if (supply_scale_ < 256 && previous == 256) {
+        ESP_LOGW(TAG, "Supply %d mV (average %d mV), derating motion to %d%%", mv, (int)average_mv_,
+                 supply_scale_ * 100 / 256);
+    }
+}
+
+uint16_t MotionSafety::Apply(int16_t* positions, const int16_t* current, uint16_t mask, int64_t now_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 温升估计按实际经过的时间衰减，空闲期间没有节拍也一样
+    if (last_us_ != 0) {
+        float decay = expf(-(now_us - last_us_) / (config_.heat_tau_s * 1e6f));
+        for (int i = 0; i < servo_count_; i++) {
+            heat_[i] *= decay;
+        }
+    }
+    last_us_ = now_us;
+    if (now_us - last_supply_us_ >= SUPPLY_INTERVAL_MS * 1000) {
+        last_supply_us_ = now_us;
+        UpdateSupply();
+    }
+
+    for (int i = 0; i < servo_count_; i++) {
+        if (mask & (1 << i)) {
+            requested_[i] = positions[i];
+        }
+    }
+    pending_ |= mask;
+
+    int target[MOTION_MAX_SERVOS];
+    int step[MOTION_MAX_SERVOS] = {};
+    int total = 0;
+    bool limited = false;
+    for (int i = 0; i < servo_count_; i++) {
+        if (!(pending_ & (1 << i))) {
+            continue;
+        }
+        int scale = std::min(supply_scale_, ThermalScale(i));
+        // 幅度的降额是速度的一半，向中位收缩
+        int amplitude = 256 - (256 - scale) / 2;
+        target[i] = neutral_[i] + (requested_[i] - neutral_[i]) * amplitude / 256;
+        int limit = std::max(1, config_.max_step * scale / 256);
+        int delta = target[i] - current[i];
+        // 上一节拍写入了却没有动：舵机已断开，不再追赶，避免运动引擎一直等待
+        if (!(mask & (1 << i)) && current[i] != last_output_[i] && current[i] == last_current_[i]) {
+            if (++stuck_[i] >= kMaxStuckTicks) {
+                ESP_LOGW(TAG, "Servo %d not following, stop settling", i);
+                pending_ &= ~(1 << i);
+                continue;
+            }
+        } else {
+            stuck_[i] = 0;
+        }
+        step[i] = std::clamp(delta, -limit, limit);
+        if (step[i] != delta) {
+            limited = true;
+        }
+        total += abs(step[i]);
+    }
+
+    // 总步长超出预算时等比例缩小，保持各舵机之间的协调
+    int budget = std::max(1, config_.bus_budget * supply_scale_ / 256);
+    if (total > budget) {
+        limited = true;
+        budget_ticks_++;
+        for (int i = 0; i < servo_count_; i++) {
+            if (step[i] != 0) {
+                // 至少走一度，小步长的舵机不会被卡住
+                int scaled = step[i] * budget / total;
+                step[i] = scaled != 0 ? scaled : (step[i] > 0 ? 1 : -1);
+            }
+        }
+    }
+
+    uint16_t output = 0;
+    for (int i = 0; i < servo_count_; i++) {
+        if (!(pending_ & (1 << i))) {
+            continue;
+        }
+        positions[i] = current[i] + step[i];
+        last_current_[i] = current[i];
+        last_output_[i] = positions[i];
+        heat_[i] += abs(step[i]);
+        window_steps_ += abs(step[i]);
+        if (positions[i] == target[i]) {
+            pending_ &= ~(1 << i);
+        }
+        if (step[i] != 0 || (mask & (1 << i))) {
+            output |= 1 << i;
+        }
+    }
+
+    if (limited) {
+        limited_ticks_++;
+        window_limited_++;
+    }
+    if (++tick_ >= kTelemetryTicks) {
+        tick_ = 0;
+        Record(now_us);
+    }
+    return output;
+}
+
+void MotionSafety::Record(int64_t now_us) {
+    int hottest = 0;
+    for (int i = 1; i < servo_count_; i++) {
+        if (heat_[i] > heat_[hottest]) {
+            hottest = i;
+        }
+    }
+    int speed = std::min(supply_scale_, ThermalScale(hottest)) * 100 / 256;
+
+    Sample& sample = samples_[sample_head_];
+    sample.time_ms = (uint32_t)(now_us / 1000);
+    sample.supply_mv = supply_mv_;
+    sample.bus_steps = std::min(window_steps_, 0xFFFF);
+    sample.peak_heat = std::min((int)heat_[hottest], 0xFFFF);
+    sample.speed_pct = speed;
+    sample.amplitude_pct = 100 - (100 - speed) / 2;
+    sample.hottest = hottest;
+    sample.limited_ticks = window_limited_;
+    sample_head_ = (sample_head_ + 1) % kTelemetryLength;
+    if (sample_count_ < kTelemetryLength) {
+        sample_count_++;
+    }
+    window_steps_ = 0;
+    window_limited_ = 0;
+}
+
+std::string MotionSafety::GetTelemetryJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string json = "{\"supply_mv\":" + std::to_string(supply_mv_);
+    json += ",\"supply_average_mv\":" + std::to_string((int)average_mv_);
+    json += ",\"supply_scale_pct\":" + std::to_string(supply_scale_ * 100 / 256);
+    // 空闲时没有节拍，按经过的时间折算当前的温升
+    float decay = 1.0f;
+    if (last_us_ != 0) {
+        decay = expf(-(esp_timer_get_time() - last_us_) / (config_.heat_tau_s * 1e6f));
+    }
+    json += ",\"heat\":[";
+    for (int i = 0; i < servo_count_; i++) {
+        if (i > 0) {
+            json += ",";
+        }
+        json += std::to_string((int)(heat_[i] * decay));
+    }
+    json += "],\"limited_ticks\":" + std::to_string(limited_ticks_);
+    json += ",\"budget_ticks\":" + std::to_string(budget_ticks_);
+    json += ",\"columns\":[\"time_ms\",\"supply_mv\",\"bus_steps\",\"speed_pct\",\"amplitude_pct\","
+            "\"hottest\",\"peak_heat\",\"limited_ticks\"],\"samples\":[";
+    int start = (sample_head_ - sample_count_ + kTelemetryLength) % kTelemetryLength;
+    for (int n = 0; n < sample_count_; n++) {
+        const Sample& s = samples_[(start + n) % kTelemetryLength];
+        if (n > 0) {
+            json += ",";
+        }
+        json += "[" + std::to_string(s.time_ms) + "," + std::to_string(s.supply_mv) + "," +
+                std::to_string(s.bus_steps) + "," + std::to_string(s.speed_pct) + "," +
+                std::to_string(s.amplitude_pct) + "," + std::to_string(s.hottest) + "," +
+                std::to_string(s.peak_heat) + "," + std::to_string(s.limited_ticks) + "]";
+    }
+    json += "]}";
+    return json;
+}
@@ -0,0 +1,117 @@
+#ifndef _MOTION_SAFETY_H_
+#define _MOTION_SAFETY_H_
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include "motion_curve.h"
+
+/**
+ * @brief 舵机运动安全限幅
+ *
+ * 在 ServoMotionEngine 每个节拍写入舵机之前调用。舵机没有电流反馈，这里用指令
+ * 本身估算负载：
+ * - 每个舵机每节拍的步长不超过舵机的实际速度，更快的指令只会让舵机堵转；
+ * - 所有舵机每节拍的步长总和有预算，超出时等比例缩小，多个舵机同时启动的浪涌
+ *   被摊到几个节拍里，动作的形状保持不变；
+ * - 每个舵机的累计运动量按时间常数衰减，作为温升估计，过热时单独降速降幅；
+ * - 电源电压比最近的平均值跌落过多，或低于电池的空电电压时整体降速降幅，避免与
+ *   Wi-Fi 发射、音频播放叠加时欠压复位。按跌落而不是绝对电压判断，电量不同的
+ *   电池在静止时都不会被降额。
+ * 每 100ms 记录一条遥测，保存最近 64 条，可通过 GetTelemetryJson 读取。
+ */
+class MotionSafety {
+public:
+    static constexpr int kTelemetryLength = 64;
+    // 每多少个节拍记录一条遥测、读取一次电压
+    static constexpr int kTelemetryTicks = 5;
+    // 写入后连续这么多节拍位置不变，认为舵机已断开
+    static constexpr int kMaxStuckTicks = 5;
+
+    struct Config {
+        int max_step = 12;          // 单个舵机每节拍最大步长（度），约 600°/s
+        int bus_budget = 48;        // 所有舵机每节拍步长总和（度）
+        int sag_warn_mv = 100;      // 电压比平均值低这么多时开始降额
+        int sag_limit_mv = 300;     // 降到最低额度的跌落
+        int supply_tau_s = 10;      // 平均电压的时间常数
+        int heat_warn = 9000;       // 开始降额的温升估计（约 1 分钟内的累计运动度数）
+        int heat_limit = 18000;     // 降到最低额度的温升估计
+        int heat_tau_s = 60;        // 温升衰减时间常数
+    };
+
+    MotionSafety(int servo_count, const Config& config);
+    explicit MotionSafety(int servo_count) : MotionSafety(servo_count, Config()) {}
+
+    /**
+     * @brief 电源电压来源（毫伏），在节拍回调中调用，必须立即返回；返回 0 表示未知
+     * @param empty_mv 电池电量为 0% 时的电压（来自板子的电量校准），低于它时降到最低额度；
+     *                 0 表示只按跌落降额
+     */
+    void SetSupplyVoltageSource(std::function<int()> source, int empty_mv = 0);
+
+    // 降幅时向 position 收缩，默认 90
+    void SetNeutral(int servo, int position);
+
+    /**
+     * @brief 限幅本节拍的输出
+     * @param positions 输入为期望位置（mask 中的舵机），输出为实际写入的位置
+     * @param current 每个舵机当前的位置
+     * @param mask 本节拍有新期望位置的舵机
+     * @return 需要写入的舵机，包括之前被限速、还没到达目标的舵机
+     */
+    uint16_t Apply(int16_t* positions, const int16_t* current, uint16_t mask, int64_t now_us);
+
+    // 所有舵机都已到达最后的期望位置
+    bool IsSettled() const { return pending_ == 0; }
+
+    std::string GetTelemetryJson() const;
+
+private:
+    struct Sample {
+        uint32_t time_ms;
+        uint16_t supply_mv;
+        uint16_t bus_steps;     // 这段时间内所有舵机的步长总和
+        uint16_t peak_heat;
+        uint8_t speed_pct;
+        uint8_t amplitude_pct;
+        uint8_t hottest;
+        uint8_t limited_ticks;  // 这段时间内发生限幅的节拍数
+    };
+
+    int ThermalScale(int servo) const;
+    void UpdateSupply();
+    void Record(int64_t now_us);
+
+    int servo_count_;
+    Config config_;
+    std::function<int()> supply_source_;
+    int empty_mv_ = 0;
+
+    mutable std::mutex mutex_;
+    int16_t requested_[MOTION_MAX_SERVOS] = {};
+    int16_t neutral_[MOTION_MAX_SERVOS];
+    float heat_[MOTION_MAX_SERVOS] = {};
+    int16_t last_current_[MOTION_MAX_SERVOS] = {};
+    int16_t last_output_[MOTION_MAX_SERVOS] = {};
+    uint8_t stuck_[MOTION_MAX_SERVOS] = {};
+    uint16_t pending_ = 0;
+    int64_t last_us_ = 0;
+
+    int supply_mv_ = 0;
+    float average_mv_ = 0;
+    int supply_scale_ = 256;    // Q8
+    int64_t last_supply_us_ = 0;
+    int tick_ = 0;
+    int window_steps_ = 0;
+    int window_limited_ = 0;
+    uint32_t limited_ticks_ = 0;
+    uint32_t budget_ticks_ = 0;
+
+    Sample samples_[kTelemetryLength] = {};
+    int sample_head_ = 0;
+    int sample_count_ = 0;
+};
+
+#endif // _MOTION_SAFETY_H_
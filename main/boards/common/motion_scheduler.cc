@@ -0,0 +1,115 @@
+#include "motion_scheduler.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#define TAG "MotionScheduler"
+
+
+MotionScheduler::MotionScheduler(const char* task_name, uint32_t stack_size, UBaseType_t task_priority,
+                                 std::function<void()> preempt)
+    : preempt_(std::move(preempt)) {
+    xTaskCreate(TaskEntry, task_name, stack_size, this, task_priority, &task_);
+}
+
+MotionScheduler::~MotionScheduler() {
+    if (task_ != nullptr) {
+        vTaskDelete(task_);
+    }
+}
+
+bool MotionScheduler::Submit(Priority priority, const char* name, std::function<void()> action) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (priority == kPriorityIdle && (running_ || !pending_.empty())) {
+            return false;
+        }
+        if (priority == kPrioritySafety) {
+            dropped_ += pending_.size();
+            pending_.clear();
+        } else if (pending_.size() >= kMaxPending) {
+            dropped_++;
+            ESP_LOGW(TAG, "Queue full, dropping %s", name);
+            return false;
+        }
+
+        Action item = {priority, name, std::move(action), esp_timer_get_time()};
+        if (priority == kPrioritySafety) {
+            pending_.push_front(std::move(item));
+        } else {
+            pending_.push_back(std::move(item));
+        }
+
+        // 在锁内打断，保证打断的是当前动作而不是刚开始的新动作
+        if (running_ && priority > running_priority_) {
+            ESP_LOGI(TAG, "%s preempts %s", name, running_name_);
+            preempted_++;
+            preempt_();
+        }
+    }
+    xTaskNotifyGive(task_);
+    return true;
+}
+
+bool MotionScheduler::IsBusy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ || !pending_.empty();
+}
+
+bool MotionScheduler::HasPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !pending_.empty();
+}
+
+std::string MotionScheduler::GetStatusJson() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string json = "{\"state\":\"";
+    json += running_ || !pending_.empty() ? "moving" : "idle";
+    json += "\",\"action\":\"";
+    json += running_ ? running_name_ : "";
+    json += "\",\"queue_depth\":" + std::to_string(pending_.size());
+    json += ",\"last_latency_ms\":" + std::to_string(last_latency_us_ / 1000);
+    json += ",\"max_latency_ms\":" + std::to_string(max_latency_us_ / 1000);
+    json += ",\"completed\":" + std::to_string(completed_);
+    json += ",\"preempted\":" + std::to_string(preempted_);
+    json += ",\"dropped\":" + std::to_string(dropped_);
+    json += "}";
+    return json;
+}
+
+void MotionScheduler::TaskEntry(void* arg) {
+    static_cast<MotionScheduler*>(arg)->Run();
+}
+
+void MotionScheduler::Run() {
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (true) {
+            Action action;
+            int64_t latency;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (pending_.empty()) {
+                    running_ = false;
+                    break;
+                }
+                action = std::move(pending_.front());
+                pending_.pop_front();
+                running_ = true;
+                running_priority_ = action.priority;
+                running_name_ = action.name;
+                latency = esp_timer_get_time() - action.submit_us;
+                last_latency_us_ = latency;
+                if (latency > max_latency_us_) {
+                    max_latency_us_ = latency;
+                }
+            }
+
+            ESP_LOGI(TAG, "Run %s (waited %d ms)", action.name, int(latency / 1000));
+            action.fn();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            completed_++;
+        }
+    }
+}
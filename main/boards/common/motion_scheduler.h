@@ -0,0 +1,79 @@
+#ifndef _MOTION_SCHEDULER_H_
+#define _MOTION_SCHEDULER_H_
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * @brief 机器人动作调度器
+ *
+ * 动作按优先级排队，在调度器自己的任务中逐个执行。更高优先级的动作到达时调用
+ * preempt 打断正在执行的动作（通常是 ServoMotionEngine::Cancel，平滑过渡到安全
+ * 姿态），安全动作还会清空排队中的动作；空闲动画只在没有其他动作时执行。
+ * 调度器记录每个动作从提交到开始执行的延迟，通过 GetStatusJson 报告。
+ */
+class MotionScheduler {
+public:
+    enum Priority {
+        kPriorityIdle = 0,    // 空闲动画，有其他动作时丢弃
+        kPriorityUser = 1,    // 用户/大模型的动作指令
+        kPrioritySafety = 2,  // 停止、复位，打断一切并清空队列
+    };
+
+    static constexpr size_t kMaxPending = 10;
+
+    /**
+     * @param preempt 在提交者的任务中、持有调度器锁时调用，要求正在执行的动作尽快返回
+     */
+    MotionScheduler(const char* task_name, uint32_t stack_size, UBaseType_t task_priority,
+                    std::function<void()> preempt);
+    ~MotionScheduler();
+
+    /**
+     * @brief 提交动作；队列已满或空闲动作遇到其他动作时返回 false
+     * @param name 动作名称，必须是静态字符串
+     */
+    bool Submit(Priority priority, const char* name, std::function<void()> action);
+
+    // 有动作正在执行或排队
+    bool IsBusy() const;
+    // 当前动作之后还有排队的动作，用于决定动作之间衔接还是回到休息姿态
+    bool HasPending() const;
+
+    std::string GetStatusJson() const;
+
+private:
+    struct Action {
+        Priority priority;
+        const char* name;
+        std::function<void()> fn;
+        int64_t submit_us;
+    };
+
+    static void TaskEntry(void* arg);
+    void Run();
+
+    TaskHandle_t task_ = nullptr;
+    std::function<void()> preempt_;
+
+    mutable std::mutex mutex_;
+    std::deque<Action> pending_;
+    bool running_ = false;
+    Priority running_priority_ = kPriorityIdle;
+    const char* running_name_ = nullptr;
+
+    // 统计
+    int64_t last_latency_us_ = 0;
+    int64_t max_latency_us_ = 0;
+    uint32_t completed_ = 0;
+    uint32_t preempted_ = 0;
+    uint32_t dropped_ = 0;
+};
+
+#endif // _MOTION_SCHEDULER_H_
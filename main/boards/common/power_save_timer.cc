@@ -1,6 +1,7 @@
 #include "power_save_timer.h"
 #include "application.h"
 #include "settings.h"
+#include "persistent_store.h"
 
 #include <esp_log.h>
 
@@ -71,6 +72,8 @@ void PowerSaveTimer::PowerSaveCheck() {
         if (!in_sleep_mode_) {
             ESP_LOGI(TAG, "Enabling power save mode");
             in_sleep_mode_ = true;
+            // 低功耗期间可能随时被关机，先把缓存写入 Flash
+            PersistentStore::GetInstance().Flush();
             if (on_enter_sleep_mode_) {
                 on_enter_sleep_mode_();
             }
@@ -99,6 +102,8 @@ void PowerSaveTimer::PowerSaveCheck() {
         }
     }
     if (seconds_to_shutdown_ != -1 && ticks_ >= seconds_to_shutdown_ && on_shutdown_request_) {
+        // 板子的关机回调进入深度睡眠或直接断电，不会执行 esp_register_shutdown_handler 注册的处理
+        PersistentStore::GetInstance().Flush();
         on_shutdown_request_();
     }
 }
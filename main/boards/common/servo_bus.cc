@@ -0,0 +1,259 @@
+#include "servo_bus.h"
+
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <cstring>
+
+#define TAG "ServoBus"
+
+// 舵机 PWM 周期 20ms
+#define SERVO_PERIOD_US 20000
+// LEDC 13 位占空比，一个周期 8192 个计数
+#define SERVO_LEDC_TIMER LEDC_TIMER_1
+#define SERVO_LEDC_RESOLUTION LEDC_TIMER_13_BIT
+#define SERVO_LEDC_PERIOD_TICKS 8192
+// 相邻通道脉冲起点错开的时间，不小于最大脉宽 2.5ms，7 路正好排满一个周期
+#define SERVO_LEDC_STAGGER_TICKS (SERVO_LEDC_PERIOD_TICKS * 2500 / SERVO_PERIOD_US)
+
+#define PCA9685_MODE1 0x00
+#define PCA9685_MODE2 0x01
+#define PCA9685_LED0_ON_L 0x06
+#define PCA9685_ALL_LED_OFF_H 0xFD
+#define PCA9685_PRE_SCALE 0xFE
+#define PCA9685_MODE1_AI 0x20
+#define PCA9685_MODE1_SLEEP 0x10
+#define PCA9685_MODE2_OUTDRV 0x04
+#define PCA9685_FULL_OFF 0x10
+// 25MHz 内部振荡器，25000000 / (4096 * 50) - 1
+#define PCA9685_PRE_SCALE_50HZ 121
+// 相邻通道脉冲起点错开 256 个计数（1.25ms），16 路排满一个周期
+#define PCA9685_STAGGER_TICKS 256
+
+int PwmServoBus::Attach(int pin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < kMaxChannels; i++) {
+        if (attached_[i]) {
+            continue;
+        }
+        bool ok = false;
+        if (i < kLedcChannels) {
+            ok = AttachLedc(i, pin);
+        }
+#if SOC_MCPWM_SUPPORTED
+        else {
+            ok = AttachMcpwm(i - kLedcChannels, pin);
+        }
+#endif
+        if (ok) {
+            attached_[i] = true;
+            dirty_[i] = false;
+            pulse_us_[i] = 0;
+            return i;
+        }
+    }
+    ESP_LOGE(TAG, "No free PWM output for GPIO %d (%d in use)", pin, kMaxChannels);
+    return -1;
+}
+
+bool PwmServoBus::AttachLedc(int index, int pin) {
+    if (!timer_configured_) {
+        ledc_timer_config_t ledc_timer = {};
+        ledc_timer.speed_mode = LEDC_LOW_SPEED_MODE;
+        ledc_timer.duty_resolution = SERVO_LEDC_RESOLUTION;
+        ledc_timer.timer_num = SERVO_LEDC_TIMER;
+        ledc_timer.freq_hz = 1000000 / SERVO_PERIOD_US;
+        ledc_timer.clk_cfg = LEDC_AUTO_CLK;
+        ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+        timer_configured_ = true;
+    }
+
+    ledc_channel_config_t ledc_channel = {};
+    ledc_channel.gpio_num = pin;
+    ledc_channel.speed_mode = LEDC_LOW_SPEED_MODE;
+    ledc_channel.channel = (ledc_channel_t)(index + 1);
+    ledc_channel.intr_type = LEDC_INTR_DISABLE;
+    ledc_channel.timer_sel = SERVO_LEDC_TIMER;
+    ledc_channel.duty = 0;
+    ledc_channel.hpoint = index * SERVO_LEDC_STAGGER_TICKS;
+    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+    return true;
+}
+
+#if SOC_MCPWM_SUPPORTED
+bool PwmServoBus::AttachMcpwm(int index, int pin) {
+    int group = index / kMcpwmOutputsPerGroup;
+    int slot = index % kMcpwmOutputsPerGroup;
+    int oper = slot / SOC_MCPWM_GENERATORS_PER_OPERATOR;
+
+    if (mcpwm_timer_[group] == nullptr) {
+        mcpwm_timer_config_t timer_config = {};
+        timer_config.group_id = group;
+        timer_config.clk_src = MCPWM_TIMER_CLK_SRC_DEFAULT;
+        timer_config.resolution_hz = 1000000;
+        timer_config.count_mode = MCPWM_TIMER_COUNT_MODE_UP;
+        timer_config.period_ticks = SERVO_PERIOD_US;
+        ESP_ERROR_CHECK(mcpwm_new_timer(&timer_config, &mcpwm_timer_[group]));
+        ESP_ERROR_CHECK(mcpwm_timer_enable(mcpwm_timer_[group]));
+        ESP_ERROR_CHECK(mcpwm_timer_start_stop(mcpwm_timer_[group], MCPWM_TIMER_START_NO_STOP));
+    }
+    if (mcpwm_operator_[group][oper] == nullptr) {
+        mcpwm_operator_config_t operator_config = {};
+        operator_config.group_id = group;
+        ESP_ERROR_CHECK(mcpwm_new_operator(&operator_config, &mcpwm_operator_[group][oper]));
+        ESP_ERROR_CHECK(mcpwm_operator_connect_timer(mcpwm_operator_[group][oper], mcpwm_timer_[group]));
+    }
+
+    // 比较值在定时器归零时才更新，与 LEDC 一样在下一个周期开始时生效
+    mcpwm_comparator_config_t comparator_config = {};
+    comparator_config.flags.update_cmp_on_tez = true;
+    ESP_ERROR_CHECK(mcpwm_new_comparator(mcpwm_operator_[group][oper], &comparator_config,
+                                         &mcpwm_comparator_[index]));
+    ESP_ERROR_CHECK(mcpwm_comparator_set_compare_value(mcpwm_comparator_[index], 0));
+
+    mcpwm_generator_config_t generator_config = {};
+    generator_config.gen_gpio_num = pin;
+    ESP_ERROR_CHECK(mcpwm_new_generator(mcpwm_operator_[group][oper], &generator_config,
+                                        &mcpwm_generator_[index]));
+    ESP_ERROR_CHECK(mcpwm_generator_set_action_on_timer_event(mcpwm_generator_[index],
+        MCPWM_GEN_TIMER_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, MCPWM_TIMER_EVENT_EMPTY, MCPWM_GEN_ACTION_HIGH)));
+    ESP_ERROR_CHECK(mcpwm_generator_set_action_on_compare_event(mcpwm_generator_[index],
+        MCPWM_GEN_COMPARE_EVENT_ACTION(MCPWM_TIMER_DIRECTION_UP, mcpwm_comparator_[index], MCPWM_GEN_ACTION_LOW)));
+    return true;
+}
+#endif
+
+void PwmServoBus::Detach(int channel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel < 0 || channel >= kMaxChannels || !attached_[channel]) {
+        return;
+    }
+    if (channel < kLedcChannels) {
+        ESP_ERROR_CHECK(ledc_stop(LEDC_LOW_SPEED_MODE, (ledc_channel_t)(channel + 1), 0));
+    }
+#if SOC_MCPWM_SUPPORTED
+    else {
+        int index = channel - kLedcChannels;
+        ESP_ERROR_CHECK(mcpwm_generator_set_force_level(mcpwm_generator_[index], 0, true));
+        ESP_ERROR_CHECK(mcpwm_del_generator(mcpwm_generator_[index]));
+        ESP_ERROR_CHECK(mcpwm_del_comparator(mcpwm_comparator_[index]));
+        mcpwm_generator_[index] = nullptr;
+        mcpwm_comparator_[index] = nullptr;
+    }
+#endif
+    attached_[channel] = false;
+    dirty_[channel] = false;
+}
+
+void PwmServoBus::SetPulse(int channel, uint16_t pulse_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel < 0 || channel >= kMaxChannels || !attached_[channel]) {
+        return;
+    }
+    if (channel < kLedcChannels) {
+        // 只写占空比寄存器，ledc_update_duty 之后才锁存
+        uint32_t duty = (uint32_t)pulse_us * SERVO_LEDC_PERIOD_TICKS / SERVO_PERIOD_US;
+        ESP_ERROR_CHECK(ledc_set_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)(channel + 1), duty));
+    }
+    pulse_us_[channel] = pulse_us;
+    dirty_[channel] = true;
+}
+
+void PwmServoBus::Commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 连续设置所有通道的更新标志，只需几微秒，定时器溢出时一起锁存
+    for (int i = 0; i < kLedcChannels; i++) {
+        if (dirty_[i]) {
+            ESP_ERROR_CHECK(ledc_update_duty(LEDC_LOW_SPEED_MODE, (ledc_channel_t)(i + 1)));
+            dirty_[i] = false;
+        }
+    }
+#if SOC_MCPWM_SUPPORTED
+    for (int i = kLedcChannels; i < kMaxChannels; i++) {
+        if (dirty_[i]) {
+            ESP_ERROR_CHECK(mcpwm_comparator_set_compare_value(mcpwm_comparator_[i - kLedcChannels],
+                                                               pulse_us_[i]));
+            dirty_[i] = false;
+        }
+    }
+#endif
+}
+
+Pca9685ServoBus::Pca9685ServoBus(i2c_master_bus_handle_t i2c_bus, uint8_t addr) : I2cDevice(i2c_bus, addr) {
+    // 预分频只能在休眠时修改
+    WriteReg(PCA9685_MODE1, PCA9685_MODE1_SLEEP);
+    WriteReg(PCA9685_PRE_SCALE, PCA9685_PRE_SCALE_50HZ);
+    // 推挽输出，输出在 STOP 时更新（OCH = 0）
+    WriteReg(PCA9685_MODE2, PCA9685_MODE2_OUTDRV);
+    WriteReg(PCA9685_ALL_LED_OFF_H, PCA9685_FULL_OFF);
+    WriteReg(PCA9685_MODE1, PCA9685_MODE1_AI);
+    // 振荡器起振需要 500us
+    vTaskDelay(pdMS_TO_TICKS(2));
+    for (int i = 0; i < kChannels; i++) {
+        registers_[i][3] = PCA9685_FULL_OFF;
+    }
+    ESP_LOGI(TAG, "PCA9685 servo bus at 0x%02x", addr);
+}
+
+int Pca9685ServoBus::Attach(int pin) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pin < 0 || pin >= kChannels || attached_[pin]) {
+        ESP_LOGE(TAG, "PCA9685 channel %d is invalid or in use", pin);
+        return -1;
+    }
+    attached_[pin] = true;
+    return pin;
+}
+
+void Pca9685ServoBus::Detach(int channel) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (channel < 0 || channel >= kChannels || !attached_[channel]) {
+            return;
+        }
+        attached_[channel] = false;
+        memset(registers_[channel], 0, 4);
+        registers_[channel][3] = PCA9685_FULL_OFF;
+        dirty_ |= 1 << channel;
+    }
+    Commit();
+}
+
+void Pca9685ServoBus::SetPulse(int channel, uint16_t pulse_us) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel < 0 || channel >= kChannels || !attached_[channel]) {
+        return;
+    }
+    uint16_t on = channel * PCA9685_STAGGER_TICKS % 4096;
+    uint16_t off = (on + (uint32_t)pulse_us * 4096 / SERVO_PERIOD_US) % 4096;
+    registers_[channel][0] = on & 0xFF;
+    registers_[channel][1] = on >> 8;
+    registers_[channel][2] = off & 0xFF;
+    registers_[channel][3] = off >> 8;
+    dirty_ |= 1 << channel;
+}
+
+void Pca9685ServoBus::Commit() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dirty_ == 0) {
+        return;
+    }
+    // 从第一个到最后一个改动的通道连续写入，中间未改动的通道写回缓存的原值
+    int first = __builtin_ctz(dirty_);
+    int last = 31 - __builtin_clz(dirty_);
+    uint8_t buffer[1 + kChannels * 4];
+    buffer[0] = PCA9685_LED0_ON_L + first * 4;
+    memcpy(buffer + 1, registers_[first], (last - first + 1) * 4);
+    // 在运动引擎的节拍中调用，总线偶尔出错时跳过这一次，不能中止程序
+    esp_err_t err = i2c_master_transmit(i2c_device_, buffer, 1 + (last - first + 1) * 4, 10);
+    if (err != ESP_OK) {
+        if (!failed_) {
+            ESP_LOGW(TAG, "PCA9685 write failed: %s", esp_err_to_name(err));
+            failed_ = true;
+        }
+        return;
+    }
+    failed_ = false;
+    dirty_ = 0;
+}
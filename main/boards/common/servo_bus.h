@@ -0,0 +1,119 @@
+#ifndef _SERVO_BUS_H_
+#define _SERVO_BUS_H_
+
+#include <driver/i2c_master.h>
+#include <driver/ledc.h>
+#include <soc/soc_caps.h>
+#if SOC_MCPWM_SUPPORTED
+#include <driver/mcpwm_prelude.h>
+#endif
+
+#include <cstdint>
+#include <mutex>
+
+#include "i2c_device.h"
+
+/**
+ * @brief 舵机脉冲输出总线
+ *
+ * 多个舵机共用一条总线，输出通道由总线显式分配：通道用完时 Attach 返回 -1，
+ * 不会因为构造顺序不同而与其他舵机或背光冲突。SetPulse 只记录脉宽，Commit 让
+ * 上次提交以来写入的所有通道在同一个 PWM 周期开始时一起生效，一个节拍内的
+ * 多关节动作不会有的关节早一个周期、有的晚一个周期。
+ */
+class ServoBus {
+public:
+    virtual ~ServoBus() = default;
+
+    /**
+     * @brief 分配一路输出
+     * @param pin PWM 后端为 GPIO，扩展芯片后端为芯片上的通道号
+     * @return 通道号，没有空闲输出时返回 -1
+     */
+    virtual int Attach(int pin) = 0;
+    // 释放输出并停止脉冲，舵机不再保持力矩
+    virtual void Detach(int channel) = 0;
+    virtual void SetPulse(int channel, uint16_t pulse_us) = 0;
+    virtual void Commit() = 0;
+};
+
+/**
+ * @brief 片上 PWM 舵机总线
+ *
+ * 先分配 LEDC 通道（LEDC_TIMER_1，通道 0 留给背光），用完后在支持 MCPWM 的芯片上
+ * 继续分配 MCPWM 输出。ESP32-S3 上共 7 + 12 路，足够 12 自由度的机器人。
+ * 各 LEDC 通道的脉冲起点依次错开，多个舵机不会在同一时刻一起吸收启动电流。
+ * LEDC 和 MCPWM 的新脉宽都在各自定时器的下一个周期开始时锁存；同一个定时器上
+ * 的通道在同一个周期生效，不同定时器之间相差不超过一个周期。
+ */
+class PwmServoBus : public ServoBus {
+public:
+    static PwmServoBus& GetInstance() {
+        static PwmServoBus instance;
+        return instance;
+    }
+
+    int Attach(int pin) override;
+    void Detach(int channel) override;
+    void SetPulse(int channel, uint16_t pulse_us) override;
+    void Commit() override;
+
+private:
+    static constexpr int kLedcChannels = SOC_LEDC_CHANNEL_NUM - 1;
+#if SOC_MCPWM_SUPPORTED
+    static constexpr int kMcpwmOutputsPerGroup =
+        SOC_MCPWM_OPERATORS_PER_GROUP * SOC_MCPWM_GENERATORS_PER_OPERATOR;
+    static constexpr int kMcpwmOutputs = SOC_MCPWM_GROUPS * kMcpwmOutputsPerGroup;
+#else
+    static constexpr int kMcpwmOutputs = 0;
+#endif
+    static constexpr int kMaxChannels = kLedcChannels + kMcpwmOutputs;
+
+    PwmServoBus() = default;
+
+    bool AttachLedc(int index, int pin);
+#if SOC_MCPWM_SUPPORTED
+    bool AttachMcpwm(int index, int pin);
+#endif
+
+    std::mutex mutex_;
+    bool timer_configured_ = false;
+    bool attached_[kMaxChannels] = {};
+    bool dirty_[kMaxChannels] = {};
+    uint16_t pulse_us_[kMaxChannels] = {};
+#if SOC_MCPWM_SUPPORTED
+    mcpwm_timer_handle_t mcpwm_timer_[SOC_MCPWM_GROUPS] = {};
+    mcpwm_oper_handle_t mcpwm_operator_[SOC_MCPWM_GROUPS][SOC_MCPWM_OPERATORS_PER_GROUP] = {};
+    mcpwm_cmpr_handle_t mcpwm_comparator_[kMcpwmOutputs] = {};
+    mcpwm_gen_handle_t mcpwm_generator_[kMcpwmOutputs] = {};
+#endif
+};
+
+/**
+ * @brief PCA9685 I2C 舵机扩展板
+ *
+ * 16 路 12 位 PWM，适合关节较多、片上 PWM 不够用的机型。Commit 把上次提交以来
+ * 改动的通道范围在一次 I2C 传输中写完，芯片在传输的 STOP 时让所有通道一起生效；
+ * 12 路舵机在 400kHz 下约 1.2ms。各通道的脉冲起点依次错开 1.25ms。
+ */
+class Pca9685ServoBus : public ServoBus, private I2cDevice {
+public:
+    static constexpr int kChannels = 16;
+
+    Pca9685ServoBus(i2c_master_bus_handle_t i2c_bus, uint8_t addr = 0x40);
+
+    int Attach(int pin) override;
+    void Detach(int channel) override;
+    void SetPulse(int channel, uint16_t pulse_us) override;
+    void Commit() override;
+
+private:
+    std::mutex mutex_;
+    bool attached_[kChannels] = {};
+    // LEDn_ON_L/ON_H/OFF_L/OFF_H 的缓存，Commit 时按范围连续写入
+    uint8_t registers_[kChannels][4] = {};
+    uint16_t dirty_ = 0;
+    bool failed_ = false;
+};
+
+#endif // _SERVO_BUS_H_
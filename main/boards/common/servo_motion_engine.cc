@@ -0,0 +1,282 @@
+#include "servo_motion_engine.h"
+#include "motion_safety.h"
+
+#include <esp_log.h>
+
+#include <algorithm>
+#include <cassert>
+
+#define TAG "MotionEngine"
+
+#define MOTION_IDLE_EVENT (1 << 0)
+
+ServoMotionEngine::ServoMotionEngine(ServoOutput* output, int servo_count)
+    : output_(output), servo_count_(servo_count) {
+    assert(servo_count_ <= MOTION_MAX_SERVOS);
+    queue_ = xQueueCreate(kQueueLength, sizeof(QueuedSegment));
+    event_group_ = xEventGroupCreate();
+    xEventGroupSetBits(event_group_, MOTION_IDLE_EVENT);
+
+    esp_timer_create_args_t timer_args = {
+        .callback = TimerCallback,
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "motion_engine",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer_));
+}
+
+ServoMotionEngine::~ServoMotionEngine() {
+    if (timer_ != nullptr) {
+        esp_timer_stop(timer_);
+        esp_timer_delete(timer_);
+    }
+    if (queue_ != nullptr) {
+        vQueueDelete(queue_);
+    }
+    if (event_group_ != nullptr) {
+        vEventGroupDelete(event_group_);
+    }
+}
+
+void ServoMotionEngine::Start() {
+    if (!esp_timer_is_active(timer_)) {
+        ESP_ERROR_CHECK(esp_timer_start_periodic(timer_, kTickMs * 1000));
+    }
+}
+
+void ServoMotionEngine::Stop() {
+    if (esp_timer_is_active(timer_)) {
+        esp_timer_stop(timer_);
+    }
+}
+
+bool ServoMotionEngine::Submit(const MotionSegment& segment, TickType_t timeout) {
+    QueuedSegment item = {segment, 0};
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) {
+            return false;
+        }
+        item.generation = generation_;
+        pending_++;
+        xEventGroupClearBits(event_group_, MOTION_IDLE_EVENT);
+    }
+    if (xQueueSend(queue_, &item, timeout) != pdTRUE) {
+        ESP_LOGW(TAG, "Motion queue full, segment dropped");
+        FinishSegment();
+        return false;
+    }
+    return true;
+}
+
+bool ServoMotionEngine::WaitIdle(TickType_t timeout) {
+    auto bits = xEventGroupWaitBits(event_group_, MOTION_IDLE_EVENT, pdFALSE, pdTRUE, timeout);
+    return (bits & MOTION_IDLE_EVENT) != 0;
+}
+
+bool ServoMotionEngine::IsIdle() const {
+    return (xEventGroupGetBits(event_group_) & MOTION_IDLE_EVENT) != 0;
+}
+
+void ServoMotionEngine::Clear() {
+    QueuedSegment item;
+    while (xQueueReceive(queue_, &item, 0) == pdTRUE) {
+        FinishSegment();
+    }
+}
+
+void ServoMotionEngine::Cancel(const MotionSegment& ramp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = true;
+    generation_++;
+    cancel_ramp_ = ramp;
+    if (!cancel_pending_) {
+        // 过渡段也计入未完成的段，等待空闲的任务会等到过渡结束
+        cancel_pending_ = true;
+        pending_++;
+        xEventGroupClearBits(event_group_, MOTION_IDLE_EVENT);
+    }
+}
+
+void ServoMotionEngine::Resume() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cancelled_ = false;
+}
+
+void ServoMotionEngine::FinishSegment() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_ == 0) {
+        xEventGroupSetBits(event_group_, MOTION_IDLE_EVENT);
+    }
+}
+
+void ServoMotionEngine::ReleaseSettling() {
+    if (settling_ && safety_->IsSettled()) {
+        settling_ = false;
+        FinishSegment();
+    }
+}
+
+void ServoMotionEngine::TimerCallback(void* arg) {
+    static_cast<ServoMotionEngine*>(arg)->Tick();
+}
+
+bool ServoMotionEngine::BeginNextSegment(int64_t start_us) {
+    QueuedSegment item;
+    while (xQueueReceive(queue_, &item, 0) == pdTRUE) {
+        bool stale;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stale = item.generation != generation_;
+        }
+        if (stale) {
+            FinishSegment();
+            continue;
+        }
+        active_ = item.segment;
+        StartSegment(start_us);
+        return true;
+    }
+    has_active_ = false;
+    return false;
+}
+
+void ServoMotionEngine::StartSegment(int64_t start_us) {
+    has_active_ = true;
+    segment_start_us_ = start_us;
+    if (safety_ != nullptr && !settling_) {
+        // 多计一个未完成的段，直到限幅器把舵机送到最后的目标，WaitIdle 才返回
+        std::lock_guard<std::mutex> lock(mutex_);
+        settling_ = true;
+        pending_++;
+    }
+    for (int i = 0; i < servo_count_; i++) {
+        if (active_.mask & (1 << i)) {
+            start_[i] = output_->Read(i);
+        }
+    }
+
+    // 只和刚刚结束的段过渡，间隔太久时上一段的延续已经没有意义
+    blend_us_ = 0;
+    if (blend_requested_.exchange(false) && has_previous_) {
+        int64_t previous_end = previous_start_us_ + (int64_t)previous_.duration_ms * 1000;
+        if (start_us - previous_end < kDefaultBlendMs * 1000) {
+            blend_us_ = previous_.type == kMotionOscillate ? (int64_t)previous_.period_ms * 500
+                                                           : kDefaultBlendMs * 1000;
+            blend_us_ = std::min<int64_t>(blend_us_, (int64_t)active_.duration_ms * 1000);
+        }
+    }
+}
+
+void ServoMotionEngine::Tick() {
+    int64_t now = esp_timer_get_time();
+
+    // Cancel：作废当前段，立即从当前位置开始过渡
+    bool cancel = false;
+    MotionSegment ramp;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancel_pending_) {
+            cancel_pending_ = false;
+            cancel = true;
+            ramp = cancel_ramp_;
+        }
+    }
+    if (cancel) {
+        if (has_active_) {
+            FinishSegment();
+        }
+        active_ = ramp;
+        has_previous_ = false;
+        StartSegment(now);
+    } else if (!has_active_ && !BeginNextSegment(now)) {
+        // 空闲时限幅器可能还没把舵机送到最后的目标
+        if (settling_) {
+            int16_t positions[MOTION_MAX_SERVOS];
+            Output(positions, 0, now);
+            ReleaseSettling();
+        }
+        return;
+    }
+
+    // 时间按段开始时刻计算，错过的节拍不会拉长动作
+    int64_t elapsed = now - segment_start_us_;
+    int64_t duration = (int64_t)active_.duration_ms * 1000;
+    int16_t positions[MOTION_MAX_SERVOS];
+    uint16_t written = 0;
+    while (elapsed >= duration) {
+        // 段结束：移动段和贝塞尔段精确落到目标位置，下一段紧接着本段的结束时刻开始
+        if (MotionCurve::EndsAtTarget(active_.type)) {
+            for (int i = 0; i < servo_count_; i++) {
+                if (active_.mask & (1 << i)) {
+                    positions[i] = active_.target[i];
+                    written |= 1 << i;
+                }
+            }
+        }
+        previous_ = active_;
+        previous_start_us_ = segment_start_us_;
+        std::copy(start_, start_ + servo_count_, previous_start_);
+        has_previous_ = true;
+
+        int64_t end = segment_start_us_ + duration;
+        FinishSegment();
+        if (!BeginNextSegment(end)) {
+            break;
+        }
+        elapsed = now - segment_start_us_;
+        duration = (int64_t)active_.duration_ms * 1000;
+    }
+
+    if (has_active_ && active_.type != kMotionHold) {
+        // 过渡期内从上一段的延续线性渐变到本段
+        int32_t weight = elapsed < blend_us_ ? (int32_t)((elapsed << 15) / blend_us_) : 32768;
+        for (int i = 0; i < servo_count_; i++) {
+            if (!(active_.mask & (1 << i))) {
+                continue;
+            }
+            int position = MotionCurve::Evaluate(active_, start_, elapsed, i);
+            if (weight < 32768) {
+                int from = (previous_.mask & (1 << i))
+                               ? MotionCurve::Evaluate(previous_, previous_start_, now - previous_start_us_, i)
+                               : start_[i];
+                position = from + (((position - from) * weight + (1 << 14)) >> 15);
+            }
+            positions[i] = position;
+            written |= 1 << i;
+        }
+    }
+    if (written == 0 && safety_ == nullptr) {
+        return;
+    }
+    Output(positions, written, now);
+    if (!has_active_) {
+        ReleaseSettling();
+    }
+
+    int64_t cost = esp_timer_get_time() - now;
+    if (cost > max_tick_us_) {
+        max_tick_us_ = cost;
+    }
+}
+
+void ServoMotionEngine::Output(int16_t* positions, uint16_t mask, int64_t now) {
+    if (safety_ != nullptr) {
+        int16_t current[MOTION_MAX_SERVOS];
+        for (int i = 0; i < servo_count_; i++) {
+            current[i] = output_->Read(i);
+        }
+        mask = safety_->Apply(positions, current, mask, now);
+    }
+    if (mask == 0) {
+        return;
+    }
+    for (int i = 0; i < servo_count_; i++) {
+        if (mask & (1 << i)) {
+            output_->Write(i, positions[i]);
+        }
+    }
+    output_->Commit();
+}
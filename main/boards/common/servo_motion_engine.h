@@ -0,0 +1,138 @@
+#ifndef _SERVO_MOTION_ENGINE_H_
+#define _SERVO_MOTION_ENGINE_H_
+
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/event_groups.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "motion_curve.h"
+
+class MotionSafety;
+
+/**
+ * @brief 舵机输出接口
+ *
+ * 引擎每个节拍先为所有参与运动的舵机调用 Write，再调用一次 Commit，
+ * 输出端可以在 Write 中只写入占空比，在 Commit 中统一生效。
+ */
+class ServoOutput {
+public:
+    virtual ~ServoOutput() = default;
+    virtual void Write(int servo, int position) = 0;
+    virtual int Read(int servo) = 0;
+    virtual void Commit() {}
+};
+
+/**
+ * @brief 实时舵机运动引擎
+ *
+ * 由周期为 kTickMs 的 esp_timer 驱动，与舵机 PWM 周期（20ms）一致。每个节拍用 Q15
+ * 定点查表（MotionCurve）一次算出所有舵机的位置，批量写入输出端。运动以轨迹段排队
+ * 提交，调用方不再需要忙等和 vTaskDelay，动作时序也不受其他任务占用 CPU 的影响。
+ */
+class ServoMotionEngine {
+public:
+    static constexpr int kTickMs = MOTION_TICK_MS;
+    static constexpr int kQueueLength = 8;
+    // 上一段不是振荡段时的过渡时长
+    static constexpr int kDefaultBlendMs = 200;
+
+    ServoMotionEngine(ServoOutput* output, int servo_count);
+    ~ServoMotionEngine();
+
+    void Start();
+    void Stop();
+
+    /**
+     * @brief 提交轨迹段，队列满时等待
+     */
+    bool Submit(const MotionSegment& segment, TickType_t timeout = portMAX_DELAY);
+
+    /**
+     * @brief 等待所有已提交的轨迹段执行完成
+     */
+    bool WaitIdle(TickType_t timeout = portMAX_DELAY);
+    bool IsIdle() const;
+
+    /**
+     * @brief 丢弃排队中的轨迹段，当前段继续执行
+     */
+    void Clear();
+
+    /**
+     * @brief 打断当前运动：丢弃所有轨迹段，从当前位置执行 ramp 过渡到安全姿态
+     *
+     * 之后的 Submit 都会被拒绝，正在执行的动作函数因此很快返回；调用 Resume 恢复。
+     */
+    void Cancel(const MotionSegment& ramp);
+    void Resume();
+    bool IsCancelled() const { return cancelled_; }
+
+    /**
+     * @brief 下一个开始的轨迹段与刚结束的段交叉过渡
+     *
+     * 上一段是振荡段时在半个周期内从它的延续渐变到新段，否则用 kDefaultBlendMs。
+     * 用于连续的动作之间，代替回到休息姿态。
+     */
+    void BlendNext() { blend_requested_ = true; }
+
+    int64_t max_tick_us() const { return max_tick_us_; }
+
+    /**
+     * @brief 设置输出限幅（见 MotionSafety），在 Start 之前调用
+     */
+    void SetSafety(MotionSafety* safety) { safety_ = safety; }
+
+private:
+    // 队列中的轨迹段，generation 与当前不同的段已被 Cancel 作废
+    struct QueuedSegment {
+        MotionSegment segment;
+        uint32_t generation;
+    };
+
+    static void TimerCallback(void* arg);
+    void Tick();
+    bool BeginNextSegment(int64_t start_us);
+    void StartSegment(int64_t start_us);
+    void FinishSegment();
+    void ReleaseSettling();
+    void Output(int16_t* positions, uint16_t mask, int64_t now);
+
+    ServoOutput* output_;
+    MotionSafety* safety_ = nullptr;
+    int servo_count_;
+    esp_timer_handle_t timer_ = nullptr;
+    QueueHandle_t queue_ = nullptr;
+    EventGroupHandle_t event_group_ = nullptr;
+
+    // 保护 pending_ 与空闲事件位，保证 Submit 和节拍之间不会丢失空闲状态
+    mutable std::mutex mutex_;
+    int pending_ = 0;
+    uint32_t generation_ = 0;
+    bool cancel_pending_ = false;
+    MotionSegment cancel_ramp_;
+    std::atomic<bool> cancelled_{false};
+    std::atomic<bool> blend_requested_{false};
+
+    // 以下只在节拍回调中访问
+    MotionSegment active_;
+    bool has_active_ = false;
+    int64_t segment_start_us_ = 0;
+    int16_t start_[MOTION_MAX_SERVOS] = {};
+    // 上一个结束的段，用于交叉过渡
+    MotionSegment previous_;
+    bool has_previous_ = false;
+    int64_t previous_start_us_ = 0;
+    int16_t previous_start_[MOTION_MAX_SERVOS] = {};
+    int64_t blend_us_ = 0;
+    // 持有一个未完成计数，等待限幅器把舵机送到最后的目标
+    bool settling_ = false;
+    int64_t max_tick_us_ = 0;
+};
+
+#endif // _SERVO_MOTION_ENGINE_H_
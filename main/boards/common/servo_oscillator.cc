@@ -1,22 +1,24 @@
-#include "oscillator.h"
+#include "servo_oscillator.h"
 
-#include <driver/ledc.h>
+#include <esp_log.h>
 #include <esp_timer.h>
 
 #include <algorithm>
 #include <cmath>
 
-static const char *TAG = "Oscillator";
+static const char *TAG = "ServoOscillator";
 
-// millis() 函数声明（实现在otto_movements.cc中）
-extern unsigned long millis();
-
-static ledc_channel_t next_free_channel = LEDC_CHANNEL_0;
+static unsigned long millis() {
+  return (unsigned long)(esp_timer_get_time() / 1000);
+}
 
-Oscillator::Oscillator(int trim) {
+ServoOscillator::ServoOscillator(int trim) {
   trim_ = trim;
   diff_limit_ = 0;
   is_attached_ = false;
+  bus_ = &PwmServoBus::GetInstance();
+  channel_ = -1;
+  pin_ = -1;
 
   // 提高采样频率，让动作更流畅 (v3优化)
   sampling_period_ = 20; // 20ms = 50Hz (原始:30ms = 33Hz)
@@ -40,10 +42,10 @@ Oscillator::Oscillator(int trim) {
   smoothing_factor_ = 0.5; // 平滑因子
 }
 
-Oscillator::~Oscillator() { Detach(); }
+ServoOscillator::~ServoOscillator() { Detach(); }
 
 // 缓动函数：三次方缓入缓出（更平滑的加速/减速）
-double Oscillator::EaseInOutCubic(double t) {
+double ServoOscillator::EaseInOutCubic(double t) {
   if (t < 0.5) {
     return 4 * t * t * t;
   } else {
@@ -53,7 +55,7 @@ double Oscillator::EaseInOutCubic(double t) {
 }
 
 // 缓动函数：二次方缓入缓出（较温和的平滑）
-double Oscillator::EaseInOutQuad(double t) {
+double ServoOscillator::EaseInOutQuad(double t) {
   if (t < 0.5) {
     return 2 * t * t;
   } else {
@@ -62,7 +64,7 @@ double Oscillator::EaseInOutQuad(double t) {
 }
 
 // S型曲线平滑函数
-double Oscillator::ApplySmoothing(double value) {
+double ServoOscillator::ApplySmoothing(double value) {
   if (smooth_level_ == SMOOTH_LEVEL_NONE) {
     return value;
   }
@@ -74,7 +76,7 @@ double Oscillator::ApplySmoothing(double value) {
   return smoothed_value;
 }
 
-void Oscillator::SetSmoothLevel(SmoothLevel level) {
+void ServoOscillator::SetSmoothLevel(SmoothLevel level) {
   smooth_level_ = level;
 
   // 根据平滑度等级设置平滑因子
@@ -95,7 +97,7 @@ void Oscillator::SetSmoothLevel(SmoothLevel level) {
 }
 
 // 优化的角度到脉宽转换（更精确）
-uint32_t Oscillator::AngleToCompare(int angle) {
+uint32_t ServoOscillator::AngleToCompare(int angle) {
   // 确保角度在有效范围内
   angle = (angle > 180) ? 180 : ((angle < 0) ? 0 : angle);
 
@@ -108,7 +110,7 @@ uint32_t Oscillator::AngleToCompare(int angle) {
   return pulsewidth_us;
 }
 
-bool Oscillator::NextSample() {
+bool ServoOscillator::NextSample() {
   current_millis_ = millis();
 
   if (current_millis_ - previous_millis_ >= sampling_period_) {
@@ -119,63 +121,53 @@ bool Oscillator::NextSample() {
   return false;
 }
 
-void Oscillator::Attach(int pin, bool rev) {
+void ServoOscillator::Attach(int pin, bool rev) {
+  rev_ = rev;
+  // 动作函数每次执行前都会 Attach，同一引脚不重新分配通道
+  if (is_attached_ && pin == pin_) {
+    return;
+  }
   if (is_attached_) {
     Detach();
   }
 
   pin_ = pin;
-  rev_ = rev;
-
-  ledc_timer_config_t ledc_timer = {};
-  ledc_timer.speed_mode = LEDC_LOW_SPEED_MODE;
-  ledc_timer.duty_resolution = LEDC_TIMER_13_BIT;
-  ledc_timer.timer_num = LEDC_TIMER_1;
-  ledc_timer.freq_hz = 50;
-  ledc_timer.clk_cfg = LEDC_AUTO_CLK;
-  ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-  static int last_channel = 0;
-  last_channel = (last_channel + 1) % 7 + 1;
-  ledc_channel_ = last_channel;
-
-  ledc_channel_config_t ledc_channel = {};
-  ledc_channel.gpio_num = pin_;
-  ledc_channel.speed_mode = LEDC_LOW_SPEED_MODE;
-  ledc_channel.channel = (ledc_channel_t)ledc_channel_;
-  ledc_channel.intr_type = LEDC_INTR_DISABLE;
-  ledc_channel.timer_sel = LEDC_TIMER_1;
-  ledc_channel.duty = 0;
-  ledc_channel.hpoint = 0;
-  ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-
-  ledc_speed_mode_ = LEDC_LOW_SPEED_MODE;
+  channel_ = bus_->Attach(pin_);
+  if (channel_ < 0) {
+    ESP_LOGE(TAG, "Servo on pin %d not attached", pin_);
+    return;
+  }
 
   previous_servo_command_millis_ = millis();
 
   is_attached_ = true;
 }
 
-void Oscillator::Detach() {
+void ServoOscillator::Detach() {
   if (!is_attached_)
     return;
 
-  ESP_ERROR_CHECK(ledc_stop((ledc_mode_t)ledc_speed_mode_,
-                            (ledc_channel_t)ledc_channel_, 0));
+  bus_->Detach(channel_);
+  channel_ = -1;
 
   is_attached_ = false;
 }
 
-void Oscillator::SetT(unsigned int T) {
+void ServoOscillator::SetBus(ServoBus* bus) {
+  Detach();
+  bus_ = bus;
+}
+
+void ServoOscillator::SetT(unsigned int T) {
   period_ = T;
 
   number_samples_ = (double)period_ / (double)sampling_period_;
   inc_ = 2 * M_PI / number_samples_;
 }
 
-void Oscillator::SetPosition(int position) { Write(position); }
+void ServoOscillator::SetPosition(int position) { Write(position); }
 
-void Oscillator::Refresh() {
+void ServoOscillator::Refresh() {
   if (NextSample()) {
     if (!stop_) {
       // 直接计算位置，不使用过度平滑避免延迟
@@ -189,7 +181,14 @@ void Oscillator::Refresh() {
   }
 }
 
-void Oscillator::Write(int position) {
+void ServoOscillator::Write(int position) {
+  Stage(position);
+  Update();
+}
+
+// 只把脉宽写入总线，Update 之后才在下一个 PWM 周期生效，
+// 运动引擎借此在一个节拍内先写完所有舵机再统一提交
+void ServoOscillator::Stage(int position) {
   if (!is_attached_)
     return;
 
@@ -231,13 +230,12 @@ void Oscillator::Write(int position) {
   // 优化的脉宽计算
   uint32_t pulsewidth_us = AngleToCompare(angle);
 
-  // 将脉宽转换为占空比
-  // PWM周期 = 20ms = 20000us
-  // duty = (pulsewidth_us / 20000) * 2^13
-  uint32_t duty = (pulsewidth_us * 8191) / 20000;
+  bus_->SetPulse(channel_, pulsewidth_us);
+}
+
+void ServoOscillator::Update() {
+  if (!is_attached_)
+    return;
 
-  ESP_ERROR_CHECK(ledc_set_duty((ledc_mode_t)ledc_speed_mode_,
-                                (ledc_channel_t)ledc_channel_, duty));
-  ESP_ERROR_CHECK(ledc_update_duty((ledc_mode_t)ledc_speed_mode_,
-                                   (ledc_channel_t)ledc_channel_));
+  bus_->Commit();
 }
@@ -1,9 +1,13 @@
-#ifndef __OSCILLATOR_SMOOTH_H__
-#define __OSCILLATOR_SMOOTH_H__
+#ifndef _SERVO_OSCILLATOR_H_
+#define _SERVO_OSCILLATOR_H_
 
 #include <stdint.h>
 
+#include "servo_bus.h"
+
+#ifndef M_PI
 #define M_PI 3.14159265358979323846
+#endif
 
 #ifndef DEG2RAD
 #define DEG2RAD(g) ((g) * M_PI) / 180
@@ -25,12 +29,20 @@ enum SmoothLevel {
     SMOOTH_LEVEL_HIGH = 3      // 高平滑度
 };
 
-class Oscillator {
+/**
+ * @brief 单个舵机的输出与振荡器，Otto 和 Dog 共用
+ *
+ * 与 electron-bot、palqiqi 自带的 Oscillator 同时编译进固件，所以换了名字。
+ */
+class ServoOscillator {
 public:
-    Oscillator(int trim = 0);
-    ~Oscillator();
+    ServoOscillator(int trim = 0);
+    ~ServoOscillator();
+    // 从总线分配输出通道；已连接在同一引脚上时保留原通道
     void Attach(int pin, bool rev = false);
     void Detach();
+    // 更换输出总线（默认片上 PWM），在 Attach 之前调用
+    void SetBus(ServoBus* bus);
 
     void SetA(unsigned int amplitude) { amplitude_ = amplitude; };
     void SetO(int offset) { offset_ = offset; };
@@ -41,6 +53,8 @@ public:
     void DisableLimiter() { diff_limit_ = 0; };
     int GetTrim() { return trim_; };
     void SetPosition(int position);
+    void Stage(int position);
+    void Update();
     void Stop() { stop_ = true; };
     void Play() { stop_ = false; };
     void Reset() { phase_ = 0; };
@@ -100,9 +114,9 @@ private:
     SmoothLevel smooth_level_;
     double smoothing_factor_;  // 平滑因子 (0.0 - 1.0)
 
-    int ledc_channel_;
-    int ledc_speed_mode_;
+    ServoBus* bus_;
+    int channel_;
 };
 
-#endif  // __OSCILLATOR_SMOOTH_H__
+#endif  // _SERVO_OSCILLATOR_H_
 
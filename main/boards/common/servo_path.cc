@@ -0,0 +1,43 @@
+#include "servo_path.h"
+
+bool MoveServosWithEase(ServoMotionEngine& engine, uint16_t mask, const int* target,
+                        int time, EaseType ease_type) {
+    if (mask == 0) {
+        return !engine.IsCancelled();
+    }
+    MotionSegment segment;
+    segment.type = kMotionMove;
+    segment.ease = (MotionEase)ease_type;
+    segment.mask = mask;
+    segment.duration_ms = time;
+    for (int i = 0; i < MOTION_MAX_SERVOS; i++) {
+        if (mask & (1 << i)) {
+            segment.target[i] = target[i];
+        }
+    }
+    if (!engine.Submit(segment)) {
+        return false;
+    }
+    engine.WaitIdle();
+    return true;
+}
+
+bool MoveServoPath(ServoMotionEngine& engine, int servo, const BezierWaypoint* waypoints,
+                   int count, int bias) {
+    if (servo < 0 || servo >= MOTION_MAX_SERVOS || count < 1) {
+        return true;
+    }
+    for (int i = 0; i < count; i++) {
+        MotionSegment segment;
+        segment.type = kMotionMove;
+        segment.ease = (MotionEase)waypoints[i].ease;
+        segment.mask = 1 << servo;
+        segment.duration_ms = waypoints[i].duration_ms;
+        segment.target[servo] = waypoints[i].position + bias;
+        if (!engine.Submit(segment)) {
+            return false;
+        }
+    }
+    engine.WaitIdle();
+    return true;
+}
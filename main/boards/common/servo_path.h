@@ -0,0 +1,44 @@
+#ifndef _SERVO_PATH_H_
+#define _SERVO_PATH_H_
+
+#include "servo_motion_engine.h"
+
+// 预定义的运动曲线类型，编号与 MotionEase 一致
+enum EaseType {
+    EASE_LINEAR = 0,      // 线性（无缓动）
+    EASE_IN_OUT = 1,      // 标准 S 型（默认）
+    EASE_IN = 2,          // 慢启动，快结束
+    EASE_OUT = 3,         // 快启动，慢结束
+    EASE_IN_BACK = 4,     // 回弹启动
+    EASE_OUT_BACK = 5,    // 回弹结束
+    EASE_OUT_BOUNCE = 6,  // 弹跳结束
+};
+
+// 贝塞尔路径点（用于多点轨迹）
+struct BezierWaypoint {
+    int position;      // 目标角度
+    int duration_ms;   // 到达此点的时间
+    EaseType ease;     // 缓动类型
+};
+
+// 最大路径点数
+#define MAX_WAYPOINTS 8
+
+/**
+ * @brief 把 mask 中的舵机按 ease 曲线移动到 target，提交一个移动段并等待完成
+ * @param target 按舵机编号的目标位置，只用到 mask 中的舵机
+ * @return 引擎已被 Cancel 时返回 false
+ */
+bool MoveServosWithEase(ServoMotionEngine& engine, uint16_t mask, const int* target,
+                        int time, EaseType ease_type);
+
+/**
+ * @brief 单个舵机依次经过多个路径点并等待完成
+ *
+ * 所有路径点一次排队，段与段之间由引擎无缝衔接。bias 加到每个路径点上（舵机微调）。
+ * @return 引擎已被 Cancel 时返回 false
+ */
+bool MoveServoPath(ServoMotionEngine& engine, int servo, const BezierWaypoint* waypoints,
+                   int count, int bias = 0);
+
+#endif // _SERVO_PATH_H_
@@ -3,6 +3,7 @@
 #include "board.h"
 #include "display.h"
 #include "settings.h"
+#include "persistent_store.h"
 
 #include <esp_log.h>
 #include <esp_sleep.h>
@@ -86,6 +87,8 @@ void SleepTimer::CheckTimer() {
             }
         
             app.Schedule([this, &app]() {
+                // 睡眠期间不会再有防抖定时器触发，先把缓存写入 Flash
+                PersistentStore::GetInstance().Flush();
                 while (in_light_sleep_mode_) {
                     auto& board = Board::GetInstance();
                     board.GetDisplay()->UpdateStatusBar(true);
@@ -118,6 +121,7 @@ void SleepTimer::CheckTimer() {
             on_enter_deep_sleep_mode_();
         }
 
+        PersistentStore::GetInstance().Flush();
         esp_deep_sleep_start();
     }
 }
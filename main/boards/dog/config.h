@@ -7,12 +7,24 @@
 #define POWER_ADC_UNIT ADC_UNIT_2
 #define POWER_ADC_CHANNEL ADC_CHANNEL_3
 
+// 舵机接在 PCA9685 扩展板上时取消注释（关节较多的机型），下面的舵机引脚为扩展板通道号
+// #define SERVO_PCA9685_I2C_ADDR 0x40
+// #define SERVO_PCA9685_SDA_PIN GPIO_NUM_1
+// #define SERVO_PCA9685_SCL_PIN GPIO_NUM_2
+
 // 桌面小狗舵机定义
 // 注意：舵机转轴平行于地面，脚可以垂直地面前后运动
+#ifdef SERVO_PCA9685_I2C_ADDR
+#define LEFT_REAR_LEG_PIN 0
+#define LEFT_FRONT_LEG_PIN 1
+#define RIGHT_FRONT_LEG_PIN 2
+#define RIGHT_REAR_LEG_PIN 3
+#else
 #define LEFT_REAR_LEG_PIN GPIO_NUM_39   // 左后腿（原palqiqi左腿）
 #define LEFT_FRONT_LEG_PIN GPIO_NUM_38  // 左前腿（原palqiqi左脚）
 #define RIGHT_FRONT_LEG_PIN GPIO_NUM_17 // 右前腿（原palqiqi右腿）
 #define RIGHT_REAR_LEG_PIN GPIO_NUM_18  // 右后腿（原palqiqi右脚）
+#endif
 
 #define AUDIO_INPUT_SAMPLE_RATE 16000
 #define AUDIO_OUTPUT_SAMPLE_RATE 16000 // 16kHz避免重采样，音质更好
@@ -4,6 +4,7 @@
 #include <esp_lcd_panel_ops.h>
 #include <esp_lcd_panel_vendor.h>
 #include <esp_log.h>
+#include <functional>
 #include <wifi_station.h>
 
 #include "application.h"
@@ -15,6 +16,7 @@
 #include "led/single_led.h"
 #include "mcp_server.h"
 #include "power_manager.h"
+#include "servo_bus.h"
 #include "system_reset.h"
 #include "wifi_board.h"
 
@@ -30,18 +32,39 @@
 
 #define TAG "Dog"
 
-extern void InitializeDogController();
+extern void InitializeDogController(std::function<int()> supply_voltage, int empty_mv, ServoBus* servo_bus);
 
 class DogBoard : public WifiBoard {
 private:
     LcdDisplay* display_;
     PowerManager* power_manager_;
+    ServoBus* servo_bus_ = nullptr;
     Button boot_button_;
     void InitializePowerManager() {
         power_manager_ =
             new PowerManager(POWER_CHARGE_DETECT_PIN, POWER_ADC_UNIT, POWER_ADC_CHANNEL);
     }
 
+    void InitializeServoBus() {
+#ifdef SERVO_PCA9685_I2C_ADDR
+        i2c_master_bus_handle_t i2c_bus = nullptr;
+        i2c_master_bus_config_t i2c_bus_cfg = {
+            .i2c_port = I2C_NUM_0,
+            .sda_io_num = SERVO_PCA9685_SDA_PIN,
+            .scl_io_num = SERVO_PCA9685_SCL_PIN,
+            .clk_source = I2C_CLK_SRC_DEFAULT,
+            .glitch_ignore_cnt = 7,
+            .intr_priority = 0,
+            .trans_queue_depth = 0,
+            .flags = {
+                .enable_internal_pullup = 1,
+            },
+        };
+        ESP_ERROR_CHECK(i2c_new_master_bus(&i2c_bus_cfg, &i2c_bus));
+        servo_bus_ = new Pca9685ServoBus(i2c_bus, SERVO_PCA9685_I2C_ADDR);
+#endif
+    }
+
     void InitializeSpi() {
         spi_bus_config_t buscfg = {};
         buscfg.mosi_io_num = DISPLAY_MOSI_PIN;
@@ -108,7 +131,10 @@ private:
 
     void InitializeDogController() {
         ESP_LOGI(TAG, "初始化桌面小狗机器人MCP控制器");
-        ::InitializeDogController();
+        // 舵机按电池电压降额，电压来自 PowerManager 最近一次的采样，不在节拍里读 ADC；
+        // 空电电压与电量校准一致
+        ::InitializeDogController([this]() { return power_manager_->GetBatteryVoltage(); },
+                                  power_manager_->GetEmptyVoltage(), servo_bus_);
     }
 
 public:
@@ -117,6 +143,7 @@ public:
         InitializeLcdDisplay();
         InitializeButtons();
         InitializePowerManager();
+        InitializeServoBus();
         InitializeDogController();
         GetBacklight()->RestoreBrightness();
     }
@@ -1,12 +1,18 @@
+#include "application.h"
 #include "board.h"
+#include "choreography.h"
 #include "config.h"
+#include "device_state_event.h"
 #include "dog_movements.h"
 #include "mcp_server.h"
+#include "motion_scheduler.h"
 #include "settings.h"
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
-#include <freertos/queue.h>
 #include <freertos/task.h>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
 #include <string>
 
 #define TAG "DogController"
@@ -18,6 +24,8 @@ struct DogActionParams {
   int speed;
   int direction;
   int amount;
+  char name[32];  // ACTION_CHOREOGRAPHY 的序列名称
+  uint32_t cancel_token;  // 发起动作的工具调用被取消后停止播放
 };
 
 // 动作类型枚举
@@ -27,64 +35,108 @@ enum ActionType {
   ACTION_HOME = 3,
   ACTION_TURN_RIGHT = 4,
   ACTION_TURN_LEFT = 5,
-  ACTION_SAY_HELLO = 6
+  ACTION_SAY_HELLO = 6,
+  ACTION_CHOREOGRAPHY = 7,
+  ACTION_SPEAK = 8
 };
 
 class DogController {
 private:
   Dog dog_;
-  TaskHandle_t action_task_handle_ = nullptr;
+  ChoreographyLibrary choreographies_{SERVO_COUNT};
+  // 动作按优先级调度：停止 > 用户指令 > 空闲复位，高优先级动作打断当前动作
+  MotionScheduler scheduler_{"dog_action", 1024 * 3, 5,
+                             [this]() { dog_.Cancel(); }};
   TaskHandle_t idle_task_handle_ = nullptr;
-  QueueHandle_t action_queue_;
-  bool is_action_in_progress_ = false;
 
-  static void ActionTask(void *arg) {
-    DogController *controller = static_cast<DogController *>(arg);
-    DogActionParams params;
-    controller->dog_.AttachServos();
+  static const char *ActionName(int action_type) {
+    static const char *const kNames[] = {
+        "", "walk_forward", "walk_backward", "home",
+        "turn_right", "turn_left", "say_hello", "choreography", "speak"};
+    if (action_type < 0 || action_type > ACTION_SPEAK) {
+      return "unknown";
+    }
+    return kNames[action_type];
+  }
 
-    while (true) {
-      if (xQueueReceive(controller->action_queue_, &params,
-                        pdMS_TO_TICKS(1000)) == pdTRUE) {
-        ESP_LOGI(TAG, "执行动作: %d", params.action_type);
-        controller->is_action_in_progress_ = true;
-
-        switch (params.action_type) {
-        case ACTION_WALK_FORWARD:
-          controller->dog_.WalkForward(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_WALK_BACKWARD:
-          controller->dog_.WalkBackward(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_TURN_RIGHT:
-          controller->dog_.TurnRight(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_TURN_LEFT:
-          controller->dog_.TurnLeft(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_SAY_HELLO:
-          controller->dog_.SayHello((int)params.steps, params.speed, params.amount);
-          break;
-        case ACTION_HOME:
-          controller->dog_.Home();
-          break;
-        default:
-          ESP_LOGW(TAG, "未知的动作类型: %d", params.action_type);
-          break;
-        }
-        
-        // 每个动作完成后自动回到中立位置(除非动作本身就是Home)
-        if (params.action_type != ACTION_HOME) {
-          ESP_LOGI(TAG, "动作完成，回到中立位置");
-          controller->dog_.Home();
-        }
-
-        controller->is_action_in_progress_ = false;
-        vTaskDelay(pdMS_TO_TICKS(20));
+  // 在调度器任务中执行一个动作
+  void RunAction(const DogActionParams &params) {
+    ESP_LOGI(TAG, "执行动作: %d", params.action_type);
+    dog_.Resume();
+
+    switch (params.action_type) {
+    case ACTION_WALK_FORWARD:
+      dog_.WalkForward(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_WALK_BACKWARD:
+      dog_.WalkBackward(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_TURN_RIGHT:
+      dog_.TurnRight(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_TURN_LEFT:
+      dog_.TurnLeft(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_SAY_HELLO:
+      dog_.SayHello((int)params.steps, params.speed, params.amount);
+      break;
+    case ACTION_HOME:
+      dog_.Home();
+      break;
+    case ACTION_CHOREOGRAPHY: {
+      size_t size = 0;
+      auto data = choreographies_.Find(params.name, size);
+      if (data != nullptr) {
+        uint32_t token = params.cancel_token;
+        dog_.PlayChoreography(data.get(), size, (int)params.steps, [token]() {
+          return McpServer::IsToolCallCancelled(token);
+        });
+      }
+      break;
+    }
+    case ACTION_SPEAK:
+      SpeakAlong();
+      break;
+    default:
+      ESP_LOGW(TAG, "未知的动作类型: %d", params.action_type);
+      break;
+    }
+
+    // 被打断时引擎已经在过渡到中立姿态
+    if (dog_.IsCancelled()) {
+      return;
+    }
+    // 每个动作完成后自动回到中立位置(除非动作本身就是Home)；后面还有动作时直接衔接
+    if (params.action_type != ACTION_HOME) {
+      if (scheduler_.HasPending()) {
+        dog_.BlendNext();
+      } else {
+        ESP_LOGI(TAG, "动作完成，回到中立位置");
+        dog_.Home();
       }
     }
   }
 
+  // 说话期间跟随 TTS 的响度和重音点头，有其他动作排队或说话结束时返回
+  void SpeakAlong() {
+    auto &app = Application::GetInstance();
+    const auto &channel = app.GetAudioService().speech_features();
+    SpeechFeatures features;
+    channel.Read(features);
+    uint8_t last_onset = features.onset_count;
+
+    while (app.GetDeviceState() == kDeviceStateSpeaking &&
+           !dog_.IsCancelled() && !scheduler_.HasPending()) {
+      if (!channel.Read(features)) {
+        dog_.SpeechGesture(0, false, SPEECH_HOP_MS * 4);
+        continue;
+      }
+      bool onset = features.onset_count != last_onset;
+      last_onset = features.onset_count;
+      dog_.SpeechGesture(features.level, onset);
+    }
+  }
+
   // 空闲时持续复位任务 - 参考palqiqi的IdleActionTask
   static void IdleResetTask(void *arg) {
     DogController *controller = static_cast<DogController *>(arg);
@@ -95,23 +147,41 @@ private:
     while (true) {
       vTaskDelay(pdMS_TO_TICKS(2000)); // 每2秒检查一次
       
-      // 如果没有动作正在执行，就复位
-      if (!controller->is_action_in_progress_) {
+      // 如果没有动作正在执行或排队，就复位
+      if (!controller->scheduler_.IsBusy() && !controller->dog_.GetRestState()) {
         ESP_LOGI(TAG, "空闲复位");
-        controller->dog_.Home();
+        controller->QueueAction(ACTION_HOME, 1, 1000, 0, 30,
+                                MotionScheduler::kPriorityIdle);
       }
     }
   }
 
   void QueueAction(ActionType action_type, float steps = 1, int speed = 1000,
-                   int direction = 0, int amount = 30) {
+                   int direction = 0, int amount = 30,
+                   MotionScheduler::Priority priority =
+                       MotionScheduler::kPriorityUser) {
     DogActionParams params = {
         .action_type = (int)action_type,
         .steps = steps,
         .speed = speed,
         .direction = direction,
         .amount = amount};
-    xQueueSend(action_queue_, &params, 0);
+    scheduler_.Submit(priority, ActionName(params.action_type),
+                      [this, params]() { RunAction(params); });
+  }
+
+  void QueueChoreography(const std::string &name, int repeat) {
+    DogActionParams params = {
+        .action_type = ACTION_CHOREOGRAPHY,
+        .steps = (float)repeat,
+        .speed = 0,
+        .direction = 0,
+        .amount = 0};
+    strlcpy(params.name, name.c_str(), sizeof(params.name));
+    // 打断说话时取消工具调用，正在播放的编排随之停止
+    params.cancel_token = McpServer::GetToolCallToken();
+    scheduler_.Submit(MotionScheduler::kPriorityUser, ActionName(params.action_type),
+                      [this, params]() { RunAction(params); });
   }
 
   void LoadTrims() {
@@ -126,13 +196,16 @@ private:
   }
 
 public:
-  DogController() {
+  DogController(std::function<int()> supply_voltage, int empty_mv,
+                ServoBus *servo_bus) {
+    if (servo_bus != nullptr) {
+      dog_.SetServoBus(servo_bus);
+    }
     // Init参数顺序: left_rear_leg, left_front_leg, right_front_leg, right_rear_leg
     dog_.Init(LEFT_REAR_LEG_PIN, LEFT_FRONT_LEG_PIN, RIGHT_FRONT_LEG_PIN,
               RIGHT_REAR_LEG_PIN);
+    dog_.SetSupplyVoltageSource(std::move(supply_voltage), empty_mv);
     ESP_LOGI(TAG, "Dog机器人初始化");
-    action_queue_ = xQueueCreate(10, sizeof(DogActionParams));
-    xTaskCreate(ActionTask, "dog_action", 1024 * 3, this, 5, &action_task_handle_);
     
     // 启动空闲复位任务
     xTaskCreate(IdleResetTask, "dog_idle_reset", 1024 * 2, this, 4, &idle_task_handle_);
@@ -141,6 +214,16 @@ public:
     
     // 开机时立即复位到中立位置
     dog_.Home();
+
+    // 开始说话时跟随语音点头，以空闲优先级提交，不影响其他动作指令
+    Application::GetInstance().GetAudioService().EnableSpeechAnalysis(true);
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [this](DeviceState previous_state, DeviceState current_state) {
+          if (current_state == kDeviceStateSpeaking) {
+            QueueAction(ACTION_SPEAK, 1, 0, 0, 0,
+                        MotionScheduler::kPriorityIdle);
+          }
+        });
     
     auto &mcp_server = McpServer::GetInstance();
 
@@ -219,15 +302,53 @@ public:
           return "OK";
         });
 
+    // 动作编排：序列由 scripts/choreography.py 生成
+    mcp_server.AddTool(
+        "self.dog.choreography.upload",
+        "上传动作编排序列（舞蹈/步态），保存在内存中直到重启。name: "
+        "序列名称(字母、数字、_、-); data: base64 编码的 XZCH 序列",
+        PropertyList({
+            Property("name", kPropertyTypeString),
+            Property("data", kPropertyTypeString),
+        }),
+        [this](const PropertyList &properties) -> ReturnValue {
+          std::string error;
+          if (!choreographies_.Upload(properties["name"].value<std::string>(),
+                                      properties["data"].value<std::string>(),
+                                      error)) {
+            throw std::runtime_error(error);
+          }
+          return "OK";
+        });
+
+    mcp_server.AddTool(
+        "self.dog.choreography.play",
+        "播放动作编排序列。name: 已上传的或内置的序列名称; repeat: 重复次数(1-20)",
+        PropertyList({
+            Property("name", kPropertyTypeString),
+            Property("repeat", kPropertyTypeInteger, 1, 1, 20),
+        }),
+        [this](const PropertyList &properties) -> ReturnValue {
+          std::string name = properties["name"].value<std::string>();
+          size_t size = 0;
+          if (choreographies_.Find(name, size) == nullptr) {
+            throw std::runtime_error("Unknown choreography: " + name);
+          }
+          QueueChoreography(name, properties["repeat"].value<int>());
+          return "OK";
+        });
+
     mcp_server.AddTool("self.dog.stop", "立即停止", PropertyList(),
                         [this](const PropertyList &properties) -> ReturnValue {
-                          dog_.Home();
+                          // 打断当前动作、清空队列，平滑回到中立姿态
+                          QueueAction(ACTION_HOME, 1, 1000, 0, 30,
+                                      MotionScheduler::kPrioritySafety);
                           return "OK";
                         });
 
     mcp_server.AddTool("self.dog.home", "回到休息姿态", PropertyList(),
                         [this](const PropertyList &properties) -> ReturnValue {
-                          dog_.Home();
+                          QueueAction(ACTION_HOME);
                           return "OK";
                         });
 
@@ -255,7 +376,7 @@ public:
 
           dog_.SetTrims(left_front_leg, right_front_leg, left_rear_leg,
                         right_rear_leg);
-          dog_.Home();
+          QueueAction(ACTION_HOME);
           return "OK";
         });
 
@@ -279,9 +400,24 @@ public:
                           return trims;
                         });
 
-    mcp_server.AddTool("self.dog.get_status", "获取机器人当前状态", PropertyList(),
+    mcp_server.AddTool("self.dog.get_status",
+                        "获取机器人当前状态。返回 JSON：state(moving/idle), action(当前动作), "
+                        "queue_depth(排队动作数), last_latency_ms/max_latency_ms"
+                        "(指令从提交到开始执行的延迟), completed, preempted(被打断次数), "
+                        "dropped(被丢弃的动作数)",
+                        PropertyList(),
+                        [this](const PropertyList &properties) -> ReturnValue {
+                          return scheduler_.GetStatusJson();
+                        });
+
+    mcp_server.AddTool("self.dog.get_motion_telemetry",
+                        "获取舵机运动的安全限幅遥测。返回 JSON：supply_mv(电源电压), "
+                        "supply_scale_pct(电压降额后的速度百分比), heat(每个舵机的温升估计), "
+                        "limited_ticks/budget_ticks(被限速/超出总线预算的节拍数), "
+                        "samples(最近约 6 秒、每 100ms 一条的记录，字段见 columns)",
+                        PropertyList(),
                         [this](const PropertyList &properties) -> ReturnValue {
-                          return is_action_in_progress_ ? "moving" : "idle";
+                          return dog_.GetMotionTelemetryJson();
                         });
 
     mcp_server.AddTool("self.battery.get_level", "获取机器人电池电量和充电状态",
@@ -300,27 +436,28 @@ public:
                           return status;
                         });
 
+    // 只读取内存中的状态，直接在收到请求的任务上执行，不排队等主循环
+    mcp_server.SetToolExecution("self.dog.get_status", kToolExecutionInline);
+    mcp_server.SetToolExecution("self.dog.get_motion_telemetry", kToolExecutionInline);
+    mcp_server.SetToolExecution("self.battery.get_level", kToolExecutionInline);
+
     ESP_LOGI(TAG, "MCP工具注册完成");
   }
 
   ~DogController() {
-    if (action_task_handle_ != nullptr) {
-      vTaskDelete(action_task_handle_);
-    }
     if (idle_task_handle_ != nullptr) {
       vTaskDelete(idle_task_handle_);
     }
-    if (action_queue_ != nullptr) {
-      vQueueDelete(action_queue_);
-    }
   }
 };
 
 static DogController *g_dog_controller = nullptr;
 
-void InitializeDogController() {
+void InitializeDogController(std::function<int()> supply_voltage, int empty_mv,
+                             ServoBus *servo_bus) {
   if (g_dog_controller == nullptr) {
-    g_dog_controller = new DogController();
+    g_dog_controller =
+        new DogController(std::move(supply_voltage), empty_mv, servo_bus);
   }
 }
 
@@ -1,55 +1,15 @@
 #include "dog_movements.h"
+#include "choreography.h"
 #include <math.h>
 #include <string.h>
+#include <algorithm>
 
 static const char *TAG = "DogMovements";
 
-// millis() 函数实现
-unsigned long IRAM_ATTR millis() {
-  return (unsigned long)(esp_timer_get_time() / 1000ULL);
-}
-
-// 缓动函数实现
-static float ApplyEasing(float t, EaseType ease_type) {
-  switch (ease_type) {
-  case EASE_LINEAR:
-    return t;
-  case EASE_IN_OUT: // S 型曲线
-    return t * t * (3.0f - 2.0f * t);
-  case EASE_IN: // 慢启动
-    return t * t;
-  case EASE_OUT: // 慢结束
-    return t * (2.0f - t);
-  case EASE_IN_BACK: // 回弹启动
-    return t * t * (2.70158f * t - 1.70158f);
-  case EASE_OUT_BACK: { // 回弹结束
-    float s = 1.70158f;
-    t -= 1.0f;
-    return t * t * ((s + 1.0f) * t + s) + 1.0f;
-  }
-  case EASE_OUT_BOUNCE: { // 弹跳结束
-    if (t < (1.0f / 2.75f)) {
-      return 7.5625f * t * t;
-    } else if (t < (2.0f / 2.75f)) {
-      t -= 1.5f / 2.75f;
-      return 7.5625f * t * t + 0.75f;
-    } else if (t < (2.5f / 2.75f)) {
-      t -= 2.25f / 2.75f;
-      return 7.5625f * t * t + 0.9375f;
-    } else {
-      t -= 2.625f / 2.75f;
-      return 7.5625f * t * t + 0.984375f;
-    }
-  }
-  default:
-    return t;
-  }
-}
-
 //--------------------------------------------------------------
 //-- Dog构造函数
 //--------------------------------------------------------------
-Dog::Dog() {
+Dog::Dog() : engine_(this, SERVO_COUNT) {
   is_dog_resting_ = false;
   for (int i = 0; i < SERVO_COUNT; i++) {
     servo_pins_[i] = 0;
@@ -58,12 +18,16 @@ Dog::Dog() {
   }
   final_time_ = 0;
   partial_time_ = 0;
+  engine_.SetSafety(&safety_);
 }
 
 //--------------------------------------------------------------
 //-- Dog析构函数
 //--------------------------------------------------------------
-Dog::~Dog() { DetachServos(); }
+Dog::~Dog() {
+  engine_.Stop();
+  DetachServos();
+}
 
 //--------------------------------------------------------------
 //-- Dog初始化
@@ -77,8 +41,48 @@ void Dog::Init(int left_rear_leg, int left_front_leg, int right_front_leg,
 
   AttachServos();
   is_dog_resting_ = false;
+  engine_.Start();
+}
+
+//--------------------------------------------------------------
+//-- 运动引擎输出（在引擎节拍中调用），位置已包含微调
+//--------------------------------------------------------------
+void Dog::Write(int servo, int position) { servo_[servo].Stage(position); }
+
+int Dog::Read(int servo) { return servo_[servo].GetPosition(); }
+
+// 所有舵机在同一个 PWM 周期生效
+void Dog::Commit() { bus_->Commit(); }
+
+void Dog::Hold(int time) {
+  MotionSegment segment;
+  segment.type = kMotionHold;
+  segment.duration_ms = time;
+  if (engine_.Submit(segment)) {
+    engine_.WaitIdle();
+  }
 }
 
+//--------------------------------------------------------------
+//-- 打断与衔接
+//--------------------------------------------------------------
+void Dog::Cancel(int ramp_ms) {
+  MotionSegment ramp;
+  ramp.type = kMotionMove;
+  ramp.ease = kMotionEaseInOut;
+  ramp.mask = (1 << SERVO_COUNT) - 1;
+  ramp.duration_ms = ramp_ms;
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    ramp.target[i] = 90 + servo_trim_[i];
+  }
+  engine_.Cancel(ramp);
+  is_dog_resting_ = false;
+}
+
+void Dog::Resume() { engine_.Resume(); }
+
+void Dog::BlendNext() { engine_.BlendNext(); }
+
 //--------------------------------------------------------------
 //-- 连接舵机
 //--------------------------------------------------------------
@@ -88,6 +92,16 @@ void Dog::AttachServos() {
   }
 }
 
+//--------------------------------------------------------------
+//-- 更换舵机输出总线
+//--------------------------------------------------------------
+void Dog::SetServoBus(ServoBus* bus) {
+  bus_ = bus;
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    servo_[i].SetBus(bus);
+  }
+}
+
 //--------------------------------------------------------------
 //-- 断开舵机
 //--------------------------------------------------------------
@@ -106,39 +120,35 @@ void Dog::SetTrims(int left_rear_leg, int left_front_leg, int right_front_leg,
   servo_trim_[LEFT_FRONT_LEG] = left_front_leg;
   servo_trim_[RIGHT_FRONT_LEG] = right_front_leg;
   servo_trim_[RIGHT_REAR_LEG] = right_rear_leg;
+  // 引擎中的位置含微调，降幅时向微调后的中位收缩
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    safety_.SetNeutral(i, 90 + servo_trim_[i]);
+  }
 }
 
 //--------------------------------------------------------------
 //-- 移动所有舵机到指定位置
 //--------------------------------------------------------------
 void Dog::MoveServos(int time, int servo_target[]) {
+  if (engine_.IsCancelled()) {
+    return;
+  }
   AttachServos();
   if (GetRestState() == true) {
     SetRestState(false);
   }
 
-  if (time > 10) {
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      increment_[i] = ((servo_target[i]) - servo_[i].GetPosition()) / (time / 10.0);
-    }
-
-    final_time_ = esp_timer_get_time() / 1000 + time;
-
-    for (int iteration = 1; esp_timer_get_time() / 1000 < final_time_; iteration++) {
-      partial_time_ = esp_timer_get_time() / 1000 + 10;
-      for (int i = 0; i < SERVO_COUNT; i++) {
-        servo_[i].SetPosition(servo_[i].GetPosition() + increment_[i]);
-      }
-      while (esp_timer_get_time() / 1000 < partial_time_)
-        ; // 等待
-    }
-  } else {
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      servo_[i].SetPosition(servo_target[i] + servo_trim_[i]);
-    }
-  }
+  // 线性插值，由引擎按节拍执行；time <= 10 的动作也经过限幅器，不直接写舵机
+  MotionSegment segment;
+  segment.type = kMotionMove;
+  segment.ease = kMotionEaseLinear;
+  segment.mask = (1 << SERVO_COUNT) - 1;
+  segment.duration_ms = std::max(time, 0);
   for (int i = 0; i < SERVO_COUNT; i++) {
-    servo_[i].SetPosition(servo_target[i] + servo_trim_[i]);
+    segment.target[i] = servo_target[i] + servo_trim_[i];
+  }
+  if (engine_.Submit(segment)) {
+    engine_.WaitIdle();
   }
 }
 
@@ -162,21 +172,18 @@ void Dog::MoveSingle(int position, int servo_number) {
 //--------------------------------------------------------------
 void Dog::OscillateServos(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT],
                           int period, double phase_diff[SERVO_COUNT], float cycle) {
+  MotionSegment segment;
+  segment.type = kMotionOscillate;
+  segment.mask = (1 << SERVO_COUNT) - 1;
+  segment.period_ms = period;
+  segment.duration_ms = period * cycle;
   for (int i = 0; i < SERVO_COUNT; i++) {
-    servo_[i].SetO(offset[i]);
-    servo_[i].SetA(amplitude[i]);
-    servo_[i].SetT(period);
-    servo_[i].SetPh(phase_diff[i]);
+    segment.amplitude[i] = amplitude[i];
+    segment.offset[i] = offset[i];
+    segment.phase[i] = MotionCurve::PhaseFromRadians(phase_diff[i]);
   }
-  unsigned long ref = esp_timer_get_time() / 1000;
-  unsigned long end_time = ref + (unsigned long)(period * cycle);
-  
-  while (esp_timer_get_time() / 1000 <= end_time) {
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      servo_[i].Refresh();
-    }
-    // 添加延迟以避免看门狗超时，10ms对舵机控制来说足够快
-    vTaskDelay(pdMS_TO_TICKS(10));
+  if (engine_.Submit(segment)) {
+    engine_.WaitIdle();
   }
 }
 
@@ -196,6 +203,10 @@ void Dog::Execute(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT], int perio
 //-- HOME = Dog休息姿态
 //--------------------------------------------------------------
 void Dog::Home() {
+  // 被打断时引擎正在过渡到中立姿态，不能断开舵机
+  if (engine_.IsCancelled()) {
+    return;
+  }
   if (is_dog_resting_ == false) {
     int servo_position[SERVO_COUNT] = {90, 90, 90, 90};
     MoveServos(500, servo_position);
@@ -347,6 +358,9 @@ void Dog::WalkForward(float steps, int period, int amount) {
       MoveServosWithEase(step_time, target, EASE_IN_OUT);
     }
     
+    if (engine_.IsCancelled()) {
+      break;
+    }
     // 添加延迟避免看门狗超时
     vTaskDelay(pdMS_TO_TICKS(10));
   }
@@ -477,6 +491,9 @@ void Dog::WalkBackward(float steps, int period, int amount) {
       MoveServosWithEase(step_time, target, EASE_IN_OUT);
     }
     
+    if (engine_.IsCancelled()) {
+      break;
+    }
     // 添加延迟避免看门狗超时
     vTaskDelay(pdMS_TO_TICKS(10));
   }
@@ -557,6 +574,9 @@ void Dog::TurnRight(float steps, int period, int amount) {
       MoveServosWithEase(step_time, target, EASE_IN_OUT);
     }
     
+    if (engine_.IsCancelled()) {
+      break;
+    }
     // 添加延迟避免看门狗超时
     vTaskDelay(pdMS_TO_TICKS(10));
   }
@@ -648,6 +668,9 @@ void Dog::TurnLeft(float steps, int period, int amount) {
       MoveServosWithEase(step_time, target, EASE_IN_OUT);
     }
     
+    if (engine_.IsCancelled()) {
+      break;
+    }
     // 添加延迟避免看门狗超时
     vTaskDelay(pdMS_TO_TICKS(10));
   }
@@ -655,6 +678,16 @@ void Dog::TurnLeft(float steps, int period, int amount) {
   // 注意: Home()由controller统一调用,这里不调用
 }
 
+//--------------------------------------------------------------
+//-- 说话时跟随语音点头
+//-- 左侧：角度增大 = 向前摆；右侧：角度减小 = 向前摆
+//--------------------------------------------------------------
+void Dog::SpeechGesture(int level, bool onset, int time) {
+  int bob = level * 6 / 255 + (onset ? 6 : 0);
+  int target[SERVO_COUNT] = {90, 90 + bob, 90 - bob, 90};
+  MoveServos(time, target);
+}
+
 //--------------------------------------------------------------
 //-- Dog打招呼动作 - 模仿小狗招手
 //-- 步态说明：
@@ -700,7 +733,7 @@ void Dog::SayHello(int wave_times, int period, int amount) {
   }
   
   // 稍等一下稳定
-  vTaskDelay(pdMS_TO_TICKS(200));
+  Hold(200);
   
   // ========== 第2步：左前脚来回摆动（招手）==========
   for (int i = 0; i < wave_times; i++) {
@@ -726,6 +759,9 @@ void Dog::SayHello(int wave_times, int period, int amount) {
       MoveServosWithEase(period / 2, target, EASE_IN_OUT);
     }
     
+    if (engine_.IsCancelled()) {
+      break;
+    }
     vTaskDelay(pdMS_TO_TICKS(10));
   }
   
@@ -741,7 +777,7 @@ void Dog::SayHello(int wave_times, int period, int amount) {
   }
   
   // 稍等一下
-  vTaskDelay(pdMS_TO_TICKS(200));
+  Hold(200);
   
   // ========== 第4步：后两腿回中立 ==========
   {
@@ -761,51 +797,32 @@ void Dog::SayHello(int wave_times, int period, int amount) {
 //-- 使用缓动函数移动舵机
 //--------------------------------------------------------------
 void Dog::MoveServosWithEase(int time, int servo_target[], EaseType ease_type) {
+  if (engine_.IsCancelled()) {
+    return;
+  }
   AttachServos();
   if (GetRestState() == true) {
     SetRestState(false);
   }
 
-  if (time > 10) {
-    int start_position[SERVO_COUNT];
-    bool need_move[SERVO_COUNT];  // 标记哪些舵机需要移动
-    
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      start_position[i] = servo_[i].GetPosition();
-      // 计算是否需要移动：如果起始位置和目标位置差异很小（<5度），则不需要移动
-      // 舵机读取误差可能达到±2-3度，用5度阈值确保静止的腿不会抖动
-      int delta = abs(servo_target[i] - start_position[i]);
-      need_move[i] = (delta >= 5);
-      
-      // 对于不需要移动的舵机，直接设置目标位置，避免累积误差
-      if (!need_move[i]) {
-        servo_[i].SetPosition(servo_target[i] + servo_trim_[i]);
-      }
-    }
-
-    unsigned long start_time = esp_timer_get_time() / 1000;
-    unsigned long end_time = start_time + time;
-
-    while (esp_timer_get_time() / 1000 < end_time) {
-      float progress = (float)(esp_timer_get_time() / 1000 - start_time) / time;
-      progress = fminf(progress, 1.0f);
-      float eased = ApplyEasing(progress, ease_type);
-
-      for (int i = 0; i < SERVO_COUNT; i++) {
-        // 只移动需要移动的舵机
-        if (need_move[i]) {
-          int delta = servo_target[i] - start_position[i];
-          servo_[i].SetPosition(start_position[i] + (int)(delta * eased) + servo_trim_[i]);
-        }
-      }
-      vTaskDelay(pdMS_TO_TICKS(10));
-    }
-  }
-
-  // 确保到达最终位置
+  int target[SERVO_COUNT];
+  uint16_t eased = 0;
+  uint16_t snapped = 0;
   for (int i = 0; i < SERVO_COUNT; i++) {
-    servo_[i].SetPosition(servo_target[i] + servo_trim_[i]);
+    // 差异很小（<5度）的舵机直接到达目标位置，不参与插值
+    // 舵机读取误差可能达到±2-3度，用5度阈值确保静止的腿不会抖动
+    target[i] = servo_target[i] + servo_trim_[i];
+    if (time > 10 && abs(target[i] - servo_[i].GetPosition()) >= 5) {
+      eased |= 1 << i;
+    } else {
+      snapped |= 1 << i;
+    }
+  }
+  // 直接到位的舵机也是一个零时长的段，和插值段一样经过限幅器
+  if (!::MoveServosWithEase(engine_, snapped, target, 0, EASE_LINEAR)) {
+    return;
   }
+  ::MoveServosWithEase(engine_, eased, target, time, ease_type);
 }
 
 //--------------------------------------------------------------
@@ -821,30 +838,30 @@ void Dog::MoveServoPath(int servo_index, BezierWaypoint waypoints[], int count)
     SetRestState(false);
   }
 
-  int current_position = servo_[servo_index].GetPosition();
-
-  for (int wp = 0; wp < count; wp++) {
-    int target_position = waypoints[wp].position;
-    int duration = waypoints[wp].duration_ms;
-    EaseType ease = waypoints[wp].ease;
-
-    unsigned long start_time = esp_timer_get_time() / 1000;
-    unsigned long end_time = start_time + duration;
-
-    while (esp_timer_get_time() / 1000 < end_time) {
-      float progress = (float)(esp_timer_get_time() / 1000 - start_time) / duration;
-      progress = fminf(progress, 1.0f);
-      float eased = ApplyEasing(progress, ease);
+  ::MoveServoPath(engine_, servo_index, waypoints, count, servo_trim_[servo_index]);
+}
 
-      int delta = target_position - current_position;
-      servo_[servo_index].SetPosition(current_position + (int)(delta * eased) +
-                                      servo_trim_[servo_index]);
-      vTaskDelay(pdMS_TO_TICKS(10));
-    }
+//--------------------------------------------------------------
+//-- 播放动作编排序列
+//--------------------------------------------------------------
+bool Dog::PlayChoreography(const uint8_t* data, size_t size, int repeat,
+                           const std::function<bool()>& cancelled) {
+  if (GetRestState() == true) {
+    SetRestState(false);
+  }
 
-    servo_[servo_index].SetPosition(target_position + servo_trim_[servo_index]);
-    current_position = target_position;
+  ChoreographyPlayer player(engine_, SERVO_COUNT, (1 << SERVO_COUNT) - 1);
+  // 引擎中的位置已包含微调
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    player.SetBias(i, servo_trim_[i]);
+  }
+  if (player.Play(data, size, repeat, cancelled)) {
+    return true;
+  }
+  if (!IsCancelled()) {
+    Cancel();
   }
+  return false;
 }
 
 //--------------------------------------------------------------
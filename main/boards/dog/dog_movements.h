@@ -6,7 +6,13 @@
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "oscillator.h"
+#include "motion_safety.h"
+#include "servo_motion_engine.h"
+#include "servo_oscillator.h"
+#include "servo_path.h"
+
+#include <functional>
+#include <string>
 
 //-- Constants
 #define FORWARD 1
@@ -28,29 +34,7 @@
 #define RIGHT_REAR_LEG 3  // 右后腿（原palqiqi右脚）
 #define SERVO_COUNT 4
 
-// 预定义的运动曲线类型
-enum EaseType {
-  EASE_LINEAR = 0,      // 线性（无缓动）
-  EASE_IN_OUT = 1,      // 标准 S 型（默认）
-  EASE_IN = 2,          // 慢启动，快结束
-  EASE_OUT = 3,         // 快启动，慢结束
-  EASE_IN_BACK = 4,     // 回弹启动
-  EASE_OUT_BACK = 5,    // 回弹结束
-  EASE_OUT_BOUNCE = 6,  // 弹跳结束
-};
-
-// 贝塞尔路径点（用于多点轨迹）
-struct BezierWaypoint {
-  int position;      // 目标角度
-  int duration_ms;   // 到达此点的时间
-  EaseType ease;     // 缓动类型
-};
-
-// 最大路径点数
-#define MAX_WAYPOINTS 8
-
-
-class Dog {
+class Dog : private ServoOutput {
 public:
   Dog();
   ~Dog();
@@ -61,6 +45,8 @@ public:
   //-- Attach & detach functions
   void AttachServos();
   void DetachServos();
+  // 舵机输出总线，默认片上 PWM；关节较多的机型可换成 PCA9685，在 Init 之前调用
+  void SetServoBus(ServoBus* bus);
 
   //-- Oscillator Trims
   void SetTrims(int left_rear_leg, int left_front_leg, int right_front_leg, int right_rear_leg);
@@ -117,16 +103,48 @@ public:
    */
   void SayHello(int wave_times = 5, int period = 500, int amount = 30);
 
+  /**
+   * 说话时跟随语音点头 - 前腿随响度前后摆动，重音时幅度更大
+   * @param level 当前语音响度 0..255
+   * @param onset 是否刚出现重音
+   * @param time 动作时间（毫秒）
+   */
+  void SpeechGesture(int level, bool onset = false, int time = 120);
+
   // -- 贝塞尔曲线轨迹运动（更平滑）
   void MoveServosWithEase(int time, int servo_target[], EaseType ease_type);
   void MoveServoPath(int servo_index, BezierWaypoint waypoints[], int count);
 
+  // -- 动作编排序列（格式见 choreography.h），播放 repeat 遍并等待完成；
+  //    cancelled 返回 true 时平滑回到休息姿态并返回 false
+  bool PlayChoreography(const uint8_t* data, size_t size, int repeat = 1,
+                        const std::function<bool()>& cancelled = nullptr);
+
+  // -- 打断与衔接（由动作调度器调用）
+  // 打断正在执行的动作，ramp_ms 内平滑回到中立姿态；动作函数随即返回，Resume 之后才能再动
+  void Cancel(int ramp_ms = 300);
+  void Resume();
+  bool IsCancelled() const { return engine_.IsCancelled(); }
+  // 下一个动作与当前动作的末尾交叉过渡，不回到休息姿态
+  void BlendNext();
+
   // -- Servo limiter
   void EnableServoLimit(int speed_limit_degree_per_sec = SERVO_LIMIT_DEFAULT);
   void DisableServoLimit();
 
+  // -- 运动安全：电源电压来源（毫伏）和电池空电电压用于欠压前降额，遥测见 MotionSafety
+  void SetSupplyVoltageSource(std::function<int()> source, int empty_mv) {
+    safety_.SetSupplyVoltageSource(std::move(source), empty_mv);
+  }
+  std::string GetMotionTelemetryJson() const { return safety_.GetTelemetryJson(); }
+
 private:
-  Oscillator servo_[SERVO_COUNT];
+  ServoOscillator servo_[SERVO_COUNT];
+  ServoBus* bus_ = &PwmServoBus::GetInstance();
+  // 限制速度、浪涌和温升，在引擎写入 servo_ 之前生效
+  MotionSafety safety_{SERVO_COUNT};
+  // 运动引擎按节拍驱动 servo_，动作函数只提交轨迹段并等待完成
+  ServoMotionEngine engine_;
 
   int servo_pins_[SERVO_COUNT];
   int servo_trim_[SERVO_COUNT];
@@ -137,6 +155,14 @@ private:
 
   bool is_dog_resting_;
 
+  // -- ServoOutput
+  void Write(int servo, int position) override;
+  int Read(int servo) override;
+  void Commit() override;
+
+  // 保持当前姿态（引擎保持段，可被 Cancel 打断）
+  void Hold(int time);
+
   // -- Advanced oscillation
   void Execute(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT], int period,
                double phase_diff[SERVO_COUNT], float steps);
@@ -14,13 +14,15 @@ private:
         uint8_t level;
     } BATTERY_LEVELS[] = {{2150, 0}, {2450, 100}};
     static constexpr size_t BATTERY_LEVELS_COUNT = 2;
-    static constexpr size_t ADC_VALUES_COUNT = 10;
+    // 每 200ms 采样一次，电量取最近 10 秒的平均值
+    static constexpr size_t ADC_VALUES_COUNT = 50;
 
     esp_timer_handle_t timer_handle_ = nullptr;
     gpio_num_t charging_pin_;
     adc_unit_t adc_unit_;
     adc_channel_t adc_channel_;
     uint16_t adc_values_[ADC_VALUES_COUNT];
+    uint16_t last_adc_value_ = 0;
     size_t adc_values_index_ = 0;
     size_t adc_values_count_ = 0;
     uint8_t battery_level_ = 100;
@@ -28,6 +30,9 @@ private:
 
     adc_oneshot_unit_handle_t adc_handle_;
 
+    // 12dB 衰减下满量程约 3100mV，分压电阻为 2 个 100k
+    static int AdcToMillivolts(int adc) { return adc * 3100 / 4095 * 2; }
+
     void CheckBatteryStatus() {
         is_charging_ = gpio_get_level(charging_pin_) == 0;
         ReadBatteryAdcData();
@@ -38,6 +43,7 @@ private:
         ESP_ERROR_CHECK(adc_oneshot_read(adc_handle_, adc_channel_, &adc_value));
 
         adc_values_[adc_values_index_] = adc_value;
+        last_adc_value_ = adc_value;
         adc_values_index_ = (adc_values_index_ + 1) % ADC_VALUES_COUNT;
         if (adc_values_count_ < ADC_VALUES_COUNT) {
             adc_values_count_++;
@@ -91,7 +97,7 @@ public:
             .skip_unhandled_events = true,
         };
         ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer_handle_));
-        ESP_ERROR_CHECK(esp_timer_start_periodic(timer_handle_, 1000000));  // 1秒
+        ESP_ERROR_CHECK(esp_timer_start_periodic(timer_handle_, 200000));  // 200毫秒
 
         InitializeAdc();
     }
@@ -124,5 +130,11 @@ public:
     bool IsCharging() { return is_charging_; }
 
     uint8_t GetBatteryLevel() { return battery_level_; }
+
+    // 电池电压（毫伏），取最近一次采样，舵机负载下的压降能及时反映出来；尚未采样时返回 0
+    int GetBatteryVoltage() { return AdcToMillivolts(last_adc_value_); }
+
+    // 电量为 0% 时的电池电压，与 BATTERY_LEVELS 的校准一致
+    int GetEmptyVoltage() { return AdcToMillivolts(BATTERY_LEVELS[0].adc); }
 };
 #endif  // __POWER_MANAGER_H__
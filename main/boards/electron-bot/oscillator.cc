@@ -1,6 +1,6 @@
 #include "oscillator.h"
 
-#include <driver/ledc.h>
+#include <esp_log.h>
 #include <esp_timer.h>
 
 #include <algorithm>
@@ -12,6 +12,7 @@ Oscillator::Oscillator(int trim) {
     trim_ = trim;
     diff_limit_ = 0;
     is_attached_ = false;
+    channel_ = -1;
 
     sampling_period_ = 30;
     period_ = 2000;
@@ -58,27 +59,11 @@ void Oscillator::Attach(int pin, bool rev) {
     pin_ = pin;
     rev_ = rev;
 
-    ledc_timer_config_t ledc_timer = {.speed_mode = LEDC_LOW_SPEED_MODE,
-                                      .duty_resolution = LEDC_TIMER_13_BIT,
-                                      .timer_num = LEDC_TIMER_1,
-                                      .freq_hz = 50,
-                                      .clk_cfg = LEDC_AUTO_CLK};
-    ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-    static int last_channel = 0;
-    last_channel = (last_channel + 1) % 7 + 1;
-    ledc_channel_ = (ledc_channel_t)last_channel;
-
-    ledc_channel_config_t ledc_channel = {.gpio_num = pin_,
-                                          .speed_mode = LEDC_LOW_SPEED_MODE,
-                                          .channel = ledc_channel_,
-                                          .intr_type = LEDC_INTR_DISABLE,
-                                          .timer_sel = LEDC_TIMER_1,
-                                          .duty = 0,
-                                          .hpoint = 0};
-    ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-
-    ledc_speed_mode_ = LEDC_LOW_SPEED_MODE;
+    channel_ = PwmServoBus::GetInstance().Attach(pin_);
+    if (channel_ < 0) {
+        ESP_LOGE("Oscillator", "Servo on pin %d not attached", pin_);
+        return;
+    }
 
     // pos_ = 90;
     // Write(pos_);
@@ -91,7 +76,8 @@ void Oscillator::Detach() {
     if (!is_attached_)
         return;
 
-    ESP_ERROR_CHECK(ledc_stop(ledc_speed_mode_, ledc_channel_, 0));
+    PwmServoBus::GetInstance().Detach(channel_);
+    channel_ = -1;
 
     is_attached_ = false;
 }
@@ -142,8 +128,10 @@ void Oscillator::Write(int position) {
 
     angle = std::min(std::max(angle, 0), 180);
 
-    uint32_t duty = (uint32_t)(((angle / 180.0) * 2.0 + 0.5) * 8191 / 20.0);
+    // 0.5ms ~ 2.5ms 对应 0 ~ 180 度
+    uint16_t pulse_us = 500 + angle * 2000 / 180;
 
-    ESP_ERROR_CHECK(ledc_set_duty(ledc_speed_mode_, ledc_channel_, duty));
-    ESP_ERROR_CHECK(ledc_update_duty(ledc_speed_mode_, ledc_channel_));
+    auto& bus = PwmServoBus::GetInstance();
+    bus.SetPulse(channel_, pulse_us);
+    bus.Commit();
 }
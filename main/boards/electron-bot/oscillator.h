@@ -1,10 +1,10 @@
 #ifndef __OSCILLATOR_H__
 #define __OSCILLATOR_H__
 
-#include "driver/ledc.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "servo_bus.h"
 
 #define M_PI 3.14159265358979323846
 
@@ -76,8 +76,7 @@ private:
     int diff_limit_;
     long previous_servo_command_millis_;
 
-    ledc_channel_t ledc_channel_;
-    ledc_mode_t ledc_speed_mode_;
+    int channel_;
 };
 
 #endif  // __OSCILLATOR_H__
\ No newline at end of file
@@ -7,12 +7,16 @@
 #include <esp_random.h>
 
 #include <cstring>
+#include <functional>
+#include <stdexcept>
 
 #include "application.h"
 #include "board.h"
+#include "choreography.h"
 #include "config.h"
 #include "device_state_event.h"
 #include "mcp_server.h"
+#include "motion_scheduler.h"
 #include "otto_movements.h"
 #include "sdkconfig.h"
 #include "settings.h"
@@ -27,20 +31,31 @@
 class OttoController {
 private:
   Otto otto_;
-  TaskHandle_t action_task_handle_ = nullptr;
+  ChoreographyLibrary choreographies_{SERVO_COUNT};
+  // 动作按优先级调度：停止 > 用户指令 > 空闲动作，高优先级动作打断当前动作
+  MotionScheduler scheduler_{"otto_action", 1024 * 3, configMAX_PRIORITIES - 1,
+                             [this]() { otto_.Cancel(); }};
   TaskHandle_t idle_task_handle_ = nullptr;
-  QueueHandle_t action_queue_;
   bool has_hands_ = false;
-  bool is_action_in_progress_ = false;
   bool idle_actions_enabled_ = true;
   uint32_t last_idle_action_time_ = 0;
 
+  // 移动类 MCP 工具的参数，直接由 McpServer 绑定
+  struct MotionArgs {
+    int steps;
+    int speed;
+    int arm_swing;
+    int direction;
+  };
+
   struct OttoActionParams {
     int action_type;
     int steps;
     int speed;
     int direction;
     int amount;
+    char name[32];  // ACTION_CHOREOGRAPHY 的序列名称
+    uint32_t cancel_token;  // 发起动作的工具调用被取消后停止播放
   };
 
   enum ActionType {
@@ -61,103 +76,162 @@ private:
     ACTION_HANDS_DOWN = 15,
     ACTION_HAND_WAVE = 16,
     ACTION_HOME = 17,
-    ACTION_LOOK_AROUND = 18
+    ACTION_LOOK_AROUND = 18,
+    ACTION_CHOREOGRAPHY = 19,
+    ACTION_SPEAK = 20
   };
 
-  static void ActionTask(void *arg) {
-    OttoController *controller = static_cast<OttoController *>(arg);
-    OttoActionParams params;
-    controller->otto_.AttachServos();
+  static const char *ActionName(int action_type) {
+    static const char *const kNames[] = {
+        "",          "walk",         "turn",           "jump",
+        "swing",     "moonwalk",     "bend",           "shake_leg",
+        "updown",    "tiptoe_swing", "jitter",         "ascending_turn",
+        "crusaito",  "flapping",     "hands_up",       "hands_down",
+        "hand_wave", "home",         "look_around",    "choreography",
+        "speak"};
+    if (action_type < 0 || action_type > ACTION_SPEAK) {
+      return "unknown";
+    }
+    return kNames[action_type];
+  }
 
-    while (true) {
-      if (xQueueReceive(controller->action_queue_, &params,
-                        pdMS_TO_TICKS(1000)) == pdTRUE) {
-        ESP_LOGI(TAG, "执行动作: %d", params.action_type);
-        controller->is_action_in_progress_ = true;
-
-        switch (params.action_type) {
-        case ACTION_WALK:
-          controller->otto_.Walk(params.steps, params.speed, params.direction,
-                                 params.amount);
-          break;
-        case ACTION_TURN:
-          controller->otto_.Turn(params.steps, params.speed, params.direction,
-                                 params.amount);
-          break;
-        case ACTION_JUMP:
-          controller->otto_.Jump(params.steps, params.speed);
-          break;
-        case ACTION_SWING:
-          controller->otto_.Swing(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_MOONWALK:
-          controller->otto_.Moonwalker(params.steps, params.speed,
-                                       params.amount, params.direction);
-          break;
-        case ACTION_BEND:
-          controller->otto_.Bend(params.steps, params.speed, params.direction);
-          break;
-        case ACTION_SHAKE_LEG:
-          controller->otto_.ShakeLeg(params.steps, params.speed,
-                                     params.direction);
-          break;
-        case ACTION_UPDOWN:
-          controller->otto_.UpDown(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_TIPTOE_SWING:
-          controller->otto_.TiptoeSwing(params.steps, params.speed,
-                                        params.amount);
-          break;
-        case ACTION_JITTER:
-          controller->otto_.Jitter(params.steps, params.speed, params.amount);
-          break;
-        case ACTION_ASCENDING_TURN:
-          controller->otto_.AscendingTurn(params.steps, params.speed,
-                                          params.amount);
-          break;
-        case ACTION_CRUSAITO:
-          controller->otto_.Crusaito(params.steps, params.speed, params.amount,
-                                     params.direction);
-          break;
-        case ACTION_FLAPPING:
-          controller->otto_.Flapping(params.steps, params.speed, params.amount,
-                                     params.direction);
-          break;
-        case ACTION_HANDS_UP:
-          if (controller->has_hands_) {
-            controller->otto_.HandsUp(params.speed, params.direction);
-          }
-          break;
-        case ACTION_HANDS_DOWN:
-          if (controller->has_hands_) {
-            controller->otto_.HandsDown(params.speed, params.direction);
-          }
-          break;
-        case ACTION_HAND_WAVE:
-          if (controller->has_hands_) {
-            controller->otto_.HandWave(params.speed, params.direction);
-          }
-          break;
-        case ACTION_HOME:
-          controller->otto_.Home(params.direction == 1);
-          break;
-        case ACTION_LOOK_AROUND:
-          controller->otto_.LookAround(params.speed, params.direction);
-          break;
-        }
-        if (params.action_type != ACTION_HOME) {
-          controller->otto_.Home(params.action_type < ACTION_HANDS_UP);
-        }
-        controller->is_action_in_progress_ = false;
-        vTaskDelay(pdMS_TO_TICKS(20));
+  // 在调度器任务中执行一个动作
+  void RunAction(const OttoActionParams &params) {
+    ESP_LOGI(TAG, "执行动作: %d", params.action_type);
+    otto_.Resume();
+    otto_.SetChainNext(scheduler_.HasPending());
+
+    switch (params.action_type) {
+    case ACTION_WALK:
+      otto_.Walk(params.steps, params.speed, params.direction, params.amount);
+      break;
+    case ACTION_TURN:
+      otto_.Turn(params.steps, params.speed, params.direction, params.amount);
+      break;
+    case ACTION_JUMP:
+      otto_.Jump(params.steps, params.speed);
+      break;
+    case ACTION_SWING:
+      otto_.Swing(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_MOONWALK:
+      otto_.Moonwalker(params.steps, params.speed, params.amount,
+                       params.direction);
+      break;
+    case ACTION_BEND:
+      otto_.Bend(params.steps, params.speed, params.direction);
+      break;
+    case ACTION_SHAKE_LEG:
+      otto_.ShakeLeg(params.steps, params.speed, params.direction);
+      break;
+    case ACTION_UPDOWN:
+      otto_.UpDown(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_TIPTOE_SWING:
+      otto_.TiptoeSwing(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_JITTER:
+      otto_.Jitter(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_ASCENDING_TURN:
+      otto_.AscendingTurn(params.steps, params.speed, params.amount);
+      break;
+    case ACTION_CRUSAITO:
+      otto_.Crusaito(params.steps, params.speed, params.amount,
+                     params.direction);
+      break;
+    case ACTION_FLAPPING:
+      otto_.Flapping(params.steps, params.speed, params.amount,
+                     params.direction);
+      break;
+    case ACTION_HANDS_UP:
+      if (has_hands_) {
+        otto_.HandsUp(params.speed, params.direction);
+      }
+      break;
+    case ACTION_HANDS_DOWN:
+      if (has_hands_) {
+        otto_.HandsDown(params.speed, params.direction);
+      }
+      break;
+    case ACTION_HAND_WAVE:
+      if (has_hands_) {
+        otto_.HandWave(params.speed, params.direction);
+      }
+      break;
+    case ACTION_HOME:
+      otto_.Home(params.direction == 1);
+      break;
+    case ACTION_LOOK_AROUND:
+      otto_.LookAround(params.speed, params.direction);
+      break;
+    case ACTION_CHOREOGRAPHY: {
+      size_t size = 0;
+      auto data = choreographies_.Find(params.name, size);
+      if (data != nullptr) {
+        uint32_t token = params.cancel_token;
+        otto_.PlayChoreography(data.get(), size, params.steps, [token]() {
+          return McpServer::IsToolCallCancelled(token);
+        });
+      }
+      break;
+    }
+    case ACTION_SPEAK:
+      SpeakAlong();
+      break;
+    }
+
+    // 被打断时引擎已经在过渡到休息姿态
+    if (otto_.IsCancelled()) {
+      return;
+    }
+    if (params.action_type != ACTION_HOME) {
+      if (scheduler_.HasPending()) {
+        // 后面还有动作：与下一个动作交叉过渡，不经过休息姿态
+        otto_.BlendNext();
+      } else {
+        otto_.Home(params.action_type < ACTION_HANDS_UP ||
+                   params.action_type >= ACTION_CHOREOGRAPHY);
+      }
+    }
+  }
+
+  // 说话期间跟随 TTS 的响度和重音做小动作，有其他动作排队或说话结束时返回
+  void SpeakAlong() {
+    auto &app = Application::GetInstance();
+    const auto &channel = app.GetAudioService().speech_features();
+    SpeechFeatures features;
+    channel.Read(features);
+    uint8_t last_onset = features.onset_count;
+    int hand = LEFT;
+
+    while (app.GetDeviceState() == kDeviceStateSpeaking &&
+           !otto_.IsCancelled() && !scheduler_.HasPending()) {
+      if (!channel.Read(features)) {
+        // 句间停顿或等待下一段语音
+        otto_.SpeechGesture(0, 0, SPEECH_HOP_MS * 4);
+        continue;
+      }
+      if (features.onset_count != last_onset) {
+        last_onset = features.onset_count;
+        otto_.SpeechGesture(features.level, hand);
+        hand = -hand;
+      } else {
+        otto_.SpeechGesture(features.level);
       }
     }
   }
 
-  void StartActionTaskIfNeeded() {
-    if (action_task_handle_ == nullptr) {
-      xTaskCreate(ActionTask, "otto_action", 1024 * 3, this,
-                  configMAX_PRIORITIES - 1, &action_task_handle_);
+  void Submit(MotionScheduler::Priority priority,
+              const OttoActionParams &params) {
+    bool busy = scheduler_.IsBusy();
+    if (!scheduler_.Submit(priority, ActionName(params.action_type),
+                           [this, params]() { RunAction(params); })) {
+      return;
+    }
+    // 正在执行的步态结束时不再归位，由这个动作接着过渡
+    if (busy && priority == MotionScheduler::kPriorityUser) {
+      otto_.SetChainNext(true);
     }
   }
 
@@ -176,8 +250,8 @@ private:
         continue;
       }
       
-      // 检查是否有动作正在执行
-      if (controller->is_action_in_progress_) {
+      // 检查是否有动作正在执行或排队
+      if (controller->scheduler_.IsBusy()) {
         continue;
       }
       
@@ -203,22 +277,28 @@ private:
       
       switch (action) {
         case 0:  // 向左看
-          controller->QueueAction(ACTION_LOOK_AROUND, 1, 1200, 1, 0);
+          controller->QueueAction(ACTION_LOOK_AROUND, 1, 1200, 1, 0,
+                                  MotionScheduler::kPriorityIdle);
           break;
         case 1:  // 向右看
-          controller->QueueAction(ACTION_LOOK_AROUND, 1, 1200, -1, 0);
+          controller->QueueAction(ACTION_LOOK_AROUND, 1, 1200, -1, 0,
+                                  MotionScheduler::kPriorityIdle);
           break;
         case 2:  // 抖左腿
-          controller->QueueAction(ACTION_SHAKE_LEG, 1, 2000, 1, 0);
+          controller->QueueAction(ACTION_SHAKE_LEG, 1, 2000, 1, 0,
+                                  MotionScheduler::kPriorityIdle);
           break;
         case 3:  // 抖右腿
-          controller->QueueAction(ACTION_SHAKE_LEG, 1, 2000, -1, 0);
+          controller->QueueAction(ACTION_SHAKE_LEG, 1, 2000, -1, 0,
+                                  MotionScheduler::kPriorityIdle);
           break;
         case 4:  // 向左转
-          controller->QueueAction(ACTION_TURN, 2, 600, 1, 30);
+          controller->QueueAction(ACTION_TURN, 2, 600, 1, 30,
+                                  MotionScheduler::kPriorityIdle);
           break;
         case 5:  // 向右转
-          controller->QueueAction(ACTION_TURN, 2, 600, -1, 30);
+          controller->QueueAction(ACTION_TURN, 2, 600, -1, 30,
+                                  MotionScheduler::kPriorityIdle);
           break;
       }
       
@@ -236,7 +316,9 @@ private:
 
 public:
   void QueueAction(int action_type, int steps, int speed, int direction,
-                   int amount) {
+                   int amount,
+                   MotionScheduler::Priority priority =
+                       MotionScheduler::kPriorityUser) {
     // 检查手部动作
     if ((action_type >= ACTION_HANDS_UP && action_type <= ACTION_HAND_WAVE) &&
         !has_hands_) {
@@ -248,8 +330,17 @@ public:
              action_type, steps, speed, direction, amount);
 
     OttoActionParams params = {action_type, steps, speed, direction, amount};
-    xQueueSend(action_queue_, &params, portMAX_DELAY);
-    StartActionTaskIfNeeded();
+    Submit(priority, params);
+  }
+
+  void QueueChoreography(const std::string &name, int repeat) {
+    ESP_LOGI(TAG, "动作编排: %s x%d", name.c_str(), repeat);
+
+    OttoActionParams params = {ACTION_CHOREOGRAPHY, repeat, 0, 0, 0};
+    strlcpy(params.name, name.c_str(), sizeof(params.name));
+    // 打断说话时取消工具调用，正在播放的编排随之停止
+    params.cancel_token = McpServer::GetToolCallToken();
+    Submit(MotionScheduler::kPriorityUser, params);
   }
 
   void LoadTrimsFromNVS() {
@@ -271,19 +362,28 @@ public:
                    right_hand);
   }
 
-  OttoController() {
+  OttoController(std::function<int()> supply_voltage, int empty_mv) {
     otto_.Init(LEFT_LEG_PIN, RIGHT_LEG_PIN, LEFT_FOOT_PIN, RIGHT_FOOT_PIN,
                LEFT_HAND_PIN, RIGHT_HAND_PIN);
+    otto_.SetSupplyVoltageSource(std::move(supply_voltage), empty_mv);
 
     has_hands_ = (LEFT_HAND_PIN != -1 && RIGHT_HAND_PIN != -1);
     ESP_LOGI(TAG, "Otto机器人初始化%s手部舵机", has_hands_ ? "带" : "不带");
 
     LoadTrimsFromNVS();
 
-    action_queue_ = xQueueCreate(10, sizeof(OttoActionParams));
-
     QueueAction(ACTION_HOME, 1, 1000, 1, 0); // direction=1表示复位手部
 
+    // 开始说话时跟随语音做动作，以空闲优先级提交，不影响其他动作指令
+    Application::GetInstance().GetAudioService().EnableSpeechAnalysis(true);
+    DeviceStateEventManager::GetInstance().RegisterStateChangeCallback(
+        [this](DeviceState previous_state, DeviceState current_state) {
+          if (current_state == kDeviceStateSpeaking) {
+            QueueAction(ACTION_SPEAK, 1, 0, 0, 0,
+                        MotionScheduler::kPriorityIdle);
+          }
+        });
+
     RegisterMcpTools();
     
     // 启动空闲动作任务
@@ -302,17 +402,13 @@ public:
         "行走速度(400-1500，数值越小越快，推荐500); "
         "direction: 行走方向(-1=后退, 1=前进); arm_swing: "
         "手臂摆动幅度(0-170度)",
-        PropertyList({Property("steps", kPropertyTypeInteger, 8, 1, 100),
-                      Property("speed", kPropertyTypeInteger, 500, 400, 1500),
-                      Property("arm_swing", kPropertyTypeInteger, 50, 0, 170),
-                      Property("direction", kPropertyTypeInteger, 1, -1, 1)}),
-        [this](const PropertyList &properties) -> ReturnValue {
-          int steps = properties["steps"].value<int>();
-          int speed = properties["speed"].value<int>();
-          int arm_swing = properties["arm_swing"].value<int>();
-          int direction = properties["direction"].value<int>();
-          QueueAction(ACTION_WALK, steps, speed, direction, arm_swing);
-          return true;
+        {McpArg("steps", &MotionArgs::steps, 8, 1, 100),
+         McpArg("speed", &MotionArgs::speed, 500, 400, 1500),
+         McpArg("arm_swing", &MotionArgs::arm_swing, 50, 0, 170),
+         McpArg("direction", &MotionArgs::direction, 1, -1, 1)},
+        [this](const MotionArgs &args, McpResultWriter &result) {
+          QueueAction(ACTION_WALK, args.steps, args.speed, args.direction,
+                      args.arm_swing);
         });
 
     mcp_server.AddTool(
@@ -321,30 +417,23 @@ public:
         "转身速度(400-1500，数值越小越快，推荐500); "
         "direction: 转身方向(1=左转, -1=右转); arm_swing: "
         "手臂摆动幅度(0-170度)",
-        PropertyList({Property("steps", kPropertyTypeInteger, 10, 1, 100),
-                      Property("speed", kPropertyTypeInteger, 500, 400, 1500),
-                      Property("arm_swing", kPropertyTypeInteger, 50, 0, 170),
-                      Property("direction", kPropertyTypeInteger, 1, -1, 1)}),
-        [this](const PropertyList &properties) -> ReturnValue {
-          int steps = properties["steps"].value<int>();
-          int speed = properties["speed"].value<int>();
-          int arm_swing = properties["arm_swing"].value<int>();
-          int direction = properties["direction"].value<int>();
-          QueueAction(ACTION_TURN, steps, speed, direction, arm_swing);
-          return true;
+        {McpArg("steps", &MotionArgs::steps, 10, 1, 100),
+         McpArg("speed", &MotionArgs::speed, 500, 400, 1500),
+         McpArg("arm_swing", &MotionArgs::arm_swing, 50, 0, 170),
+         McpArg("direction", &MotionArgs::direction, 1, -1, 1)},
+        [this](const MotionArgs &args, McpResultWriter &result) {
+          QueueAction(ACTION_TURN, args.steps, args.speed, args.direction,
+                      args.arm_swing);
         });
 
     mcp_server.AddTool(
         "self.otto.jump",
         "跳跃。steps: 跳跃次数(1-100); speed: "
         "跳跃周期(2000-8000ms，数值越大越慢，推荐5000)",
-        PropertyList({Property("steps", kPropertyTypeInteger, 1, 1, 100),
-                      Property("speed", kPropertyTypeInteger, 5000, 2000, 8000)}),
-        [this](const PropertyList &properties) -> ReturnValue {
-          int steps = properties["steps"].value<int>();
-          int speed = properties["speed"].value<int>();
-          QueueAction(ACTION_JUMP, steps, speed, 0, 0);
-          return true;
+        {McpArg("steps", &MotionArgs::steps, 1, 1, 100),
+         McpArg("speed", &MotionArgs::speed, 5000, 2000, 8000)},
+        [this](const MotionArgs &args, McpResultWriter &result) {
+          QueueAction(ACTION_JUMP, args.steps, args.speed, 0, 0);
         });
 
     // 特殊动作
@@ -486,17 +575,45 @@ public:
           });
     }
 
+    // 动作编排：序列由 scripts/choreography.py 生成
+    mcp_server.AddTool(
+        "self.otto.choreography.upload",
+        "上传动作编排序列（舞蹈/步态），保存在内存中直到重启。name: "
+        "序列名称(字母、数字、_、-); data: base64 编码的 XZCH 序列",
+        PropertyList({Property("name", kPropertyTypeString),
+                      Property("data", kPropertyTypeString)}),
+        [this](const PropertyList &properties) -> ReturnValue {
+          std::string error;
+          if (!choreographies_.Upload(properties["name"].value<std::string>(),
+                                      properties["data"].value<std::string>(),
+                                      error)) {
+            throw std::runtime_error(error);
+          }
+          return true;
+        });
+
+    mcp_server.AddTool(
+        "self.otto.choreography.play",
+        "播放动作编排序列。name: 已上传的或内置的序列名称; repeat: "
+        "重复次数(1-20)",
+        PropertyList({Property("name", kPropertyTypeString),
+                      Property("repeat", kPropertyTypeInteger, 1, 1, 20)}),
+        [this](const PropertyList &properties) -> ReturnValue {
+          std::string name = properties["name"].value<std::string>();
+          size_t size = 0;
+          if (choreographies_.Find(name, size) == nullptr) {
+            throw std::runtime_error("Unknown choreography: " + name);
+          }
+          QueueChoreography(name, properties["repeat"].value<int>());
+          return true;
+        });
+
     // 系统工具
     mcp_server.AddTool("self.otto.stop", "立即停止", PropertyList(),
                        [this](const PropertyList &properties) -> ReturnValue {
-                         if (action_task_handle_ != nullptr) {
-                           vTaskDelete(action_task_handle_);
-                           action_task_handle_ = nullptr;
-                         }
-                         is_action_in_progress_ = false;
-                         xQueueReset(action_queue_);
-
-                         QueueAction(ACTION_HOME, 1, 1000, 1, 0);
+                         // 打断当前动作、清空队列，平滑回到休息姿态
+                         QueueAction(ACTION_HOME, 1, 1000, 1, 0,
+                                     MotionScheduler::kPrioritySafety);
                          return true;
                        });
 
@@ -592,11 +709,27 @@ public:
           return result;
         });
 
-    mcp_server.AddTool("self.otto.get_status",
-                       "获取机器人状态，返回 moving 或 idle", PropertyList(),
-                       [this](const PropertyList &properties) -> ReturnValue {
-                         return is_action_in_progress_ ? "moving" : "idle";
-                       });
+    mcp_server.AddTool(
+        "self.otto.get_status",
+        "获取机器人状态。返回 JSON：state(moving/idle), action(当前动作), "
+        "queue_depth(排队动作数), last_latency_ms/max_latency_ms"
+        "(指令从提交到开始执行的延迟), completed, preempted(被打断次数), "
+        "dropped(被丢弃的动作数)",
+        PropertyList(),
+        [this](const PropertyList &properties) -> ReturnValue {
+          return scheduler_.GetStatusJson();
+        });
+
+    mcp_server.AddTool(
+        "self.otto.get_motion_telemetry",
+        "获取舵机运动的安全限幅遥测。返回 JSON：supply_mv(电源电压), "
+        "supply_scale_pct(电压降额后的速度百分比), heat(每个舵机的温升估计), "
+        "limited_ticks/budget_ticks(被限速/超出总线预算的节拍数), "
+        "samples(最近约 6 秒、每 100ms 一条的记录，字段见 columns)",
+        PropertyList(),
+        [this](const PropertyList &properties) -> ReturnValue {
+          return otto_.GetMotionTelemetryJson();
+        });
 
     mcp_server.AddTool("self.battery.get_level", "获取机器人电池电量和充电状态",
                        PropertyList(),
@@ -614,27 +747,28 @@ public:
                          return status;
                        });
 
+    // 只读取内存中的状态，直接在收到请求的任务上执行，不排队等主循环
+    mcp_server.SetToolExecution("self.otto.get_status", kToolExecutionInline);
+    mcp_server.SetToolExecution("self.otto.get_motion_telemetry",
+                                kToolExecutionInline);
+    mcp_server.SetToolExecution("self.battery.get_level", kToolExecutionInline);
+
     ESP_LOGI(TAG, "MCP工具注册完成");
   }
 
   ~OttoController() {
-    if (action_task_handle_ != nullptr) {
-      vTaskDelete(action_task_handle_);
-      action_task_handle_ = nullptr;
-    }
     if (idle_task_handle_ != nullptr) {
       vTaskDelete(idle_task_handle_);
       idle_task_handle_ = nullptr;
     }
-    vQueueDelete(action_queue_);
   }
 };
 
 static OttoController *g_otto_controller = nullptr;
 
-void InitializeOttoController() {
+void InitializeOttoController(std::function<int()> supply_voltage, int empty_mv) {
   if (g_otto_controller == nullptr) {
-    g_otto_controller = new OttoController();
+    g_otto_controller = new OttoController(std::move(supply_voltage), empty_mv);
     ESP_LOGI(TAG, "Otto控制器已初始化并注册MCP工具");
   }
 }
@@ -3,21 +3,13 @@
 #include <algorithm>
 #include <cmath>
 
-#include "oscillator.h"
+#include "choreography.h"
+#include "servo_oscillator.h"
 
 static const char *TAG = "OttoMovements";
 
 #define HAND_HOME_POSITION 170 // 左手放下位置（右手为 180-170=10）
 
-// 三次贝塞尔 S 型曲线查找表（33 个点，0.0 到 1.0）
-// 控制点: P0=(0,0), P1=(0.25,0), P2=(0.75,1), P3=(1,1)
-// 特点: 比余弦曲线更平滑，起止速度为0，中间加速更自然
-static const float EASE_BEZIER_LUT[33] = {
-    0.000f, 0.001f, 0.007f, 0.020f, 0.042f, 0.074f, 0.117f, 0.170f, 0.234f,
-    0.305f, 0.383f, 0.461f, 0.537f, 0.609f, 0.676f, 0.736f, 0.789f, 0.836f,
-    0.875f, 0.908f, 0.934f, 0.955f, 0.971f, 0.982f, 0.990f, 0.995f, 0.998f,
-    0.999f, 1.000f, 1.000f, 1.000f, 1.000f, 1.000f};
-
 // 三次贝塞尔曲线实时计算（用于需要精确控制的场景）
 // 控制点可调: p1 控制起始加速度, p2 控制结束减速度
 // ease-in-out 默认: p1=0.25, p2=0.75
@@ -32,18 +24,6 @@ inline float CubicBezier(float t, float p1 = 0.25f, float p2 = 0.75f) {
   return 3.0f * mt2 * t * p1 + 3.0f * mt * t2 * p2 + t3;
 }
 
-// 快速查找贝塞尔 S 型进度（CPU 优化：查表）
-inline float GetEaseProgress(float progress) {
-  if (progress <= 0.0f)
-    return 0.0f;
-  if (progress >= 1.0f)
-    return 1.0f;
-  int index = (int)(progress * 32.0f);
-  if (index > 32)
-    index = 32;
-  return EASE_BEZIER_LUT[index];
-}
-
 // 可调节的 S 型曲线（支持不同的加减速特性）
 // smoothness: 0.0=线性, 0.5=标准S型, 1.0=极端S型（几乎阶跃）
 inline float GetEaseProgressCustom(float progress, float smoothness = 0.5f) {
@@ -82,63 +62,7 @@ inline Point2D BezierPoint(float t, Point2D p0, Point2D p1, Point2D p2,
   return result;
 }
 
-// 根据曲线类型获取进度值
-inline float GetEaseByType(float t, EaseType type) {
-  if (t <= 0.0f) return 0.0f;
-  if (t >= 1.0f) return 1.0f;
-
-  switch (type) {
-    case EASE_LINEAR:
-      return t;
-
-    case EASE_IN_OUT:
-      return GetEaseProgress(t);  // 使用查找表
-
-    case EASE_IN: {
-      // 慢启动: P1=(0.42, 0), P2=(1, 1)
-      return CubicBezier(t, 0.0f, 0.0f);
-    }
-
-    case EASE_OUT: {
-      // 快启动慢结束: P1=(0, 0), P2=(0.58, 1)
-      return CubicBezier(t, 1.0f, 1.0f);
-    }
-
-    case EASE_IN_BACK: {
-      // 回弹启动（先后退再前进）
-      float s = 1.70158f;
-      return t * t * ((s + 1.0f) * t - s);
-    }
-
-    case EASE_OUT_BACK: {
-      // 回弹结束（超过目标再回来）
-      float s = 1.70158f;
-      float t1 = t - 1.0f;
-      return t1 * t1 * ((s + 1.0f) * t1 + s) + 1.0f;
-    }
-
-    case EASE_OUT_BOUNCE: {
-      // 弹跳效果
-      if (t < 1.0f / 2.75f) {
-        return 7.5625f * t * t;
-      } else if (t < 2.0f / 2.75f) {
-        float t1 = t - 1.5f / 2.75f;
-        return 7.5625f * t1 * t1 + 0.75f;
-      } else if (t < 2.5f / 2.75f) {
-        float t1 = t - 2.25f / 2.75f;
-        return 7.5625f * t1 * t1 + 0.9375f;
-      } else {
-        float t1 = t - 2.625f / 2.75f;
-        return 7.5625f * t1 * t1 + 0.984375f;
-      }
-    }
-
-    default:
-      return GetEaseProgress(t);
-  }
-}
-
-Otto::Otto() {
+Otto::Otto() : engine_(this, SERVO_COUNT) {
   is_otto_resting_ = false;
   has_hands_ = false;
   // 初始化所有舵机管脚为-1（未连接）
@@ -146,9 +70,16 @@ Otto::Otto() {
     servo_pins_[i] = -1;
     servo_trim_[i] = 0;
   }
+  // 手的休息位置在下方，降幅时向它收缩
+  safety_.SetNeutral(LEFT_HAND, HAND_HOME_POSITION);
+  safety_.SetNeutral(RIGHT_HAND, HAND_HOME_POSITION);
+  engine_.SetSafety(&safety_);
 }
 
-Otto::~Otto() { DetachServos(); }
+Otto::~Otto() {
+  engine_.Stop();
+  DetachServos();
+}
 
 unsigned long IRAM_ATTR millis() {
   return (unsigned long)(esp_timer_get_time() / 1000ULL);
@@ -168,8 +99,58 @@ void Otto::Init(int left_leg, int right_leg, int left_foot, int right_foot,
 
   AttachServos();
   is_otto_resting_ = false;
+  engine_.Start();
 }
 
+///////////////////////////////////////////////////////////////////
+//-- SERVO OUTPUT (called from the motion engine tick) ----------//
+///////////////////////////////////////////////////////////////////
+void Otto::Write(int servo, int position) { servo_[servo].Stage(position); }
+
+int Otto::Read(int servo) { return servo_[servo].GetPosition(); }
+
+// 所有舵机在同一个 PWM 周期生效
+void Otto::Commit() { bus_->Commit(); }
+
+uint16_t Otto::ServoMask() {
+  uint16_t mask = 0;
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    if (servo_pins_[i] != -1) {
+      mask |= 1 << i;
+    }
+  }
+  return mask;
+}
+
+void Otto::Hold(int time) {
+  MotionSegment segment;
+  segment.type = kMotionHold;
+  segment.duration_ms = time;
+  if (engine_.Submit(segment)) {
+    engine_.WaitIdle();
+  }
+}
+
+///////////////////////////////////////////////////////////////////
+//-- CANCEL & BLEND ---------------------------------------------//
+///////////////////////////////////////////////////////////////////
+void Otto::Cancel(int ramp_ms) {
+  MotionSegment ramp;
+  ramp.type = kMotionMove;
+  ramp.ease = kMotionEaseInOut;
+  ramp.mask = ServoMask();
+  ramp.duration_ms = ramp_ms;
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    ramp.target[i] = (i == LEFT_HAND || i == RIGHT_HAND) ? HAND_HOME_POSITION : 90;
+  }
+  engine_.Cancel(ramp);
+  is_otto_resting_ = false;
+}
+
+void Otto::Resume() { engine_.Resume(); }
+
+void Otto::BlendNext() { engine_.BlendNext(); }
+
 ///////////////////////////////////////////////////////////////////
 //-- ATTACH & DETACH FUNCTIONS ----------------------------------//
 ///////////////////////////////////////////////////////////////////
@@ -181,6 +162,13 @@ void Otto::AttachServos() {
   }
 }
 
+void Otto::SetServoBus(ServoBus* bus) {
+  bus_ = bus;
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    servo_[i].SetBus(bus);
+  }
+}
+
 void Otto::DetachServos() {
   for (int i = 0; i < SERVO_COUNT; i++) {
     if (servo_pins_[i] != -1) {
@@ -215,73 +203,27 @@ void Otto::SetTrims(int left_leg, int right_leg, int left_foot, int right_foot,
 //-- BASIC MOTION FUNCTIONS -------------------------------------//
 ///////////////////////////////////////////////////////////////////
 void Otto::MoveServos(int time, int servo_target[]) {
+  if (engine_.IsCancelled()) {
+    return;
+  }
   if (GetRestState() == true) {
     SetRestState(false);
   }
 
   final_time_ = millis() + time;
-  if (time > 10) {
-    // 记录起始位置（用于余弦插值）
-    int start_positions[SERVO_COUNT];
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      if (servo_pins_[i] != -1) {
-        start_positions[i] = servo_[i].GetPosition();
-      }
-    }
-
-    // 使用余弦插值（仅对慢速动作 time > 100ms，减少 CPU 开销）
-    bool use_ease = (time > 100);
-
-    unsigned long start_time = millis();
-    while (millis() < final_time_) {
-      unsigned long elapsed = millis() - start_time;
-      float progress = (float)elapsed / (float)time;
-
-      // 获取平滑进度（查表，无三角函数计算）
-      float ease_progress = use_ease ? GetEaseProgress(progress) : progress;
-
-      // 更新所有舵机位置
-      for (int i = 0; i < SERVO_COUNT; i++) {
-        if (servo_pins_[i] != -1) {
-          int new_pos = start_positions[i] +
-                        (servo_target[i] - start_positions[i]) * ease_progress;
-          servo_[i].SetPosition(new_pos);
-        }
-      }
-
-      vTaskDelay(pdMS_TO_TICKS(10));
-    }
-  } else {
-    // 快速动作直接设置（无插值）
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      if (servo_pins_[i] != -1) {
-        servo_[i].SetPosition(servo_target[i]);
-      }
-    }
-    vTaskDelay(pdMS_TO_TICKS(time));
+  // 慢速动作（time > 100ms）使用 S 型缓动，快速动作线性插值。time <= 10 的动作也提交给
+  // 引擎，由限幅器按步长预算送到目标；WaitIdle 等到限幅器到位才返回，不需要再修正
+  MotionSegment segment;
+  segment.type = kMotionMove;
+  segment.ease = time > 100 ? kMotionEaseInOut : kMotionEaseLinear;
+  segment.mask = ServoMask();
+  segment.duration_ms = std::max(time, 0);
+  for (int i = 0; i < SERVO_COUNT; i++) {
+    segment.target[i] = servo_target[i];
+  }
+  if (engine_.Submit(segment)) {
+    engine_.WaitIdle();
   }
-
-  // final adjustment to the target.
-  bool f = true;
-  int adjustment_count = 0;
-  while (f && adjustment_count < 10) {
-    f = false;
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      if (servo_pins_[i] != -1 && servo_target[i] != servo_[i].GetPosition()) {
-        f = true;
-        break;
-      }
-    }
-    if (f) {
-      for (int i = 0; i < SERVO_COUNT; i++) {
-        if (servo_pins_[i] != -1) {
-          servo_[i].SetPosition(servo_target[i]);
-        }
-      }
-      vTaskDelay(pdMS_TO_TICKS(10));
-      adjustment_count++;
-    }
-  };
 }
 
 void Otto::MoveSingle(int position, int servo_number) {
@@ -296,34 +238,28 @@ void Otto::MoveSingle(int position, int servo_number) {
 
   if (servo_number >= 0 && servo_number < SERVO_COUNT &&
       servo_pins_[servo_number] != -1) {
-    servo_[servo_number].SetPosition(position);
+    int servo_target[SERVO_COUNT] = {};
+    servo_target[servo_number] = position;
+    ::MoveServosWithEase(engine_, 1 << servo_number, servo_target, 0, EASE_LINEAR);
   }
 }
 
 void Otto::OscillateServos(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT],
                            int period, double phase_diff[SERVO_COUNT],
                            float cycle = 1) {
+  MotionSegment segment;
+  segment.type = kMotionOscillate;
+  segment.mask = ServoMask();
+  segment.period_ms = period;
+  segment.duration_ms = period * cycle;
   for (int i = 0; i < SERVO_COUNT; i++) {
-    if (servo_pins_[i] != -1) {
-      servo_[i].SetO(offset[i]);
-      servo_[i].SetA(amplitude[i]);
-      servo_[i].SetT(period);
-      servo_[i].SetPh(phase_diff[i]);
-    }
+    segment.amplitude[i] = amplitude[i];
+    segment.offset[i] = offset[i];
+    segment.phase[i] = MotionCurve::PhaseFromRadians(phase_diff[i]);
   }
-
-  double ref = millis();
-  double end_time = period * cycle + ref;
-
-  while (millis() < end_time) {
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      if (servo_pins_[i] != -1) {
-        servo_[i].Refresh();
-      }
-    }
-    vTaskDelay(5);
+  if (engine_.Submit(segment)) {
+    engine_.WaitIdle();
   }
-  vTaskDelay(pdMS_TO_TICKS(10));
 }
 
 void Otto::Execute(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT],
@@ -338,9 +274,12 @@ void Otto::Execute(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT],
   int cycles = (int)(steps + 0.5f);  // 四舍五入
   if (cycles < 1) cycles = 1;
 
-  //-- Execute complete cycles
-  for (int i = 0; i < cycles; i++) {
-    OscillateServos(amplitude, offset, period, phase_diff);
+  //-- Execute complete cycles（整段提交，周期之间没有停顿）
+  OscillateServos(amplitude, offset, period, phase_diff, cycles);
+
+  // 后面还有动作时由下一个动作从振荡的延续交叉过渡，不在这里归位
+  if (chain_next_) {
+    return;
   }
 
   // 平滑归位（400ms），修正位置偏差
@@ -383,7 +322,7 @@ void Otto::Home(bool hands_down) {
     is_otto_resting_ = true;
   }
 
-  vTaskDelay(pdMS_TO_TICKS(200));
+  Hold(200);
 }
 
 bool Otto::GetRestState() { return is_otto_resting_; }
@@ -414,7 +353,7 @@ void Otto::Jump(float steps, int period) {
   MoveServosWithEase(period * 0.15, up, EASE_OUT);
   
   // 阶段3: 滞空（保持一会儿）- 10%时间
-  vTaskDelay(pdMS_TO_TICKS(period * 0.10));
+  Hold(period * 0.10);
   
   // 阶段4: 下落（自然下落）- 使用 EASE_IN 模拟重力，15%时间
   int land[SERVO_COUNT] = {
@@ -558,7 +497,7 @@ void Otto::Bend(int steps, int period, int dir) {
     // 弯腰：使用 EASE_IN_OUT 保持平滑
     MoveServosWithEase(T2 / 2, bend2, EASE_IN_OUT);
     // 保持弯腰姿势
-    vTaskDelay(pdMS_TO_TICKS(period * 0.6));
+    Hold(period * 0.6);
     // 回到站立：使用 EASE_IN_OUT 平滑归位，时间延长到 800ms
     MoveServosWithEase(800, homes, EASE_IN_OUT);
   }
@@ -614,7 +553,7 @@ void Otto::ShakeLeg(int steps, int period, int dir) {
     MoveServosWithEase(1500, homes, EASE_IN_OUT);
   }
 
-  vTaskDelay(pdMS_TO_TICKS(200));
+  Hold(200);
 }
 
 //---------------------------------------------------------
@@ -663,7 +602,7 @@ void Otto::LookAround(int period, int dir) {
   MoveServosWithEase(period * 2 / 3, look_pose, EASE_IN_OUT);
 
   // 保持姿势一小段时间
-  vTaskDelay(pdMS_TO_TICKS(period / 3));
+  Hold(period / 3);
 
   // 转回原位（速度放慢）
   MoveServosWithEase(period * 2 / 3, homes, EASE_IN_OUT);
@@ -963,24 +902,24 @@ void Otto::HandWave(int period, int dir) {
 
   current_positions[servo_index] = position;
   MoveServos(300, current_positions);
-  vTaskDelay(pdMS_TO_TICKS(300));
+  Hold(300);
 
   // 左右摆动5次
   for (int i = 0; i < 5; i++) {
     if (servo_index == LEFT_HAND) {
       current_positions[servo_index] = position - 30;
       MoveServos(period / 10, current_positions);
-      vTaskDelay(pdMS_TO_TICKS(period / 10));
+      Hold(period / 10);
       current_positions[servo_index] = position + 30;
       MoveServos(period / 10, current_positions);
     } else {
       current_positions[servo_index] = position + 30;
       MoveServos(period / 10, current_positions);
-      vTaskDelay(pdMS_TO_TICKS(period / 10));
+      Hold(period / 10);
       current_positions[servo_index] = position - 30;
       MoveServos(period / 10, current_positions);
     }
-    vTaskDelay(pdMS_TO_TICKS(period / 10));
+    Hold(period / 10);
   }
 
   if (servo_index == LEFT_HAND) {
@@ -1047,57 +986,36 @@ void Otto::HandWaveBoth(int period) {
 //--    ease_type: 缓动类型
 //---------------------------------------------------------
 void Otto::MoveServosWithEase(int time, int servo_target[], EaseType ease_type) {
-  if (GetRestState() == true) {
-    SetRestState(false);
-  }
-
-  if (time <= 10) {
-    // 快速动作直接设置
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      if (servo_pins_[i] != -1) {
-        servo_[i].SetPosition(servo_target[i]);
-      }
-    }
-    vTaskDelay(pdMS_TO_TICKS(time));
+  if (engine_.IsCancelled()) {
     return;
   }
-
-  // 记录起始位置
-  int start_positions[SERVO_COUNT];
-  for (int i = 0; i < SERVO_COUNT; i++) {
-    if (servo_pins_[i] != -1) {
-      start_positions[i] = servo_[i].GetPosition();
-    }
+  if (GetRestState() == true) {
+    SetRestState(false);
   }
 
-  unsigned long start_time = millis();
-  unsigned long end_time = start_time + time;
-
-  while (millis() < end_time) {
-    unsigned long elapsed = millis() - start_time;
-    float progress = (float)elapsed / (float)time;
-
-    // 使用指定的缓动类型
-    float ease_progress = GetEaseByType(progress, ease_type);
-
-    // 更新所有舵机位置
-    for (int i = 0; i < SERVO_COUNT; i++) {
-      if (servo_pins_[i] != -1) {
-        int new_pos = start_positions[i] +
-                      (int)((servo_target[i] - start_positions[i]) * ease_progress);
-        servo_[i].SetPosition(new_pos);
-      }
-    }
+  ::MoveServosWithEase(engine_, ServoMask(), servo_target, std::max(time, 0), ease_type);
+}
 
-    vTaskDelay(pdMS_TO_TICKS(10));
+//---------------------------------------------------------
+//-- 说话时的跟随动作: 身体随响度起伏，重音时快速点头并抬手
+//--  Parameters:
+//--    level: 当前语音响度 0..255
+//--    hand: 重音时抬起的手 LEFT/RIGHT，0=没有重音
+//--    time: 动作时间，决定跟随语音的延迟
+//---------------------------------------------------------
+void Otto::SpeechGesture(int level, int hand, int time) {
+  int bob = level * 4 / 255;
+  if (hand != 0) {
+    bob += 4;
   }
-
-  // 确保到达目标位置
-  for (int i = 0; i < SERVO_COUNT; i++) {
-    if (servo_pins_[i] != -1) {
-      servo_[i].SetPosition(servo_target[i]);
-    }
+  int target[SERVO_COUNT] = {
+      90, 90, 90 + bob, 90 - bob, HAND_HOME_POSITION, HAND_HOME_POSITION};
+  if (has_hands_ && hand != 0) {
+    // 小角度=抬起，响度越大抬得越高
+    int lift = 30 + level * 50 / 255;
+    target[hand == LEFT ? LEFT_HAND : RIGHT_HAND] = HAND_HOME_POSITION - lift;
   }
+  MoveServosWithEase(time, target, hand != 0 ? EASE_OUT : EASE_IN_OUT);
 }
 
 //---------------------------------------------------------
@@ -1117,36 +1035,7 @@ void Otto::MoveServoPath(int servo_index, BezierWaypoint waypoints[], int count)
     SetRestState(false);
   }
 
-  int current_pos = servo_[servo_index].GetPosition();
-
-  for (int i = 0; i < count; i++) {
-    int target_pos = waypoints[i].position;
-    int duration = waypoints[i].duration_ms;
-    EaseType ease = waypoints[i].ease;
-
-    if (duration <= 10) {
-      servo_[servo_index].SetPosition(target_pos);
-      vTaskDelay(pdMS_TO_TICKS(duration));
-    } else {
-      unsigned long start_time = millis();
-      unsigned long end_time = start_time + duration;
-
-      while (millis() < end_time) {
-        unsigned long elapsed = millis() - start_time;
-        float progress = (float)elapsed / (float)duration;
-        float ease_progress = GetEaseByType(progress, ease);
-
-        int new_pos = current_pos + (int)((target_pos - current_pos) * ease_progress);
-        servo_[servo_index].SetPosition(new_pos);
-
-        vTaskDelay(pdMS_TO_TICKS(10));
-      }
-
-      servo_[servo_index].SetPosition(target_pos);
-    }
-
-    current_pos = target_pos;
-  }
+  ::MoveServoPath(engine_, servo_index, waypoints, count);
 }
 
 //---------------------------------------------------------
@@ -1207,6 +1096,22 @@ void Otto::JumpBounce(int period) {
   MoveServosWithEase(period / 2, down, EASE_OUT_BOUNCE);
 }
 
+bool Otto::PlayChoreography(const uint8_t* data, size_t size, int repeat,
+                            const std::function<bool()>& cancelled) {
+  if (GetRestState() == true) {
+    SetRestState(false);
+  }
+
+  ChoreographyPlayer player(engine_, SERVO_COUNT, ServoMask());
+  if (player.Play(data, size, repeat, cancelled)) {
+    return true;
+  }
+  if (!IsCancelled()) {
+    Cancel();
+  }
+  return false;
+}
+
 void Otto::EnableServoLimit(int diff_limit) {
   for (int i = 0; i < SERVO_COUNT; i++) {
     if (servo_pins_[i] != -1) {
@@ -6,7 +6,14 @@
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "oscillator.h"
+#include "motion_safety.h"
+#include "servo_motion_engine.h"
+#include "servo_oscillator.h"
+#include "servo_path.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
 
 //-- Constants
 #define FORWARD 1
@@ -30,28 +37,7 @@
 #define RIGHT_HAND 5
 #define SERVO_COUNT 6
 
-// 预定义的运动曲线类型
-enum EaseType {
-  EASE_LINEAR = 0,      // 线性（无缓动）
-  EASE_IN_OUT = 1,      // 标准 S 型（默认）
-  EASE_IN = 2,          // 慢启动，快结束
-  EASE_OUT = 3,         // 快启动，慢结束
-  EASE_IN_BACK = 4,     // 回弹启动
-  EASE_OUT_BACK = 5,    // 回弹结束
-  EASE_OUT_BOUNCE = 6,  // 弹跳结束
-};
-
-// 贝塞尔路径点（用于多点轨迹）
-struct BezierWaypoint {
-  int position;      // 目标角度
-  int duration_ms;   // 到达此点的时间
-  EaseType ease;     // 缓动类型
-};
-
-// 最大路径点数
-#define MAX_WAYPOINTS 8
-
-class Otto {
+class Otto : private ServoOutput {
 public:
   Otto();
   ~Otto();
@@ -62,6 +48,8 @@ public:
   //-- Attach & detach functions
   void AttachServos();
   void DetachServos();
+  // 舵机输出总线，默认片上 PWM；在 Init 之前调用
+  void SetServoBus(ServoBus* bus);
 
   //-- Oscillator Trims
   void SetTrims(int left_leg, int right_leg, int left_foot, int right_foot,
@@ -113,12 +101,41 @@ public:
   void HandWaveSmooth(int period = 1000, int dir = LEFT); // 平滑挥手（带回弹）
   void JumpBounce(int period = 2000);                     // 弹跳跳跃
 
+  // -- 说话时跟随语音的小动作：level 为响度 0..255，重音时 hand 指定抬起的手
+  void SpeechGesture(int level, int hand = 0, int time = 120);
+
+  // -- 动作编排序列（格式见 choreography.h），播放 repeat 遍并等待完成；
+  //    cancelled 返回 true 时平滑回到休息姿态并返回 false
+  bool PlayChoreography(const uint8_t* data, size_t size, int repeat = 1,
+                        const std::function<bool()>& cancelled = nullptr);
+
+  // -- 打断与衔接（由动作调度器调用）
+  // 打断正在执行的动作，ramp_ms 内平滑回到休息姿态；动作函数随即返回，Resume 之后才能再动
+  void Cancel(int ramp_ms = 300);
+  void Resume();
+  bool IsCancelled() const { return engine_.IsCancelled(); }
+  // 下一个动作从当前动作的末尾交叉过渡，不回到休息姿态
+  void BlendNext();
+  // 后面还有动作排队时，步态结束不再归位
+  void SetChainNext(bool chain) { chain_next_ = chain; }
+
   // -- Servo limiter
   void EnableServoLimit(int speed_limit_degree_per_sec = SERVO_LIMIT_DEFAULT);
   void DisableServoLimit();
 
+  // -- 运动安全：电源电压来源（毫伏）和电池空电电压用于欠压前降额，遥测见 MotionSafety
+  void SetSupplyVoltageSource(std::function<int()> source, int empty_mv) {
+    safety_.SetSupplyVoltageSource(std::move(source), empty_mv);
+  }
+  std::string GetMotionTelemetryJson() const { return safety_.GetTelemetryJson(); }
+
 private:
-  Oscillator servo_[SERVO_COUNT];
+  ServoOscillator servo_[SERVO_COUNT];
+  ServoBus* bus_ = &PwmServoBus::GetInstance();
+  // 限制速度、浪涌和温升，在引擎写入 servo_ 之前生效
+  MotionSafety safety_{SERVO_COUNT};
+  // 运动引擎按节拍驱动 servo_，动作函数只提交轨迹段并等待完成
+  ServoMotionEngine engine_;
 
   int servo_pins_[SERVO_COUNT];
   int servo_trim_[SERVO_COUNT];
@@ -129,6 +146,16 @@ private:
 
   bool is_otto_resting_;
   bool has_hands_; // 是否有手部舵机
+  std::atomic<bool> chain_next_{false};
+
+  // -- ServoOutput
+  void Write(int servo, int position) override;
+  int Read(int servo) override;
+  void Commit() override;
+  uint16_t ServoMask();
+
+  // 保持当前姿态（引擎保持段，可被 Cancel 打断）
+  void Hold(int time);
 
   // -- Advanced oscillation
   void Execute(int amplitude[SERVO_COUNT], int offset[SERVO_COUNT], int period,
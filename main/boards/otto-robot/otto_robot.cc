@@ -4,6 +4,7 @@
 #include <esp_lcd_panel_ops.h>
 #include <esp_lcd_panel_vendor.h>
 #include <esp_log.h>
+#include <functional>
 #include <wifi_station.h>
 
 #include "application.h"
@@ -30,7 +31,7 @@
 
 #define TAG "OttoRobot"
 
-extern void InitializeOttoController();
+extern void InitializeOttoController(std::function<int()> supply_voltage, int empty_mv);
 
 class OttoRobot : public WifiBoard {
 private:
@@ -108,7 +109,10 @@ private:
 
     void InitializeOttoController() {
         ESP_LOGI(TAG, "初始化Otto机器人MCP控制器");
-        ::InitializeOttoController();
+        // 舵机按电池电压降额，电压来自 PowerManager 最近一次的采样，不在节拍里读 ADC；
+        // 空电电压与电量校准一致
+        ::InitializeOttoController([this]() { return power_manager_->GetBatteryVoltage(); },
+                                   power_manager_->GetEmptyVoltage());
     }
 
 public:
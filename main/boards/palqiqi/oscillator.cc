@@ -1,6 +1,6 @@
 #include "oscillator.h"
 
-#include <driver/ledc.h>
+#include <esp_log.h>
 #include <esp_timer.h>
 
 #include <algorithm>
@@ -11,12 +11,11 @@ static const char *TAG = "Oscillator";
 // millis() 函数声明（实现在palqiqi_movements.cc中）
 extern unsigned long millis();
 
-static ledc_channel_t next_free_channel = LEDC_CHANNEL_0;
-
 Oscillator::Oscillator(int trim) {
   trim_ = trim;
   diff_limit_ = 0;
   is_attached_ = false;
+  channel_ = -1;
 
   // 提高采样频率，让动作更流畅 (v3优化)
   sampling_period_ = 20; // 20ms = 50Hz (原始:30ms = 33Hz)
@@ -127,29 +126,11 @@ void Oscillator::Attach(int pin, bool rev) {
   pin_ = pin;
   rev_ = rev;
 
-  ledc_timer_config_t ledc_timer = {};
-  ledc_timer.speed_mode = LEDC_LOW_SPEED_MODE;
-  ledc_timer.duty_resolution = LEDC_TIMER_13_BIT;
-  ledc_timer.timer_num = LEDC_TIMER_1;
-  ledc_timer.freq_hz = 50;
-  ledc_timer.clk_cfg = LEDC_AUTO_CLK;
-  ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-  static int last_channel = 0;
-  last_channel = (last_channel + 1) % 7 + 1;
-  ledc_channel_ = last_channel;
-
-  ledc_channel_config_t ledc_channel = {};
-  ledc_channel.gpio_num = pin_;
-  ledc_channel.speed_mode = LEDC_LOW_SPEED_MODE;
-  ledc_channel.channel = (ledc_channel_t)ledc_channel_;
-  ledc_channel.intr_type = LEDC_INTR_DISABLE;
-  ledc_channel.timer_sel = LEDC_TIMER_1;
-  ledc_channel.duty = 0;
-  ledc_channel.hpoint = 0;
-  ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-
-  ledc_speed_mode_ = LEDC_LOW_SPEED_MODE;
+  channel_ = PwmServoBus::GetInstance().Attach(pin_);
+  if (channel_ < 0) {
+    ESP_LOGE(TAG, "Servo on pin %d not attached", pin_);
+    return;
+  }
 
   previous_servo_command_millis_ = millis();
 
@@ -160,8 +141,8 @@ void Oscillator::Detach() {
   if (!is_attached_)
     return;
 
-  ESP_ERROR_CHECK(ledc_stop((ledc_mode_t)ledc_speed_mode_,
-                            (ledc_channel_t)ledc_channel_, 0));
+  PwmServoBus::GetInstance().Detach(channel_);
+  channel_ = -1;
 
   is_attached_ = false;
 }
@@ -231,13 +212,7 @@ void Oscillator::Write(int position) {
   // 优化的脉宽计算
   uint32_t pulsewidth_us = AngleToCompare(angle);
 
-  // 将脉宽转换为占空比
-  // PWM周期 = 20ms = 20000us
-  // duty = (pulsewidth_us / 20000) * 2^13
-  uint32_t duty = (pulsewidth_us * 8191) / 20000;
-
-  ESP_ERROR_CHECK(ledc_set_duty((ledc_mode_t)ledc_speed_mode_,
-                                (ledc_channel_t)ledc_channel_, duty));
-  ESP_ERROR_CHECK(ledc_update_duty((ledc_mode_t)ledc_speed_mode_,
-                                   (ledc_channel_t)ledc_channel_));
+  auto &bus = PwmServoBus::GetInstance();
+  bus.SetPulse(channel_, pulsewidth_us);
+  bus.Commit();
 }
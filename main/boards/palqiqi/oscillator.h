@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#include "servo_bus.h"
+
 #define M_PI 3.14159265358979323846
 
 #ifndef DEG2RAD
@@ -100,8 +102,7 @@ private:
     SmoothLevel smooth_level_;
     double smoothing_factor_;  // 平滑因子 (0.0 - 1.0)
 
-    int ledc_channel_;
-    int ledc_speed_mode_;
+    int channel_;
 };
 
 #endif  // __OSCILLATOR_SMOOTH_H__
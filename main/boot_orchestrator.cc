@@ -0,0 +1,137 @@
+#include "boot_orchestrator.h"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <freertos/task.h>
+
+#include <algorithm>
+#include <cassert>
+
+#define TAG "Boot"
+
+// 时间线条形图的宽度（字符）
+#define BOOT_TIMELINE_WIDTH 40
+
+
+BootOrchestrator::BootOrchestrator() {
+    event_group_ = xEventGroupCreate();
+    stages_.reserve(kMaxStages);
+}
+
+BootOrchestrator::~BootOrchestrator() {
+    if (event_group_ != nullptr) {
+        vEventGroupDelete(event_group_);
+    }
+}
+
+BootOrchestrator::Stage BootOrchestrator::AddStage(const char* name, std::function<void()> fn,
+                                                   std::initializer_list<Stage> deps, uint32_t stack_size) {
+    assert(stages_.size() < kMaxStages);
+    EventBits_t bits = 0;
+    for (auto dep : deps) {
+        bits |= 1 << dep;
+    }
+    stages_.push_back({this, name, std::move(fn), bits, stack_size, 0, 0, 0});
+    return stages_.size() - 1;
+}
+
+void BootOrchestrator::Run() {
+    remaining_ = stages_.size();
+    for (auto& stage : stages_) {
+        if (stage.stack_size == 0) {
+            continue;
+        }
+        stage.created_us = esp_timer_get_time();
+        if (xTaskCreate([](void* arg) {
+                auto stage = static_cast<StageInfo*>(arg);
+                stage->owner->RunStage(*stage);
+                vTaskDelete(NULL);
+            }, stage.name, stage.stack_size, &stage, 4, nullptr) != pdPASS) {
+            // 内存不足时退化为顺序执行
+            ESP_LOGW(TAG, "Failed to create task for stage %s, running inline", stage.name);
+            stage.stack_size = 0;
+        }
+    }
+
+    for (auto& stage : stages_) {
+        if (stage.stack_size == 0) {
+            stage.created_us = esp_timer_get_time();
+            RunStage(stage);
+        }
+    }
+}
+
+void BootOrchestrator::RunStage(StageInfo& stage) {
+    if (stage.deps != 0) {
+        xEventGroupWaitBits(event_group_, stage.deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    stage.start_us = esp_timer_get_time();
+    if (stage.fn) {
+        stage.fn();
+    }
+    stage.end_us = esp_timer_get_time();
+    ESP_LOGI(TAG, "Stage %s done in %d ms", stage.name, int((stage.end_us - stage.start_us) / 1000));
+
+    bool last;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        last = --remaining_ == 0;
+    }
+    xEventGroupSetBits(event_group_, 1 << (&stage - stages_.data()));
+    if (last) {
+        PrintTimeline();
+    }
+}
+
+void BootOrchestrator::Wait(Stage stage) {
+    xEventGroupWaitBits(event_group_, 1 << stage, pdFALSE, pdTRUE, portMAX_DELAY);
+}
+
+bool BootOrchestrator::IsDone(Stage stage) const {
+    return (xEventGroupGetBits(event_group_) & (1 << stage)) != 0;
+}
+
+void BootOrchestrator::Mark(const char* milestone) {
+    int64_t now = esp_timer_get_time();
+    bool printed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        milestones_.push_back({milestone, now});
+        printed = timeline_printed_;
+    }
+    if (printed) {
+        ESP_LOGI(TAG, "Milestone %s at %d ms", milestone, int(now / 1000));
+    }
+}
+
+void BootOrchestrator::PrintTimeline() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timeline_printed_ = true;
+
+    int64_t end = 1;
+    for (const auto& stage : stages_) {
+        end = std::max(end, stage.end_us);
+    }
+    for (const auto& milestone : milestones_) {
+        end = std::max(end, milestone.time_us);
+    }
+
+    // 每个阶段一行：等待依赖的时间画成 '.'，运行时间画成 '#'
+    ESP_LOGI(TAG, "Boot timeline (ms since power-on, %d ms per column):", int(end / 1000 / BOOT_TIMELINE_WIDTH) + 1);
+    char bar[BOOT_TIMELINE_WIDTH + 1];
+    for (const auto& stage : stages_) {
+        int created = stage.created_us * BOOT_TIMELINE_WIDTH / end;
+        int start = stage.start_us * BOOT_TIMELINE_WIDTH / end;
+        int finish = std::max<int>(start + 1, stage.end_us * BOOT_TIMELINE_WIDTH / end);
+        for (int i = 0; i < BOOT_TIMELINE_WIDTH; i++) {
+            bar[i] = i >= start && i < finish ? '#' : (i >= created && i < start ? '.' : ' ');
+        }
+        bar[BOOT_TIMELINE_WIDTH] = '\0';
+        ESP_LOGI(TAG, "  %-14s |%s| %5d..%5d ms (waited %d ms, %s)", stage.name, bar,
+                 int(stage.start_us / 1000), int(stage.end_us / 1000),
+                 int((stage.start_us - stage.created_us) / 1000), stage.stack_size > 0 ? "task" : "inline");
+    }
+    for (const auto& milestone : milestones_) {
+        ESP_LOGI(TAG, "  * %s at %d ms", milestone.name, int(milestone.time_us / 1000));
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef _BOOT_ORCHESTRATOR_H_
+#define _BOOT_ORCHESTRATOR_H_
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief 启动编排器
+ *
+ * 启动过程拆成若干阶段并声明依赖。有栈大小的阶段在各自的临时任务中运行，
+ * 依赖满足后立即开始，互不依赖的阶段并行执行；栈大小为 0 的阶段在调用 Run
+ * 的任务上按添加顺序执行。每个阶段的等待/运行时间和里程碑都记录在启动时间线里，
+ * 时间以 esp_timer 计，即从上电开始的毫秒数。
+ */
+class BootOrchestrator {
+public:
+    using Stage = int;
+    static constexpr int kMaxStages = 16;
+
+    BootOrchestrator();
+    ~BootOrchestrator();
+
+    /**
+     * @brief 添加阶段，必须在 Run 之前调用
+     * @param deps 依赖的阶段，全部完成后才开始执行
+     * @param stack_size 阶段任务的栈大小，0 表示在调用 Run 的任务上执行
+     */
+    Stage AddStage(const char* name, std::function<void()> fn,
+                   std::initializer_list<Stage> deps = {}, uint32_t stack_size = 0);
+
+    /**
+     * @brief 启动所有任务阶段，然后依次执行内联阶段；不等待任务阶段完成
+     */
+    void Run();
+
+    void Wait(Stage stage);
+    bool IsDone(Stage stage) const;
+
+    /**
+     * @brief 在时间线上记录里程碑，可在任意任务中调用
+     */
+    void Mark(const char* milestone);
+
+    void PrintTimeline();
+
+private:
+    struct StageInfo {
+        BootOrchestrator* owner;
+        const char* name;
+        std::function<void()> fn;
+        EventBits_t deps;
+        uint32_t stack_size;
+        int64_t created_us;
+        int64_t start_us;
+        int64_t end_us;
+    };
+
+    struct Milestone {
+        const char* name;
+        int64_t time_us;
+    };
+
+    void RunStage(StageInfo& stage);
+
+    EventGroupHandle_t event_group_ = nullptr;
+    std::vector<StageInfo> stages_;
+    std::vector<Milestone> milestones_;
+    std::mutex mutex_;
+    int remaining_ = 0;
+    bool timeline_printed_ = false;
+};
+
+#endif // _BOOT_ORCHESTRATOR_H_
@@ -0,0 +1,121 @@
+#include "companion_state.h"
+#include "persistent_store.h"
+
+#include <esp_log.h>
+
+namespace xiaozhi {
+
+static const char* TAG = "CompanionState";
+
+static const char* kNamespace = "companion";
+static const char* kSlotKeys[2] = {"snap_a", "snap_b"};
+
+CompanionState& CompanionState::GetInstance() {
+  static CompanionState instance;
+  return instance;
+}
+
+CompanionState::CompanionState() {
+  PersistentStore::GetInstance().AddFlushHook([this]() { OnFlush(); });
+}
+
+void CompanionState::LoadLocked() {
+  if (loaded_) {
+    return;
+  }
+  loaded_ = true;
+
+  auto& store = PersistentStore::GetInstance();
+  bool found = false;
+  for (int slot = 0; slot < 2; slot++) {
+    std::vector<uint8_t> data;
+    if (!store.Load(kNamespace, kSlotKeys[slot], data)) {
+      continue;
+    }
+
+    std::vector<snapshot::Section> sections;
+    uint32_t sequence = 0;
+    if (!snapshot::Decode(data.data(), data.size(), sections, sequence)) {
+      ESP_LOGW(TAG, "Snapshot slot %s is corrupted, ignored", kSlotKeys[slot]);
+      continue;
+    }
+    // 序号允许回绕，取较新的一份
+    if (!found || static_cast<int32_t>(sequence - sequence_) > 0) {
+      found = true;
+      sequence_ = sequence;
+      sections_ = std::move(sections);
+    }
+  }
+
+  if (found) {
+    ESP_LOGI(TAG, "Loaded snapshot #%lu with %u sections", sequence_, sections_.size());
+  }
+}
+
+bool CompanionState::ReadSection(uint8_t id, snapshot::Section& section) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadLocked();
+  for (const auto& s : sections_) {
+    if (s.id == id) {
+      section = s;
+      return true;
+    }
+  }
+  return false;
+}
+
+void CompanionState::WriteSection(uint8_t id, uint8_t schema,
+                                  const snapshot::SectionWriter& writer) {
+  if (!writer.ok()) {
+    // 字段或 section 超长时保留上一份数据，不写入会被读错的内容
+    ESP_LOGE(TAG, "Section %u exceeds the snapshot format limits, not saved", id);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LoadLocked();
+
+    snapshot::Section* target = nullptr;
+    for (auto& s : sections_) {
+      if (s.id == id) {
+        target = &s;
+        break;
+      }
+    }
+    if (target == nullptr) {
+      sections_.push_back({id, schema, {}});
+      target = &sections_.back();
+    }
+    if (target->schema == schema && target->data == writer.data()) {
+      return;
+    }
+    target->schema = schema;
+    target->data = writer.data();
+    dirty_ = true;
+  }
+  PersistentStore::GetInstance().RequestFlush();
+}
+
+void CompanionState::OnFlush() {
+  std::vector<uint8_t> data;
+  int slot;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!dirty_) {
+      return;
+    }
+    dirty_ = false;
+    if (!snapshot::Encode(sections_, sequence_ + 1, data)) {
+      ESP_LOGE(TAG, "Snapshot exceeds the format limits, not saved");
+      return;
+    }
+    sequence_++;
+    slot = sequence_ & 1;
+  }
+  // 写入与当前最新快照不同的槽位
+  PersistentStore::GetInstance().Store(kNamespace, kSlotKeys[slot], data.data(), data.size());
+  ESP_LOGD(TAG, "Encoded snapshot #%lu (%u bytes) into %s", sequence_, data.size(),
+           kSlotKeys[slot]);
+}
+
+}  // namespace xiaozhi
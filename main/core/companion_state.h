@@ -0,0 +1,59 @@
+#pragma once
+
+#include "snapshot_codec.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace xiaozhi {
+
+// ============================================================================
+// 陪伴状态快照 - 宠物、用户画像、情绪记忆共用一份带版本和 CRC 的快照
+// ============================================================================
+
+/**
+ * @brief 陪伴状态快照存储
+ *
+ * 各模块把自己的状态编码成一个 section 交给这里，实际的快照编码推迟到
+ * PersistentStore 落盘时才进行，并在 snap_a / snap_b 两个槽位之间交替写入：
+ * 任何一次写入中断都不会破坏另一个槽位，启动时取 CRC 有效且序号最新的一份。
+ */
+class CompanionState {
+ public:
+  enum SectionId : uint8_t {
+    kSectionPet = 1,
+    kSectionUserProfile = 2,
+    kSectionEmotionalMemory = 3,
+  };
+
+  static CompanionState& GetInstance();
+
+  /**
+   * @brief 读取 section（首次调用时加载快照）
+   * @return 快照中不存在该 section 时返回 false
+   */
+  bool ReadSection(uint8_t id, snapshot::Section& section);
+
+  /**
+   * @brief 更新 section 并请求一次防抖落盘
+   */
+  void WriteSection(uint8_t id, uint8_t schema, const snapshot::SectionWriter& writer);
+
+ private:
+  CompanionState();
+  ~CompanionState() = default;
+  CompanionState(const CompanionState&) = delete;
+  CompanionState& operator=(const CompanionState&) = delete;
+
+  void LoadLocked();
+  void OnFlush();
+
+  std::mutex mutex_;
+  bool loaded_ = false;
+  bool dirty_ = false;
+  uint32_t sequence_ = 0;
+  std::vector<snapshot::Section> sections_;
+};
+
+}  // namespace xiaozhi
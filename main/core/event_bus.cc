@@ -1,5 +1,6 @@
 #include "event_bus.h"
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <cstring>
 
 namespace xiaozhi {
@@ -240,31 +241,115 @@ esp_err_t EventBus::PublishFromISR(
   return ret;
 }
 
+EventBus::EventStats EventBus::GetStats() const {
+  EventStats stats = stats_;
+  for (size_t i = 0; i < kEventTypeCount; i++) {
+    stats.per_event[i] = fast_channel_.GetCounters(static_cast<EventType>(i));
+  }
+  return stats;
+}
+
 void EventBus::ResetStats() {
   stats_ = {0};
+  fast_channel_.ResetCounters();
 }
 
-}  // namespace xiaozhi
-
-
-
-
-
-
-
-
-
-
-
-
-
+// ========== 类型化快速路径 ==========
 
+// 快速路径事件在 esp_event 中对应的域和 ID，用于转发给旧的订阅者
+struct LegacyEventMapping {
+  esp_event_base_t base;
+  int32_t id;
+};
 
+static LegacyEventMapping GetLegacyMapping(EventType type) {
+  switch (type) {
+    case EventType::kPetStateChanged:
+      return {PET_EVENT, PET_STATE_CHANGED};
+    case EventType::kEmotionSet:
+      return {EMO_EVENT, EMO_SET};
+    case EventType::kConversationEnd:
+      return {LOGIC_EVENT, LOGIC_CONVERSATION_END};
+    case EventType::kUserFeedback:
+      return {LOGIC_EVENT, LOGIC_USER_FEEDBACK};
+    default:
+      return {nullptr, 0};
+  }
+}
 
+static size_t GetPayloadSize(EventType type) {
+  switch (type) {
+    case EventType::kPetStateChanged:
+      return sizeof(PetStateEventData);
+    case EventType::kEmotionSet:
+      return sizeof(EmoEventData);
+    case EventType::kConversationEnd:
+      return sizeof(ConversationEventData);
+    case EventType::kUserFeedback:
+      return sizeof(UserFeedbackData);
+    default:
+      return 0;
+  }
+}
 
+int64_t EventBus::NowUs() {
+  return esp_timer_get_time();
+}
 
+bool EventBus::PublishFast(EventType type, const EventPayload& payload) {
+  bool queued = false;
+  bool ok = fast_channel_.Publish(type, payload, queued);
+  if (queued) {
+    TaskHandle_t task = fast_task_.load(std::memory_order_acquire);
+    if (task != nullptr) {
+      xTaskNotifyGive(task);
+    }
+  } else if (!ok) {
+    ESP_LOGW(TAG, "Fast event queue full, event %u dropped", static_cast<unsigned>(type));
+  }
 
+  // 兼容通过 esp_event 订阅的旧代码，未初始化时不产生任何开销
+  if (initialized_) {
+    auto mapping = GetLegacyMapping(type);
+    if (mapping.base != nullptr) {
+      PublishNonBlocking(mapping.base, mapping.id, &payload, GetPayloadSize(type));
+    }
+  }
+  return ok;
+}
 
+bool EventBus::StartFastDispatcher() {
+  if (fast_task_.load(std::memory_order_acquire) != nullptr) {
+    return true;
+  }
 
+  static std::atomic_flag starting = ATOMIC_FLAG_INIT;
+  while (starting.test_and_set(std::memory_order_acquire)) {
+    vTaskDelay(1);
+  }
+  bool ok = fast_task_.load(std::memory_order_acquire) != nullptr;
+  if (!ok) {
+    TaskHandle_t task = nullptr;
+    ok = xTaskCreate(FastDispatchTask, "event_fast", 3072, this, 5, &task) == pdPASS;
+    if (ok) {
+      fast_task_.store(task, std::memory_order_release);
+      // 任务句柄发布之前入队的事件在这里补一次唤醒
+      xTaskNotifyGive(task);
+      ESP_LOGI(TAG, "Fast event dispatcher started (queue: %u)", kFastQueueSize);
+    } else {
+      ESP_LOGE(TAG, "Failed to create fast event dispatcher");
+    }
+  }
+  starting.clear(std::memory_order_release);
+  return ok;
+}
 
+void EventBus::FastDispatchTask(void* arg) {
+  auto* bus = static_cast<EventBus*>(arg);
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    bus->fast_channel_.Drain();
+  }
+}
 
+}  // namespace xiaozhi
@@ -2,9 +2,13 @@
 
 #include <esp_event.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <functional>
 #include <string>
 
+#include "fast_event.h"
+
 namespace xiaozhi {
 
 // ============================================================================
@@ -75,35 +79,7 @@ enum LearningEventId {
   LEARNING_DECISION_MADE,       // 做出决策
 };
 
-// ============================================================================
-// 事件数据结构
-// ============================================================================
-
-// 宠物状态事件数据
-struct PetStateEventData {
-  int mood;
-  int satiety;
-  int cleanliness;
-  int overall;
-};
-
-// 表情事件数据
-struct EmoEventData {
-  char emotion[32];  // 表情名称
-};
-
-// 对话事件数据
-struct ConversationEventData {
-  char topic[64];         // 话题类型（如 "weather", "pet", "story"）
-  bool positive_feedback; // 是否正面反馈
-  uint32_t duration_ms;   // 对话时长（毫秒）
-};
-
-// 用户反馈事件数据
-struct UserFeedbackData {
-  bool is_positive;  // true=点赞，false=点踩
-  char context[32];  // 反馈上下文
-};
+// 事件数据结构见 fast_event.h
 
 // ============================================================================
 // 事件总线类
@@ -162,6 +138,40 @@ class EventBus {
       size_t event_data_size = 0
   );
 
+  // ========== 类型化快速路径 ==========
+
+  /**
+   * @brief 订阅类型化事件（不经过 esp_event，不分配内存）
+   * @param mode kInline 在发布者上下文中同步调用，kDeferred 由分发任务调用
+   * @return 订阅表已满或分发任务创建失败时返回 false
+   */
+  template <EventType T>
+  bool SubscribeFast(FastEventHandler handler, void* ctx = nullptr,
+                     DispatchMode mode = DispatchMode::kDeferred) {
+    if (mode == DispatchMode::kDeferred && !StartFastDispatcher()) {
+      return false;
+    }
+    return fast_channel_.Subscribe(T, handler, ctx, mode);
+  }
+
+  /**
+   * @brief 发布类型化事件，永不阻塞，可在任意任务中调用
+   *
+   * 事件总线（esp_event）已初始化时还会转发一份给旧的订阅者。
+   * @return 队列满导致事件被丢弃时返回 false
+   */
+  template <EventType T>
+  bool PublishFast(const typename EventTraits<T>::Payload& data) {
+    EventPayload payload;
+    EventTraits<T>::Get(payload) = data;
+    return PublishFast(T, payload);
+  }
+
+  // 获取快速路径中单个事件类型的统计
+  FastEventCounters GetFastStats(EventType type) const {
+    return fast_channel_.GetCounters(type);
+  }
+
   // ========== 辅助工具 ==========
   
   // 获取事件循环句柄（供高级用户直接使用）
@@ -172,8 +182,9 @@ class EventBus {
     uint32_t total_published;
     uint32_t total_dropped;
     uint32_t queue_overflow_count;
+    FastEventCounters per_event[kEventTypeCount];  // 快速路径按事件统计
   };
-  EventStats GetStats() const { return stats_; }
+  EventStats GetStats() const;
 
   // 重置统计
   void ResetStats();
@@ -184,7 +195,18 @@ class EventBus {
   EventBus(const EventBus&) = delete;
   EventBus& operator=(const EventBus&) = delete;
 
+  // 快速路径队列深度和每个事件的订阅者上限
+  static constexpr size_t kFastQueueSize = 16;
+  static constexpr size_t kMaxFastSubscribers = 4;
+
+  bool PublishFast(EventType type, const EventPayload& payload);
+  bool StartFastDispatcher();
+  static void FastDispatchTask(void* arg);
+  static int64_t NowUs();
+
   esp_event_loop_handle_t event_loop_ = nullptr;
+  FastEventChannel<kFastQueueSize, kMaxFastSubscribers, &EventBus::NowUs> fast_channel_;
+  std::atomic<TaskHandle_t> fast_task_{nullptr};
   bool initialized_ = false;
   EventStats stats_ = {0};
 };
@@ -206,26 +228,3 @@ class EventBus {
   EventBus::GetInstance().Publish(base, id, nullptr, 0)
 
 }  // namespace xiaozhi
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
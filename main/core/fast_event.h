@@ -0,0 +1,346 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace xiaozhi {
+
+// ============================================================================
+// 事件数据结构
+// ============================================================================
+
+// 宠物状态事件数据
+struct PetStateEventData {
+  int mood;
+  int satiety;
+  int cleanliness;
+  int overall;
+};
+
+// 表情事件数据
+struct EmoEventData {
+  char emotion[32];  // 表情名称
+};
+
+// 对话事件数据
+struct ConversationEventData {
+  char topic[64];         // 话题类型（如 "weather", "pet", "story"）
+  bool positive_feedback; // 是否正面反馈
+  uint32_t duration_ms;   // 对话时长（毫秒）
+};
+
+// 用户反馈事件数据
+struct UserFeedbackData {
+  bool is_positive;  // true=点赞，false=点踩
+  char context[32];  // 反馈上下文
+};
+
+// ============================================================================
+// 快速路径：进程内类型化事件
+//
+// 事件类型在编译期确定，载荷放在定长 union 里按值进入无锁 MPSC 环形队列，
+// 订阅者是静态表里的函数指针，发布和分发过程都不分配内存。
+// 本文件不依赖 ESP-IDF，时钟由模板参数注入，可以在主机上编译测试。
+// ============================================================================
+
+enum class EventType : uint8_t {
+  kPetStateChanged = 0,   // 宠物状态改变
+  kEmotionSet,            // 设置表情
+  kConversationEnd,       // 对话结束
+  kUserFeedback,          // 用户反馈
+  kCount,
+};
+
+constexpr size_t kEventTypeCount = static_cast<size_t>(EventType::kCount);
+
+union EventPayload {
+  PetStateEventData pet;
+  EmoEventData emotion;
+  ConversationEventData conversation;
+  UserFeedbackData feedback;
+};
+
+// 事件类型到载荷类型的编译期映射
+template <EventType T>
+struct EventTraits;
+
+template <>
+struct EventTraits<EventType::kPetStateChanged> {
+  using Payload = PetStateEventData;
+  static Payload& Get(EventPayload& p) { return p.pet; }
+  static const Payload& Get(const EventPayload& p) { return p.pet; }
+};
+
+template <>
+struct EventTraits<EventType::kEmotionSet> {
+  using Payload = EmoEventData;
+  static Payload& Get(EventPayload& p) { return p.emotion; }
+  static const Payload& Get(const EventPayload& p) { return p.emotion; }
+};
+
+template <>
+struct EventTraits<EventType::kConversationEnd> {
+  using Payload = ConversationEventData;
+  static Payload& Get(EventPayload& p) { return p.conversation; }
+  static const Payload& Get(const EventPayload& p) { return p.conversation; }
+};
+
+template <>
+struct EventTraits<EventType::kUserFeedback> {
+  using Payload = UserFeedbackData;
+  static Payload& Get(EventPayload& p) { return p.feedback; }
+  static const Payload& Get(const EventPayload& p) { return p.feedback; }
+};
+
+struct FastEvent {
+  EventType type;
+  int64_t publish_us;     // 发布时刻，用于统计分发延迟
+  EventPayload payload;
+
+  template <EventType T>
+  const typename EventTraits<T>::Payload& As() const {
+    return EventTraits<T>::Get(payload);
+  }
+};
+
+using FastEventHandler = void (*)(const FastEvent& event, void* ctx);
+
+enum class DispatchMode : uint8_t {
+  kDeferred,  // 由分发任务异步调用
+  kInline,    // 在发布者上下文中同步调用，只适用于耗时极短且不阻塞的处理函数
+};
+
+// 单个事件类型的统计
+struct FastEventCounters {
+  uint32_t published;
+  uint32_t dropped;         // 队列满而丢弃
+  uint32_t dispatched;      // 异步分发次数
+  uint32_t max_latency_us;  // 发布到异步分发的最大延迟
+  uint32_t avg_latency_us;  // 平均延迟（指数滑动平均）
+};
+
+/**
+ * @brief 有界无锁多生产者单消费者环形队列
+ *
+ * 每个槽位带序号：生产者用 CAS 抢占写位置，消费者按序读取，
+ * 队列满时 TryPush 立即失败而不阻塞，因此也可以在 ISR 中使用。
+ */
+template <typename T, size_t N>
+class MpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "capacity must be a power of two");
+
+ public:
+  MpscRing() {
+    for (size_t i = 0; i < N; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool TryPush(const T& value) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells_[pos & (N - 1)];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = value;
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 只能由唯一的消费者调用
+  bool TryPop(T& value) {
+    Cell& cell = cells_[dequeue_pos_ & (N - 1)];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeue_pos_ + 1) < 0) {
+      return false;
+    }
+    value = cell.value;
+    cell.sequence.store(dequeue_pos_ + N, std::memory_order_release);
+    dequeue_pos_++;
+    return true;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  Cell cells_[N];
+  std::atomic<size_t> enqueue_pos_{0};
+  size_t dequeue_pos_ = 0;
+};
+
+/**
+ * @brief 类型化事件通道：静态订阅表 + MPSC 队列 + 按事件统计
+ *
+ * Publish() 可以由任意任务并发调用；Drain() 只能由一个分发任务调用。
+ * 没有异步订阅者的事件不进入队列，没有任何订阅者的事件只计数。
+ */
+template <size_t Capacity, size_t MaxSubscribers, int64_t (*NowUs)()>
+class FastEventChannel {
+ public:
+  FastEventChannel() { ResetCounters(); }
+
+  /**
+   * @brief 注册订阅者（通常在初始化阶段调用）
+   * @return 该事件的订阅表已满时返回 false
+   */
+  bool Subscribe(EventType type, FastEventHandler handler, void* ctx, DispatchMode mode) {
+    if (handler == nullptr || type >= EventType::kCount) {
+      return false;
+    }
+    while (register_lock_.test_and_set(std::memory_order_acquire)) {
+    }
+    auto& table = tables_[Index(type)];
+    uint8_t count = table.count.load(std::memory_order_relaxed);
+    bool ok = count < MaxSubscribers;
+    if (ok) {
+      table.subscribers[count] = {handler, ctx, mode};
+      if (mode == DispatchMode::kDeferred) {
+        table.deferred.fetch_add(1, std::memory_order_relaxed);
+      }
+      // 先写好表项再发布数量，发布者读到的表项总是完整的
+      table.count.store(count + 1, std::memory_order_release);
+    }
+    register_lock_.clear(std::memory_order_release);
+    return ok;
+  }
+
+  /**
+   * @brief 发布事件：先同步调用内联订阅者，再把事件放入队列
+   * @param queued 事件进入队列时置为 true，调用方据此唤醒分发任务
+   * @return 队列满导致异步订阅者收不到事件时返回 false
+   */
+  bool Publish(EventType type, const EventPayload& payload, bool& queued) {
+    queued = false;
+    size_t index = Index(type);
+    auto& table = tables_[index];
+    auto& counters = counters_[index];
+    counters.published.fetch_add(1, std::memory_order_relaxed);
+
+    uint8_t count = table.count.load(std::memory_order_acquire);
+    if (count == 0) {
+      return true;
+    }
+
+    FastEvent event;
+    event.type = type;
+    event.publish_us = NowUs();
+    event.payload = payload;
+
+    for (uint8_t i = 0; i < count; i++) {
+      const auto& subscriber = table.subscribers[i];
+      if (subscriber.mode == DispatchMode::kInline) {
+        subscriber.handler(event, subscriber.ctx);
+      }
+    }
+
+    if (table.deferred.load(std::memory_order_relaxed) == 0) {
+      return true;
+    }
+    if (!ring_.TryPush(event)) {
+      counters.dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    queued = true;
+    return true;
+  }
+
+  /**
+   * @brief 取出队列中的全部事件并调用异步订阅者
+   * @return 分发的事件数
+   */
+  size_t Drain() {
+    size_t drained = 0;
+    FastEvent event;
+    while (ring_.TryPop(event)) {
+      size_t index = Index(event.type);
+      auto& table = tables_[index];
+      auto& counters = counters_[index];
+
+      int64_t latency = NowUs() - event.publish_us;
+      uint32_t latency_us = latency > 0 ? static_cast<uint32_t>(latency) : 0;
+      if (latency_us > counters.max_latency_us.load(std::memory_order_relaxed)) {
+        counters.max_latency_us.store(latency_us, std::memory_order_relaxed);
+      }
+      uint32_t avg = counters.avg_latency_us.load(std::memory_order_relaxed);
+      avg = avg - avg / 8 + latency_us / 8;
+      counters.avg_latency_us.store(avg, std::memory_order_relaxed);
+      counters.dispatched.fetch_add(1, std::memory_order_relaxed);
+
+      uint8_t count = table.count.load(std::memory_order_acquire);
+      for (uint8_t i = 0; i < count; i++) {
+        const auto& subscriber = table.subscribers[i];
+        if (subscriber.mode == DispatchMode::kDeferred) {
+          subscriber.handler(event, subscriber.ctx);
+        }
+      }
+      drained++;
+    }
+    return drained;
+  }
+
+  FastEventCounters GetCounters(EventType type) const {
+    const auto& c = counters_[Index(type)];
+    return {
+        c.published.load(std::memory_order_relaxed),
+        c.dropped.load(std::memory_order_relaxed),
+        c.dispatched.load(std::memory_order_relaxed),
+        c.max_latency_us.load(std::memory_order_relaxed),
+        c.avg_latency_us.load(std::memory_order_relaxed),
+    };
+  }
+
+  void ResetCounters() {
+    for (auto& c : counters_) {
+      c.published.store(0, std::memory_order_relaxed);
+      c.dropped.store(0, std::memory_order_relaxed);
+      c.dispatched.store(0, std::memory_order_relaxed);
+      c.max_latency_us.store(0, std::memory_order_relaxed);
+      c.avg_latency_us.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  struct Subscriber {
+    FastEventHandler handler;
+    void* ctx;
+    DispatchMode mode;
+  };
+
+  struct Table {
+    Subscriber subscribers[MaxSubscribers] = {};
+    std::atomic<uint8_t> count{0};
+    std::atomic<uint8_t> deferred{0};
+  };
+
+  struct Counters {
+    std::atomic<uint32_t> published;
+    std::atomic<uint32_t> dropped;
+    std::atomic<uint32_t> dispatched;
+    std::atomic<uint32_t> max_latency_us;
+    std::atomic<uint32_t> avg_latency_us;
+  };
+
+  static size_t Index(EventType type) { return static_cast<size_t>(type); }
+
+  Table tables_[kEventTypeCount];
+  Counters counters_[kEventTypeCount];
+  std::atomic_flag register_lock_ = ATOMIC_FLAG_INIT;
+  MpscRing<FastEvent, Capacity> ring_;
+};
+
+}  // namespace xiaozhi
@@ -0,0 +1,283 @@
+#include "snapshot_codec.h"
+
+#include <cstring>
+
+namespace xiaozhi {
+namespace snapshot {
+
+namespace {
+
+constexpr size_t kSectionHeaderSize = 4;
+
+void PutLe(std::vector<uint8_t>& out, uint64_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+uint64_t GetLe(const uint8_t* data, size_t bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; i++) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+}  // namespace
+
+uint32_t Crc32(const uint8_t* data, size_t length, uint32_t crc) {
+  // 4 位查表的 CRC-32 (IEEE 802.3)，表只有 64 字节
+  static const uint32_t table[16] = {
+      0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+      0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+      0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+// ============================================================================
+// SectionWriter
+// ============================================================================
+
+void SectionWriter::Put(uint8_t tag, const void* value, size_t length) {
+  if (length > kMaxFieldLength) {
+    // 截断会让读取方得到错误的数据，整个字段丢弃并标记失败
+    ok_ = false;
+    return;
+  }
+  data_.push_back(tag);
+  data_.push_back(static_cast<uint8_t>(length));
+  auto bytes = static_cast<const uint8_t*>(value);
+  data_.insert(data_.end(), bytes, bytes + length);
+}
+
+void SectionWriter::PutU16(uint8_t tag, uint16_t value) {
+  uint8_t buf[2] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+  Put(tag, buf, sizeof(buf));
+}
+
+void SectionWriter::PutU32(uint8_t tag, uint32_t value) {
+  uint8_t buf[4];
+  for (int i = 0; i < 4; i++) {
+    buf[i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+  Put(tag, buf, sizeof(buf));
+}
+
+void SectionWriter::PutI64(uint8_t tag, int64_t value) {
+  uint8_t buf[8];
+  for (int i = 0; i < 8; i++) {
+    buf[i] = static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i));
+  }
+  Put(tag, buf, sizeof(buf));
+}
+
+void SectionWriter::PutF32(uint8_t tag, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  PutU32(tag, bits);
+}
+
+void SectionWriter::PutString(uint8_t tag, const std::string& value) {
+  Put(tag, value.data(), value.size());
+}
+
+void SectionWriter::PutU32Array(uint8_t tag, const uint32_t* values, size_t count) {
+  std::vector<uint8_t> buf;
+  buf.reserve(count * 4);
+  for (size_t i = 0; i < count; i++) {
+    PutLe(buf, values[i], 4);
+  }
+  Put(tag, buf.data(), buf.size());
+}
+
+// ============================================================================
+// SectionReader
+// ============================================================================
+
+bool SectionReader::Find(uint8_t tag, const uint8_t*& value, size_t& length) const {
+  size_t offset = 0;
+  while (offset + 2 <= length_) {
+    uint8_t field_tag = data_[offset];
+    size_t field_length = data_[offset + 1];
+    if (offset + 2 + field_length > length_) {
+      return false;
+    }
+    if (field_tag == tag) {
+      value = data_ + offset + 2;
+      length = field_length;
+      return true;
+    }
+    offset += 2 + field_length;
+  }
+  return false;
+}
+
+bool SectionReader::GetU8(uint8_t tag, uint8_t& value) const {
+  const uint8_t* field;
+  size_t length;
+  if (!Find(tag, field, length) || length != 1) {
+    return false;
+  }
+  value = field[0];
+  return true;
+}
+
+bool SectionReader::GetU16(uint8_t tag, uint16_t& value) const {
+  const uint8_t* field;
+  size_t length;
+  if (!Find(tag, field, length) || length != 2) {
+    return false;
+  }
+  value = static_cast<uint16_t>(GetLe(field, 2));
+  return true;
+}
+
+bool SectionReader::GetU32(uint8_t tag, uint32_t& value) const {
+  const uint8_t* field;
+  size_t length;
+  if (!Find(tag, field, length) || length != 4) {
+    return false;
+  }
+  value = static_cast<uint32_t>(GetLe(field, 4));
+  return true;
+}
+
+bool SectionReader::GetI32(uint8_t tag, int32_t& value) const {
+  uint32_t bits;
+  if (!GetU32(tag, bits)) {
+    return false;
+  }
+  value = static_cast<int32_t>(bits);
+  return true;
+}
+
+bool SectionReader::GetI64(uint8_t tag, int64_t& value) const {
+  const uint8_t* field;
+  size_t length;
+  if (!Find(tag, field, length) || length != 8) {
+    return false;
+  }
+  value = static_cast<int64_t>(GetLe(field, 8));
+  return true;
+}
+
+bool SectionReader::GetF32(uint8_t tag, float& value) const {
+  uint32_t bits;
+  if (!GetU32(tag, bits)) {
+    return false;
+  }
+  memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+bool SectionReader::GetString(uint8_t tag, std::string& value) const {
+  const uint8_t* field;
+  size_t length;
+  if (!Find(tag, field, length)) {
+    return false;
+  }
+  value.assign(reinterpret_cast<const char*>(field), length);
+  return true;
+}
+
+bool SectionReader::GetBytes(uint8_t tag, void* data, size_t length) const {
+  const uint8_t* field;
+  size_t field_length;
+  if (!Find(tag, field, field_length) || field_length != length) {
+    return false;
+  }
+  memcpy(data, field, length);
+  return true;
+}
+
+bool SectionReader::GetU32Array(uint8_t tag, uint32_t* values, size_t count) const {
+  const uint8_t* field;
+  size_t length;
+  if (!Find(tag, field, length) || length != count * 4) {
+    return false;
+  }
+  for (size_t i = 0; i < count; i++) {
+    values[i] = static_cast<uint32_t>(GetLe(field + i * 4, 4));
+  }
+  return true;
+}
+
+// ============================================================================
+// 快照编解码
+// ============================================================================
+
+bool Encode(const std::vector<Section>& sections, uint32_t sequence, std::vector<uint8_t>& out) {
+  if (sections.size() > kMaxSections) {
+    return false;
+  }
+  std::vector<uint8_t> payload;
+  for (const auto& section : sections) {
+    if (section.data.size() > kMaxSectionLength) {
+      return false;
+    }
+    payload.push_back(section.id);
+    payload.push_back(section.schema);
+    PutLe(payload, section.data.size(), 2);
+    payload.insert(payload.end(), section.data.begin(), section.data.end());
+  }
+
+  out.clear();
+  out.reserve(kHeaderSize + payload.size());
+  PutLe(out, kMagic, 4);
+  out.push_back(kFormatVersion);
+  out.push_back(static_cast<uint8_t>(sections.size()));
+  PutLe(out, 0, 2);
+  PutLe(out, sequence, 4);
+  PutLe(out, payload.size(), 4);
+  // CRC 覆盖 CRC 字段之前的头部和全部 payload，序号损坏也能被发现
+  uint32_t crc = Crc32(out.data(), out.size());
+  PutLe(out, Crc32(payload.data(), payload.size(), crc), 4);
+  out.insert(out.end(), payload.begin(), payload.end());
+  return true;
+}
+
+bool Decode(const uint8_t* data, size_t length, std::vector<Section>& sections,
+            uint32_t& sequence) {
+  if (length < kHeaderSize || GetLe(data, 4) != kMagic || data[4] != kFormatVersion) {
+    return false;
+  }
+  uint8_t count = data[5];
+  sequence = static_cast<uint32_t>(GetLe(data + 8, 4));
+  size_t payload_length = GetLe(data + 12, 4);
+  uint32_t crc = static_cast<uint32_t>(GetLe(data + 16, 4));
+  if (payload_length != length - kHeaderSize) {
+    return false;
+  }
+  const uint8_t* payload = data + kHeaderSize;
+  if (Crc32(payload, payload_length, Crc32(data, kHeaderSize - 4)) != crc) {
+    return false;
+  }
+
+  sections.clear();
+  size_t offset = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    if (offset + kSectionHeaderSize > payload_length) {
+      return false;
+    }
+    Section section;
+    section.id = payload[offset];
+    section.schema = payload[offset + 1];
+    size_t section_length = GetLe(payload + offset + 2, 2);
+    offset += kSectionHeaderSize;
+    if (offset + section_length > payload_length) {
+      return false;
+    }
+    section.data.assign(payload + offset, payload + offset + section_length);
+    offset += section_length;
+    sections.push_back(std::move(section));
+  }
+  return offset == payload_length;
+}
+
+}  // namespace snapshot
+}  // namespace xiaozhi
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xiaozhi {
+namespace snapshot {
+
+// ============================================================================
+// 陪伴状态快照格式（小端序）
+//
+//   Header  : magic "CSNP"(4) | format(1) | section_count(1) | reserved(2)
+//             | sequence(4) | payload_len(4) | crc32(4)
+//   Section : id(1) | schema(1) | length(2) | fields...
+//   Field   : tag(1) | length(1) | value...
+//   crc32 覆盖它前面的 16 字节头部和全部 payload
+//
+// 字段按 tag 查找：新增字段时旧快照缺失的字段保持默认值，删除的字段被忽略；
+// 字段语义变化时提升 section 的 schema 版本，由读取方做迁移。
+// 本文件不依赖 ESP-IDF，可以在主机上编译测试。
+// ============================================================================
+
+constexpr uint32_t kMagic = 0x504E5343;  // "CSNP"
+constexpr uint8_t kFormatVersion = 1;
+constexpr size_t kHeaderSize = 20;
+// 字段长度和 section 长度的上限，由格式中长度字段的宽度决定
+constexpr size_t kMaxFieldLength = 0xFF;
+constexpr size_t kMaxSectionLength = 0xFFFF;
+constexpr size_t kMaxSections = 0xFF;
+
+uint32_t Crc32(const uint8_t* data, size_t length, uint32_t crc = 0);
+
+/**
+ * @brief 单个 section 的字段编码器
+ *
+ * 超过 kMaxFieldLength 的字段不会被截断写入，而是整体丢弃并让 ok() 返回 false，
+ * 调用方应放弃本次写入，保留上一份完整的数据。
+ */
+class SectionWriter {
+ public:
+  void PutU8(uint8_t tag, uint8_t value) { Put(tag, &value, 1); }
+  void PutU16(uint8_t tag, uint16_t value);
+  void PutU32(uint8_t tag, uint32_t value);
+  void PutI32(uint8_t tag, int32_t value) { PutU32(tag, static_cast<uint32_t>(value)); }
+  void PutI64(uint8_t tag, int64_t value);
+  void PutF32(uint8_t tag, float value);
+  void PutString(uint8_t tag, const std::string& value);
+  void PutBytes(uint8_t tag, const void* data, size_t length) { Put(tag, data, length); }
+  // 每个元素按小端序写入
+  void PutU32Array(uint8_t tag, const uint32_t* values, size_t count);
+
+  // 所有字段都完整写入，并且 section 没有超过 kMaxSectionLength
+  bool ok() const { return ok_ && data_.size() <= kMaxSectionLength; }
+  const std::vector<uint8_t>& data() const { return data_; }
+
+ private:
+  void Put(uint8_t tag, const void* value, size_t length);
+
+  std::vector<uint8_t> data_;
+  bool ok_ = true;
+};
+
+/**
+ * @brief 单个 section 的字段读取器，字段缺失或长度不符时保留调用方的默认值
+ */
+class SectionReader {
+ public:
+  SectionReader() = default;
+  SectionReader(uint8_t schema, const uint8_t* data, size_t length)
+      : schema_(schema), data_(data), length_(length) {}
+
+  uint8_t schema() const { return schema_; }
+
+  bool GetU8(uint8_t tag, uint8_t& value) const;
+  bool GetU16(uint8_t tag, uint16_t& value) const;
+  bool GetU32(uint8_t tag, uint32_t& value) const;
+  bool GetI32(uint8_t tag, int32_t& value) const;
+  bool GetI64(uint8_t tag, int64_t& value) const;
+  bool GetF32(uint8_t tag, float& value) const;
+  bool GetString(uint8_t tag, std::string& value) const;
+  bool GetBytes(uint8_t tag, void* data, size_t length) const;
+  bool GetU32Array(uint8_t tag, uint32_t* values, size_t count) const;
+
+ private:
+  bool Find(uint8_t tag, const uint8_t*& value, size_t& length) const;
+
+  uint8_t schema_ = 0;
+  const uint8_t* data_ = nullptr;
+  size_t length_ = 0;
+};
+
+struct Section {
+  uint8_t id = 0;
+  uint8_t schema = 0;
+  std::vector<uint8_t> data;
+};
+
+/**
+ * @brief 把多个 section 编码成带头部和 CRC 的完整快照
+ * @return section 数量或某个 section 的长度超出格式上限时返回 false，out 不变
+ */
+bool Encode(const std::vector<Section>& sections, uint32_t sequence, std::vector<uint8_t>& out);
+
+/**
+ * @brief 校验并解析快照
+ * @return magic、版本、长度或 CRC 任一不符时返回 false
+ */
+bool Decode(const uint8_t* data, size_t length, std::vector<Section>& sections,
+            uint32_t& sequence);
+
+}  // namespace snapshot
+}  // namespace xiaozhi
@@ -161,12 +161,13 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io,
   lvgl_port_init(&port_cfg);
 
   ESP_LOGI(TAG, "Adding LCD display");
-  const lvgl_port_display_cfg_t display_cfg = {
+  // 两块内部RAM的DMA缓冲区：LVGL 渲染一块的同时，另一块在 SPI 上异步传输
+  lvgl_port_display_cfg_t display_cfg = {
       .io_handle = panel_io_,
       .panel_handle = panel_,
       .control_handle = nullptr,
       .buffer_size = static_cast<uint32_t>(width_ * 20),  // 恢复20行（启用PSRAM后内存充足）
-      .double_buffer = false,
+      .double_buffer = true,
       .trans_size = 0,
       .hres = static_cast<uint32_t>(width_),
       .vres = static_cast<uint32_t>(height_),
@@ -190,6 +191,12 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io,
   };
 
   display_ = lvgl_port_add_disp(&display_cfg);
+  if (display_ == nullptr) {
+    // 内部RAM不足以放下两块缓冲区时退回单缓冲
+    ESP_LOGW(TAG, "Failed to add double-buffered display, fallback to single buffer");
+    display_cfg.double_buffer = false;
+    display_ = lvgl_port_add_disp(&display_cfg);
+  }
   if (display_ == nullptr) {
     ESP_LOGE(TAG, "Failed to add display");
     return;
@@ -199,9 +206,92 @@ SpiLcdDisplay::SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io,
     lv_display_set_offset(display_, offset_x, offset_y);
   }
 
+  RegisterFlushHooks();
   SetupUI();
 }
 
+void SpiLcdDisplay::RegisterFlushHooks() {
+  lv_display_add_event_cb(display_, OnInvalidateArea, LV_EVENT_INVALIDATE_AREA, this);
+  lv_display_add_event_cb(display_, OnFlushEvent, LV_EVENT_RENDER_START, this);
+  lv_display_add_event_cb(display_, OnFlushEvent, LV_EVENT_RENDER_READY, this);
+  lv_display_add_event_cb(display_, OnFlushEvent, LV_EVENT_FLUSH_START, this);
+  lv_display_add_event_cb(display_, OnFlushEvent, LV_EVENT_FLUSH_WAIT_START, this);
+  lv_display_add_event_cb(display_, OnFlushEvent, LV_EVENT_FLUSH_WAIT_FINISH, this);
+}
+
+void SpiLcdDisplay::OnInvalidateArea(lv_event_t *e) {
+  // 在区域进入失效列表前扩展到对齐边界，相邻的小区域（如状态栏图标、
+  // 字幕行）因此更容易被 LVGL 合并成一次 SPI 传输
+  auto *area = static_cast<lv_area_t *>(lv_event_get_param(e));
+  auto *disp = static_cast<lv_display_t *>(lv_event_get_current_target(e));
+  int32_t max_x = lv_display_get_horizontal_resolution(disp) - 1;
+  int32_t max_y = lv_display_get_vertical_resolution(disp) - 1;
+
+  area->x1 = area->x1 & ~(kFlushAlign - 1);
+  area->y1 = area->y1 & ~(kFlushAlign - 1);
+  area->x2 = std::min<int32_t>(area->x2 | (kFlushAlign - 1), max_x);
+  area->y2 = std::min<int32_t>(area->y2 | (kFlushAlign - 1), max_y);
+}
+
+void SpiLcdDisplay::OnFlushEvent(lv_event_t *e) {
+  auto *self = static_cast<SpiLcdDisplay *>(lv_event_get_user_data(e));
+  int64_t now = esp_timer_get_time();
+
+  switch (lv_event_get_code(e)) {
+  case LV_EVENT_RENDER_START:
+    self->frame_start_us_ = now;
+    self->frame_wait_us_ = 0;
+    break;
+  case LV_EVENT_FLUSH_START: {
+    auto *area = static_cast<const lv_area_t *>(lv_event_get_param(e));
+    self->flush_stats_.areas++;
+    self->flush_stats_.bytes += lv_area_get_size(area) * sizeof(uint16_t);
+    break;
+  }
+  case LV_EVENT_FLUSH_WAIT_START:
+    self->wait_start_us_ = now;
+    break;
+  case LV_EVENT_FLUSH_WAIT_FINISH:
+    self->frame_wait_us_ += now - self->wait_start_us_;
+    break;
+  case LV_EVENT_RENDER_READY: {
+    auto &stats = self->flush_stats_;
+    uint32_t frame_us = now - self->frame_start_us_;
+    stats.frames++;
+    stats.render_us += frame_us - self->frame_wait_us_;
+    stats.flush_wait_us += self->frame_wait_us_;
+    stats.max_frame_us = std::max(stats.max_frame_us, frame_us);
+
+    if (now - self->last_stats_log_us_ >= kFlushStatsLogIntervalUs) {
+      auto &last = self->logged_stats_;
+      uint32_t frames = stats.frames - last.frames;
+      if (frames > 0) {
+        ESP_LOGI(TAG, "Flush: %lu frames, %lu areas, %llu KB, render %llu us/frame, wait %llu us/frame, max %lu us",
+                 frames, stats.areas - last.areas, (stats.bytes - last.bytes) / 1024,
+                 (stats.render_us - last.render_us) / frames,
+                 (stats.flush_wait_us - last.flush_wait_us) / frames, stats.max_frame_us);
+      }
+      stats.max_frame_us = 0;
+      last = stats;
+      self->last_stats_log_us_ = now;
+    }
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+SpiLcdDisplay::FlushStats SpiLcdDisplay::GetFlushStats(bool reset) {
+  DisplayLockGuard lock(this);
+  FlushStats stats = flush_stats_;
+  if (reset) {
+    flush_stats_ = FlushStats();
+    logged_stats_ = FlushStats();
+  }
+  return stats;
+}
+
 // RGB LCD实现
 RgbLcdDisplay::RgbLcdDisplay(esp_lcd_panel_io_handle_t panel_io,
                              esp_lcd_panel_handle_t panel, int width,
@@ -57,9 +57,37 @@ public:
 // SPI LCD显示器
 class SpiLcdDisplay : public LcdDisplay {
 public:
+    // 刷新流水线统计
+    struct FlushStats {
+        uint32_t frames = 0;        // 渲染帧数
+        uint32_t areas = 0;         // 提交给 SPI 的区域数
+        uint64_t bytes = 0;         // 经 SPI 发送的像素字节数
+        uint64_t render_us = 0;     // LVGL 渲染耗时（不含等待 SPI）
+        uint64_t flush_wait_us = 0; // 渲染因缓冲区仍在传输而等待的耗时
+        uint32_t max_frame_us = 0;  // 单帧最长耗时
+    };
+
     SpiLcdDisplay(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_handle_t panel,
                   int width, int height, int offset_x, int offset_y,
                   bool mirror_x, bool mirror_y, bool swap_xy);
+
+    FlushStats GetFlushStats(bool reset = false);
+
+private:
+    // 刷新区域对齐到 2 像素，便于相邻区域合并，也满足部分面板控制器的窗口要求
+    static constexpr int kFlushAlign = 2;
+    static constexpr int64_t kFlushStatsLogIntervalUs = 10 * 1000 * 1000;
+
+    FlushStats flush_stats_;
+    FlushStats logged_stats_;
+    int64_t frame_start_us_ = 0;
+    int64_t frame_wait_us_ = 0;
+    int64_t wait_start_us_ = 0;
+    int64_t last_stats_log_us_ = 0;
+
+    void RegisterFlushHooks();
+    static void OnInvalidateArea(lv_event_t* e);
+    static void OnFlushEvent(lv_event_t* e);
 };
 
 // RGB LCD显示器
@@ -74,9 +74,16 @@ void LvglDisplay::SetStatus(const char* status) {
     if (status_label_ == nullptr) {
         return;
     }
-    lv_label_set_text(status_label_, status);
-    lv_obj_remove_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
-    lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+    // 文本和可见性没有变化时不触碰控件，避免状态栏时钟每次刷新都产生 SPI 传输
+    if (strcmp(lv_label_get_text(status_label_), status) != 0) {
+        lv_label_set_text(status_label_, status);
+    }
+    if (lv_obj_has_flag(status_label_, LV_OBJ_FLAG_HIDDEN)) {
+        lv_obj_remove_flag(status_label_, LV_OBJ_FLAG_HIDDEN);
+    }
+    if (!lv_obj_has_flag(notification_label_, LV_OBJ_FLAG_HIDDEN)) {
+        lv_obj_add_flag(notification_label_, LV_OBJ_FLAG_HIDDEN);
+    }
 
     last_status_update_time_ = std::chrono::system_clock::now();
 }
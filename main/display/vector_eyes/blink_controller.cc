@@ -49,6 +49,18 @@ void BlinkController::Blink() {
     }
 }
 
+uint32_t BlinkController::NextEventDelay(uint32_t now) const {
+    if (blinking_) {
+        return 0;
+    }
+    if (!auto_blink_enabled_) {
+        return UINT32_MAX;
+    }
+    uint32_t elapsed = now - last_blink_;
+    // Update() 在 elapsed > interval 时才触发眨眼
+    return elapsed > next_blink_interval_ ? 0 : next_blink_interval_ + 1 - elapsed;
+}
+
 void BlinkController::StartBlink() {
     blinking_ = true;
     blink_start_ = millis_idf();
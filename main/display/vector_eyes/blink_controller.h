@@ -42,6 +42,12 @@ public:
      */
     void SetBlinkInterval(uint32_t min_ms, uint32_t max_ms);
 
+    /**
+     * @brief 距下一次需要刷新的时间（毫秒）
+     * @return 正在眨眼时返回 0；未启用自动眨眼时返回 UINT32_MAX
+     */
+    uint32_t NextEventDelay(uint32_t now) const;
+
 private:
     void StartBlink();
     void ScheduleNextBlink();
@@ -36,6 +36,43 @@ struct EyeConfig {
     int16_t inverse_offset_top = 0;     ///< 上眼睑内凹偏移
     int16_t inverse_offset_bottom = 0;  ///< 下眼睑内凹偏移
 
+    bool operator==(const EyeConfig& other) const {
+        return offset_x == other.offset_x && offset_y == other.offset_y &&
+               height == other.height && width == other.width &&
+               slope_top == other.slope_top && slope_bottom == other.slope_bottom &&
+               radius_top == other.radius_top && radius_bottom == other.radius_bottom &&
+               inverse_radius_top == other.inverse_radius_top &&
+               inverse_radius_bottom == other.inverse_radius_bottom &&
+               inverse_offset_top == other.inverse_offset_top &&
+               inverse_offset_bottom == other.inverse_offset_bottom;
+    }
+
+    bool operator!=(const EyeConfig& other) const { return !(*this == other); }
+
+    /**
+     * @brief 定点线性插值两个配置，t 为 Q16 (0 ~ 65536)
+     */
+    static EyeConfig LerpQ16(const EyeConfig& a, const EyeConfig& b, uint32_t t) {
+        auto lerp = [t](int16_t from, int16_t to) -> int16_t {
+            return static_cast<int16_t>(from + (((to - from) * static_cast<int32_t>(t)) >> 16));
+        };
+        float tf = t / 65536.0f;
+        EyeConfig result;
+        result.offset_x = lerp(a.offset_x, b.offset_x);
+        result.offset_y = lerp(a.offset_y, b.offset_y);
+        result.height = lerp(a.height, b.height);
+        result.width = lerp(a.width, b.width);
+        result.slope_top = a.slope_top + (b.slope_top - a.slope_top) * tf;
+        result.slope_bottom = a.slope_bottom + (b.slope_bottom - a.slope_bottom) * tf;
+        result.radius_top = lerp(a.radius_top, b.radius_top);
+        result.radius_bottom = lerp(a.radius_bottom, b.radius_bottom);
+        result.inverse_radius_top = lerp(a.inverse_radius_top, b.inverse_radius_top);
+        result.inverse_radius_bottom = lerp(a.inverse_radius_bottom, b.inverse_radius_bottom);
+        result.inverse_offset_top = lerp(a.inverse_offset_top, b.inverse_offset_top);
+        result.inverse_offset_bottom = lerp(a.inverse_offset_bottom, b.inverse_offset_bottom);
+        return result;
+    }
+
     /**
      * @brief 线性插值两个配置
      */
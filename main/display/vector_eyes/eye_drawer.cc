@@ -0,0 +1,366 @@
+/**
+ * @file eye_drawer.cc
+ * @brief 眼睛光栅化绘制器实现 - Cozmo 风格
+ *
+ * 特点：
+ * 1. 直接写 canvas 的 RGB565 缓冲区，按扫描线填充，不创建 LVGL layer
+ * 2. 圆角和三角形边缘使用定点数计算
+ * 3. 背景为纯色，发光层颜色预先混合，无需逐像素 alpha 混合
+ * 4. 只擦除和刷新眼睛的包围盒，不再整屏重绘
+ */
+
+#include "eye_drawer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vector_eyes {
+
+// 静态成员初始化
+lv_obj_t *EyeDrawer::canvas_ = nullptr;
+uint16_t *EyeDrawer::buf_ = nullptr;
+int32_t EyeDrawer::buf_width_ = 0;
+int32_t EyeDrawer::buf_height_ = 0;
+int32_t EyeDrawer::stride_ = 0;
+lv_color_t EyeDrawer::draw_color_ = lv_color_white();
+lv_color_t EyeDrawer::bg_color_ = lv_color_black();
+uint16_t EyeDrawer::draw_pixel_ = 0xFFFF;
+uint16_t EyeDrawer::glow_pixel_ = 0;
+uint16_t EyeDrawer::bg_pixel_ = 0;
+lv_area_t EyeDrawer::prev_areas_[kMaxEyes];
+lv_area_t EyeDrawer::cur_areas_[kMaxEyes];
+int EyeDrawer::prev_count_ = 0;
+int EyeDrawer::cur_count_ = 0;
+
+// 发光层相对眼睛主体向外扩展的像素数
+static constexpr int32_t GLOW_SIZE = 3;
+// 斜边三角形相对眼睛主体向外扩展的像素数，需覆盖发光层
+static constexpr int32_t GLOW_EXTEND = 4;
+
+static uint32_t ISqrt(uint32_t n) {
+  uint32_t root = 0;
+  uint32_t bit = 1u << 30;
+  while (bit > n) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (n >= root + bit) {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// 半径为 r 的圆角在距边缘第 row 行时需要缩进的像素数（按像素中心判断，半像素精度）
+static int32_t CornerInset(int32_t r, int32_t row) {
+  int32_t d = 2 * (r - row) - 1;
+  int32_t s = ISqrt(static_cast<uint32_t>(4 * r * r - d * d));
+  int32_t inset = (2 * r - s) / 2;
+  return inset > 0 ? inset : 0;
+}
+
+void EyeDrawer::SetCanvas(lv_obj_t *canvas) {
+  canvas_ = canvas;
+  buf_ = nullptr;
+  prev_count_ = 0;
+  cur_count_ = 0;
+  if (!canvas_)
+    return;
+
+  lv_draw_buf_t *draw_buf = lv_canvas_get_draw_buf(canvas_);
+  if (!draw_buf || draw_buf->header.cf != LV_COLOR_FORMAT_RGB565)
+    return;
+
+  buf_ = reinterpret_cast<uint16_t *>(draw_buf->data);
+  buf_width_ = draw_buf->header.w;
+  buf_height_ = draw_buf->header.h;
+  stride_ = draw_buf->header.stride / sizeof(uint16_t);
+}
+
+void EyeDrawer::SetColor(lv_color_t color) { draw_color_ = color; }
+
+lv_color_t EyeDrawer::GetBgColor() { return bg_color_; }
+
+void EyeDrawer::Clear(lv_color_t bg_color) {
+  bg_color_ = bg_color;
+  bg_pixel_ = lv_color_to_u16(bg_color);
+  prev_count_ = 0;
+  if (!buf_)
+    return;
+
+  for (int32_t y = 0; y < buf_height_; y++) {
+    FillSpan(y, 0, buf_width_ - 1, bg_pixel_);
+  }
+  lv_obj_invalidate(canvas_);
+}
+
+void EyeDrawer::BeginFrame(lv_color_t bg_color) {
+  if (!lv_color_eq(bg_color, bg_color_)) {
+    Clear(bg_color);
+  }
+
+  draw_pixel_ = lv_color_to_u16(draw_color_);
+  glow_pixel_ = lv_color_to_u16(lv_color_mix(draw_color_, bg_color_, LV_OPA_30));
+
+  // 只擦除上一帧画过的区域
+  for (int i = 0; i < prev_count_; i++) {
+    const lv_area_t &area = prev_areas_[i];
+    for (int32_t y = area.y1; y <= area.y2; y++) {
+      FillSpan(y, area.x1, area.x2, bg_pixel_);
+    }
+  }
+  cur_count_ = 0;
+}
+
+void EyeDrawer::EndFrame() {
+  if (!canvas_)
+    return;
+
+  lv_area_t coords;
+  lv_obj_get_coords(canvas_, &coords);
+
+  int count = std::max(prev_count_, cur_count_);
+  for (int i = 0; i < count; i++) {
+    lv_area_t area;
+    if (i < prev_count_ && i < cur_count_) {
+      lv_area_join(&area, &prev_areas_[i], &cur_areas_[i]);
+    } else if (i < cur_count_) {
+      area = cur_areas_[i];
+    } else {
+      area = prev_areas_[i];
+    }
+    // 转换为屏幕坐标
+    lv_area_move(&area, coords.x1, coords.y1);
+    lv_obj_invalidate_area(canvas_, &area);
+  }
+
+  for (int i = 0; i < cur_count_; i++) {
+    prev_areas_[i] = cur_areas_[i];
+  }
+  prev_count_ = cur_count_;
+}
+
+void EyeDrawer::AddDirtyArea(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+  if (cur_count_ >= kMaxEyes)
+    return;
+
+  x1 = std::max<int32_t>(x1, 0);
+  y1 = std::max<int32_t>(y1, 0);
+  x2 = std::min<int32_t>(x2, buf_width_ - 1);
+  y2 = std::min<int32_t>(y2, buf_height_ - 1);
+  if (x1 > x2 || y1 > y2)
+    return;
+
+  cur_areas_[cur_count_++] = {x1, y1, x2, y2};
+}
+
+void EyeDrawer::FillSpan(int32_t y, int32_t x0, int32_t x1, uint16_t color) {
+  if (y < 0 || y >= buf_height_)
+    return;
+  x0 = std::max<int32_t>(x0, 0);
+  x1 = std::min<int32_t>(x1, buf_width_ - 1);
+  if (x0 > x1)
+    return;
+
+  std::fill_n(buf_ + y * stride_ + x0, x1 - x0 + 1, color);
+}
+
+void EyeDrawer::FillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                              int32_t r_top, int32_t r_bottom,
+                              uint16_t color) {
+  if (w <= 0 || h <= 0)
+    return;
+
+  // 与 LVGL 一致：圆角不超过短边的一半
+  int32_t max_r = std::min(w, h) / 2;
+  r_top = std::clamp<int32_t>(r_top, 0, max_r);
+  r_bottom = std::clamp<int32_t>(r_bottom, 0, max_r);
+
+  int32_t y_start = std::max<int32_t>(0, -y);
+  int32_t y_end = std::min<int32_t>(h, buf_height_ - y);
+  for (int32_t row = y_start; row < y_end; row++) {
+    int32_t inset = 0;
+    if (row < r_top) {
+      inset = CornerInset(r_top, row);
+    } else if (row >= h - r_bottom) {
+      inset = CornerInset(r_bottom, h - 1 - row);
+    }
+    FillSpan(y + row, x + inset, x + w - 1 - inset, color);
+  }
+}
+
+void EyeDrawer::FillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                             int32_t x2, int32_t y2, uint16_t color) {
+  // 按 y 排序顶点
+  if (y0 > y1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+  if (y1 > y2) {
+    std::swap(x1, x2);
+    std::swap(y1, y2);
+  }
+  if (y0 > y1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+
+  if (y0 == y2) {
+    FillSpan(y0, std::min({x0, x1, x2}), std::max({x0, x1, x2}), color);
+    return;
+  }
+
+  // 16.16 定点斜率
+  int32_t step_02 = ((x2 - x0) << 16) / (y2 - y0);
+  int32_t step_01 = y1 != y0 ? ((x1 - x0) << 16) / (y1 - y0) : 0;
+  int32_t step_12 = y2 != y1 ? ((x2 - x1) << 16) / (y2 - y1) : 0;
+
+  int32_t y_start = std::max<int32_t>(y0, 0);
+  int32_t y_end = std::min<int32_t>(y2, buf_height_ - 1);
+  for (int32_t y = y_start; y <= y_end; y++) {
+    int32_t xa = (x0 << 16) + step_02 * (y - y0);
+    int32_t xb = y < y1 ? (x0 << 16) + step_01 * (y - y0)
+                        : (x1 << 16) + step_12 * (y - y1);
+    if (xa > xb) {
+      std::swap(xa, xb);
+    }
+    FillSpan(y, (xa + 0x8000) >> 16, (xb + 0x8000) >> 16, color);
+  }
+}
+
+// 绘制笑眼（上凸下平，填充面积大）
+void EyeDrawer::DrawHappyArc(int32_t x, int32_t y, int32_t w, int32_t h,
+                             int32_t arc_height) {
+  if (w <= 0 || h <= 0)
+    return;
+
+  int32_t total_height = arc_height + h; // 总高度
+  int32_t top_radius = arc_height;       // 上边圆角 = 弧形高度
+  int32_t bottom_radius = 8;             // 下边很小的圆角，几乎是平的
+
+  // 发光效果
+  FillRoundRect(x - GLOW_SIZE, y - GLOW_SIZE, w + GLOW_SIZE * 2,
+                total_height + GLOW_SIZE * 2, top_radius, top_radius,
+                glow_pixel_);
+  // 主体：上边大圆角，下边小圆角
+  FillRoundRect(x, y, w, total_height, top_radius, bottom_radius, draw_pixel_);
+
+  AddDirtyArea(x - GLOW_SIZE, y - GLOW_SIZE, x + w - 1 + GLOW_SIZE,
+               y + total_height - 1 + GLOW_SIZE);
+}
+
+// 绘制梯形（带发光的圆角矩形，再用背景色三角形削出斜边）
+void EyeDrawer::DrawTrapezoid(int32_t x, int32_t y, int32_t w, int32_t h,
+                              float slope_top, float slope_bottom,
+                              int32_t radius) {
+  if (w <= 0 || h <= 0)
+    return;
+
+  // 绘制基础矩形（带发光效果）
+  FillRoundRect(x - GLOW_SIZE, y - GLOW_SIZE, w + GLOW_SIZE * 2,
+                h + GLOW_SIZE * 2, radius + GLOW_SIZE, radius + GLOW_SIZE,
+                glow_pixel_);
+  FillRoundRect(x, y, w, h, radius, radius, draw_pixel_);
+
+  // 三角形只画背景色，包围盒只需覆盖发光层
+  AddDirtyArea(x - GLOW_SIZE, y - GLOW_SIZE, x + w - 1 + GLOW_SIZE,
+               y + h - 1 + GLOW_SIZE);
+
+  // 用背景色三角形削掉边角，形成斜边
+  // 三角形区域需要扩大，覆盖发光层
+  if (slope_top != 0) {
+    int32_t cut_height = h / 2 + GLOW_EXTEND; // 固定切掉一半高度
+    int32_t cut_width =
+        static_cast<int32_t>(std::abs(slope_top) * w * 0.5f) + GLOW_EXTEND;
+
+    if (slope_top > 0) {
+      // 外高内低（愤怒）：削掉左上角
+      FillTriangle(x - GLOW_EXTEND - 1, y - GLOW_EXTEND - 1, // 左上角扩展
+                   x + cut_width, y - GLOW_EXTEND - 1,       // 右上角
+                   x - GLOW_EXTEND - 1, y + cut_height,      // 左下角
+                   bg_pixel_);
+    } else {
+      // 内高外低（悲伤）：削掉右上角
+      FillTriangle(x + w + GLOW_EXTEND, y - GLOW_EXTEND - 1,     // 右上角扩展
+                   x + w - cut_width, y - GLOW_EXTEND - 1,       // 左上角
+                   x + w + GLOW_EXTEND, y + cut_height,          // 右下角
+                   bg_pixel_);
+    }
+  }
+
+  if (slope_bottom != 0) {
+    int32_t cut_height = h / 3 + GLOW_EXTEND;
+    int32_t cut_width =
+        static_cast<int32_t>(std::abs(slope_bottom) * w * 0.5f) + GLOW_EXTEND;
+
+    if (slope_bottom > 0) {
+      // 削掉左下角
+      FillTriangle(x - GLOW_EXTEND - 1, y + h + GLOW_EXTEND,     // 左下角扩展
+                   x + cut_width, y + h + GLOW_EXTEND,           // 右下角
+                   x - GLOW_EXTEND - 1, y + h - cut_height,      // 左上角
+                   bg_pixel_);
+    } else {
+      // 削掉右下角
+      FillTriangle(x + w + GLOW_EXTEND, y + h + GLOW_EXTEND,     // 右下角扩展
+                   x + w - cut_width, y + h + GLOW_EXTEND,       // 左下角
+                   x + w + GLOW_EXTEND, y + h - cut_height,      // 右上角
+                   bg_pixel_);
+    }
+  }
+}
+
+void EyeDrawer::Draw(int16_t center_x, int16_t center_y, EyeConfig *config) {
+  if (!buf_ || !config)
+    return;
+
+  int16_t w = config->width;
+  int16_t h = config->height;
+
+  if (w < 2 || h < 2)
+    return;
+
+  // 计算边界
+  int32_t left = center_x + config->offset_x - w / 2;
+  int32_t top = center_y + config->offset_y - h / 2;
+
+  // 检查是否使用弧形绘制（inverse_offset_top > 0 表示笑眼弧形模式）
+  if (config->inverse_offset_top > 0) {
+    // 笑眼弧形模式：上凸下平的月牙形
+    DrawHappyArc(left, top, w, h, config->inverse_offset_top);
+    return;
+  }
+
+  // 计算圆角（取平均值，确保不超过一半）
+  int16_t r_top = std::min(config->radius_top,
+                           static_cast<int16_t>(std::min(w / 2, (int)h / 2)));
+  int16_t r_bottom = std::min(
+      config->radius_bottom, static_cast<int16_t>(std::min(w / 2, (int)h / 2)));
+  int16_t avg_radius = (r_top + r_bottom) / 2;
+
+  // 绘制主眼睛形状（带发光效果）
+  DrawTrapezoid(left, top, w, h, config->slope_top, config->slope_bottom,
+                avg_radius);
+
+  // 处理反向圆角（内凹效果，用于 Glee 笑脸）
+  if (config->inverse_radius_bottom > 0) {
+    int16_t inv_r = config->inverse_radius_bottom;
+    // 在底部中间画一个背景色的半圆
+    int32_t cx = left + w / 2;
+    int32_t cy = top + h - inv_r / 2;
+    FillRoundRect(cx - inv_r, cy, inv_r * 2, inv_r, inv_r, inv_r, bg_pixel_);
+  }
+
+  // 处理上眼睑内凹（如果需要）
+  if (config->inverse_radius_top > 0) {
+    int16_t inv_r = config->inverse_radius_top;
+    int32_t cx = left + w / 2;
+    int32_t cy = top + inv_r / 2;
+    FillRoundRect(cx - inv_r, cy - inv_r, inv_r * 2, inv_r, inv_r, inv_r,
+                  bg_pixel_);
+  }
+}
+
+} // namespace vector_eyes
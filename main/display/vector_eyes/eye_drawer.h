@@ -0,0 +1,94 @@
+/**
+ * @file eye_drawer.h
+ * @brief 眼睛光栅化绘制器
+ *
+ * 移植自 esp32-eyes EyeDrawer。直接以扫描线方式填充 canvas 的 RGB565 缓冲区，
+ * 不经过 LVGL layer，并只刷新眼睛新旧包围盒的并集。
+ */
+
+#pragma once
+
+#include "eye_config.h"
+#include <lvgl.h>
+
+namespace vector_eyes {
+
+/**
+ * @brief 眼睛绘制器（静态工具类）
+ *
+ * 每帧调用顺序：BeginFrame() -> Draw() x N -> EndFrame()
+ */
+class EyeDrawer {
+public:
+  static constexpr int kMaxEyes = 2;
+
+  /**
+   * @brief 设置绘图目标 canvas（必须是 RGB565 格式）
+   */
+  static void SetCanvas(lv_obj_t *canvas);
+
+  /**
+   * @brief 设置绘图颜色
+   */
+  static void SetColor(lv_color_t color);
+
+  /**
+   * @brief 清空整个画布
+   */
+  static void Clear(lv_color_t bg_color);
+
+  /**
+   * @brief 获取背景颜色
+   */
+  static lv_color_t GetBgColor();
+
+  /**
+   * @brief 开始一帧：用背景色擦除上一帧眼睛的包围盒
+   */
+  static void BeginFrame(lv_color_t bg_color);
+
+  /**
+   * @brief 绘制完整眼睛
+   * @param center_x 眼睛中心X
+   * @param center_y 眼睛中心Y
+   * @param config 眼睛配置参数
+   */
+  static void Draw(int16_t center_x, int16_t center_y, EyeConfig *config);
+
+  /**
+   * @brief 结束一帧：只使新旧包围盒的并集失效
+   */
+  static void EndFrame();
+
+private:
+  static void FillSpan(int32_t y, int32_t x0, int32_t x1, uint16_t color);
+  static void FillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h,
+                            int32_t r_top, int32_t r_bottom, uint16_t color);
+  static void FillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1,
+                           int32_t x2, int32_t y2, uint16_t color);
+  static void DrawTrapezoid(int32_t x, int32_t y, int32_t w, int32_t h,
+                            float slope_top, float slope_bottom,
+                            int32_t radius);
+  static void DrawHappyArc(int32_t x, int32_t y, int32_t w, int32_t h,
+                           int32_t arc_height);
+  static void AddDirtyArea(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+
+  static lv_obj_t *canvas_;
+  static uint16_t *buf_;
+  static int32_t buf_width_;
+  static int32_t buf_height_;
+  static int32_t stride_;
+  static lv_color_t draw_color_;
+  static lv_color_t bg_color_;
+  static uint16_t draw_pixel_;
+  static uint16_t glow_pixel_;
+  static uint16_t bg_pixel_;
+
+  // 上一帧和当前帧每只眼睛的包围盒
+  static lv_area_t prev_areas_[kMaxEyes];
+  static lv_area_t cur_areas_[kMaxEyes];
+  static int prev_count_;
+  static int cur_count_;
+};
+
+} // namespace vector_eyes
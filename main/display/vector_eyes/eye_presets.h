@@ -403,4 +403,54 @@ inline bool IsAsymmetricEmotion(Emotion emotion) {
   return emotion == Emotion::Skeptic || emotion == Emotion::Furious;
 }
 
+// ============ 关键帧时间轴 ============
+
+/**
+ * @brief 关键帧（4 字节）：从 at 时刻开始，用 tween 时长过渡到 emotion
+ *
+ * 时间单位均为 10ms，单条时间轴最长约 655 秒。
+ */
+struct EyeKeyframe {
+  uint16_t at;     ///< 相对时间轴起点的时刻
+  uint8_t emotion; ///< 目标表情 (Emotion)
+  uint8_t tween;   ///< 过渡时长
+};
+
+/**
+ * @brief 关键帧时间轴，关键帧按 at 升序排列
+ */
+struct EyeTimeline {
+  const EyeKeyframe *frames;
+  uint8_t count;
+  uint16_t length; ///< 时间轴总长（10ms），循环播放时从头开始
+  bool loop;
+};
+
+/**
+ * @brief 以毫秒为单位构造关键帧
+ */
+constexpr EyeKeyframe Keyframe(uint32_t at_ms, Emotion emotion,
+                               uint32_t tween_ms = 300) {
+  return {static_cast<uint16_t>(at_ms / 10), static_cast<uint8_t>(emotion),
+          static_cast<uint8_t>(tween_ms / 10)};
+}
+
+// 表情演示：每 2 秒切换一个表情，最后回到 Normal
+constexpr EyeKeyframe Keyframes_Demo[] = {
+    Keyframe(0, Emotion::Normal),         Keyframe(2000, Emotion::Happy),
+    Keyframe(4000, Emotion::Glee),        Keyframe(6000, Emotion::Sad),
+    Keyframe(8000, Emotion::Worried),     Keyframe(10000, Emotion::Focused),
+    Keyframe(12000, Emotion::Annoyed),    Keyframe(14000, Emotion::Surprised),
+    Keyframe(16000, Emotion::Skeptic),    Keyframe(18000, Emotion::Frustrated),
+    Keyframe(20000, Emotion::Unimpressed), Keyframe(22000, Emotion::Sleepy),
+    Keyframe(24000, Emotion::Suspicious), Keyframe(26000, Emotion::Squint),
+    Keyframe(28000, Emotion::Angry),      Keyframe(30000, Emotion::Furious),
+    Keyframe(32000, Emotion::Scared),     Keyframe(34000, Emotion::Awe),
+    Keyframe(36000, Emotion::Normal),
+};
+
+constexpr EyeTimeline Timeline_Demo = {
+    Keyframes_Demo, sizeof(Keyframes_Demo) / sizeof(Keyframes_Demo[0]), 3600,
+    false};
+
 } // namespace vector_eyes
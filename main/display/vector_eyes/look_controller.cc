@@ -48,6 +48,17 @@ void LookController::LookAt(float x, float y) {
     ScheduleNextLook();
 }
 
+uint32_t LookController::NextEventDelay(uint32_t now) const {
+    if (transitioning_) {
+        return 0;
+    }
+    if (!random_look_enabled_) {
+        return UINT32_MAX;
+    }
+    uint32_t elapsed = now - last_look_;
+    return elapsed > next_look_interval_ ? 0 : next_look_interval_ + 1 - elapsed;
+}
+
 void LookController::StartRandomLook() {
     // 随机选择一个方向，但大部分时间看前方
     float rand_val = RandomFloat();
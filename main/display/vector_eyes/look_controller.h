@@ -73,6 +73,12 @@ public:
      */
     void SetLookInterval(uint32_t min_ms, uint32_t max_ms);
 
+    /**
+     * @brief 距下一次需要刷新的时间（毫秒）
+     * @return 视线过渡中返回 0；未启用随机视线时返回 UINT32_MAX
+     */
+    uint32_t NextEventDelay(uint32_t now) const;
+
 private:
     void ScheduleNextLook();
     void StartRandomLook();
@@ -40,6 +40,17 @@ inline float EaseInOutQuad(float t) {
     return t < 0.5f ? 2.0f * t * t : 1.0f - std::pow(-2.0f * t + 2.0f, 2.0f) / 2.0f;
 }
 
+/**
+ * @brief Q16 定点 EaseInOutQuad，t 取值 0 ~ 65536
+ */
+inline uint32_t EaseInOutQuadQ16(uint32_t t) {
+    if (t < 32768) {
+        return (t * t) >> 15;
+    }
+    uint32_t u = 65536 - t;
+    return 65536 - ((u * u) >> 15);
+}
+
 /**
  * @brief EaseOutQuad 缓动函数
  * 开始快，结束慢
@@ -44,19 +44,18 @@ void VectorEye::UpdateTransition() {
     return;
 
   uint32_t elapsed = millis_idf() - transition_start_;
-  float t = static_cast<float>(elapsed) / transition_duration_;
-
-  if (t >= 1.0f) {
-    t = 1.0f;
+  if (transition_duration_ == 0 || elapsed >= transition_duration_) {
     transitioning_ = false;
     base_config_ = target_config_;
+    return;
   }
 
-  // 使用缓动函数
-  t = EaseInOutQuad(t);
+  // Q16 定点进度，使用缓动函数
+  uint32_t t = (elapsed << 16) / transition_duration_;
+  t = EaseInOutQuadQ16(t);
 
   // 插值所有参数
-  base_config_ = EyeConfig::Lerp(start_config_, target_config_, t);
+  base_config_ = EyeConfig::LerpQ16(start_config_, target_config_, t);
 }
 
 void VectorEye::ApplyEffects() {
@@ -43,6 +43,11 @@ public:
      */
     void Update();
 
+    /**
+     * @brief 是否正在表情过渡中
+     */
+    bool IsTransitioning() const { return transitioning_; }
+
     /**
      * @brief 获取当前配置（用于绘制）
      */
@@ -1,21 +1,22 @@
 /**
- * @file palqiqi_vector_eye_display.cc
- * @brief Palqiqi机器人矢量眼睛显示类实现
+ * @file vector_eye_display.cc
+ * @brief 机器人矢量眼睛显示类实现
  */
 
-#include "palqiqi_vector_eye_display.h"
+#include "vector_eye_display.h"
 #include "display/lvgl_display/lvgl_theme.h"
 #include "application.h"
 
+#include <algorithm>
 #include <cstring>
-#include <esp_log.h>
 #include <esp_heap_caps.h>
+#include <esp_log.h>
 
-#define TAG "PalqiqiVectorEyeDisplay"
+#define TAG "VectorEyeDisplay"
 
 // 表情名称映射表 - 将现有表情名映射到矢量表情
-const PalqiqiVectorEyeDisplay::EmotionNameMap
-    PalqiqiVectorEyeDisplay::emotion_name_maps_[] = {
+const VectorEyeDisplay::EmotionNameMap
+    VectorEyeDisplay::emotion_name_maps_[] = {
         // 中性/平静类
         {"neutral", vector_eyes::Emotion::Normal},
         {"relaxed", vector_eyes::Emotion::Sleepy},
@@ -59,31 +60,36 @@ const PalqiqiVectorEyeDisplay::EmotionNameMap
         {nullptr, vector_eyes::Emotion::Normal} // 结束标记
 };
 
-
-PalqiqiVectorEyeDisplay::PalqiqiVectorEyeDisplay(esp_lcd_panel_io_handle_t panel_io,
-                                           esp_lcd_panel_handle_t panel,
-                                           int width, int height, int offset_x,
-                                           int offset_y, bool mirror_x,
-                                           bool mirror_y, bool swap_xy)
+VectorEyeDisplay::VectorEyeDisplay(esp_lcd_panel_io_handle_t panel_io,
+                                   esp_lcd_panel_handle_t panel, int width,
+                                   int height, int offset_x, int offset_y,
+                                   bool mirror_x, bool mirror_y, bool swap_xy,
+                                   bool canvas_in_psram)
     : SpiLcdDisplay(panel_io, panel, width, height, offset_x, offset_y,
                     mirror_x, mirror_y, swap_xy) {
-  SetupCanvas();
+  SetupCanvas(canvas_in_psram);
   StartUpdateTimer();
+  // 说话时眼睛跟随语音响度，需要播放路径上的语音分析
+  Application::GetInstance().GetAudioService().EnableSpeechAnalysis(true);
 }
 
-PalqiqiVectorEyeDisplay::~PalqiqiVectorEyeDisplay() {
+VectorEyeDisplay::~VectorEyeDisplay() {
   StopUpdateTimer();
   if (face_) {
     delete face_;
     face_ = nullptr;
   }
   if (canvas_buf_) {
-    lv_free(canvas_buf_);
+    if (canvas_buf_in_psram_) {
+      heap_caps_free(canvas_buf_);
+    } else {
+      lv_free(canvas_buf_);
+    }
     canvas_buf_ = nullptr;
   }
 }
 
-void PalqiqiVectorEyeDisplay::SetupCanvas() {
+void VectorEyeDisplay::SetupCanvas(bool canvas_in_psram) {
   DisplayLockGuard lock(static_cast<Display *>(this));
 
   // 删除原有的 emoji_label_ 和 chat_message_label_
@@ -109,31 +115,31 @@ void PalqiqiVectorEyeDisplay::SetupCanvas() {
   lv_obj_set_flex_grow(content_, 1);
   lv_obj_center(content_);
 
-  // 创建 canvas 用于绘制眼睛（启用PSRAM，可以用更大尺寸）
+  // 创建 canvas 用于绘制眼睛
+  bool landscape = LV_HOR_RES > LV_VER_RES;
   int canvas_size;
-  if (LV_HOR_RES > LV_VER_RES) {
+  if (landscape) {
     // 横屏模式: 使用高度减去状态栏和字幕空间
-    canvas_size = LV_VER_RES - 40;  // 240-40 = 200
+    canvas_size = LV_VER_RES - 40;
   } else {
     // 竖屏模式: 使用宽度
-    canvas_size = LV_HOR_RES;  // 240
+    canvas_size = LV_HOR_RES;
   }
-  
-  // 优先使用PSRAM分配Canvas缓冲区以节省内部RAM
+
   size_t buf_size = canvas_size * canvas_size * sizeof(lv_color_t);
-  
 #if CONFIG_SPIRAM
-  canvas_buf_ = (lv_color_t *)heap_caps_malloc(buf_size, MALLOC_CAP_SPIRAM);
-  if (canvas_buf_) {
-    ESP_LOGI(TAG, "Canvas使用PSRAM分配: %dx%d (%zu bytes)", canvas_size, canvas_size, buf_size);
-  } else {
-    ESP_LOGW(TAG, "PSRAM分配失败，尝试内部RAM");
-    canvas_buf_ = (lv_color_t *)lv_malloc(buf_size);
+  // 优先使用PSRAM分配Canvas缓冲区以节省内部RAM
+  if (canvas_in_psram) {
+    canvas_buf_ = (lv_color_t *)heap_caps_malloc(buf_size, MALLOC_CAP_SPIRAM);
+    canvas_buf_in_psram_ = canvas_buf_ != nullptr;
+    if (!canvas_buf_) {
+      ESP_LOGW(TAG, "PSRAM分配失败，尝试内部RAM");
+    }
   }
-#else
-  canvas_buf_ = (lv_color_t *)lv_malloc(buf_size);
-  ESP_LOGI(TAG, "Canvas使用内部RAM: %dx%d (%zu bytes)", canvas_size, canvas_size, buf_size);
 #endif
+  if (!canvas_buf_) {
+    canvas_buf_ = (lv_color_t *)lv_malloc(buf_size);
+  }
 
   if (canvas_buf_) {
     canvas_ = lv_canvas_create(content_);
@@ -150,8 +156,9 @@ void PalqiqiVectorEyeDisplay::SetupCanvas() {
     face_->SetEyeColor(lv_color_hex(0x00D4AA)); // Cozmo 青色
     face_->SetBackgroundColor(lv_color_black());
 
-    ESP_LOGI(TAG, "矢量眼睛初始化完成，canvas大小: %dx%d, 眼睛尺寸: %d", 
-             canvas_size, canvas_size, eye_size);
+    ESP_LOGI(TAG, "矢量眼睛初始化完成，canvas大小: %dx%d (%s, %zu bytes)",
+             canvas_size, canvas_size, canvas_buf_in_psram_ ? "PSRAM" : "内部RAM",
+             buf_size);
   } else {
     ESP_LOGE(TAG, "无法分配 canvas 缓冲区");
   }
@@ -161,176 +168,141 @@ void PalqiqiVectorEyeDisplay::SetupCanvas() {
   lv_label_set_text(emoji_label_, "");
   lv_obj_add_flag(emoji_label_, LV_OBJ_FLAG_HIDDEN);
 
-  // 创建聊天消息标签
+  // 创建聊天消息标签，横屏时用更大比例的宽度、更小的垂直padding
   chat_message_label_ = lv_label_create(content_);
   lv_label_set_text(chat_message_label_, "");
-  // 横屏优化: 使用更大比例的宽度显示字幕
-  lv_obj_set_width(chat_message_label_, LV_HOR_RES * 0.95);
+  lv_obj_set_width(chat_message_label_, LV_HOR_RES * (landscape ? 0.95 : 0.9));
   lv_label_set_long_mode(chat_message_label_, LV_LABEL_LONG_SCROLL_CIRCULAR);
   lv_obj_set_style_text_align(chat_message_label_, LV_TEXT_ALIGN_CENTER, 0);
   lv_obj_set_style_text_color(chat_message_label_, lv_color_white(), 0);
   lv_obj_set_style_bg_color(chat_message_label_, lv_color_black(), 0);
   lv_obj_set_style_border_width(chat_message_label_, 0, 0);
   lv_obj_set_style_bg_opa(chat_message_label_, LV_OPA_70, 0);
-  lv_obj_set_style_pad_ver(chat_message_label_, 3, 0);  // 横屏优化: 减少垂直padding
+  lv_obj_set_style_pad_ver(chat_message_label_, landscape ? 3 : 5, 0);
   lv_obj_align(chat_message_label_, LV_ALIGN_BOTTOM_MID, 0, 0);
   lv_obj_add_flag(chat_message_label_, LV_OBJ_FLAG_HIDDEN);
-  
+
   // 注意：不调用 SetTheme，矢量眼睛使用固定的黑底白眼风格
 }
 
-void PalqiqiVectorEyeDisplay::StartUpdateTimer() {
-  // 创建 20Hz 更新定时器 (50ms)，平衡流畅度和性能
-  update_timer_ = lv_timer_create(UpdateTimerCallback, 50, this);
+void VectorEyeDisplay::StartUpdateTimer() {
+  // 周期由 OnUpdate 动态调整：动画中 20Hz，空闲时休眠到下一个事件
+  update_timer_ = lv_timer_create(UpdateTimerCallback, kFramePeriodMs, this);
+  if (demo_mode_) {
+    PlayTimeline(&vector_eyes::Timeline_Demo);
+  }
 }
 
-void PalqiqiVectorEyeDisplay::StopUpdateTimer() {
+void VectorEyeDisplay::StopUpdateTimer() {
   if (update_timer_) {
     lv_timer_del(update_timer_);
     update_timer_ = nullptr;
   }
 }
 
-void PalqiqiVectorEyeDisplay::UpdateTimerCallback(lv_timer_t *timer) {
-  auto *self =
-      static_cast<PalqiqiVectorEyeDisplay *>(lv_timer_get_user_data(timer));
+void VectorEyeDisplay::WakeUp() {
+  // 调用方需持有显示锁
+  if (update_timer_) {
+    lv_timer_set_period(update_timer_, kFramePeriodMs);
+    lv_timer_ready(update_timer_);
+  }
+}
+
+void VectorEyeDisplay::UpdateTimerCallback(lv_timer_t *timer) {
+  auto *self = static_cast<VectorEyeDisplay *>(lv_timer_get_user_data(timer));
   if (self) {
     self->OnUpdate();
   }
 }
 
-void PalqiqiVectorEyeDisplay::OnUpdate() {
+void VectorEyeDisplay::OnUpdate() {
   if (!face_ || !canvas_)
     return;
 
   DisplayLockGuard lock(static_cast<Display *>(this));
 
-  // 检查演示模式
-  CheckDemoMode();
+  uint32_t now = vector_eyes::millis_idf();
 
-  // 检查是否需要随机表情变化（演示模式结束后）
-  if (!demo_mode_) {
-    CheckRandomEmotion();
+  // 检查是否需要随机表情变化，返回距下次检查的时间
+  uint32_t emotion_delay = CheckRandomEmotion(now);
+
+  // 说话时眼睛跟随语音响度眯起，保持帧率以便及时响应下一句
+  auto &app = Application::GetInstance();
+  bool speaking = app.GetDeviceState() == kDeviceStateSpeaking;
+  SpeechFeatures speech;
+  if (speaking && app.GetAudioService().speech_features().Read(speech)) {
+    face_->SetSpeechLevel(speech.level / 255.0f);
+  } else {
+    face_->SetSpeechLevel(0.0f);
   }
 
-  // 更新动画状态
+  // 更新动画状态（含时间轴关键帧）
   face_->Update();
 
-  // 重绘眼睛
+  // 重绘眼睛，只有画面变化时才会提交眼睛所在的局部刷新区域
   face_->Draw();
 
-  // 通知 LVGL canvas 已更新
-  lv_obj_invalidate(canvas_);
+  // 动画进行中按帧率刷新，否则休眠到下一个关键帧/眨眼/视线/随机表情时刻
+  uint32_t delay = std::min(face_->GetNextUpdateDelay(), emotion_delay);
+  if (speaking) {
+    delay = kFramePeriodMs;
+  }
+  delay = std::clamp(delay, kFramePeriodMs, kMaxSleepMs);
+  lv_timer_set_period(update_timer_, delay);
 }
 
-void PalqiqiVectorEyeDisplay::CheckRandomEmotion() {
-  if (!idle_mode_)
-    return;
+uint32_t VectorEyeDisplay::CheckRandomEmotion(uint32_t now) {
+  // 时间轴播放期间由时间轴控制表情
+  if (!idle_mode_ || face_->IsTimelinePlaying())
+    return UINT32_MAX;
 
-  // 只在设备待命状态下才随机变化表情
+  // 只在设备待命状态下才随机变化表情，状态切换时会通过 SetEmotion 唤醒
   auto &app = Application::GetInstance();
   if (app.GetDeviceState() != kDeviceStateIdle) {
-    return;
+    return kMaxSleepMs;
   }
 
-  uint32_t now = lv_tick_get();
-
   // 初始化
   if (next_emotion_interval_ == 0) {
     ScheduleNextEmotionChange();
     last_emotion_change_ = now;
-    return;
+    return next_emotion_interval_;
   }
 
   // 检查是否到了变化时间
-  if (now - last_emotion_change_ > next_emotion_interval_) {
-    // 随机选择一个表情
-    static const vector_eyes::Emotion idle_emotions[] = {
-        vector_eyes::Emotion::Normal,
-        vector_eyes::Emotion::Normal, // 增加Normal的权重
-        vector_eyes::Emotion::Sleepy,     vector_eyes::Emotion::Skeptic,
-        vector_eyes::Emotion::Suspicious, vector_eyes::Emotion::Focused,
-    };
-
-    int idx = rand() % (sizeof(idle_emotions) / sizeof(idle_emotions[0]));
-    vector_eyes::Emotion new_emotion = idle_emotions[idx];
-
-    if (new_emotion != current_emotion_) {
-      current_emotion_ = new_emotion;
-      face_->SetExpression(new_emotion);
-      ESP_LOGI(TAG, "🎲 随机表情变化: %d", static_cast<int>(new_emotion));
-    }
-
-    last_emotion_change_ = now;
-    ScheduleNextEmotionChange();
+  uint32_t elapsed = now - last_emotion_change_;
+  if (elapsed <= next_emotion_interval_) {
+    return next_emotion_interval_ + 1 - elapsed;
   }
-}
 
-
-void PalqiqiVectorEyeDisplay::CheckDemoMode() {
-  if (!demo_mode_)
-    return;
-
-  uint32_t now = lv_tick_get();
-
-  // 初始化演示
-  if (demo_start_time_ == 0) {
-    demo_start_time_ = now;
-    demo_emotion_index_ = 0;
-    ESP_LOGI(TAG, "🎭 开始表情演示模式");
+  // 随机选择一个表情
+  static const vector_eyes::Emotion idle_emotions[] = {
+      vector_eyes::Emotion::Normal,
+      vector_eyes::Emotion::Normal, // 增加Normal的权重
+      vector_eyes::Emotion::Sleepy,     vector_eyes::Emotion::Skeptic,
+      vector_eyes::Emotion::Suspicious, vector_eyes::Emotion::Focused,
+  };
+
+  int idx = rand() % (sizeof(idle_emotions) / sizeof(idle_emotions[0]));
+  vector_eyes::Emotion new_emotion = idle_emotions[idx];
+
+  if (new_emotion != current_emotion_) {
+    current_emotion_ = new_emotion;
+    face_->SetExpression(new_emotion);
+    ESP_LOGI(TAG, "🎲 随机表情变化: %d", static_cast<int>(new_emotion));
   }
 
-  // 每2秒切换一个表情
-  if (now - demo_start_time_ > 2000) {
-    static const vector_eyes::Emotion all_emotions[] = {
-        vector_eyes::Emotion::Normal,      // 0
-        vector_eyes::Emotion::Happy,       // 1
-        vector_eyes::Emotion::Glee,        // 2
-        vector_eyes::Emotion::Sad,         // 3
-        vector_eyes::Emotion::Worried,     // 4
-        vector_eyes::Emotion::Focused,     // 5
-        vector_eyes::Emotion::Annoyed,     // 6
-        vector_eyes::Emotion::Surprised,   // 7
-        vector_eyes::Emotion::Skeptic,     // 8
-        vector_eyes::Emotion::Frustrated,  // 9
-        vector_eyes::Emotion::Unimpressed, // 10
-        vector_eyes::Emotion::Sleepy,      // 11
-        vector_eyes::Emotion::Suspicious,  // 12
-        vector_eyes::Emotion::Squint,      // 13
-        vector_eyes::Emotion::Angry,       // 14
-        vector_eyes::Emotion::Furious,     // 15
-        vector_eyes::Emotion::Scared,      // 16
-        vector_eyes::Emotion::Awe          // 17
-    };
-    static const char *emotion_names[] = {
-        "Normal",      "Happy",   "Glee",       "Sad",     "Worried",
-        "Focused",     "Annoyed", "Surprised",  "Skeptic", "Frustrated",
-        "Unimpressed", "Sleepy",  "Suspicious", "Squint",  "Angry",
-        "Furious",     "Scared",  "Awe"};
-
-    if (demo_emotion_index_ < 18) {
-      vector_eyes::Emotion emotion = all_emotions[demo_emotion_index_];
-      face_->SetExpression(emotion);
-      ESP_LOGI(TAG, "🎭 演示表情 %d/18: %s", demo_emotion_index_ + 1,
-               emotion_names[demo_emotion_index_]);
-      demo_emotion_index_++;
-      demo_start_time_ = now;
-    } else {
-      // 演示结束，进入正常模式
-      demo_mode_ = false;
-      idle_mode_ = true;
-      face_->SetExpression(vector_eyes::Emotion::Normal);
-      ESP_LOGI(TAG, "🎭 表情演示完成，进入正常模式");
-    }
-  }
+  last_emotion_change_ = now;
+  ScheduleNextEmotionChange();
+  return next_emotion_interval_;
 }
 
-void PalqiqiVectorEyeDisplay::ScheduleNextEmotionChange() {
+void VectorEyeDisplay::ScheduleNextEmotionChange() {
   // 8-15秒随机间隔
   next_emotion_interval_ = 8000 + (rand() % 7000);
 }
 
-vector_eyes::Emotion PalqiqiVectorEyeDisplay::MapEmotionName(const char *name) {
+vector_eyes::Emotion VectorEyeDisplay::MapEmotionName(const char *name) {
   if (!name)
     return vector_eyes::Emotion::Normal;
 
@@ -344,7 +316,7 @@ vector_eyes::Emotion PalqiqiVectorEyeDisplay::MapEmotionName(const char *name) {
   return vector_eyes::Emotion::Normal;
 }
 
-void PalqiqiVectorEyeDisplay::SetEmotion(const char *emotion) {
+void VectorEyeDisplay::SetEmotion(const char *emotion) {
   if (!emotion || !face_)
     return;
 
@@ -361,7 +333,10 @@ void PalqiqiVectorEyeDisplay::SetEmotion(const char *emotion) {
     current_emotion_ = mapped;
   }
 
+  // 外部表情优先于正在播放的时间轴
+  face_->StopTimeline();
   face_->SetExpression(mapped);
+  WakeUp();
 
   // 表情名称映射
   static const char *emotion_names[] = {
@@ -377,8 +352,7 @@ void PalqiqiVectorEyeDisplay::SetEmotion(const char *emotion) {
            mapped_name, static_cast<int>(mapped), idle_mode_ ? "是" : "否");
 }
 
-void PalqiqiVectorEyeDisplay::SetChatMessage(const char *role,
-                                          const char *content) {
+void VectorEyeDisplay::SetChatMessage(const char *role, const char *content) {
   DisplayLockGuard lock(static_cast<Display *>(this));
 
   if (chat_message_label_ == nullptr)
@@ -395,25 +369,41 @@ void PalqiqiVectorEyeDisplay::SetChatMessage(const char *role,
   ESP_LOGI(TAG, "设置聊天消息 [%s]: %s", role, content);
 }
 
-void PalqiqiVectorEyeDisplay::Blink() {
+void VectorEyeDisplay::Blink() {
   if (face_) {
+    DisplayLockGuard lock(static_cast<Display *>(this));
     face_->Blink();
+    WakeUp();
   }
 }
 
-void PalqiqiVectorEyeDisplay::LookAt(float x, float y) {
+void VectorEyeDisplay::LookAt(float x, float y) {
   if (face_) {
+    DisplayLockGuard lock(static_cast<Display *>(this));
     face_->LookAt(x, y);
+    WakeUp();
   }
 }
 
-void PalqiqiVectorEyeDisplay::SetEyeColor(uint32_t color_hex) {
+void VectorEyeDisplay::SetEyeColor(uint32_t color_hex) {
   if (face_) {
+    DisplayLockGuard lock(static_cast<Display *>(this));
     face_->SetEyeColor(lv_color_hex(color_hex));
+    WakeUp();
+  }
+}
+
+void VectorEyeDisplay::PlayTimeline(const vector_eyes::EyeTimeline *timeline) {
+  if (face_) {
+    DisplayLockGuard lock(static_cast<Display *>(this));
+    face_->PlayTimeline(timeline);
+    WakeUp();
+    ESP_LOGI(TAG, "🎭 播放表情时间轴: %d 个关键帧",
+             timeline ? timeline->count : 0);
   }
 }
 
-void PalqiqiVectorEyeDisplay::SetTheme(Theme *theme) {
+void VectorEyeDisplay::SetTheme(Theme *theme) {
   // 矢量眼睛使用固定的黑底白眼风格，不需要主题切换
   // 只保存主题设置，不应用到UI元素
   DisplayLockGuard lock(static_cast<Display *>(this));
@@ -0,0 +1,188 @@
+/**
+ * @file vector_face.cc
+ * @brief 双眼管理类实现
+ */
+
+#include "vector_face.h"
+#include "eye_drawer.h"
+#include "eye_presets.h"
+
+#include <algorithm>
+
+namespace vector_eyes {
+
+VectorFace::VectorFace(uint16_t screen_width, uint16_t screen_height,
+                       uint16_t eye_size)
+    : screen_width_(screen_width), screen_height_(screen_height),
+      eye_size_(eye_size) {
+
+  // 左眼需要镜像
+  left_eye_.SetMirrored(true);
+  right_eye_.SetMirrored(false);
+
+  // 初始化眼睛位置
+  UpdateEyePositions();
+
+  // 设置初始表情
+  left_eye_.ApplyPreset(Preset_Normal);
+  right_eye_.ApplyPreset(Preset_Normal);
+}
+
+void VectorFace::SetCanvas(lv_obj_t *canvas) {
+  canvas_ = canvas;
+  EyeDrawer::SetCanvas(canvas);
+  force_redraw_ = true;
+}
+
+void VectorFace::SetExpression(Emotion emotion, uint32_t duration_ms) {
+  // 检查是否需要不对称处理
+  if (IsAsymmetricEmotion(emotion)) {
+    // 左右眼使用不同的预设
+    const EyeConfig &left_preset = GetPresetLeft(emotion);
+    const EyeConfig &right_preset = GetPresetRight(emotion);
+    left_eye_.TransitionTo(left_preset, duration_ms);
+    right_eye_.TransitionTo(right_preset, duration_ms);
+  } else {
+    // 对称表情
+    const EyeConfig &preset = GetPreset(emotion);
+    SetExpression(preset, duration_ms);
+  }
+}
+
+void VectorFace::SetExpression(const EyeConfig &preset, uint32_t duration_ms) {
+  left_eye_.TransitionTo(preset, duration_ms);
+  right_eye_.TransitionTo(preset, duration_ms);
+}
+
+void VectorFace::PlayTimeline(const EyeTimeline *timeline) {
+  if (!timeline || timeline->count == 0) {
+    timeline_ = nullptr;
+    return;
+  }
+  timeline_ = timeline;
+  timeline_start_ = millis_idf();
+  timeline_index_ = 0;
+}
+
+void VectorFace::UpdateTimeline(uint32_t now) {
+  if (!timeline_)
+    return;
+
+  uint32_t elapsed = now - timeline_start_;
+  uint32_t length_ms = timeline_->length * 10u;
+  if (elapsed >= length_ms && timeline_index_ >= timeline_->count) {
+    if (!timeline_->loop) {
+      timeline_ = nullptr;
+      return;
+    }
+    timeline_start_ += length_ms;
+    timeline_index_ = 0;
+    elapsed = now - timeline_start_;
+  }
+
+  // 触发所有已到时刻的关键帧，只有最后一个真正生效
+  const EyeKeyframe *due = nullptr;
+  while (timeline_index_ < timeline_->count &&
+         timeline_->frames[timeline_index_].at * 10u <= elapsed) {
+    due = &timeline_->frames[timeline_index_++];
+  }
+  if (due) {
+    SetExpression(static_cast<Emotion>(due->emotion), due->tween * 10u);
+  }
+}
+
+uint32_t VectorFace::GetNextUpdateDelay() const {
+  if (force_redraw_ || left_eye_.IsTransitioning() ||
+      right_eye_.IsTransitioning() || speech_squint_ > 0.0f)
+    return 0;
+
+  uint32_t now = millis_idf();
+  uint32_t delay = std::min(blink_controller_.NextEventDelay(now),
+                            look_controller_.NextEventDelay(now));
+
+  if (timeline_) {
+    uint32_t elapsed = now - timeline_start_;
+    uint32_t due = timeline_index_ < timeline_->count
+                       ? timeline_->frames[timeline_index_].at * 10u
+                       : timeline_->length * 10u;
+    delay = std::min(delay, due > elapsed ? due - elapsed : 0u);
+  }
+  return delay;
+}
+
+void VectorFace::SetSpeechLevel(float level) {
+  float target = Clamp(level, 0.0f, 1.0f) * 0.4f;
+  if (target >= speech_squint_) {
+    speech_squint_ = target;
+  } else {
+    speech_squint_ += (target - speech_squint_) * 0.5f;
+    if (speech_squint_ < 0.01f)
+      speech_squint_ = 0.0f;
+  }
+}
+
+void VectorFace::Update() {
+  UpdateTimeline(millis_idf());
+
+  // 更新眨眼
+  blink_controller_.Update();
+  float blink = std::max(blink_controller_.GetBlinkFactor(), speech_squint_);
+  left_eye_.ApplyBlink(blink);
+  right_eye_.ApplyBlink(blink);
+
+  // 更新视线
+  look_controller_.Update();
+  float look_x = look_controller_.GetLookX();
+  float look_y = look_controller_.GetLookY();
+  left_eye_.ApplyLook(look_x, look_y);
+  right_eye_.ApplyLook(look_x, look_y);
+
+  // 更新眼睛动画
+  left_eye_.Update();
+  right_eye_.Update();
+}
+
+bool VectorFace::Draw() {
+  if (!canvas_)
+    return false;
+
+  EyeConfig *left = left_eye_.GetCurrentConfig();
+  EyeConfig *right = right_eye_.GetCurrentConfig();
+  if (!force_redraw_ && *left == drawn_left_ && *right == drawn_right_)
+    return false;
+
+  // 擦除上一帧的眼睛区域
+  EyeDrawer::SetColor(eye_color_);
+  EyeDrawer::BeginFrame(bg_color_);
+
+  // 绘制左眼
+  EyeDrawer::Draw(left_eye_.GetCenterX(), left_eye_.GetCenterY(), left);
+
+  // 绘制右眼
+  EyeDrawer::Draw(right_eye_.GetCenterX(), right_eye_.GetCenterY(), right);
+
+  // 只刷新新旧眼睛区域
+  EyeDrawer::EndFrame();
+
+  drawn_left_ = *left;
+  drawn_right_ = *right;
+  force_redraw_ = false;
+  return true;
+}
+
+void VectorFace::SetRandomBehavior(bool blink, bool look) {
+  blink_controller_.SetAutoBlinkEnabled(blink);
+  look_controller_.SetRandomLookEnabled(look);
+}
+
+void VectorFace::UpdateEyePositions() {
+  int16_t center_x = screen_width_ / 2;
+  int16_t center_y = screen_height_ / 2;
+
+  // 左眼在左边，右眼在右边
+  left_eye_.SetCenter(center_x - eye_size_ / 2 - eye_inter_distance_, center_y);
+  right_eye_.SetCenter(center_x + eye_size_ / 2 + eye_inter_distance_,
+                       center_y);
+}
+
+} // namespace vector_eyes
@@ -33,13 +33,29 @@ public:
 
   /**
    * @brief 设置表情
+   * @param duration_ms 过渡时长
    */
-  void SetExpression(Emotion emotion);
+  void SetExpression(Emotion emotion, uint32_t duration_ms = 300);
 
   /**
    * @brief 设置表情（通过预设）
    */
-  void SetExpression(const EyeConfig &preset);
+  void SetExpression(const EyeConfig &preset, uint32_t duration_ms = 300);
+
+  /**
+   * @brief 播放关键帧时间轴，由 Update() 推进
+   */
+  void PlayTimeline(const EyeTimeline *timeline);
+
+  /**
+   * @brief 停止时间轴，保持当前表情
+   */
+  void StopTimeline() { timeline_ = nullptr; }
+
+  /**
+   * @brief 是否正在播放时间轴
+   */
+  bool IsTimelinePlaying() const { return timeline_ != nullptr; }
 
   /**
    * @brief 更新状态（每帧调用）
@@ -48,8 +64,17 @@ public:
 
   /**
    * @brief 绘制眼睛
+   * @return 画面有变化并已提交刷新区域时返回 true
    */
-  void Draw();
+  bool Draw();
+
+  /**
+   * @brief 距下一次需要 Update()/Draw() 的时间（毫秒）
+   *
+   * 表情过渡、眨眼或视线移动进行中时返回 0；否则返回到下一个关键帧、
+   * 自动眨眼或随机视线的时间，全部空闲时返回 UINT32_MAX。
+   */
+  uint32_t GetNextUpdateDelay() const;
 
   /**
    * @brief 手动触发眨眼
@@ -61,6 +86,12 @@ public:
    */
   void LookAt(float x, float y) { look_controller_.LookAt(x, y); }
 
+  /**
+   * @brief 跟随语音响度眯眼
+   * @param level 响度 0..1，每帧调用；变大时立即眯眼，变小时逐渐恢复
+   */
+  void SetSpeechLevel(float level);
+
   /**
    * @brief 启用/禁用随机行为
    */
@@ -69,12 +100,18 @@ public:
   /**
    * @brief 设置眼睛颜色
    */
-  void SetEyeColor(lv_color_t color) { eye_color_ = color; }
+  void SetEyeColor(lv_color_t color) {
+    eye_color_ = color;
+    force_redraw_ = true;
+  }
 
   /**
    * @brief 设置背景颜色
    */
-  void SetBackgroundColor(lv_color_t color) { bg_color_ = color; }
+  void SetBackgroundColor(lv_color_t color) {
+    bg_color_ = color;
+    force_redraw_ = true;
+  }
 
   /**
    * @brief 获取眨眼控制器
@@ -101,7 +138,21 @@ private:
   lv_color_t eye_color_ = lv_color_white();
   lv_color_t bg_color_ = lv_color_black();
 
+  // 上一次绘制的眼睛参数，没有变化时跳过重绘
+  EyeConfig drawn_left_;
+  EyeConfig drawn_right_;
+  bool force_redraw_ = true;
+
+  // 说话时的眯眼程度，与眨眼取较大值
+  float speech_squint_ = 0.0f;
+
+  // 关键帧时间轴
+  const EyeTimeline *timeline_ = nullptr;
+  uint32_t timeline_start_ = 0;
+  uint8_t timeline_index_ = 0; // 下一个待触发的关键帧
+
   void UpdateEyePositions();
+  void UpdateTimeline(uint32_t now);
 };
 
 } // namespace vector_eyes
@@ -0,0 +1,221 @@
+#include "activity_model.h"
+
+#include <cstring>
+
+namespace xiaozhi {
+
+namespace {
+
+struct TopicKeyword {
+  const char* text;
+  uint8_t length;
+  ActivityModel::Topic topic;
+};
+
+// 与旧的 strstr 判断顺序一致：话题枚举值越小优先级越高
+constexpr TopicKeyword kKeywords[] = {
+    {"weather", 7, ActivityModel::kTopicWeather},
+    {"天气", 6, ActivityModel::kTopicWeather},
+    {"story", 5, ActivityModel::kTopicStory},
+    {"故事", 6, ActivityModel::kTopicStory},
+    {"pet", 3, ActivityModel::kTopicPet},
+    {"宠物", 6, ActivityModel::kTopicPet},
+    {"smart_home", 10, ActivityModel::kTopicSmartHome},
+    {"智能家居", 12, ActivityModel::kTopicSmartHome},
+    {"control", 7, ActivityModel::kTopicSmartHome},
+    {"控制", 6, ActivityModel::kTopicSmartHome},
+    {"chat", 4, ActivityModel::kTopicChat},
+    {"聊天", 6, ActivityModel::kTopicChat},
+};
+
+constexpr size_t kKeywordCount = sizeof(kKeywords) / sizeof(kKeywords[0]);
+static_assert(kKeywordCount <= 16, "first byte index holds 16 keywords");
+
+// 首字节 → 以该字节开头的关键词位图，编译期生成
+struct FirstByteIndex {
+  uint16_t masks[256] = {};
+};
+
+constexpr FirstByteIndex BuildFirstByteIndex() {
+  FirstByteIndex index;
+  for (size_t i = 0; i < kKeywordCount; i++) {
+    index.masks[static_cast<uint8_t>(kKeywords[i].text[0])] |= static_cast<uint16_t>(1u << i);
+  }
+  return index;
+}
+
+constexpr FirstByteIndex kFirstByteIndex = BuildFirstByteIndex();
+
+const char* const kTopicNames[ActivityModel::kTopicCount] = {
+    "weather", "story", "pet", "smart_home", "chat", "other",
+};
+
+uint32_t SaturatingAdd(uint32_t a, uint32_t b) {
+  return a > UINT32_MAX - b ? UINT32_MAX : a + b;
+}
+
+}  // namespace
+
+// ========== 话题分类 ==========
+
+ActivityModel::Topic ActivityModel::ClassifyTopic(const char* text) {
+  if (text == nullptr) {
+    return kTopicOther;
+  }
+
+  size_t length = strlen(text);
+  Topic best = kTopicOther;
+  for (size_t pos = 0; pos < length; pos++) {
+    uint16_t mask = kFirstByteIndex.masks[static_cast<uint8_t>(text[pos])];
+    while (mask != 0) {
+      int i = __builtin_ctz(mask);
+      mask &= mask - 1;
+      const auto& keyword = kKeywords[i];
+      if (keyword.topic >= best || pos + keyword.length > length) {
+        continue;
+      }
+      if (memcmp(text + pos, keyword.text, keyword.length) == 0) {
+        best = keyword.topic;
+        if (best == kTopicWeather) {
+          return best;
+        }
+      }
+    }
+  }
+  return best;
+}
+
+const char* ActivityModel::GetTopicName(Topic topic) {
+  return topic < kTopicCount ? kTopicNames[topic] : "other";
+}
+
+// ========== 更新 ==========
+
+void ActivityModel::Reset(int64_t now_s) {
+  epoch_s_ = now_s;
+  memset(hours_, 0, sizeof(hours_));
+  memset(topics_, 0, sizeof(topics_));
+  top_hour_ = 0;
+  top_topic_ = kTopicChat;
+}
+
+uint32_t ActivityModel::GetWeight(int64_t now_s) const {
+  int64_t elapsed = now_s - epoch_s_;
+  if (elapsed <= 0) {
+    return kUnitWeight;
+  }
+  int64_t half_lives = elapsed / kHalfLifeS;
+  if (half_lives >= 16) {
+    return UINT32_MAX;
+  }
+  // 小数部分用二次多项式近似 2^x（x ∈ [0,1)，误差 < 0.3%），Q16
+  uint64_t x = static_cast<uint64_t>(elapsed % kHalfLifeS) * 65536 / kHalfLifeS;
+  uint64_t frac = 65536 + ((x * (43024 + ((22512 * x) >> 16))) >> 16);
+  return static_cast<uint32_t>(((static_cast<uint64_t>(kUnitWeight) << half_lives) * frac) >> 16);
+}
+
+void ActivityModel::Rebase(int64_t now_s) {
+  int64_t half_lives = (now_s - epoch_s_) / kHalfLifeS;
+  if (half_lives <= 0) {
+    return;
+  }
+  // 整体右移不改变大小顺序，最大值下标保持有效
+  int shift = half_lives >= 32 ? 32 : static_cast<int>(half_lives);
+  for (auto& bin : hours_) {
+    bin = shift >= 32 ? 0 : bin >> shift;
+  }
+  for (auto& bin : topics_) {
+    bin = shift >= 32 ? 0 : bin >> shift;
+  }
+  epoch_s_ += half_lives * kHalfLifeS;
+}
+
+uint32_t ActivityModel::PrepareWeight(int64_t now_s) {
+  uint32_t weight = GetWeight(now_s);
+  if (weight >= kMaxWeight) {
+    Rebase(now_s);
+    weight = GetWeight(now_s);
+  }
+  return weight;
+}
+
+void ActivityModel::RecordHour(uint8_t hour, int64_t now_s) {
+  if (hour >= kHourCount) {
+    return;
+  }
+  hours_[hour] = SaturatingAdd(hours_[hour], PrepareWeight(now_s));
+  if (hours_[hour] > hours_[top_hour_]) {
+    top_hour_ = hour;
+  }
+}
+
+void ActivityModel::RecordTopic(Topic topic, int64_t now_s) {
+  if (topic >= kTopicCount) {
+    topic = kTopicOther;
+  }
+  topics_[topic] = SaturatingAdd(topics_[topic], PrepareWeight(now_s));
+  if (topics_[topic] > topics_[top_topic_]) {
+    top_topic_ = topic;
+  }
+}
+
+void ActivityModel::Seed(const uint8_t hours[kHourCount], const uint16_t topics[kTopicCount],
+                         int64_t now_s) {
+  Reset(now_s);
+  for (int i = 0; i < kHourCount; i++) {
+    hours_[i] = hours[i] * kUnitWeight;
+  }
+  for (int i = 0; i < kTopicCount; i++) {
+    topics_[i] = topics[i] * kUnitWeight;
+  }
+  RebuildArgmax();
+}
+
+void ActivityModel::Restore(int64_t epoch_s, const uint32_t hours[kHourCount],
+                            const uint32_t topics[kTopicCount]) {
+  epoch_s_ = epoch_s;
+  memcpy(hours_, hours, sizeof(hours_));
+  memcpy(topics_, topics, sizeof(topics_));
+  RebuildArgmax();
+}
+
+void ActivityModel::RebuildArgmax() {
+  top_hour_ = 0;
+  for (int i = 1; i < kHourCount; i++) {
+    if (hours_[i] > hours_[top_hour_]) {
+      top_hour_ = i;
+    }
+  }
+  // 没有任何话题记录时默认闲聊
+  top_topic_ = kTopicChat;
+  for (int i = 0; i < kTopicCount; i++) {
+    if (topics_[i] > topics_[top_topic_]) {
+      top_topic_ = static_cast<Topic>(i);
+    }
+  }
+}
+
+// ========== 查询 ==========
+
+uint8_t ActivityModel::GetHourActivityPercent(uint8_t hour) const {
+  if (hour >= kHourCount || hours_[top_hour_] == 0) {
+    return 0;
+  }
+  return static_cast<uint8_t>(static_cast<uint64_t>(hours_[hour]) * 100 / hours_[top_hour_]);
+}
+
+uint32_t ActivityModel::GetHourCount(uint8_t hour, int64_t now_s) const {
+  if (hour >= kHourCount) {
+    return 0;
+  }
+  return hours_[hour] / GetWeight(now_s);
+}
+
+uint32_t ActivityModel::GetTopicCount(Topic topic, int64_t now_s) const {
+  if (topic >= kTopicCount) {
+    return 0;
+  }
+  return topics_[topic] / GetWeight(now_s);
+}
+
+}  // namespace xiaozhi
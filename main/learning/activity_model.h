@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xiaozhi {
+
+// ============================================================================
+// 增量用户活跃度模型
+//
+// 时段和话题直方图按指数衰减（半衰期 7 天），每次互动 O(1) 更新：
+// 不逐个衰减桶，而是让新事件的权重随时间按 2^(t/半衰期) 增长，
+// 所有桶同比例缩放不改变大小顺序，因此最大值下标可以随增量维护。
+// 权重超过上限时整体右移并推进基准时间，每 8 个半衰期才发生一次。
+// 本文件不依赖 ESP-IDF，时间由调用方传入（Unix 秒），可以在主机上测试。
+// ============================================================================
+
+class ActivityModel {
+ public:
+  enum Topic : uint8_t {
+    kTopicWeather = 0,
+    kTopicStory,
+    kTopicPet,
+    kTopicSmartHome,
+    kTopicChat,
+    kTopicOther,
+    kTopicCount,
+  };
+
+  static constexpr int kHourCount = 24;
+  static constexpr int64_t kHalfLifeS = 7 * 24 * 3600;
+
+  /**
+   * @brief 关键词分类：单次扫描 + 首字节索引，多个话题命中时取优先级最高的
+   */
+  static Topic ClassifyTopic(const char* text);
+  static const char* GetTopicName(Topic topic);
+
+  // 清空并以 now_s 作为衰减基准时间
+  void Reset(int64_t now_s);
+
+  // 记录一次时段 / 话题事件，均摊 O(1)
+  void RecordHour(uint8_t hour, int64_t now_s);
+  void RecordTopic(Topic topic, int64_t now_s);
+
+  // 用未衰减的计数初始化（迁移旧数据），视为全部发生在 now_s
+  void Seed(const uint8_t hours[kHourCount], const uint16_t topics[kTopicCount], int64_t now_s);
+
+  // ========== 查询（O(1)） ==========
+
+  uint8_t GetMostActiveHour() const { return top_hour_; }
+  Topic GetFavoriteTopic() const { return top_topic_; }
+
+  // 该时段活跃度相对最活跃时段的百分比（0-100）
+  uint8_t GetHourActivityPercent(uint8_t hour) const;
+
+  // 衰减到 now_s 时的等效互动次数
+  uint32_t GetHourCount(uint8_t hour, int64_t now_s) const;
+  uint32_t GetTopicCount(Topic topic, int64_t now_s) const;
+
+  // ========== 持久化 ==========
+
+  int64_t epoch_s() const { return epoch_s_; }
+  const uint32_t* hour_bins() const { return hours_; }
+  const uint32_t* topic_bins() const { return topics_; }
+
+  // 恢复持久化的直方图并重建最大值下标
+  void Restore(int64_t epoch_s, const uint32_t hours[kHourCount],
+               const uint32_t topics[kTopicCount]);
+
+ private:
+  // 基准时间的事件权重为 1.0 (Q8)
+  static constexpr uint32_t kUnitWeight = 1 << 8;
+  // 权重达到 2^16 时整体缩放
+  static constexpr uint32_t kMaxWeight = 1 << 16;
+
+  // now_s 时刻新事件的权重（Q8），now_s 早于基准时间时按 1.0 计
+  uint32_t GetWeight(int64_t now_s) const;
+  // 取得当前权重，必要时先整体缩放
+  uint32_t PrepareWeight(int64_t now_s);
+  void Rebase(int64_t now_s);
+  void RebuildArgmax();
+
+  int64_t epoch_s_ = 0;
+  uint32_t hours_[kHourCount] = {};
+  uint32_t topics_[kTopicCount] = {};
+  uint8_t top_hour_ = 0;
+  Topic top_topic_ = kTopicChat;
+};
+
+}  // namespace xiaozhi
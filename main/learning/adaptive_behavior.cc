@@ -85,10 +85,9 @@ bool AdaptiveBehavior::ShouldSuppressPetWarning() {
   // 🏢 工作时间 + 用户不活跃
   if (IsWorkTime()) {
     int hour = GetCurrentHour();
-    const auto& data = profile_->GetData();
     
     // 如果用户在这个时段活跃度很低（<5次），判断为不适合打扰
-    if (data.active_hours[hour] < 5) {
+    if (profile_->GetHourActivityCount(hour) < 5) {
       ESP_LOGD(TAG, "Suppress warning: work time + low activity");
       return true;
     }
@@ -256,11 +255,8 @@ int AdaptiveBehavior::GetUserFrequencyLevel() {
 int AdaptiveBehavior::GetCurrentHourActivity() {
   if (!profile_) return 50;
   
-  int hour = GetCurrentHour();
-  const auto& data = profile_->GetData();
-  
-  // 活跃度 0-255 → 转换为百分比
-  return (data.active_hours[hour] * 100) / 255;
+  // 相对最活跃时段的百分比
+  return profile_->GetHourActivityPercent(GetCurrentHour());
 }
 
 // ============================================================================
@@ -44,7 +44,7 @@ float DecisionEngine::GetProactiveProbability() {
   
   // 因素2：活跃时段（当前是用户活跃时段 → 更主动）
   int current_hour = GetCurrentHour();
-  if (data.active_hours[current_hour] > 10) {
+  if (profile_->GetHourActivityCount(current_hour) > 10) {
     prob += 0.15f;  // +15%
   }
   
@@ -71,14 +71,13 @@ float DecisionEngine::GetProactiveProbability() {
 int DecisionEngine::GetPetReminderInterval() {
   if (!profile_) return 120;  // 默认2小时
   
-  const auto& data = profile_->GetData();
-  
-  // 基于用户养宠频率调整
-  if (data.topic_pet > 100) {
+  // 基于用户最近的养宠频率调整（按 7 天半衰期衰减）
+  uint32_t pet_count = profile_->GetTopicActivityCount(ActivityModel::kTopicPet);
+  if (pet_count > 100) {
     return 30;   // 高频养宠用户：30分钟提醒一次
-  } else if (data.topic_pet > 50) {
+  } else if (pet_count > 50) {
     return 60;   // 中频用户：1小时
-  } else if (data.topic_pet > 20) {
+  } else if (pet_count > 20) {
     return 90;   // 低频用户：1.5小时
   } else {
     return 120;  // 很少养宠：2小时
@@ -148,18 +147,17 @@ const char* DecisionEngine::RecommendTopic() {
     return "要不要聊聊天？";
   }
   
-  const char* favorite = profile_->GetFavoriteTopic();
-  
-  if (strcmp(favorite, "weather") == 0) {
-    return "要不要查查今天天气？";
-  } else if (strcmp(favorite, "story") == 0) {
-    return "要不要听个故事？";
-  } else if (strcmp(favorite, "pet") == 0) {
-    return "去看看宠物吧？";
-  } else if (strcmp(favorite, "smart_home") == 0) {
-    return "需要控制家里的设备吗？";
-  } else {
-    return "要不要聊聊天？";
+  switch (profile_->GetFavoriteTopicId()) {
+    case ActivityModel::kTopicWeather:
+      return "要不要查查今天天气？";
+    case ActivityModel::kTopicStory:
+      return "要不要听个故事？";
+    case ActivityModel::kTopicPet:
+      return "去看看宠物吧？";
+    case ActivityModel::kTopicSmartHome:
+      return "需要控制家里的设备吗？";
+    default:
+      return "要不要聊聊天？";
   }
 }
 
@@ -1,8 +1,8 @@
 #include "emotional_memory.h"
 #include <esp_log.h>
 #include <esp_timer.h>
-#include <nvs_flash.h>
-#include <nvs.h>
+#include "persistent_store.h"
+#include "core/companion_state.h"
 #include <cmath>
 #include <cstring>
 
@@ -10,6 +10,22 @@ namespace xiaozhi {
 
 static const char* TAG = "EmotionalMemory";
 
+// 快照中情绪记忆 section 的字段
+static constexpr uint8_t kMemorySchema = 1;
+enum MemoryField : uint8_t {
+  kFieldLastPlay = 1,
+  kFieldLastFeed,
+  kFieldLastInteraction,
+  kFieldHappinessTrend,
+  kFieldEnergyTrend,
+  kFieldLoneliness,
+  kFieldExcitement,
+  kFieldTrust,
+  kFieldPlayCount,
+  kFieldFeedCount,
+  kFieldHugCount,
+};
+
 // ============================================================================
 // EmotionalMemoryData 辅助方法
 // ============================================================================
@@ -254,45 +270,54 @@ std::string EmotionalMemory::GetExcitedMessage() {
 // ========== 持久化（NVS） ==========
 
 bool EmotionalMemory::SaveToNVS() {
-  nvs_handle_t nvs;
-  esp_err_t err = nvs_open("emotional_mem", NVS_READWRITE, &nvs);
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
-    return false;
-  }
-  
-  err = nvs_set_blob(nvs, "data", &data_, sizeof(data_));
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to write NVS: %s", esp_err_to_name(err));
-    nvs_close(nvs);
-    return false;
-  }
-  
-  err = nvs_commit(nvs);
-  nvs_close(nvs);
-  
-  if (err == ESP_OK) {
-    ESP_LOGI(TAG, "💾 Saved emotional memory to NVS (loneliness=%d, trust=%d)",
-             data_.loneliness_level, data_.trust_level);
-    return true;
-  }
-  
-  ESP_LOGE(TAG, "Failed to commit NVS: %s", esp_err_to_name(err));
-  return false;
+  snapshot::SectionWriter writer;
+  writer.PutI64(kFieldLastPlay, data_.last_play_timestamp_ms);
+  writer.PutI64(kFieldLastFeed, data_.last_feed_timestamp_ms);
+  writer.PutI64(kFieldLastInteraction, data_.last_interaction_timestamp_ms);
+  writer.PutF32(kFieldHappinessTrend, data_.happiness_trend);
+  writer.PutF32(kFieldEnergyTrend, data_.energy_trend);
+  writer.PutI32(kFieldLoneliness, data_.loneliness_level);
+  writer.PutI32(kFieldExcitement, data_.excitement_level);
+  writer.PutI32(kFieldTrust, data_.trust_level);
+  writer.PutU16(kFieldPlayCount, data_.total_play_count);
+  writer.PutU16(kFieldFeedCount, data_.total_feed_count);
+  writer.PutU16(kFieldHugCount, data_.total_hug_count);
+  CompanionState::GetInstance().WriteSection(CompanionState::kSectionEmotionalMemory,
+                                             kMemorySchema, writer);
+  ESP_LOGD(TAG, "💾 Saved emotional memory (loneliness=%d, trust=%d)",
+           data_.loneliness_level, data_.trust_level);
+  return true;
 }
 
 bool EmotionalMemory::LoadFromNVS() {
-  nvs_handle_t nvs;
-  esp_err_t err = nvs_open("emotional_mem", NVS_READONLY, &nvs);
-  if (err != ESP_OK) {
+  snapshot::Section section;
+  if (!CompanionState::GetInstance().ReadSection(CompanionState::kSectionEmotionalMemory, section)) {
+    // 旧版本固件直接保存结构体，迁移一次
+    if (PersistentStore::GetInstance().Load("emotional_mem", "data", &data_, sizeof(data_))) {
+      ESP_LOGI(TAG, "Migrating emotional memory from legacy blob");
+      SaveToNVS();
+      return true;
+    }
     return false;
   }
-  
-  size_t required_size = sizeof(data_);
-  err = nvs_get_blob(nvs, "data", &data_, &required_size);
-  nvs_close(nvs);
-  
-  return (err == ESP_OK && required_size == sizeof(data_));
+
+  // 缺失的字段保持默认值
+  InitializeDefaults();
+  snapshot::SectionReader reader(section.schema, section.data.data(), section.data.size());
+  int32_t value;
+  reader.GetI64(kFieldLastPlay, data_.last_play_timestamp_ms);
+  reader.GetI64(kFieldLastFeed, data_.last_feed_timestamp_ms);
+  reader.GetI64(kFieldLastInteraction, data_.last_interaction_timestamp_ms);
+  reader.GetF32(kFieldHappinessTrend, data_.happiness_trend);
+  reader.GetF32(kFieldEnergyTrend, data_.energy_trend);
+  if (reader.GetI32(kFieldLoneliness, value)) data_.loneliness_level = value;
+  if (reader.GetI32(kFieldExcitement, value)) data_.excitement_level = value;
+  if (reader.GetI32(kFieldTrust, value)) data_.trust_level = value;
+  reader.GetU16(kFieldPlayCount, data_.total_play_count);
+  reader.GetU16(kFieldFeedCount, data_.total_feed_count);
+  reader.GetU16(kFieldHugCount, data_.total_hug_count);
+  needs_save_ = false;
+  return true;
 }
 
 void EmotionalMemory::Reset() {
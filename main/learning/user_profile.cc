@@ -1,8 +1,8 @@
 #include "user_profile.h"
 #include <esp_log.h>
 #include <esp_timer.h>
-#include <nvs_flash.h>
-#include <nvs.h>
+#include "persistent_store.h"
+#include "core/companion_state.h"
 #include <cstring>
 #include <ctime>
 
@@ -10,6 +10,36 @@ namespace xiaozhi {
 
 static const char* TAG = "UserProfile";
 
+// 快照中用户画像 section 的字段
+static constexpr uint8_t kProfileSchema = 1;
+enum ProfileField : uint8_t {
+  kFieldInteractionCount = 1,
+  kFieldAvgSession,
+  kFieldActiveHours,
+  kFieldTopicWeather,
+  kFieldTopicStory,
+  kFieldTopicPet,
+  kFieldTopicSmartHome,
+  kFieldTopicChat,
+  kFieldTopicOther,
+  kFieldPositiveFeedback,
+  kFieldNegativeFeedback,
+  kFieldLastUpdate,
+  kFieldCreated,
+  kFieldModelEpoch,
+  kFieldHourHistogram,
+  kFieldTopicHistogram,
+};
+
+// 系统时间未同步时（早于 2024-01-01）不更新时段直方图
+static constexpr time_t kMinValidTime = 1704067200;
+
+static time_t GetWallTime() {
+  time_t now;
+  time(&now);
+  return now;
+}
+
 // ============================================================================
 // UserProfile 实现
 // ============================================================================
@@ -42,6 +72,7 @@ void UserProfile::InitializeDefaults() {
   data_.avg_session_duration_s = 30;  // 默认30秒
   data_.created_ms = esp_timer_get_time() / 1000;
   data_.last_update_ms = data_.created_ms;
+  model_.Reset(GetWallTime());
   
   needs_save_ = true;
 }
@@ -55,7 +86,9 @@ void UserProfile::RecordInteraction(const char* topic, uint32_t duration_ms) {
   // 更新平均会话时长（简单移动平均）
   uint32_t duration_s = duration_ms / 1000;
   uint32_t old_avg = data_.avg_session_duration_s;
-  if (data_.avg_session_duration_s == 0) {
+  if (duration_s == 0) {
+    // 未知时长不参与平均
+  } else if (data_.avg_session_duration_s == 0) {
     data_.avg_session_duration_s = duration_s;
   } else {
     // 加权平均（80%旧值 + 20%新值）
@@ -63,8 +96,9 @@ void UserProfile::RecordInteraction(const char* topic, uint32_t duration_ms) {
         (data_.avg_session_duration_s * 4 + duration_s) / 5;
   }
   
-  // 增加话题计数
-  IncrementTopicCount(topic);
+  // 增加话题计数，时段和话题直方图 O(1) 增量更新
+  auto topic_id = ActivityModel::ClassifyTopic(topic);
+  IncrementTopicCount(topic_id);
   
   // 更新时间活跃度
   UpdateTimeActivity();
@@ -72,18 +106,13 @@ void UserProfile::RecordInteraction(const char* topic, uint32_t duration_ms) {
   // 更新时间戳
   data_.last_update_ms = esp_timer_get_time() / 1000;
   
-  // 🎯 关键修复：立即保存到 NVS（不再等待5分钟）
+  // 写入缓存，由 PersistentStore 防抖后落盘
   SaveToNVS();
   
-  // 🎯 详细日志展示学习过程
-  ESP_LOGI(TAG, "🧠 Learning: topic=%s, duration=%us", 
-           topic ? topic : "unknown", duration_s);
-  ESP_LOGI(TAG, "  📈 Total interactions: %u → %u", 
-           data_.interaction_count_7d - 1, data_.interaction_count_7d);
-  ESP_LOGI(TAG, "  ⏱️  Avg session: %us → %us", 
-           old_avg, data_.avg_session_duration_s);
-  ESP_LOGI(TAG, "  ⭐ Favorite topic: %s", GetFavoriteTopic());
-  ESP_LOGI(TAG, "  💾 Immediately saved to NVS");
+  ESP_LOGI(TAG, "🧠 Learning: topic=%s (%s), duration=%lus, total=%lu, avg=%lus→%lus, favorite=%s",
+           topic ? topic : "unknown", ActivityModel::GetTopicName(topic_id), duration_s,
+           data_.interaction_count_7d, old_avg, data_.avg_session_duration_s,
+           GetFavoriteTopic());
 }
 
 void UserProfile::RecordFeedback(bool is_positive) {
@@ -104,124 +133,130 @@ void UserProfile::RecordFeedback(bool is_positive) {
 }
 
 void UserProfile::UpdateTimeActivity() {
-  // 获取当前小时
-  time_t now;
-  time(&now);
+  time_t now = GetWallTime();
+  if (now < kMinValidTime) {
+    return;
+  }
   struct tm timeinfo;
   localtime_r(&now, &timeinfo);
-  int hour = timeinfo.tm_hour;
   
   // 增加该小时的活跃度（上限255）
-  if (data_.active_hours[hour] < 255) {
-    data_.active_hours[hour]++;
+  if (data_.active_hours[timeinfo.tm_hour] < 255) {
+    data_.active_hours[timeinfo.tm_hour]++;
   }
+  model_.RecordHour(timeinfo.tm_hour, now);
 }
 
-void UserProfile::IncrementTopicCount(const char* topic) {
-  if (!topic) {
-    data_.topic_other++;
-    return;
-  }
-  
-  // 简单字符串匹配
-  if (strstr(topic, "weather") || strstr(topic, "天气")) {
-    data_.topic_weather++;
-  } else if (strstr(topic, "story") || strstr(topic, "故事")) {
-    data_.topic_story++;
-  } else if (strstr(topic, "pet") || strstr(topic, "宠物")) {
-    data_.topic_pet++;
-  } else if (strstr(topic, "smart_home") || strstr(topic, "智能家居") || 
-             strstr(topic, "control") || strstr(topic, "控制")) {
-    data_.topic_smart_home++;
-  } else if (strstr(topic, "chat") || strstr(topic, "聊天")) {
-    data_.topic_chat++;
-  } else {
-    data_.topic_other++;
+void UserProfile::IncrementTopicCount(ActivityModel::Topic topic) {
+  switch (topic) {
+    case ActivityModel::kTopicWeather: data_.topic_weather++; break;
+    case ActivityModel::kTopicStory: data_.topic_story++; break;
+    case ActivityModel::kTopicPet: data_.topic_pet++; break;
+    case ActivityModel::kTopicSmartHome: data_.topic_smart_home++; break;
+    case ActivityModel::kTopicChat: data_.topic_chat++; break;
+    default: data_.topic_other++; break;
   }
+  model_.RecordTopic(topic, GetWallTime());
 }
 
 const char* UserProfile::GetFavoriteTopic() const {
-  uint16_t max_count = 0;
-  const char* favorite = "chat";
-  
-  if (data_.topic_weather > max_count) {
-    max_count = data_.topic_weather;
-    favorite = "weather";
-  }
-  if (data_.topic_story > max_count) {
-    max_count = data_.topic_story;
-    favorite = "story";
-  }
-  if (data_.topic_pet > max_count) {
-    max_count = data_.topic_pet;
-    favorite = "pet";
-  }
-  if (data_.topic_smart_home > max_count) {
-    max_count = data_.topic_smart_home;
-    favorite = "smart_home";
-  }
-  if (data_.topic_chat > max_count) {
-    favorite = "chat";
-  }
-  
-  return favorite;
+  return ActivityModel::GetTopicName(model_.GetFavoriteTopic());
+}
+
+uint32_t UserProfile::GetHourActivityCount(uint8_t hour) const {
+  return model_.GetHourCount(hour, GetWallTime());
+}
+
+uint32_t UserProfile::GetTopicActivityCount(ActivityModel::Topic topic) const {
+  return model_.GetTopicCount(topic, GetWallTime());
 }
 
 // ========== 持久化（NVS） ==========
 
 bool UserProfile::SaveToNVS() {
-  nvs_handle_t nvs;
-  esp_err_t err = nvs_open("user_profile", NVS_READWRITE, &nvs);
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "❌ Failed to open NVS: %s", esp_err_to_name(err));
-    return false;
-  }
-  
-  // 保存所有字段（使用二进制 blob 存储整个结构体，更高效）
-  err = nvs_set_blob(nvs, "profile_data", &data_, sizeof(data_));
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "❌ Failed to write profile data: %s", esp_err_to_name(err));
-    nvs_close(nvs);
-    return false;
-  }
-  
-  err = nvs_commit(nvs);
-  nvs_close(nvs);
-  
-  if (err != ESP_OK) {
-    ESP_LOGE(TAG, "❌ Failed to commit NVS: %s", esp_err_to_name(err));
-    return false;
-  }
+  snapshot::SectionWriter writer;
+  writer.PutU32(kFieldInteractionCount, data_.interaction_count_7d);
+  writer.PutU32(kFieldAvgSession, data_.avg_session_duration_s);
+  writer.PutBytes(kFieldActiveHours, data_.active_hours, sizeof(data_.active_hours));
+  writer.PutU16(kFieldTopicWeather, data_.topic_weather);
+  writer.PutU16(kFieldTopicStory, data_.topic_story);
+  writer.PutU16(kFieldTopicPet, data_.topic_pet);
+  writer.PutU16(kFieldTopicSmartHome, data_.topic_smart_home);
+  writer.PutU16(kFieldTopicChat, data_.topic_chat);
+  writer.PutU16(kFieldTopicOther, data_.topic_other);
+  writer.PutU16(kFieldPositiveFeedback, data_.positive_feedback_count);
+  writer.PutU16(kFieldNegativeFeedback, data_.negative_feedback_count);
+  writer.PutI64(kFieldLastUpdate, data_.last_update_ms);
+  writer.PutI64(kFieldCreated, data_.created_ms);
+  writer.PutI64(kFieldModelEpoch, model_.epoch_s());
+  writer.PutU32Array(kFieldHourHistogram, model_.hour_bins(), ActivityModel::kHourCount);
+  writer.PutU32Array(kFieldTopicHistogram, model_.topic_bins(), ActivityModel::kTopicCount);
+  // 写入快照缓存，由 PersistentStore 防抖后落盘
+  CompanionState::GetInstance().WriteSection(CompanionState::kSectionUserProfile,
+                                             kProfileSchema, writer);
   
   last_save_ms_ = esp_timer_get_time() / 1000;
   needs_save_ = false;
   
-  ESP_LOGI(TAG, "💾 Saved user profile to NVS (size: %u bytes, 7d互动: %u次)", 
-           sizeof(data_), data_.interaction_count_7d);
+  ESP_LOGD(TAG, "💾 Saved user profile (%u bytes, 7d互动: %u次)", 
+           writer.data().size(), data_.interaction_count_7d);
   return true;
 }
 
 bool UserProfile::LoadFromNVS() {
-  nvs_handle_t nvs;
-  esp_err_t err = nvs_open("user_profile", NVS_READONLY, &nvs);
-  if (err != ESP_OK) {
-    ESP_LOGD(TAG, "Profile not found in NVS (first run): %s", esp_err_to_name(err));
+  snapshot::Section section;
+  if (!CompanionState::GetInstance().ReadSection(CompanionState::kSectionUserProfile, section)) {
+    // 旧版本固件直接保存结构体，迁移一次
+    if (PersistentStore::GetInstance().Load("user_profile", "profile_data", &data_, sizeof(data_))) {
+      ESP_LOGI(TAG, "Migrating user profile from legacy blob");
+      SeedModelFromCounters();
+      SaveToNVS();
+      return true;
+    }
+    ESP_LOGD(TAG, "Profile not found in NVS (first run)");
     return false;
   }
-  
-  // 读取二进制 blob
-  size_t required_size = sizeof(data_);
-  err = nvs_get_blob(nvs, "profile_data", &data_, &required_size);
-  nvs_close(nvs);
-  
-  if (err != ESP_OK || required_size != sizeof(data_)) {
-    ESP_LOGW(TAG, "Failed to read profile data: %s", esp_err_to_name(err));
-    return false;
+
+  // 缺失的字段保持默认值
+  InitializeDefaults();
+  snapshot::SectionReader reader(section.schema, section.data.data(), section.data.size());
+  reader.GetU32(kFieldInteractionCount, data_.interaction_count_7d);
+  reader.GetU32(kFieldAvgSession, data_.avg_session_duration_s);
+  reader.GetBytes(kFieldActiveHours, data_.active_hours, sizeof(data_.active_hours));
+  reader.GetU16(kFieldTopicWeather, data_.topic_weather);
+  reader.GetU16(kFieldTopicStory, data_.topic_story);
+  reader.GetU16(kFieldTopicPet, data_.topic_pet);
+  reader.GetU16(kFieldTopicSmartHome, data_.topic_smart_home);
+  reader.GetU16(kFieldTopicChat, data_.topic_chat);
+  reader.GetU16(kFieldTopicOther, data_.topic_other);
+  reader.GetU16(kFieldPositiveFeedback, data_.positive_feedback_count);
+  reader.GetU16(kFieldNegativeFeedback, data_.negative_feedback_count);
+  reader.GetI64(kFieldLastUpdate, data_.last_update_ms);
+  reader.GetI64(kFieldCreated, data_.created_ms);
+
+  // 直方图每个元素按小端序保存；旧快照没有直方图时用累计计数初始化
+  int64_t epoch_s = 0;
+  uint32_t hours[ActivityModel::kHourCount];
+  uint32_t topics[ActivityModel::kTopicCount];
+  if (reader.GetI64(kFieldModelEpoch, epoch_s) &&
+      reader.GetU32Array(kFieldHourHistogram, hours, ActivityModel::kHourCount) &&
+      reader.GetU32Array(kFieldTopicHistogram, topics, ActivityModel::kTopicCount)) {
+    model_.Restore(epoch_s, hours, topics);
+  } else {
+    SeedModelFromCounters();
   }
-  
+  needs_save_ = false;
   return true;
 }
 
+void UserProfile::SeedModelFromCounters() {
+  const uint16_t topics[ActivityModel::kTopicCount] = {
+      data_.topic_weather, data_.topic_story, data_.topic_pet,
+      data_.topic_smart_home, data_.topic_chat, data_.topic_other,
+  };
+  model_.Seed(data_.active_hours, topics, GetWallTime());
+}
+
 void UserProfile::Reset() {
   InitializeDefaults();
   SaveToNVS();
@@ -234,7 +269,7 @@ void UserProfile::PrintStats() const {
   ESP_LOGI(TAG, "========== User Profile Stats ==========");
   ESP_LOGI(TAG, "Interactions (7d): %lu", data_.interaction_count_7d);
   ESP_LOGI(TAG, "Avg session: %lus", data_.avg_session_duration_s);
-  ESP_LOGI(TAG, "Most active hour: %u:00", data_.GetMostActiveHour());
+  ESP_LOGI(TAG, "Most active hour: %u:00", model_.GetMostActiveHour());
   ESP_LOGI(TAG, "Favorite topic: %s", GetFavoriteTopic());
   ESP_LOGI(TAG, "Positive ratio: %u%%", data_.GetPositiveRatio());
   ESP_LOGI(TAG, "Topics: weather=%u story=%u pet=%u home=%u chat=%u other=%u",
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <string>
 
+#include "activity_model.h"
+
 namespace xiaozhi {
 
 // ============================================================================
@@ -83,14 +85,26 @@ class UserProfile {
   // 获取7天互动次数
   uint32_t GetInteractionCount7d() const { return data_.interaction_count_7d; }
   
-  // 获取最活跃时段
-  uint8_t GetMostActiveHour() const { return data_.GetMostActiveHour(); }
+  // 获取最活跃时段（按衰减直方图，O(1)）
+  uint8_t GetMostActiveHour() const { return model_.GetMostActiveHour(); }
+  
+  // 获取某时段最近的等效互动次数（按 7 天半衰期衰减）
+  uint32_t GetHourActivityCount(uint8_t hour) const;
+  
+  // 获取某时段活跃度相对最活跃时段的百分比（0-100）
+  uint8_t GetHourActivityPercent(uint8_t hour) const {
+    return model_.GetHourActivityPercent(hour);
+  }
+  
+  // 获取某话题最近的等效次数（按 7 天半衰期衰减）
+  uint32_t GetTopicActivityCount(ActivityModel::Topic topic) const;
   
   // 获取正面反馈比例（0-100）
   uint8_t GetPositiveRatio() const { return data_.GetPositiveRatio(); }
   
-  // 获取话题偏好
+  // 获取话题偏好（按衰减直方图，O(1)）
   const char* GetFavoriteTopic() const;
+  ActivityModel::Topic GetFavoriteTopicId() const { return model_.GetFavoriteTopic(); }
 
   // ========== 持久化（NVS） ==========
   
@@ -123,11 +137,15 @@ class UserProfile {
   // 初始化数据为默认值
   void InitializeDefaults();
   
-  // 解析话题类型
-  void IncrementTopicCount(const char* topic);
+  // 用累计计数初始化衰减模型（迁移旧数据）
+  void SeedModelFromCounters();
+  
+  // 累加话题计数
+  void IncrementTopicCount(ActivityModel::Topic topic);
 
   // 数据
   UserProfileData data_;
+  ActivityModel model_;
   
   // 配置
   uint32_t auto_save_interval_s_ = 600;  // 默认10分钟自动保存
@@ -0,0 +1,83 @@
+#include "mcp_result_writer.h"
+
+#include <mbedtls/base64.h>
+
+void McpResultWriter::AppendEscaped(std::string& out, const char* text, size_t length) {
+    static const char hex[] = "0123456789abcdef";
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = text[i];
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xF];
+            } else {
+                out += c;
+            }
+            break;
+        }
+    }
+}
+
+void McpResultWriter::AppendJsonString(std::string& out, const char* text, size_t length) {
+    out += '"';
+    AppendEscaped(out, text, length);
+    out += '"';
+}
+
+void McpResultWriter::BeginContent() {
+    *target_ += has_content_ ? "," : "{\"content\":[";
+    has_content_ = true;
+}
+
+void McpResultWriter::Text(const char* text, size_t length) {
+    BeginContent();
+    *target_ += "{\"type\":\"text\",\"text\":";
+    AppendJsonString(*target_, text, length);
+    *target_ += '}';
+}
+
+void McpResultWriter::Image(std::unique_ptr<ImageContent> image) {
+    BeginContent();
+    // 与之前的格式保持一致：image 字段是序列化后的 {"type":"image","mimeType":...,"data":...}
+    std::string inner = "{\"type\":\"image\",\"mimeType\":";
+    AppendJsonString(inner, image->mime_type().data(), image->mime_type().size());
+    inner += ",\"data\":\"";
+    *target_ += "{\"type\":\"image\",\"image\":\"";
+    AppendEscaped(*target_, inner.data(), inner.size());
+
+    if (image_ == nullptr) {
+        // 第一张图片留给协议层边编码边发送，后续内容写入 tail
+        image_ = std::move(image);
+        target_ = &tail_;
+    } else {
+        // base64 字符不需要转义，直接编码进缓冲区
+        const auto& data = image->data();
+        size_t pos = target_->size();
+        size_t encoded = ImageContent::EncodedSize(data.size());
+        size_t olen = 0;
+        target_->resize(pos + encoded + 1);
+        mbedtls_base64_encode((unsigned char*)&(*target_)[pos], encoded + 1, &olen,
+                              (const unsigned char*)data.data(), data.size());
+        target_->resize(pos + olen);
+    }
+    *target_ += "\\\"}\"}";
+}
+
+bool McpResultWriter::Finish(std::string& error) {
+    if (failed_) {
+        error = error_;
+        return false;
+    }
+    if (!has_content_) {
+        Text("true");
+    }
+    *target_ += "],\"isError\":false}";
+    return true;
+}
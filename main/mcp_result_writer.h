@@ -0,0 +1,78 @@
+#ifndef MCP_RESULT_WRITER_H
+#define MCP_RESULT_WRITER_H
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+/**
+ * @brief 图片结果
+ *
+ * 保存原始图片数据，回复时才边发送边做 base64 编码，避免在内存中保存编码后的多份副本。
+ */
+class ImageContent {
+private:
+    std::string mime_type_;
+    std::string data_;
+
+public:
+    ImageContent(const std::string& mime_type, const std::string& data)
+        : mime_type_(mime_type), data_(data) {}
+    ImageContent(const std::string& mime_type, std::string&& data)
+        : mime_type_(mime_type), data_(std::move(data)) {}
+
+    inline const std::string& mime_type() const { return mime_type_; }
+    inline const std::string& data() const { return data_; }
+
+    // base64 编码后的长度（不含结尾的 '\0'）
+    static size_t EncodedSize(size_t length) { return (length + 2) / 3 * 4; }
+};
+
+/**
+ * @brief 工具结果写入器
+ *
+ * 工具把结果直接写入回复缓冲区，不经过 cJSON。
+ * 每次 Text/Bool/Int/Image 追加一个内容项；没有写入任何内容时结果为 "true"。
+ * 调用 Error 后整个调用以错误回复，不需要抛出异常。
+ * 第一张图片的数据不写入缓冲区：缓冲区在图片数据处截断，之后的内容写入 tail，
+ * 发送时由协议层边编码边发送。
+ */
+class McpResultWriter {
+private:
+    std::string& out_;
+    std::string* target_;
+    std::string tail_;
+    std::shared_ptr<ImageContent> image_;
+    std::string error_;
+    bool has_content_ = false;
+    bool failed_ = false;
+
+    void BeginContent();
+
+public:
+    explicit McpResultWriter(std::string& out) : out_(out), target_(&out) {}
+
+    void Text(const char* text, size_t length);
+    void Text(const std::string& text) { Text(text.data(), text.size()); }
+    void Text(const char* text) { Text(text, strlen(text)); }
+    void Bool(bool value) { Text(value ? "true" : "false"); }
+    void Int(int value) { Text(std::to_string(value)); }
+    void Image(std::unique_ptr<ImageContent> image);
+    void Error(const std::string& message) {
+        failed_ = true;
+        error_ = message;
+    }
+
+    bool Finish(std::string& error);
+
+    // 延迟编码的图片及其后的回复内容，没有图片时为空
+    inline const std::shared_ptr<ImageContent>& image() const { return image_; }
+    inline std::string& tail() { return tail_; }
+
+    // 追加 JSON 字符串（含引号），按 JSON 规则转义
+    static void AppendJsonString(std::string& out, const char* text, size_t length);
+    // 只转义，不加引号
+    static void AppendEscaped(std::string& out, const char* text, size_t length);
+};
+
+#endif // MCP_RESULT_WRITER_H
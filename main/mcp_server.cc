@@ -6,6 +6,9 @@
 #include "mcp_server.h"
 #include <esp_log.h>
 #include <esp_app_desc.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <algorithm>
 #include <cstring>
 #include <esp_pthread.h>
@@ -21,6 +24,13 @@
 
 #define TAG "MCP"
 
+// 超过这个时间的工具调用会打印警告
+#define MCP_SLOW_TOOL_CALL_US   (1000 * 1000)
+
+// 当前线程正在执行的工具调用所属的取消代数
+static thread_local bool tls_in_tool_call = false;
+static thread_local uint32_t tls_tool_call_generation = 0;
+
 McpServer::McpServer() {
 }
 
@@ -29,6 +39,7 @@ McpServer::~McpServer() {
         delete tool;
     }
     tools_.clear();
+    tool_index_.clear();
 }
 
 void McpServer::AddCommonTools() {
@@ -119,6 +130,8 @@ void McpServer::AddCommonTools() {
                 auto question = properties["question"].value<std::string>();
                 return camera->Explain(question);
             });
+        // 拍照、编码和上传耗时数秒，放到工作线程并与其他相机操作互斥
+        SetToolExecution("self.camera.take_photo", kToolExecutionExclusive, "camera");
     }
 #endif
 
@@ -135,6 +148,7 @@ void McpServer::AddUserOnlyTools() {
             auto& board = Board::GetInstance();
             return board.GetSystemInfoJson();
         });
+    SetToolExecution("self.get_system_info", kToolExecutionWorker);
 
     AddUserOnlyTool("self.reboot", "Reboot the system",
         PropertyList(),
@@ -285,6 +299,20 @@ void McpServer::AddUserOnlyTools() {
             });
 #endif // CONFIG_LV_USE_SNAPSHOT
     }
+
+    auto camera = Board::GetInstance().GetCamera();
+    if (camera) {
+        AddUserOnlyTool("self.camera.set_viewfinder", "Continuously preview the camera on the screen at a low frame rate",
+            PropertyList({
+                Property("enabled", kPropertyTypeBoolean),
+                Property("fps", kPropertyTypeInteger, 5, 1, 10)
+            }),
+            [camera](const PropertyList& properties) -> ReturnValue {
+                bool enabled = properties["enabled"].value<bool>();
+                int fps = properties["fps"].value<int>();
+                return camera->SetViewfinder(enabled, fps);
+            });
+    }
 #endif // HAVE_LVGL
 
     // Assets download url
@@ -302,6 +330,14 @@ void McpServer::AddUserOnlyTools() {
             });
     }
 
+    AddUserOnlyTool("self.mcp.get_metrics",
+        "Get the per-tool call count, latency and queue wait of MCP tool calls",
+        PropertyList(),
+        [this](const PropertyList& properties) -> ReturnValue {
+            return GetToolMetricsJson();
+        });
+    SetToolExecution("self.mcp.get_metrics", kToolExecutionInline);
+
     // NVS management tool
     AddUserOnlyTool("self.nvs.erase_all", 
         "Erase all NVS data and reboot. WARNING: This will reset all settings!",
@@ -316,13 +352,37 @@ void McpServer::AddUserOnlyTools() {
 
 void McpServer::AddTool(McpTool* tool) {
     // Prevent adding duplicate tools
-    if (std::find_if(tools_.begin(), tools_.end(), [tool](const McpTool* t) { return t->name() == tool->name(); }) != tools_.end()) {
+    if (FindTool(tool->name()) != nullptr) {
         ESP_LOGW(TAG, "Tool %s already added", tool->name().c_str());
         return;
     }
 
     ESP_LOGI(TAG, "Add tool: %s%s", tool->name().c_str(), tool->user_only() ? " [user]" : "");
+    tool_index_[tool->name()] = tools_.size();
     tools_.push_back(tool);
+
+    std::lock_guard<std::mutex> lock(tools_list_mutex_);
+    tools_list_valid_ = false;
+}
+
+McpTool* McpServer::FindTool(const std::string& name) const {
+    auto it = tool_index_.find(name);
+    return it != tool_index_.end() ? tools_[it->second] : nullptr;
+}
+
+void McpServer::SetToolExecution(const std::string& name, ToolExecutionClass execution_class,
+                                 const std::string& resource, int max_concurrency) {
+    auto tool = FindTool(name);
+    if (tool == nullptr) {
+        ESP_LOGW(TAG, "SetToolExecution: unknown tool %s", name.c_str());
+        return;
+    }
+    // 没有指定资源的独占工具只与自身互斥
+    if (execution_class == kToolExecutionExclusive && resource.empty()) {
+        tool->set_execution(execution_class, name, 1);
+    } else {
+        tool->set_execution(execution_class, resource, max_concurrency);
+    }
 }
 
 void McpServer::AddTool(const std::string& name, const std::string& description, const PropertyList& properties, std::function<ReturnValue(const PropertyList&)> callback) {
@@ -458,55 +518,79 @@ void McpServer::ReplyResult(int id, const std::string& result) {
 }
 
 void McpServer::ReplyError(int id, const std::string& message) {
+    // 消息中可能带有客户端传来的方法名、工具名或游标，必须转义
     std::string payload = "{\"jsonrpc\":\"2.0\",\"id\":";
     payload += std::to_string(id);
-    payload += ",\"error\":{\"message\":\"";
-    payload += message;
-    payload += "\"}}";
+    payload += ",\"error\":{\"message\":";
+    McpResultWriter::AppendJsonString(payload, message.data(), message.size());
+    payload += "}}";
     Application::GetInstance().SendMcpMessage(payload);
 }
 
+void McpServer::BuildToolsList() {
+    // 工具描述在注册后不再变化，只在第一次 tools/list 时序列化一次
+    int64_t start = esp_timer_get_time();
+    tools_list_json_.clear();
+    tools_list_entries_.clear();
+    tools_list_entries_.reserve(tools_.size());
+    for (auto tool : tools_) {
+        std::string tool_json = tool->to_json();
+        if (!tools_list_json_.empty()) {
+            tools_list_json_ += ',';
+        }
+        tools_list_entries_.push_back({uint32_t(tools_list_json_.size()), uint32_t(tool_json.size()), tool->user_only()});
+        tools_list_json_ += tool_json;
+    }
+    tools_list_json_.shrink_to_fit();
+    tools_list_valid_ = true;
+    ESP_LOGI(TAG, "tools/list: %d tools, %d bytes, built in %d ms", int(tools_.size()),
+             int(tools_list_json_.size()), int((esp_timer_get_time() - start) / 1000));
+}
+
 void McpServer::GetToolsList(int id, const std::string& cursor, bool list_user_only_tools) {
-    const int max_payload_size = 8000;
-    std::string json = "{\"tools\":[";
-    
-    bool found_cursor = cursor.empty();
-    auto it = tools_.begin();
-    std::string next_cursor = "";
-    
-    while (it != tools_.end()) {
-        // 如果我们还没有找到起始位置，继续搜索
-        if (!found_cursor) {
-            if ((*it)->name() == cursor) {
-                found_cursor = true;
-            } else {
-                ++it;
-                continue;
-            }
+    const size_t max_payload_size = 8000;
+
+    size_t index = 0;
+    if (!cursor.empty()) {
+        auto it = tool_index_.find(cursor);
+        if (it == tool_index_.end()) {
+            ESP_LOGE(TAG, "tools/list: Invalid cursor %s", cursor.c_str());
+            ReplyError(id, "Invalid cursor: " + cursor);
+            return;
         }
+        index = it->second;
+    }
 
-        if (!list_user_only_tools && (*it)->user_only()) {
-            ++it;
-            continue;
+    std::string json;
+    std::string next_cursor;
+    {
+        std::lock_guard<std::mutex> lock(tools_list_mutex_);
+        if (!tools_list_valid_) {
+            BuildToolsList();
         }
-        
-        // 添加tool前检查大小
-        std::string tool_json = (*it)->to_json() + ",";
-        if (json.length() + tool_json.length() + 30 > max_payload_size) {
-            // 如果添加这个tool会超出大小限制，设置next_cursor并退出循环
-            next_cursor = (*it)->name();
-            break;
+
+        json.reserve(max_payload_size);
+        json = "{\"tools\":[";
+        for (; index < tools_list_entries_.size(); index++) {
+            const auto& entry = tools_list_entries_[index];
+            if (!list_user_only_tools && entry.user_only) {
+                continue;
+            }
+            // 添加tool前检查大小
+            if (json.length() + entry.length + 31 > max_payload_size) {
+                next_cursor = tools_[index]->name();
+                break;
+            }
+            json.append(tools_list_json_, entry.offset, entry.length);
+            json += ',';
         }
-        
-        json += tool_json;
-        ++it;
     }
-    
+
     if (json.back() == ',') {
         json.pop_back();
     }
-    
-    if (json.back() == '[' && !tools_.empty()) {
+
+    if (json.back() == '[' && !next_cursor.empty()) {
         // 如果没有添加任何tool，返回错误
         ESP_LOGE(TAG, "tools/list: Failed to add tool %s because of payload size limit", next_cursor.c_str());
         ReplyError(id, "Failed to add tool " + next_cursor + " because of payload size limit");
@@ -518,60 +602,230 @@ void McpServer::GetToolsList(int id, const std::string& cursor, bool list_user_o
     } else {
         json += "],\"nextCursor\":\"" + next_cursor + "\"}";
     }
-    
+
     ReplyResult(id, json);
 }
 
 void McpServer::DoToolCall(int id, const std::string& tool_name, const cJSON* tool_arguments) {
-    auto tool_iter = std::find_if(tools_.begin(), tools_.end(), 
-                                 [&tool_name](const McpTool* tool) { 
-                                     return tool->name() == tool_name; 
-                                 });
-    
-    if (tool_iter == tools_.end()) {
+    auto tool = FindTool(tool_name);
+    if (tool == nullptr) {
         ESP_LOGE(TAG, "tools/call: Unknown tool: %s", tool_name.c_str());
         ReplyError(id, "Unknown tool: " + tool_name);
         return;
     }
 
-    PropertyList arguments = (*tool_iter)->properties();
-    try {
-        for (auto& argument : arguments) {
-            bool found = false;
-            if (cJSON_IsObject(tool_arguments)) {
-                auto value = cJSON_GetObjectItem(tool_arguments, argument.name().c_str());
-                if (argument.type() == kPropertyTypeBoolean && cJSON_IsBool(value)) {
-                    argument.set_value<bool>(value->valueint == 1);
-                    found = true;
-                } else if (argument.type() == kPropertyTypeInteger && cJSON_IsNumber(value)) {
-                    argument.set_value<int>(value->valueint);
-                    found = true;
-                } else if (argument.type() == kPropertyTypeString && cJSON_IsString(value)) {
-                    argument.set_value<std::string>(value->valuestring);
-                    found = true;
-                }
-            }
+    std::string error;
+    auto call = tool->Bind(tool_arguments, error);
+    if (call == nullptr) {
+        ESP_LOGE(TAG, "tools/call: %s", error.c_str());
+        ReplyError(id, error);
+        return;
+    }
 
-            if (!argument.has_default_value() && !found) {
-                ESP_LOGE(TAG, "tools/call: Missing valid argument: %s", argument.name().c_str());
-                ReplyError(id, "Missing valid argument: " + argument.name());
-                return;
-            }
+    ToolJob job = {id, tool, std::move(call), esp_timer_get_time(), cancel_generation_.load()};
+    switch (job.tool->execution_class()) {
+    case kToolExecutionInline:
+        RunToolCall(job);
+        break;
+    case kToolExecutionWorker:
+    case kToolExecutionExclusive: {
+        std::unique_lock<std::mutex> lock(jobs_mutex_);
+        if (pending_jobs_.size() >= kMaxPendingToolCalls || !StartWorkers()) {
+            lock.unlock();
+            ESP_LOGW(TAG, "tools/call: Too many pending tool calls, rejecting %s", tool_name.c_str());
+            ReplyError(id, "Too many pending tool calls");
+            return;
         }
-    } catch (const std::exception& e) {
-        ESP_LOGE(TAG, "tools/call: %s", e.what());
-        ReplyError(id, e.what());
+        pending_jobs_.push_back(std::move(job));
+        jobs_cv_.notify_all();
+        break;
+    }
+    default:
+        // Use main thread to call the tool
+        Application::GetInstance().Schedule([this, job = std::move(job)]() mutable {
+            RunToolCall(job);
+        });
+        break;
+    }
+}
+
+void McpServer::RunToolCall(ToolJob& job) {
+    auto tool = job.tool;
+    int64_t start = esp_timer_get_time();
+    if (job.generation != cancel_generation_.load()) {
+        {
+            std::lock_guard<std::mutex> lock(jobs_mutex_);
+            tool->stats.cancelled++;
+        }
+        ReplyError(job.id, "Tool call cancelled");
         return;
     }
 
-    // Use main thread to call the tool
-    auto& app = Application::GetInstance();
-    app.Schedule([this, id, tool_iter, arguments = std::move(arguments)]() {
-        try {
-            ReplyResult(id, (*tool_iter)->Call(arguments));
-        } catch (const std::exception& e) {
-            ESP_LOGE(TAG, "tools/call: %s", e.what());
-            ReplyError(id, e.what());
+    // 结果直接写在 JSON-RPC 回复的后面，避免再复制一次
+    std::string payload = "{\"jsonrpc\":\"2.0\",\"id\":";
+    payload += std::to_string(job.id) + ",\"result\":";
+    McpResultWriter result(payload);
+    std::string error;
+    bool ok;
+    tls_in_tool_call = true;
+    tls_tool_call_generation = job.generation;
+    try {
+        job.call->Invoke(result);
+        ok = result.Finish(error);
+    } catch (const std::exception& e) {
+        error = e.what();
+        ok = false;
+    }
+    tls_in_tool_call = false;
+    job.call.reset();
+
+    size_t reply_bytes = payload.size();
+    if (!ok) {
+        ESP_LOGE(TAG, "tools/call: %s", error.c_str());
+        ReplyError(job.id, error);
+    } else if (result.image() != nullptr) {
+        // 图片由协议层分片编码发送，完整的 base64 和 JSON 不会出现在内存中
+        auto image = result.image();
+        auto& tail = result.tail();
+        tail += "}";
+        reply_bytes += tail.size() + image->data().size();
+        ESP_LOGI(TAG, "tools/call: %s returned %d bytes image (%d bytes base64), reply memory %d bytes",
+                 tool->name().c_str(), int(image->data().size()), int(ImageContent::EncodedSize(image->data().size())),
+                 int(reply_bytes));
+        Application::GetInstance().SendMcpMessage(std::move(payload), std::move(image), std::move(tail));
+    } else {
+        payload += "}";
+        Application::GetInstance().SendMcpMessage(std::move(payload));
+    }
+
+    int64_t elapsed = esp_timer_get_time() - start;
+    if (elapsed > MCP_SLOW_TOOL_CALL_US) {
+        ESP_LOGW(TAG, "tools/call: %s took %d ms (queued %d ms)", tool->name().c_str(),
+                 int(elapsed / 1000), int((start - job.enqueue_us) / 1000));
+    }
+
+    std::lock_guard<std::mutex> lock(jobs_mutex_);
+    auto& stats = tool->stats;
+    stats.calls++;
+    stats.errors += ok ? 0 : 1;
+    stats.total_us += elapsed;
+    stats.max_us = std::max(stats.max_us, elapsed);
+    stats.total_wait_us += start - job.enqueue_us;
+    stats.max_reply_bytes = std::max(stats.max_reply_bytes, reply_bytes);
+}
+
+bool McpServer::StartWorkers() {
+    // 第一次有工具需要工作线程时才创建，调用方持有 jobs_mutex_
+    while (worker_count_ < kToolWorkerCount) {
+        if (xTaskCreate([](void* arg) {
+                static_cast<McpServer*>(arg)->ToolWorkerTask();
+                vTaskDelete(NULL);
+            }, "mcp_worker", 2048 * 4, this, 2, nullptr) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create MCP worker task");
+            break;
         }
-    });
+        worker_count_++;
+    }
+    return worker_count_ > 0;
+}
+
+bool McpServer::IsRunnable(const McpTool* tool) const {
+    if (tool->running >= tool->max_concurrency()) {
+        return false;
+    }
+    return tool->resource().empty() ||
+           std::find(busy_resources_.begin(), busy_resources_.end(), tool->resource()) == busy_resources_.end();
+}
+
+void McpServer::ToolWorkerTask() {
+    std::unique_lock<std::mutex> lock(jobs_mutex_);
+    for (;;) {
+        // 按到达顺序取第一个可以执行的调用，资源被占用的调用留在队列中
+        auto it = pending_jobs_.end();
+        jobs_cv_.wait(lock, [this, &it]() {
+            it = std::find_if(pending_jobs_.begin(), pending_jobs_.end(),
+                              [this](const ToolJob& job) { return IsRunnable(job.tool); });
+            return it != pending_jobs_.end();
+        });
+        ToolJob job = std::move(*it);
+        pending_jobs_.erase(it);
+
+        auto tool = job.tool;
+        tool->running++;
+        if (!tool->resource().empty()) {
+            busy_resources_.push_back(tool->resource());
+        }
+        lock.unlock();
+
+        RunToolCall(job);
+
+        lock.lock();
+        tool->running--;
+        if (!tool->resource().empty()) {
+            busy_resources_.erase(std::find(busy_resources_.begin(), busy_resources_.end(), tool->resource()));
+        }
+        jobs_cv_.notify_all();
+    }
+}
+
+void McpServer::CancelToolCalls() {
+    std::deque<ToolJob> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        cancel_generation_++;
+        cancelled.swap(pending_jobs_);
+        for (auto& job : cancelled) {
+            job.tool->stats.cancelled++;
+        }
+    }
+    if (!cancelled.empty()) {
+        ESP_LOGI(TAG, "Cancelled %d pending tool calls", int(cancelled.size()));
+    }
+    for (auto& job : cancelled) {
+        ReplyError(job.id, "Tool call cancelled");
+    }
+}
+
+bool McpServer::IsToolCallCancelled() {
+    return tls_in_tool_call && tls_tool_call_generation != GetInstance().cancel_generation_.load();
+}
+
+uint32_t McpServer::GetToolCallToken() {
+    return tls_in_tool_call ? tls_tool_call_generation : GetInstance().cancel_generation_.load();
+}
+
+bool McpServer::IsToolCallCancelled(uint32_t token) {
+    return token != GetInstance().cancel_generation_.load();
+}
+
+std::string McpServer::GetToolMetricsJson() {
+    static const char* const execution_names[] = {"main_loop", "inline", "worker", "exclusive"};
+    cJSON* json = cJSON_CreateArray();
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        for (auto tool : tools_) {
+            const auto& stats = tool->stats;
+            if (stats.calls == 0 && stats.cancelled == 0) {
+                continue;
+            }
+            cJSON* item = cJSON_CreateObject();
+            cJSON_AddStringToObject(item, "name", tool->name().c_str());
+            cJSON_AddStringToObject(item, "execution", execution_names[tool->execution_class()]);
+            cJSON_AddNumberToObject(item, "calls", stats.calls);
+            cJSON_AddNumberToObject(item, "errors", stats.errors);
+            cJSON_AddNumberToObject(item, "cancelled", stats.cancelled);
+            if (stats.calls > 0) {
+                cJSON_AddNumberToObject(item, "avg_ms", stats.total_us / stats.calls / 1000);
+                cJSON_AddNumberToObject(item, "max_ms", stats.max_us / 1000);
+                cJSON_AddNumberToObject(item, "avg_wait_ms", stats.total_wait_us / stats.calls / 1000);
+                cJSON_AddNumberToObject(item, "max_reply_bytes", stats.max_reply_bytes);
+            }
+            cJSON_AddItemToArray(json, item);
+        }
+    }
+    char* json_str = cJSON_PrintUnformatted(json);
+    std::string result(json_str);
+    cJSON_free(json_str);
+    cJSON_Delete(json);
+    return result;
 }
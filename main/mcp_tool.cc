@@ -0,0 +1,50 @@
+#include "mcp_tool.h"
+
+namespace {
+
+// PropertyList 工具的一次调用，参数为工具属性列表的副本
+class PropertyListCall : public McpToolCall {
+public:
+    PropertyListCall(McpTool* tool, PropertyList&& arguments) : tool_(tool), arguments_(std::move(arguments)) {}
+
+    void Invoke(McpResultWriter& result) override {
+        tool_->Call(arguments_, result);
+    }
+
+private:
+    McpTool* tool_;
+    PropertyList arguments_;
+};
+
+} // namespace
+
+std::shared_ptr<McpToolCall> McpTool::Bind(const cJSON* arguments, std::string& error) {
+    PropertyList values = properties_;
+    try {
+        for (auto& argument : values) {
+            bool found = false;
+            if (cJSON_IsObject(arguments)) {
+                auto value = cJSON_GetObjectItem(arguments, argument.name().c_str());
+                if (argument.type() == kPropertyTypeBoolean && cJSON_IsBool(value)) {
+                    argument.set_value<bool>(value->valueint == 1);
+                    found = true;
+                } else if (argument.type() == kPropertyTypeInteger && cJSON_IsNumber(value)) {
+                    argument.set_value<int>(value->valueint);
+                    found = true;
+                } else if (argument.type() == kPropertyTypeString && cJSON_IsString(value)) {
+                    argument.set_value<std::string>(value->valuestring);
+                    found = true;
+                }
+            }
+
+            if (!argument.has_default_value() && !found) {
+                error = "Missing valid argument: " + argument.name();
+                return nullptr;
+            }
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        return nullptr;
+    }
+    return std::make_shared<PropertyListCall>(this, std::move(values));
+}
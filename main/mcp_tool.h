@@ -0,0 +1,477 @@
+#ifndef MCP_TOOL_H
+#define MCP_TOOL_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <variant>
+#include <optional>
+#include <stdexcept>
+#include <memory>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include <cJSON.h>
+
+#include "mcp_result_writer.h"
+
+// 添加类型别名
+using ReturnValue = std::variant<bool, int, std::string, cJSON*, ImageContent*>;
+
+enum PropertyType {
+    kPropertyTypeBoolean,
+    kPropertyTypeInteger,
+    kPropertyTypeString
+};
+
+class Property {
+private:
+    std::string name_;
+    PropertyType type_;
+    std::variant<bool, int, std::string> value_;
+    bool has_default_value_;
+    std::optional<int> min_value_;  // 新增：整数最小值
+    std::optional<int> max_value_;  // 新增：整数最大值
+
+public:
+    // Required field constructor
+    Property(const std::string& name, PropertyType type)
+        : name_(name), type_(type), has_default_value_(false) {}
+
+    // Optional field constructor with default value
+    template<typename T>
+    Property(const std::string& name, PropertyType type, const T& default_value)
+        : name_(name), type_(type), has_default_value_(true) {
+        value_ = default_value;
+    }
+
+    Property(const std::string& name, PropertyType type, int min_value, int max_value)
+        : name_(name), type_(type), has_default_value_(false), min_value_(min_value), max_value_(max_value) {
+        if (type != kPropertyTypeInteger) {
+            throw std::invalid_argument("Range limits only apply to integer properties");
+        }
+    }
+
+    Property(const std::string& name, PropertyType type, int default_value, int min_value, int max_value)
+        : name_(name), type_(type), has_default_value_(true), min_value_(min_value), max_value_(max_value) {
+        if (type != kPropertyTypeInteger) {
+            throw std::invalid_argument("Range limits only apply to integer properties");
+        }
+        if (default_value < min_value || default_value > max_value) {
+            throw std::invalid_argument("Default value must be within the specified range");
+        }
+        value_ = default_value;
+    }
+
+    inline const std::string& name() const { return name_; }
+    inline PropertyType type() const { return type_; }
+    inline bool has_default_value() const { return has_default_value_; }
+    inline bool has_range() const { return min_value_.has_value() && max_value_.has_value(); }
+    inline int min_value() const { return min_value_.value_or(0); }
+    inline int max_value() const { return max_value_.value_or(0); }
+
+    template<typename T>
+    inline T value() const {
+        return std::get<T>(value_);
+    }
+
+    template<typename T>
+    inline void set_value(const T& value) {
+        // 添加对设置的整数值进行范围检查
+        if constexpr (std::is_same_v<T, int>) {
+            if (min_value_.has_value() && value < min_value_.value()) {
+                throw std::invalid_argument("Value is below minimum allowed: " + std::to_string(min_value_.value()));
+            }
+            if (max_value_.has_value() && value > max_value_.value()) {
+                throw std::invalid_argument("Value exceeds maximum allowed: " + std::to_string(max_value_.value()));
+            }
+        }
+        value_ = value;
+    }
+
+    cJSON* to_cjson() const {
+        cJSON *json = cJSON_CreateObject();
+        
+        if (type_ == kPropertyTypeBoolean) {
+            cJSON_AddStringToObject(json, "type", "boolean");
+            if (has_default_value_) {
+                cJSON_AddBoolToObject(json, "default", value<bool>());
+            }
+        } else if (type_ == kPropertyTypeInteger) {
+            cJSON_AddStringToObject(json, "type", "integer");
+            if (has_default_value_) {
+                cJSON_AddNumberToObject(json, "default", value<int>());
+            }
+            if (min_value_.has_value()) {
+                cJSON_AddNumberToObject(json, "minimum", min_value_.value());
+            }
+            if (max_value_.has_value()) {
+                cJSON_AddNumberToObject(json, "maximum", max_value_.value());
+            }
+        } else if (type_ == kPropertyTypeString) {
+            cJSON_AddStringToObject(json, "type", "string");
+            if (has_default_value_) {
+                cJSON_AddStringToObject(json, "default", value<std::string>().c_str());
+            }
+        }
+        return json;
+    }
+
+    std::string to_json() const {
+        cJSON *json = to_cjson();
+        char *json_str = cJSON_PrintUnformatted(json);
+        std::string result(json_str);
+        cJSON_free(json_str);
+        cJSON_Delete(json);
+        
+        return result;
+    }
+};
+
+class PropertyList {
+private:
+    std::vector<Property> properties_;
+
+public:
+    PropertyList() = default;
+    PropertyList(const std::vector<Property>& properties) : properties_(properties) {}
+    void AddProperty(const Property& property) {
+        properties_.push_back(property);
+    }
+
+    const Property& operator[](const std::string& name) const {
+        for (const auto& property : properties_) {
+            if (property.name() == name) {
+                return property;
+            }
+        }
+        throw std::runtime_error("Property not found: " + name);
+    }
+
+    auto begin() { return properties_.begin(); }
+    auto end() { return properties_.end(); }
+
+    std::vector<std::string> GetRequired() const {
+        std::vector<std::string> required;
+        for (auto& property : properties_) {
+            if (!property.has_default_value()) {
+                required.push_back(property.name());
+            }
+        }
+        return required;
+    }
+
+    cJSON* to_cjson() const {
+        cJSON *json = cJSON_CreateObject();
+        for (const auto& property : properties_) {
+            cJSON_AddItemToObject(json, property.name().c_str(), property.to_cjson());
+        }
+        return json;
+    }
+
+    std::string to_json() const {
+        cJSON *json = to_cjson();
+        char *json_str = cJSON_PrintUnformatted(json);
+        std::string result(json_str);
+        cJSON_free(json_str);
+        cJSON_Delete(json);
+        
+        return result;
+    }
+};
+
+// 工具的执行方式
+enum ToolExecutionClass {
+    kToolExecutionMainLoop,   // 在主事件循环中执行（默认），可以安全访问应用状态
+    kToolExecutionInline,     // 收到请求时直接执行，只适合很快且线程安全的工具
+    kToolExecutionWorker,     // 在工作线程池中执行，不阻塞主事件循环
+    kToolExecutionExclusive,  // 在工作线程池中执行，占用同一硬件资源的调用互斥
+};
+
+// 工具调用统计（时间单位为微秒）
+struct ToolCallStats {
+    uint32_t calls = 0;
+    uint32_t errors = 0;
+    uint32_t cancelled = 0;
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+    int64_t total_wait_us = 0;  // 从收到请求到开始执行的排队时间
+    size_t max_reply_bytes = 0; // 回复占用的最大内存，包括待编码的图片
+};
+
+/**
+ * @brief 已绑定参数的一次工具调用
+ *
+ * 由 McpTool::Bind 在收到 tools/call 时创建，可以在主循环、工作线程或调用方任务中执行。
+ */
+class McpToolCall {
+public:
+    virtual ~McpToolCall() = default;
+
+    /**
+     * @brief 执行调用，结果通过 result 直接写入回复
+     */
+    virtual void Invoke(McpResultWriter& result) = 0;
+};
+
+class McpTool {
+private:
+    std::string name_;
+    std::string description_;
+    PropertyList properties_;
+    std::function<ReturnValue(const PropertyList&)> callback_;
+    bool user_only_ = false;
+    ToolExecutionClass execution_class_ = kToolExecutionMainLoop;
+    std::string resource_;
+    int max_concurrency_ = 1;
+
+public:
+    McpTool(const std::string& name, 
+            const std::string& description, 
+            const PropertyList& properties, 
+            std::function<ReturnValue(const PropertyList&)> callback)
+        : name_(name), 
+        description_(description), 
+        properties_(properties), 
+        callback_(callback) {}
+    virtual ~McpTool() = default;
+
+    /**
+     * @brief 从 tools/call 的 arguments 绑定一次调用
+     * @return 参数无效时返回 nullptr，错误信息写入 error
+     */
+    virtual std::shared_ptr<McpToolCall> Bind(const cJSON* arguments, std::string& error);
+
+    void set_user_only(bool user_only) { user_only_ = user_only; }
+    void set_execution(ToolExecutionClass execution_class, const std::string& resource, int max_concurrency) {
+        execution_class_ = execution_class;
+        resource_ = resource;
+        max_concurrency_ = max_concurrency > 0 ? max_concurrency : 1;
+    }
+    inline const std::string& name() const { return name_; }
+    inline const std::string& description() const { return description_; }
+    inline const PropertyList& properties() const { return properties_; }
+    inline bool user_only() const { return user_only_; }
+    inline ToolExecutionClass execution_class() const { return execution_class_; }
+    inline const std::string& resource() const { return resource_; }
+    inline int max_concurrency() const { return max_concurrency_; }
+
+    // 以下由 McpServer 在 jobs_mutex_ 保护下维护
+    int running = 0;
+    ToolCallStats stats;
+
+    std::string to_json() const {
+        std::vector<std::string> required = properties_.GetRequired();
+        
+        cJSON *json = cJSON_CreateObject();
+        cJSON_AddStringToObject(json, "name", name_.c_str());
+        cJSON_AddStringToObject(json, "description", description_.c_str());
+        
+        cJSON *input_schema = cJSON_CreateObject();
+        cJSON_AddStringToObject(input_schema, "type", "object");
+        
+        cJSON_AddItemToObject(input_schema, "properties", properties_.to_cjson());
+        
+        if (!required.empty()) {
+            cJSON *required_array = cJSON_CreateArray();
+            for (const auto& property : required) {
+                cJSON_AddItemToArray(required_array, cJSON_CreateString(property.c_str()));
+            }
+            cJSON_AddItemToObject(input_schema, "required", required_array);
+        }
+        
+        cJSON_AddItemToObject(json, "inputSchema", input_schema);
+
+        // Add audience annotation if the tool is user only (invisible to AI)
+        if (user_only_) {
+            cJSON *annotations = cJSON_CreateObject();
+            cJSON *audience = cJSON_CreateArray();
+            cJSON_AddItemToArray(audience, cJSON_CreateString("user"));
+            cJSON_AddItemToObject(annotations, "audience", audience);
+            cJSON_AddItemToObject(json, "annotations", annotations);
+        }
+        
+        char *json_str = cJSON_PrintUnformatted(json);
+        std::string result(json_str);
+        cJSON_free(json_str);
+        cJSON_Delete(json);
+        
+        return result;
+    }
+
+    void Call(const PropertyList& properties, McpResultWriter& result) {
+        ReturnValue return_value = callback_(properties);
+        if (std::holds_alternative<ImageContent*>(return_value)) {
+            result.Image(std::unique_ptr<ImageContent>(std::get<ImageContent*>(return_value)));
+        } else if (std::holds_alternative<std::string>(return_value)) {
+            result.Text(std::get<std::string>(return_value));
+        } else if (std::holds_alternative<bool>(return_value)) {
+            result.Bool(std::get<bool>(return_value));
+        } else if (std::holds_alternative<int>(return_value)) {
+            result.Int(std::get<int>(return_value));
+        } else if (std::holds_alternative<cJSON*>(return_value)) {
+            cJSON* json = std::get<cJSON*>(return_value);
+            char* json_str = cJSON_PrintUnformatted(json);
+            result.Text(json_str);
+            cJSON_free(json_str);
+            cJSON_Delete(json);
+        }
+    }
+};
+
+/**
+ * @brief 类型化工具的参数描述
+ *
+ * 把 JSON 参数直接绑定到参数结构体 Args 的成员上，构造函数与 Property 一一对应：
+ *   McpArg("name", &Args::member)                            必填
+ *   McpArg("name", &Args::member, default_value)             可选
+ *   McpArg("name", &Args::int_member, min, max)              必填，带范围
+ *   McpArg("name", &Args::int_member, default, min, max)     可选，带范围
+ * 可以声明为 constexpr 数组，注册时生成 JSON schema。
+ */
+template<typename Args>
+struct McpArg {
+    const char* name;
+    PropertyType type;
+    bool Args::* bool_member = nullptr;
+    int Args::* int_member = nullptr;
+    std::string Args::* string_member = nullptr;
+    bool has_default = false;
+    bool bool_default = false;
+    int int_default = 0;
+    const char* string_default = "";
+    bool has_range = false;
+    int min_value = 0;
+    int max_value = 0;
+
+    constexpr McpArg(const char* name, bool Args::* member)
+        : name(name), type(kPropertyTypeBoolean), bool_member(member) {}
+    constexpr McpArg(const char* name, bool Args::* member, bool default_value)
+        : name(name), type(kPropertyTypeBoolean), bool_member(member), has_default(true), bool_default(default_value) {}
+    constexpr McpArg(const char* name, int Args::* member)
+        : name(name), type(kPropertyTypeInteger), int_member(member) {}
+    constexpr McpArg(const char* name, int Args::* member, int default_value)
+        : name(name), type(kPropertyTypeInteger), int_member(member), has_default(true), int_default(default_value) {}
+    constexpr McpArg(const char* name, int Args::* member, int min_value, int max_value)
+        : name(name), type(kPropertyTypeInteger), int_member(member),
+          has_range(true), min_value(min_value), max_value(max_value) {}
+    constexpr McpArg(const char* name, int Args::* member, int default_value, int min_value, int max_value)
+        : name(name), type(kPropertyTypeInteger), int_member(member), has_default(true), int_default(default_value),
+          has_range(true), min_value(min_value), max_value(max_value) {}
+    constexpr McpArg(const char* name, std::string Args::* member)
+        : name(name), type(kPropertyTypeString), string_member(member) {}
+    constexpr McpArg(const char* name, std::string Args::* member, const char* default_value)
+        : name(name), type(kPropertyTypeString), string_member(member), has_default(true), string_default(default_value) {}
+};
+
+/**
+ * @brief 类型化工具
+ *
+ * 参数按 McpArg 描述一次遍历 arguments 绑定到 Args 结构体，不复制 PropertyList，
+ * 也不在校验失败时抛出异常；回调通过 McpResultWriter 直接写回复。
+ */
+template<typename Args>
+class TypedMcpTool : public McpTool {
+public:
+    using Callback = std::function<void(const Args&, McpResultWriter&)>;
+
+    TypedMcpTool(const std::string& name, const std::string& description,
+                 std::initializer_list<McpArg<Args>> args, Callback callback)
+        : McpTool(name, description, MakePropertyList(args), nullptr), args_(args), typed_callback_(std::move(callback)) {
+        if (args_.size() > 32) {
+            throw std::invalid_argument("Too many arguments for tool " + name);
+        }
+    }
+
+    std::shared_ptr<McpToolCall> Bind(const cJSON* arguments, std::string& error) override {
+        auto call = std::make_shared<Call>(this);
+        auto& values = call->args;
+        for (const auto& arg : args_) {
+            if (arg.bool_member) {
+                values.*arg.bool_member = arg.bool_default;
+            } else if (arg.int_member) {
+                values.*arg.int_member = arg.int_default;
+            } else {
+                values.*arg.string_member = arg.string_default;
+            }
+        }
+
+        // 一次遍历 arguments 的成员，类型不匹配的参数视为未提供，与 PropertyList 的行为一致
+        uint32_t found = 0;
+        if (cJSON_IsObject(arguments)) {
+            for (const cJSON* item = arguments->child; item != nullptr; item = item->next) {
+                for (size_t i = 0; i < args_.size(); i++) {
+                    const auto& arg = args_[i];
+                    if (strcmp(arg.name, item->string) != 0) {
+                        continue;
+                    }
+                    if (arg.bool_member && cJSON_IsBool(item)) {
+                        values.*arg.bool_member = cJSON_IsTrue(item);
+                        found |= 1u << i;
+                    } else if (arg.int_member && cJSON_IsNumber(item)) {
+                        if (arg.has_range && item->valueint < arg.min_value) {
+                            error = "Value is below minimum allowed: " + std::to_string(arg.min_value);
+                            return nullptr;
+                        }
+                        if (arg.has_range && item->valueint > arg.max_value) {
+                            error = "Value exceeds maximum allowed: " + std::to_string(arg.max_value);
+                            return nullptr;
+                        }
+                        values.*arg.int_member = item->valueint;
+                        found |= 1u << i;
+                    } else if (arg.string_member && cJSON_IsString(item)) {
+                        values.*arg.string_member = item->valuestring;
+                        found |= 1u << i;
+                    }
+                    break;
+                }
+            }
+        }
+
+        for (size_t i = 0; i < args_.size(); i++) {
+            if (!args_[i].has_default && (found & (1u << i)) == 0) {
+                error = std::string("Missing valid argument: ") + args_[i].name;
+                return nullptr;
+            }
+        }
+        return call;
+    }
+
+private:
+    struct Call : public McpToolCall {
+        TypedMcpTool* tool;
+        Args args = {};
+
+        explicit Call(TypedMcpTool* tool) : tool(tool) {}
+
+        void Invoke(McpResultWriter& result) override {
+            tool->typed_callback_(args, result);
+        }
+    };
+
+    static PropertyList MakePropertyList(std::initializer_list<McpArg<Args>> args) {
+        PropertyList properties;
+        for (const auto& arg : args) {
+            if (arg.type == kPropertyTypeBoolean) {
+                properties.AddProperty(arg.has_default ? Property(arg.name, arg.type, arg.bool_default)
+                                                       : Property(arg.name, arg.type));
+            } else if (arg.type == kPropertyTypeString) {
+                properties.AddProperty(arg.has_default ? Property(arg.name, arg.type, std::string(arg.string_default))
+                                                       : Property(arg.name, arg.type));
+            } else if (arg.has_range) {
+                properties.AddProperty(arg.has_default ? Property(arg.name, arg.type, arg.int_default, arg.min_value, arg.max_value)
+                                                       : Property(arg.name, arg.type, arg.min_value, arg.max_value));
+            } else {
+                properties.AddProperty(arg.has_default ? Property(arg.name, arg.type, arg.int_default)
+                                                       : Property(arg.name, arg.type));
+            }
+        }
+        return properties;
+    }
+
+    std::vector<McpArg<Args>> args_;
+    Callback typed_callback_;
+};
+
+#endif // MCP_TOOL_H
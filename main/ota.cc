@@ -1,4 +1,5 @@
 #include "ota.h"
+#include "ota_writer.h"
 #include "system_info.h"
 #include "settings.h"
 #include "assets/lang_config.h"
@@ -207,6 +208,7 @@ bool Ota::CheckVersion() {
     }
 
     has_new_version_ = false;
+    firmware_patch_url_.clear();
     cJSON *firmware = cJSON_GetObjectItem(root, "firmware");
     if (cJSON_IsObject(firmware)) {
         cJSON *version = cJSON_GetObjectItem(firmware, "version");
@@ -231,6 +233,18 @@ bool Ota::CheckVersion() {
             if (cJSON_IsNumber(force) && force->valueint == 1) {
                 has_new_version_ = true;
             }
+
+            // Optional delta patch: { "patch": { "from": "1.0.0", "url": "http://" } }
+            // Only usable when it was generated against the running version
+            cJSON *patch = cJSON_GetObjectItem(firmware, "patch");
+            if (cJSON_IsObject(patch)) {
+                cJSON *from = cJSON_GetObjectItem(patch, "from");
+                cJSON *patch_url = cJSON_GetObjectItem(patch, "url");
+                if (cJSON_IsString(from) && cJSON_IsString(patch_url) && current_version_ == from->valuestring) {
+                    firmware_patch_url_ = patch_url->valuestring;
+                    ESP_LOGI(TAG, "Delta patch available from %s", from->valuestring);
+                }
+            }
         }
     } else {
         ESP_LOGW(TAG, "No firmware section found!");
@@ -262,7 +276,6 @@ void Ota::MarkCurrentVersionValid() {
 
 bool Ota::Upgrade(const std::string& firmware_url) {
     ESP_LOGI(TAG, "Upgrading firmware from %s", firmware_url.c_str());
-    esp_ota_handle_t update_handle = 0;
     auto update_partition = esp_ota_get_next_update_partition(NULL);
     if (update_partition == NULL) {
         ESP_LOGE(TAG, "Failed to get update partition");
@@ -270,8 +283,6 @@ bool Ota::Upgrade(const std::string& firmware_url) {
     }
 
     ESP_LOGI(TAG, "Writing to partition %s at offset 0x%lx", update_partition->label, update_partition->address);
-    bool image_header_checked = false;
-    std::string image_header;
 
     auto network = Board::GetInstance().GetNetwork();
     auto http = network->CreateHttp(0);
@@ -291,72 +302,61 @@ bool Ota::Upgrade(const std::string& firmware_url) {
         return false;
     }
 
-    char buffer[512];
+    // 本任务只负责接收，解压和擦写由 OtaWriter 的写入任务并行完成
+    OtaWriter writer;
+    if (!writer.Start(update_partition)) {
+        return false;
+    }
+
     size_t total_read = 0, recent_read = 0;
     auto last_calc_time = esp_timer_get_time();
-    while (true) {
-        int ret = http->Read(buffer, sizeof(buffer));
-        if (ret < 0) {
-            ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
-            return false;
-        }
-
-        // Calculate speed and progress every second
-        recent_read += ret;
-        total_read += ret;
-        if (esp_timer_get_time() - last_calc_time >= 1000000 || ret == 0) {
-            size_t progress = total_read * 100 / content_length;
-            ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %uB/s", progress, total_read, content_length, recent_read);
-            if (upgrade_callback_) {
-                upgrade_callback_(progress, recent_read);
+    bool eof = false;
+    while (!eof) {
+        uint8_t* block = writer.AcquireBlock();
+        size_t filled = 0;
+        while (filled < OtaWriter::kBlockSize) {
+            auto read_start = esp_timer_get_time();
+            int ret = http->Read(reinterpret_cast<char*>(block) + filled, OtaWriter::kBlockSize - filled);
+            writer.AddNetworkTime(esp_timer_get_time() - read_start, ret > 0 ? ret : 0);
+            if (ret < 0) {
+                ESP_LOGE(TAG, "Failed to read HTTP data: %s", esp_err_to_name(ret));
+                writer.Abort();
+                return false;
             }
-            last_calc_time = esp_timer_get_time();
-            recent_read = 0;
-        }
 
-        if (ret == 0) {
-            break;
-        }
-
-        if (!image_header_checked) {
-            image_header.append(buffer, ret);
-            if (image_header.size() >= sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t) + sizeof(esp_app_desc_t)) {
-                esp_app_desc_t new_app_info;
-                memcpy(&new_app_info, image_header.data() + sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t), sizeof(esp_app_desc_t));
-                
-                auto current_version = esp_app_get_description()->version;
-                ESP_LOGI(TAG, "Current version: %s, New version: %s", current_version, new_app_info.version);
-
-                if (esp_ota_begin(update_partition, OTA_WITH_SEQUENTIAL_WRITES, &update_handle)) {
-                    esp_ota_abort(update_handle);
-                    ESP_LOGE(TAG, "Failed to begin OTA");
-                    return false;
+            // Calculate speed and progress every second
+            recent_read += ret;
+            total_read += ret;
+            if (esp_timer_get_time() - last_calc_time >= 1000000 || ret == 0) {
+                size_t progress = total_read * 100 / content_length;
+                ESP_LOGI(TAG, "Progress: %u%% (%u/%u), Speed: %uB/s", progress, total_read, content_length, recent_read);
+                if (upgrade_callback_) {
+                    upgrade_callback_(progress, recent_read);
                 }
+                last_calc_time = esp_timer_get_time();
+                recent_read = 0;
+            }
 
-                image_header_checked = true;
-                std::string().swap(image_header);
+            if (ret == 0) {
+                eof = true;
+                break;
             }
+            filled += ret;
         }
-        auto err = esp_ota_write(update_handle, buffer, ret);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(err));
-            esp_ota_abort(update_handle);
+
+        if (!writer.CommitBlock(block, filled)) {
+            writer.Abort();
             return false;
         }
     }
     http->Close();
 
-    esp_err_t err = esp_ota_end(update_handle);
-    if (err != ESP_OK) {
-        if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
-            ESP_LOGE(TAG, "Image validation failed, image is corrupted");
-        } else {
-            ESP_LOGE(TAG, "Failed to end OTA: %s", esp_err_to_name(err));
-        }
+    if (!writer.Finish()) {
         return false;
     }
+    upgrade_stats_ = writer.stats();
 
-    err = esp_ota_set_boot_partition(update_partition);
+    esp_err_t err = esp_ota_set_boot_partition(update_partition);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set boot partition: %s", esp_err_to_name(err));
         return false;
@@ -368,6 +368,13 @@ bool Ota::Upgrade(const std::string& firmware_url) {
 
 bool Ota::StartUpgrade(std::function<void(int progress, size_t speed)> callback) {
     upgrade_callback_ = callback;
+    if (!firmware_patch_url_.empty()) {
+        if (Upgrade(firmware_patch_url_)) {
+            return true;
+        }
+        // The patch does not apply to this image or failed to download, use the full image
+        ESP_LOGW(TAG, "Delta upgrade failed, falling back to the full image");
+    }
     return Upgrade(firmware_url_);
 }
 
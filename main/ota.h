@@ -6,6 +6,7 @@
 
 #include <esp_err.h>
 #include "board.h"
+#include "ota_stats.h"
 
 class Ota {
 public:
@@ -31,6 +32,11 @@ public:
     const std::string& GetActivationCode() const { return activation_code_; }
     std::string GetCheckVersionUrl();
 
+    /**
+     * @brief 上一次成功升级的各阶段耗时与吞吐
+     */
+    const OtaStats& GetUpgradeStats() const { return upgrade_stats_; }
+
 private:
     std::string activation_message_;
     std::string activation_code_;
@@ -44,9 +50,11 @@ private:
     std::string current_version_;
     std::string firmware_version_;
     std::string firmware_url_;
+    std::string firmware_patch_url_;
     std::string activation_challenge_;
     std::string serial_number_;
     int activation_timeout_ms_ = 30000;
+    OtaStats upgrade_stats_;
 
     bool Upgrade(const std::string& firmware_url);
     std::function<void(int progress, size_t speed)> upgrade_callback_;
@@ -0,0 +1,19 @@
+#ifndef _OTA_STATS_H
+#define _OTA_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 固件写入各阶段耗时与吞吐统计，单独成文件，ota.h 不必引入解压和哈希的依赖
+struct OtaStats {
+    size_t received_bytes = 0;    // 网络接收的字节数
+    size_t image_bytes = 0;       // 写入分区的镜像字节数
+    int64_t network_us = 0;       // 下载方读取 HTTP 的时间
+    int64_t reader_stall_us = 0;  // 下载方等待空闲块的时间（写入是瓶颈）
+    int64_t writer_idle_us = 0;   // 写入任务等待数据的时间（网络是瓶颈）
+    int64_t decode_us = 0;        // 解压时间
+    int64_t flash_us = 0;         // esp_ota_write 时间
+    int64_t total_us = 0;
+};
+
+#endif // _OTA_STATS_H
@@ -0,0 +1,349 @@
+#include "ota_writer.h"
+
+#include <esp_app_format.h>
+#include <esp_log.h>
+#include <esp_rom_crc.h>
+#include <esp_timer.h>
+#include <algorithm>
+#include <cstring>
+
+#define TAG "OtaWriter"
+
+// 解压后每次交给 esp_ota_write 的字节数
+#define OTA_DECODE_CHUNK    4096
+
+
+OtaWriter::OtaWriter() {
+}
+
+OtaWriter::~OtaWriter() {
+    Abort();
+}
+
+bool OtaWriter::Start(const esp_partition_t* partition) {
+    partition_ = partition;
+    start_time_ = esp_timer_get_time();
+
+    pool_.reset(new (std::nothrow) uint8_t[kBlockSize * kBlockCount]);
+    free_queue_ = xQueueCreate(kBlockCount, sizeof(uint8_t*));
+    write_queue_ = xQueueCreate(kBlockCount + 1, sizeof(Block));
+    writer_done_ = xSemaphoreCreateBinary();
+    if (!pool_ || free_queue_ == nullptr || write_queue_ == nullptr || writer_done_ == nullptr) {
+        ESP_LOGE(TAG, "Failed to allocate %u bytes for the OTA pipeline", kBlockSize * kBlockCount);
+        Abort();
+        return false;
+    }
+    for (size_t i = 0; i < kBlockCount; i++) {
+        uint8_t* block = pool_.get() + i * kBlockSize;
+        xQueueSend(free_queue_, &block, 0);
+    }
+
+    if (xTaskCreate([](void* arg) {
+            static_cast<OtaWriter*>(arg)->WriterTask();
+            vTaskDelete(NULL);
+        }, "ota_writer", 4096, this, 5, nullptr) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create writer task");
+        Abort();
+        return false;
+    }
+    task_started_ = true;
+    return true;
+}
+
+uint8_t* OtaWriter::AcquireBlock() {
+    uint8_t* block = nullptr;
+    auto start = esp_timer_get_time();
+    xQueueReceive(free_queue_, &block, portMAX_DELAY);
+    stats_.reader_stall_us += esp_timer_get_time() - start;
+    return block;
+}
+
+bool OtaWriter::CommitBlock(uint8_t* block, size_t length) {
+    Block item = {block, length};
+    xQueueSend(write_queue_, &item, portMAX_DELAY);
+    return !failed_.load();
+}
+
+// Start 中途失败时也会调用，只有写入任务已启动时才等待它退出
+void OtaWriter::StopTask() {
+    if (task_started_) {
+        Block stop = {nullptr, 0};
+        xQueueSend(write_queue_, &stop, portMAX_DELAY);
+        xSemaphoreTake(writer_done_, portMAX_DELAY);
+        task_started_ = false;
+    }
+    if (writer_done_ != nullptr) {
+        vSemaphoreDelete(writer_done_);
+        writer_done_ = nullptr;
+    }
+    if (write_queue_ != nullptr) {
+        vQueueDelete(write_queue_);
+        write_queue_ = nullptr;
+    }
+    if (free_queue_ != nullptr) {
+        vQueueDelete(free_queue_);
+        free_queue_ = nullptr;
+    }
+    pool_.reset();
+}
+
+void OtaWriter::WriterTask() {
+    Block block;
+    for (;;) {
+        auto wait_start = esp_timer_get_time();
+        xQueueReceive(write_queue_, &block, portMAX_DELAY);
+        stats_.writer_idle_us += esp_timer_get_time() - wait_start;
+        if (block.data == nullptr) {
+            break;
+        }
+        if (!failed_.load() && !ProcessBlock(block.data, block.length)) {
+            failed_.store(true);
+        }
+        xQueueSend(free_queue_, &block.data, portMAX_DELAY);
+    }
+    xSemaphoreGive(writer_done_);
+}
+
+bool OtaWriter::DetectFormat(const uint8_t*& data, size_t& length) {
+    if (length >= sizeof(ota_compressed_header) && memcmp(data, OTA_COMPRESSED_MAGIC, 4) == 0) {
+        memcpy(&header_, data, sizeof(header_));
+        if (header_.version != 1 || !decoder_.Init(header_.window_bits, header_.lookahead_bits, OTA_DECODE_CHUNK)) {
+            ESP_LOGE(TAG, "Unsupported compressed image (version %u, window %u, lookahead %u)",
+                     header_.version, header_.window_bits, header_.lookahead_bits);
+            return false;
+        }
+        ESP_LOGI(TAG, "Compressed image: %lu bytes, window %u, lookahead %u",
+                 header_.image_size, header_.window_bits, header_.lookahead_bits);
+        data += sizeof(header_);
+        length -= sizeof(header_);
+        format_ = Format::kHeatshrink;
+        return true;
+    }
+    if (length >= sizeof(ota_patch_header) && memcmp(data, OTA_PATCH_MAGIC, 4) == 0) {
+        memcpy(&patch_header_, data, sizeof(patch_header_));
+        if (!PreparePatch()) {
+            return false;
+        }
+        data += sizeof(patch_header_);
+        length -= sizeof(patch_header_);
+        format_ = Format::kPatch;
+        return true;
+    }
+    if (length > 0 && data[0] == ESP_IMAGE_HEADER_MAGIC) {
+        format_ = Format::kRaw;
+        return true;
+    }
+    ESP_LOGE(TAG, "Unknown firmware format");
+    return false;
+}
+
+bool OtaWriter::PreparePatch() {
+    if (patch_header_.version != 1 ||
+        !decoder_.Init(patch_header_.window_bits, patch_header_.lookahead_bits, OTA_DECODE_CHUNK)) {
+        ESP_LOGE(TAG, "Unsupported patch (version %u, window %u, lookahead %u)",
+                 patch_header_.version, patch_header_.window_bits, patch_header_.lookahead_bits);
+        return false;
+    }
+
+    // 基准镜像是当前运行的分区，整体映射后按偏移随机读取
+    const esp_partition_t* running = esp_ota_get_running_partition();
+    if (running == nullptr || patch_header_.base_size == 0 || patch_header_.base_size > running->size) {
+        ESP_LOGE(TAG, "Patch base size %lu does not fit the running partition", patch_header_.base_size);
+        return false;
+    }
+    const void* base = nullptr;
+    esp_err_t err = esp_partition_mmap(running, 0, patch_header_.base_size, ESP_PARTITION_MMAP_DATA, &base, &base_mmap_);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map the running partition: %s", esp_err_to_name(err));
+        base_mmap_ = 0;
+        return false;
+    }
+    base_ = static_cast<const uint8_t*>(base);
+
+    // 补丁只能应用到生成它时的那个镜像上
+    auto start = esp_timer_get_time();
+    uint8_t digest[32];
+    mbedtls_sha256(base_, patch_header_.base_size, digest, 0);
+    if (memcmp(digest, patch_header_.base_sha256, sizeof(digest)) != 0) {
+        ESP_LOGE(TAG, "Patch base does not match the running firmware");
+        ReleaseBase();
+        return false;
+    }
+
+    if (!patcher_.Init(base_, patch_header_.base_size, OTA_DECODE_CHUNK)) {
+        ReleaseBase();
+        return false;
+    }
+    mbedtls_sha256_init(&sha256_);
+    mbedtls_sha256_starts(&sha256_, 0);
+    sha256_started_ = true;
+    ESP_LOGI(TAG, "Patch: %lu -> %lu bytes, window %u, lookahead %u, base verified in %d ms",
+             patch_header_.base_size, patch_header_.target_size, patch_header_.window_bits,
+             patch_header_.lookahead_bits, int((esp_timer_get_time() - start) / 1000));
+    return true;
+}
+
+bool OtaWriter::ApplyPatch(const uint8_t* data, size_t length) {
+    if (patcher_.Feed(data, length, [this](const uint8_t* out, size_t out_length) {
+            return WriteImage(out, out_length);
+        })) {
+        return true;
+    }
+    if (patcher_.invalid_op()) {
+        ESP_LOGE(TAG, "Invalid patch op");
+    }
+    return false;
+}
+
+void OtaWriter::ReleaseBase() {
+    if (base_mmap_ != 0) {
+        esp_partition_munmap(base_mmap_);
+        base_mmap_ = 0;
+    }
+    base_ = nullptr;
+    patcher_.Release();
+    if (sha256_started_) {
+        mbedtls_sha256_free(&sha256_);
+        sha256_started_ = false;
+    }
+}
+
+bool OtaWriter::ProcessBlock(const uint8_t* data, size_t length) {
+    if (format_ == Format::kUnknown && !DetectFormat(data, length)) {
+        return false;
+    }
+
+    if (format_ == Format::kRaw) {
+        return WriteImage(data, length);
+    }
+
+    // 解压输出直接写入分区，解压时间不含写入时间
+    auto start = esp_timer_get_time();
+    int64_t flash_before = stats_.flash_us;
+    bool ok = decoder_.Feed(data, length, [this](const uint8_t* out, size_t out_length) {
+        return format_ == Format::kPatch ? ApplyPatch(out, out_length) : WriteImage(out, out_length);
+    });
+    stats_.decode_us += esp_timer_get_time() - start - (stats_.flash_us - flash_before);
+    return ok;
+}
+
+bool OtaWriter::WriteImage(const uint8_t* data, size_t length) {
+    if (length == 0) {
+        return true;
+    }
+
+    if (!ota_begun_) {
+        const size_t app_desc_offset = sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t);
+        if (data[0] != ESP_IMAGE_HEADER_MAGIC || length < app_desc_offset + sizeof(esp_app_desc_t)) {
+            ESP_LOGE(TAG, "Invalid firmware image header");
+            return false;
+        }
+        esp_app_desc_t new_app_info;
+        memcpy(&new_app_info, data + app_desc_offset, sizeof(esp_app_desc_t));
+        ESP_LOGI(TAG, "Current version: %s, New version: %s", esp_app_get_description()->version, new_app_info.version);
+
+        if (esp_ota_begin(partition_, OTA_WITH_SEQUENTIAL_WRITES, &update_handle_) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to begin OTA");
+            return false;
+        }
+        ota_begun_ = true;
+    }
+
+    auto start = esp_timer_get_time();
+    esp_err_t err = esp_ota_write(update_handle_, data, length);
+    stats_.flash_us += esp_timer_get_time() - start;
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to write OTA data: %s", esp_err_to_name(err));
+        return false;
+    }
+    if (format_ == Format::kHeatshrink) {
+        image_crc32_ = esp_rom_crc32_le(image_crc32_, data, length);
+    } else if (format_ == Format::kPatch) {
+        mbedtls_sha256_update(&sha256_, data, length);
+    }
+    stats_.image_bytes += length;
+    return true;
+}
+
+bool OtaWriter::Finish() {
+    StopTask();
+    bool ok = !failed_.load();
+
+    if (ok && format_ == Format::kHeatshrink) {
+        ok = decoder_.Finish([this](const uint8_t* out, size_t out_length) {
+            return WriteImage(out, out_length);
+        });
+        if (ok && (stats_.image_bytes != header_.image_size || image_crc32_ != header_.image_crc32)) {
+            ESP_LOGE(TAG, "Decompressed image mismatch: %u bytes, CRC32 0x%08lx (expected %lu bytes, 0x%08lx)",
+                     stats_.image_bytes, image_crc32_, header_.image_size, header_.image_crc32);
+            ok = false;
+        }
+    }
+    if (ok && format_ == Format::kPatch) {
+        ok = decoder_.Finish([this](const uint8_t* out, size_t out_length) {
+            return ApplyPatch(out, out_length);
+        });
+        if (ok && !patcher_.Finish([this](const uint8_t* out, size_t out_length) {
+                return WriteImage(out, out_length);
+            })) {
+            ESP_LOGE(TAG, "Patch ends in the middle of an op");
+            ok = false;
+        }
+        // 切换启动分区之前必须确认重建出的镜像与目标一致
+        uint8_t digest[32];
+        mbedtls_sha256_finish(&sha256_, digest);
+        if (ok && (stats_.image_bytes != patch_header_.target_size ||
+                   memcmp(digest, patch_header_.target_sha256, sizeof(digest)) != 0)) {
+            ESP_LOGE(TAG, "Patched image mismatch: %u bytes (expected %lu bytes)",
+                     stats_.image_bytes, patch_header_.target_size);
+            ok = false;
+        }
+        ReleaseBase();
+    }
+    if (ok && !ota_begun_) {
+        ESP_LOGE(TAG, "No firmware data received");
+        ok = false;
+    }
+    if (!ok) {
+        Abort();
+        return false;
+    }
+
+    stats_.total_us = esp_timer_get_time() - start_time_;
+    ota_begun_ = false;
+    esp_err_t err = esp_ota_end(update_handle_);
+    if (err != ESP_OK) {
+        if (err == ESP_ERR_OTA_VALIDATE_FAILED) {
+            ESP_LOGE(TAG, "Image validation failed, image is corrupted");
+        } else {
+            ESP_LOGE(TAG, "Failed to end OTA: %s", esp_err_to_name(err));
+        }
+        return false;
+    }
+    LogStats();
+    return true;
+}
+
+void OtaWriter::Abort() {
+    StopTask();
+    ReleaseBase();
+    if (ota_begun_) {
+        esp_ota_abort(update_handle_);
+        ota_begun_ = false;
+    }
+}
+
+void OtaWriter::LogStats() const {
+    auto rate = [](size_t bytes, int64_t us) -> unsigned {
+        return us > 0 ? static_cast<unsigned>(bytes * 1000000ULL / us / 1024) : 0;
+    };
+    ESP_LOGI(TAG, "OTA finished in %d ms: received %u bytes, image %u bytes (%u%%)",
+             int(stats_.total_us / 1000), stats_.received_bytes, stats_.image_bytes,
+             stats_.image_bytes > 0 ? unsigned(stats_.received_bytes * 100ULL / stats_.image_bytes) : 0);
+    ESP_LOGI(TAG, "Network %u KB/s (%d ms), decode %u KB/s (%d ms), flash %u KB/s (%d ms)",
+             rate(stats_.received_bytes, stats_.network_us), int(stats_.network_us / 1000),
+             rate(stats_.image_bytes, stats_.decode_us), int(stats_.decode_us / 1000),
+             rate(stats_.image_bytes, stats_.flash_us), int(stats_.flash_us / 1000));
+    ESP_LOGI(TAG, "Reader stalled %d ms on the writer, writer idle %d ms waiting for data",
+             int(stats_.reader_stall_us / 1000), int(stats_.writer_idle_us / 1000));
+}
@@ -0,0 +1,156 @@
+#ifndef _OTA_WRITER_H
+#define _OTA_WRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include <mbedtls/sha256.h>
+
+#include "ota_stats.h"
+#include "utils/delta_patcher.h"
+#include "utils/heatshrink_decoder.h"
+
+/*
+ * 压缩固件容器：16 字节头 + heatshrink 位流
+ *   magic "XZHS", u8 version, u8 window_bits, u8 lookahead_bits, u8 reserved,
+ *   u32 image_size, u32 image_crc32（解压后镜像的 CRC32）
+ * 由 scripts/ota_compress.py 生成；未压缩的固件以 0xE9 开头，可以自动区分。
+ */
+#define OTA_COMPRESSED_MAGIC    "XZHS"
+
+struct ota_compressed_header {
+    char magic[4];
+    uint8_t version;
+    uint8_t window_bits;
+    uint8_t lookahead_bits;
+    uint8_t reserved;
+    uint32_t image_size;
+    uint32_t image_crc32;
+};
+
+/*
+ * 差量补丁容器：80 字节头 + heatshrink 压缩的操作流
+ *   magic "XZDP", u8 version, u8 window_bits, u8 lookahead_bits, u8 reserved,
+ *   u32 base_size, u32 target_size, u8 base_sha256[32], u8 target_sha256[32]
+ * 操作流的格式见 xiaozhi::DeltaPatcher。base 是当前运行分区的镜像；由 scripts/ota_delta.py 生成。
+ */
+#define OTA_PATCH_MAGIC         "XZDP"
+
+struct ota_patch_header {
+    char magic[4];
+    uint8_t version;
+    uint8_t window_bits;
+    uint8_t lookahead_bits;
+    uint8_t reserved;
+    uint32_t base_size;
+    uint32_t target_size;
+    uint8_t base_sha256[32];
+    uint8_t target_sha256[32];
+};
+
+/**
+ * @brief 流水线固件写入器
+ *
+ * 下载方从块池取出空闲块、填满后提交；写入任务依次取出已提交的块，
+ * 按需解压或应用差量补丁后调用 esp_ota_write。网络接收与 Flash 擦写、解压并行进行，
+ * 块池用尽时下载方等待，因此内存占用固定。
+ */
+class OtaWriter {
+public:
+    using Stats = OtaStats;
+
+    static constexpr size_t kBlockSize = 8 * 1024;
+    static constexpr size_t kBlockCount = 4;
+
+    OtaWriter();
+    ~OtaWriter();
+
+    bool Start(const esp_partition_t* partition);
+
+    /**
+     * @brief 取出一个空闲块（可能阻塞），容量为 kBlockSize
+     */
+    uint8_t* AcquireBlock();
+
+    /**
+     * @brief 提交填好的块
+     * @return 写入任务已经出错时返回 false
+     */
+    bool CommitBlock(uint8_t* block, size_t length);
+
+    void AddNetworkTime(int64_t us, size_t bytes) {
+        stats_.network_us += us;
+        stats_.received_bytes += bytes;
+    }
+
+    /**
+     * @brief 等待写入完成，校验并结束 OTA；失败时自动中止
+     */
+    bool Finish();
+
+    /**
+     * @brief 中止 OTA 并释放资源
+     */
+    void Abort();
+
+    const Stats& stats() const { return stats_; }
+    void LogStats() const;
+
+private:
+    enum class Format : uint8_t {
+        kUnknown,
+        kRaw,
+        kHeatshrink,
+        kPatch,
+    };
+
+    struct Block {
+        uint8_t* data;
+        size_t length;
+    };
+
+    void StopTask();
+    void WriterTask();
+    bool ProcessBlock(const uint8_t* data, size_t length);
+    bool DetectFormat(const uint8_t*& data, size_t& length);
+    bool PreparePatch();
+    bool ApplyPatch(const uint8_t* data, size_t length);
+    void ReleaseBase();
+    bool WriteImage(const uint8_t* data, size_t length);
+
+    const esp_partition_t* partition_ = nullptr;
+    esp_ota_handle_t update_handle_ = 0;
+    bool ota_begun_ = false;
+
+    std::unique_ptr<uint8_t[]> pool_;
+    QueueHandle_t free_queue_ = nullptr;
+    QueueHandle_t write_queue_ = nullptr;
+    SemaphoreHandle_t writer_done_ = nullptr;
+    bool task_started_ = false;
+    std::atomic<bool> failed_{false};
+
+    Format format_ = Format::kUnknown;
+    ota_compressed_header header_ = {};
+    xiaozhi::HeatshrinkDecoder decoder_;
+    uint32_t image_crc32_ = 0;
+
+    // 差量补丁：映射的基准镜像与操作流解析状态
+    ota_patch_header patch_header_ = {};
+    esp_partition_mmap_handle_t base_mmap_ = 0;
+    const uint8_t* base_ = nullptr;
+    xiaozhi::DeltaPatcher patcher_;
+    mbedtls_sha256_context sha256_;
+    bool sha256_started_ = false;
+
+    Stats stats_;
+    int64_t start_time_ = 0;
+};
+
+#endif // _OTA_WRITER_H
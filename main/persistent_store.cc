@@ -0,0 +1,242 @@
+#include "persistent_store.h"
+#include "application.h"
+
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+#include <esp_system.h>
+
+#define TAG "PersistentStore"
+
+PersistentStore::PersistentStore() {
+    esp_timer_create_args_t timer_args = {
+        .callback = [](void* arg) {
+            static_cast<PersistentStore*>(arg)->OnFlushTimer();
+        },
+        .arg = this,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "store_flush",
+        .skip_unhandled_events = true,
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &flush_timer_));
+
+    // esp_restart() 前写回所有脏记录
+    esp_register_shutdown_handler([]() {
+        PersistentStore::GetInstance().Flush();
+    });
+}
+
+PersistentStore::~PersistentStore() {
+    if (flush_timer_ != nullptr) {
+        esp_timer_stop(flush_timer_);
+        esp_timer_delete(flush_timer_);
+    }
+    for (auto& [name, ns] : namespaces_) {
+        if (ns.handle != 0) {
+            nvs_close(ns.handle);
+        }
+    }
+}
+
+PersistentStore::Namespace* PersistentStore::OpenNamespace(const std::string& ns) {
+    auto it = namespaces_.find(ns);
+    if (it != namespaces_.end()) {
+        return &it->second;
+    }
+
+    nvs_handle_t handle = 0;
+    esp_err_t err = nvs_open(ns.c_str(), NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open namespace %s: %s", ns.c_str(), esp_err_to_name(err));
+        return nullptr;
+    }
+    auto& entry = namespaces_[ns];
+    entry.handle = handle;
+    return &entry;
+}
+
+bool PersistentStore::Load(const char* ns, const char* key, void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto space = OpenNamespace(ns);
+    if (space == nullptr) {
+        return false;
+    }
+
+    auto it = space->records.find(key);
+    if (it != space->records.end()) {
+        if (it->second.data.size() != size) {
+            return false;
+        }
+        memcpy(data, it->second.data.data(), size);
+        return true;
+    }
+
+    size_t length = 0;
+    if (nvs_get_blob(space->handle, key, nullptr, &length) != ESP_OK || length != size) {
+        return false;
+    }
+    Record record;
+    record.data.resize(length);
+    if (nvs_get_blob(space->handle, key, record.data.data(), &length) != ESP_OK) {
+        return false;
+    }
+    memcpy(data, record.data.data(), size);
+    space->records.emplace(key, std::move(record));
+    return true;
+}
+
+bool PersistentStore::Load(const char* ns, const char* key, std::vector<uint8_t>& data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto space = OpenNamespace(ns);
+    if (space == nullptr) {
+        return false;
+    }
+
+    auto it = space->records.find(key);
+    if (it != space->records.end()) {
+        data = it->second.data;
+        return true;
+    }
+
+    size_t length = 0;
+    if (nvs_get_blob(space->handle, key, nullptr, &length) != ESP_OK) {
+        return false;
+    }
+    Record record;
+    record.data.resize(length);
+    if (nvs_get_blob(space->handle, key, record.data.data(), &length) != ESP_OK) {
+        return false;
+    }
+    data = record.data;
+    space->records.emplace(key, std::move(record));
+    return true;
+}
+
+void PersistentStore::Store(const char* ns, const char* key, const void* data, size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto space = OpenNamespace(ns);
+    if (space == nullptr) {
+        return;
+    }
+
+    stats_.stores++;
+    auto& record = space->records[key];
+    auto bytes = static_cast<const uint8_t*>(data);
+    if (record.data.size() == size && memcmp(record.data.data(), bytes, size) == 0) {
+        stats_.unchanged++;
+        return;
+    }
+    record.data.assign(bytes, bytes + size);
+    record.dirty = true;
+    ScheduleFlush();
+}
+
+void PersistentStore::AddFlushHook(std::function<void()> hook) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_hooks_.push_back(std::move(hook));
+}
+
+void PersistentStore::RequestFlush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScheduleFlush();
+}
+
+void PersistentStore::ScheduleFlush() {
+    int64_t now = esp_timer_get_time();
+    if (!has_dirty_) {
+        has_dirty_ = true;
+        first_dirty_us_ = now;
+    }
+
+    // 防抖：每次写入都重新计时，但从第一次变脏起不超过最大推迟时间
+    int64_t deadline = first_dirty_us_ + kMaxFlushDeferUs;
+    int64_t delay = std::min(kFlushDelayUs, std::max<int64_t>(deadline - now, 0));
+    esp_timer_stop(flush_timer_);
+    esp_timer_start_once(flush_timer_, delay);
+}
+
+void PersistentStore::OnFlushTimer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!has_dirty_) {
+            return;
+        }
+
+        // 对话进行中推迟写 Flash，直到设备空闲或超过最大推迟时间
+        int64_t now = esp_timer_get_time();
+        auto state = Application::GetInstance().GetDeviceState();
+        bool busy = state == kDeviceStateListening || state == kDeviceStateSpeaking ||
+                    state == kDeviceStateConnecting;
+        if (busy && now - first_dirty_us_ < kMaxFlushDeferUs) {
+            esp_timer_start_once(flush_timer_, kFlushDelayUs);
+            return;
+        }
+    }
+    Flush();
+}
+
+void PersistentStore::Flush() {
+    std::vector<std::function<void()>> hooks;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hooks = flush_hooks_;
+    }
+    for (auto& hook : hooks) {
+        hook();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+}
+
+void PersistentStore::FlushLocked() {
+    if (!has_dirty_) {
+        return;
+    }
+    esp_timer_stop(flush_timer_);
+
+    int64_t start = esp_timer_get_time();
+    uint32_t records = 0;
+    size_t bytes = 0;
+    bool failed = false;
+    for (auto& [name, ns] : namespaces_) {
+        bool written = false;
+        for (auto& [key, record] : ns.records) {
+            if (!record.dirty) {
+                continue;
+            }
+            esp_err_t err = nvs_set_blob(ns.handle, key.c_str(), record.data.data(), record.data.size());
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to write %s/%s: %s", name.c_str(), key.c_str(), esp_err_to_name(err));
+                failed = true;
+                continue;
+            }
+            record.dirty = false;
+            written = true;
+            records++;
+            bytes += record.data.size();
+        }
+        if (written) {
+            esp_err_t err = nvs_commit(ns.handle);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Failed to commit namespace %s: %s", name.c_str(), esp_err_to_name(err));
+            }
+            stats_.commits++;
+        }
+    }
+
+    // 写入失败的记录保持脏标记，随下一次 Store() 重试
+    has_dirty_ = failed;
+    first_dirty_us_ = esp_timer_get_time();
+    stats_.flushes++;
+    stats_.blob_writes += records;
+    stats_.bytes_written += bytes;
+    ESP_LOGI(TAG, "Flushed %lu records (%u bytes) in %lld us, total: %lu flushes, %llu bytes, %lu/%lu stores coalesced",
+             records, bytes, esp_timer_get_time() - start, stats_.flushes, stats_.bytes_written,
+             stats_.stores - stats_.blob_writes, stats_.stores);
+}
+
+PersistentStore::Stats PersistentStore::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
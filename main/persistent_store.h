@@ -0,0 +1,111 @@
+#ifndef PERSISTENT_STORE_H
+#define PERSISTENT_STORE_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <esp_timer.h>
+#include <nvs_flash.h>
+
+/**
+ * @brief 写回式（write-behind）NVS 记录存储
+ *
+ * 每个逻辑记录（如宠物状态、用户画像）以一个 blob 保存在 NVS 中，
+ * 内存中缓存最新内容并标记脏记录，由防抖定时器批量写入：
+ * - 每个命名空间只打开一次 NVS 句柄
+ * - 连续写入合并为一次 nvs_set_blob + 每个命名空间一次 nvs_commit
+ * - 对话进行中推迟写 Flash，避免 NVS 页整理造成卡顿
+ * - 进入睡眠、重启和关机时立即 Flush
+ */
+class PersistentStore {
+public:
+    struct Stats {
+        uint32_t stores = 0;          // Store() 调用次数
+        uint32_t unchanged = 0;       // 内容未变化而跳过的 Store()
+        uint32_t flushes = 0;         // 实际写入 Flash 的 Flush 次数
+        uint32_t blob_writes = 0;     // nvs_set_blob 次数
+        uint32_t commits = 0;         // nvs_commit 次数
+        uint64_t bytes_written = 0;   // 写入的字节数
+    };
+
+    static PersistentStore& GetInstance() {
+        static PersistentStore instance;
+        return instance;
+    }
+
+    PersistentStore(const PersistentStore&) = delete;
+    PersistentStore& operator=(const PersistentStore&) = delete;
+
+    /**
+     * @brief 读取记录：优先返回缓存，未缓存时从 NVS 读取
+     * @return 记录存在且长度等于 size 时返回 true
+     */
+    bool Load(const char* ns, const char* key, void* data, size_t size);
+
+    /**
+     * @brief 读取变长记录
+     */
+    bool Load(const char* ns, const char* key, std::vector<uint8_t>& data);
+
+    /**
+     * @brief 写入记录到缓存，由防抖定时器稍后写入 Flash
+     */
+    void Store(const char* ns, const char* key, const void* data, size_t size);
+
+    /**
+     * @brief 注册 Flush 前回调，用于延迟到真正落盘时才编码的记录
+     *
+     * 回调在 Flush 开始时、未持有内部锁的情况下调用，可以在其中调用 Store()。
+     */
+    void AddFlushHook(std::function<void()> hook);
+
+    /**
+     * @brief 请求一次防抖 Flush（配合 AddFlushHook 使用）
+     */
+    void RequestFlush();
+
+    /**
+     * @brief 立即把所有脏记录写入 Flash
+     */
+    void Flush();
+
+    Stats GetStats();
+
+private:
+    // 最后一次写入后等待的时间
+    static constexpr int64_t kFlushDelayUs = 5 * 1000 * 1000;
+    // 设备忙碌时最多推迟的时间
+    static constexpr int64_t kMaxFlushDeferUs = 60 * 1000 * 1000;
+
+    struct Record {
+        std::vector<uint8_t> data;
+        bool dirty = false;
+    };
+
+    struct Namespace {
+        nvs_handle_t handle = 0;
+        std::map<std::string, Record> records;
+    };
+
+    PersistentStore();
+    ~PersistentStore();
+
+    Namespace* OpenNamespace(const std::string& ns);
+    void ScheduleFlush();
+    void OnFlushTimer();
+    void FlushLocked();
+
+    std::mutex mutex_;
+    std::map<std::string, Namespace> namespaces_;
+    std::vector<std::function<void()>> flush_hooks_;
+    esp_timer_handle_t flush_timer_ = nullptr;
+    int64_t first_dirty_us_ = 0;
+    bool has_dirty_ = false;
+    Stats stats_;
+};
+
+#endif // PERSISTENT_STORE_H
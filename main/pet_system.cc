@@ -1,5 +1,6 @@
 #include "pet_system.h"
 #include "settings.h"
+#include "core/companion_state.h"
 #include "board.h"
 #include "display/display.h"
 #include "core/event_bus.h"
@@ -15,6 +16,28 @@
 
 #define TAG "Pet"
 
+namespace {
+
+// 快照中宠物 section 的字段
+constexpr uint8_t kPetSchema = 1;
+enum PetField : uint8_t {
+    kFieldPetType = 1,
+    kFieldMood,
+    kFieldSatiety,
+    kFieldCleanliness,
+    kFieldActive,
+    kFieldLevel,
+    kFieldLastTs,
+    kFieldLastInteract,
+    kFieldDailyDone,
+    kFieldLoginStreak,
+    kFieldLastResetDay,
+};
+
+constexpr const char* kPetNamespace = "pet";
+
+} // namespace
+
 PetSystem::PetSystem() {
     InitializePetTypes();
 }
@@ -183,6 +206,7 @@ void PetSystem::InitializePetTypes() {
 }
 
 void PetSystem::Start() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (started_) {
         ESP_LOGW(TAG, "Pet system already started");
         return;
@@ -196,7 +220,7 @@ void PetSystem::Start() {
     // 检查每日重置
     CheckDailyReset();
     
-    // 创建定时器（1分钟tick）
+    // 创建单次定时器，只在下一次阈值穿越或每日重置时唤醒
     esp_timer_create_args_t timer_args = {
         .callback = TimerCallback,
         .arg = this,
@@ -211,16 +235,8 @@ void PetSystem::Start() {
         return;
     }
     
-    // 启动定时器（60秒周期）
-    err = esp_timer_start_periodic(timer_handle_, 60 * 1000000ULL);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to start pet timer: %d", err);
-        esp_timer_delete(timer_handle_);
-        timer_handle_ = nullptr;
-        return;
-    }
-    
     started_ = true;
+    ScheduleNextWakeup();
     
     auto pet_type = GetCurrentPetType();
     ESP_LOGI(TAG, "✅ Pet system started successfully");
@@ -245,6 +261,7 @@ void PetSystem::Start() {
 }
 
 void PetSystem::Stop() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!started_) {
         return;
     }
@@ -255,6 +272,7 @@ void PetSystem::Stop() {
         timer_handle_ = nullptr;
     }
     
+    UpdateDecay();
     SaveState();
     started_ = false;
     
@@ -263,13 +281,11 @@ void PetSystem::Stop() {
 
 void PetSystem::TimerCallback(void* arg) {
     PetSystem* pet = static_cast<PetSystem*>(arg);
-    pet->OnTick();
+    pet->OnTimer();
 }
 
-void PetSystem::OnTick() {
-    int64_t now = GetCurrentTimeMs();
-    
-    // 更新衰减
+void PetSystem::OnTimer() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     UpdateDecay();
     
     // 检查每日重置
@@ -278,41 +294,65 @@ void PetSystem::OnTick() {
     // 检查是否需要发出警告
     CheckAndNotifyWarnings();
     
-    // 每5分钟保存一次
-    static int tick_count = 0;
-    tick_count++;
-    if (tick_count >= 5) {
-        SaveState();
-        tick_count = 0;
-    }
-    
-    state_.lastUpdateMs = now;
+    // 保存并以当前值为新的衰减基准，同时安排下一次唤醒
+    SaveState();
     
-    // 输出状态（调试用，每10分钟一次）
-    static int log_count = 0;
-    log_count++;
-    if (log_count >= 10) {
-        int overall = GetOverallState();
-        ESP_LOGI(TAG, "📊 Status: Mood=%d, Satiety=%d, Clean=%d, Overall=%d", 
-                 state_.mood, state_.satiety, state_.cleanliness, overall);
-        log_count = 0;
-    }
+    ESP_LOGI(TAG, "📊 Status: Mood=%d, Satiety=%d, Clean=%d, Overall=%d", 
+             state_.mood, state_.satiety, state_.cleanliness, GetOverallState());
 }
 
-void PetSystem::UpdateDecay() {
+void PetSystem::ScheduleNextWakeup() {
+    if (timer_handle_ == nullptr) {
+        return;
+    }
+    
     int64_t now = GetCurrentTimeMs();
     
-    // 🛡️ 防止时钟回退导致的异常值
-    if (now < state_.lastInteractionMs) {
-        ESP_LOGW(TAG, "⚠️  Time went backwards! Resetting interaction time.");
-        state_.lastInteractionMs = now;
-    }
+    // 下一次每日重置（与 GetDaysSince1970 一致，按 UTC 日期）
+    int64_t next_ms = static_cast<int64_t>(GetDaysSince1970(now) + 1) * 86400000LL - now;
     
-    int64_t sinceLastInteraction = (now - state_.lastInteractionMs) / 1000 / 60; // 分钟
+    // 饱腹度、清洁度按恒定速率衰减，直接求到达警告阈值的时间
+    auto rates = GetDecayRates();
+    int threshold_offset = xiaozhi::AdaptiveBehavior::GetInstance().GetPetWarningThresholdOffset();
+    auto until_threshold = [](int value, int threshold, float rate_per_min) -> int64_t {
+        if (rate_per_min <= 0 || value <= threshold) {
+            return INT64_MAX;
+        }
+        return static_cast<int64_t>((value - threshold) / rate_per_min * 60000.0f);
+    };
+    next_ms = std::min(next_ms, until_threshold(state_.satiety,
+        WARNING_SATIETY_THRESHOLD + threshold_offset, rates.satiety));
+    next_ms = std::min(next_ms, until_threshold(state_.cleanliness,
+        WARNING_CLEAN_THRESHOLD + threshold_offset, rates.cleanliness));
+    
+    // 心情在无互动 NO_INTERACTION_MIN 分钟后加倍衰减，分两段计算
+    int mood_gap = state_.mood - (WARNING_MOOD_THRESHOLD + threshold_offset);
+    if (mood_gap > 0 && rates.mood > 0) {
+        int64_t idle_at = state_.lastInteractionMs + NO_INTERACTION_MIN * 60 * 1000LL;
+        float normal_min = std::max<int64_t>(0, idle_at - now) / 60000.0f;
+        float minutes;
+        if (mood_gap <= rates.mood * normal_min) {
+            minutes = mood_gap / rates.mood;
+        } else {
+            minutes = normal_min + (mood_gap - rates.mood * normal_min) / (2 * rates.mood);
+        }
+        next_ms = std::min(next_ms, static_cast<int64_t>(minutes * 60000.0f));
+    }
     
+    next_ms = std::max(next_ms, MIN_WAKEUP_MS);
+    esp_timer_stop(timer_handle_);
+    esp_err_t err = esp_timer_start_once(timer_handle_, next_ms * 1000);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start pet timer: %d", err);
+        return;
+    }
+    ESP_LOGD(TAG, "⏰ Next pet wakeup in %lld s", next_ms / 1000);
+}
+
+PetSystem::DecayRates PetSystem::GetDecayRates() const {
     // 🧠 获取自适应衰减速率（基于用户互动频率）
-    auto& adaptive = xiaozhi::AdaptiveBehavior::GetInstance();
-    float adaptive_rate = adaptive.GetPetDecayRate();
+    // 高频用户：衰减更快（更需要照顾）；低频用户：衰减更慢（减少打扰）
+    float adaptive_rate = xiaozhi::AdaptiveBehavior::GetInstance().GetPetDecayRate();
     
     // 获取当前宠物类型的衰减倍率
     auto pet_type = GetCurrentPetType();
@@ -320,37 +360,68 @@ void PetSystem::UpdateDecay() {
     float clean_rate = pet_type ? pet_type->clean_rate : 1.0f;
     float mood_rate = pet_type ? pet_type->mood_decay_rate : 1.0f;
     
-    // 🎯 应用双重倍率：宠物类型 × 自适应速率
-    // 高频用户：衰减更快（更需要照顾）
-    // 低频用户：衰减更慢（减少打扰）
-    float final_hunger_rate = hunger_rate * adaptive_rate;
-    float final_clean_rate = clean_rate * adaptive_rate;
-    float final_mood_rate = mood_rate * adaptive_rate;
+    return {
+        DECAY_SATIETY_PER_MIN * hunger_rate * adaptive_rate,
+        DECAY_CLEAN_PER_MIN * clean_rate * adaptive_rate,
+        DECAY_MOOD_PER_MIN * mood_rate * adaptive_rate,
+    };
+}
+
+void PetSystem::UpdateDecay() const {
+    int64_t now = GetCurrentTimeMs();
     
-    // 饱腹度衰减
-    state_.satiety = Clamp(state_.satiety - static_cast<int>(DECAY_SATIETY_PER_MIN * final_hunger_rate));
+    // 🛡️ 防止时钟回退导致的异常值
+    if (now < state_.lastInteractionMs) {
+        ESP_LOGW(TAG, "⚠️  Time went backwards! Resetting interaction time.");
+        state_.lastInteractionMs = now;
+    }
+    if (now <= decay_base_.timeMs) {
+        return;
+    }
     
-    // 清洁度衰减
-    state_.cleanliness = Clamp(state_.cleanliness - static_cast<int>(DECAY_CLEAN_PER_MIN * final_clean_rate));
+    auto rates = GetDecayRates();
+    float elapsed_min = (now - decay_base_.timeMs) / 60000.0f;
     
-    // 心情衰减（无互动时额外衰减）
-    if (sinceLastInteraction > NO_INTERACTION_MIN) {
-        state_.mood = Clamp(state_.mood - static_cast<int>(DECAY_MOOD_PER_MIN * 2 * final_mood_rate));
-    } else {
-        state_.mood = Clamp(state_.mood - static_cast<int>(DECAY_MOOD_PER_MIN * final_mood_rate));
-    }
+    // 心情：无互动超过 NO_INTERACTION_MIN 分钟后的部分按双倍速率衰减
+    int64_t idle_at = state_.lastInteractionMs + NO_INTERACTION_MIN * 60 * 1000LL;
+    int64_t fast_from = std::max(idle_at, decay_base_.timeMs);
+    float fast_min = now > fast_from ? (now - fast_from) / 60000.0f : 0.0f;
+    float normal_min = elapsed_min - fast_min;
     
-    ClampState();
+    auto clamp_float = [](float value) { return std::min(100.0f, std::max(0.0f, value)); };
+    decayed_.timeMs = now;
+    decayed_.satiety = clamp_float(decay_base_.satiety - rates.satiety * elapsed_min);
+    decayed_.cleanliness = clamp_float(decay_base_.cleanliness - rates.cleanliness * elapsed_min);
+    decayed_.mood = clamp_float(decay_base_.mood - rates.mood * (normal_min + 2 * fast_min));
     
-    // 📊 自适应衰减日志（每次都显示，让用户看到学习效果）
-    ESP_LOGI(TAG, "🔄 Decay: adaptive_rate=%.2fx (7d互动=%u次), mood=%d→%d, satiety=%d, clean=%d",
-             adaptive_rate,
-             xiaozhi::UserProfile::GetInstance().GetInteractionCount7d(),
-             state_.mood + static_cast<int>(DECAY_MOOD_PER_MIN * final_mood_rate * (sinceLastInteraction > NO_INTERACTION_MIN ? 2 : 1)),
-             state_.mood, state_.satiety, state_.cleanliness);
+    state_.satiety = static_cast<int>(lroundf(decayed_.satiety));
+    state_.cleanliness = static_cast<int>(lroundf(decayed_.cleanliness));
+    state_.mood = static_cast<int>(lroundf(decayed_.mood));
+    state_.lastUpdateMs = now;
+}
+
+void PetSystem::RebaseDecay() {
+    // state_ 只保存取整后的值，新基准沿用推算值的小数部分：
+    // 频繁重设基准（每次互动、聊天）时不足 0.5 的衰减不会被取整吞掉
+    auto carry = [](float decayed, int value) {
+        float base = value + (decayed - lroundf(decayed));
+        return std::min(100.0f, std::max(0.0f, base));
+    };
+    decay_base_.timeMs = GetCurrentTimeMs();
+    decay_base_.mood = carry(decayed_.mood, state_.mood);
+    decay_base_.satiety = carry(decayed_.satiety, state_.satiety);
+    decay_base_.cleanliness = carry(decayed_.cleanliness, state_.cleanliness);
+    decayed_ = decay_base_;
+    state_.lastUpdateMs = decay_base_.timeMs;
+    
+    // 状态变化后阈值穿越时间也随之变化
+    if (started_) {
+        ScheduleNextWakeup();
+    }
 }
 
 void PetSystem::CheckDailyReset() {
+    UpdateDecay();
     int64_t now = GetCurrentTimeMs();
     int currentDay = GetDaysSince1970(now);
     int lastDay = GetDaysSince1970(state_.lastResetDayMs);
@@ -389,11 +460,14 @@ void PetSystem::ClampState() {
 }
 
 bool PetSystem::Feed(int amount) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!CheckCooldown(lastFeedMs_, FEED_COOLDOWN_SEC)) {
         ESP_LOGW(TAG, "Feed on cooldown");
         return false;
     }
     
+    UpdateDecay();
+    
     amount = Clamp(amount, 1, 10);
     
     if (state_.satiety >= 90) {
@@ -432,11 +506,14 @@ bool PetSystem::Feed(int amount) {
 }
 
 bool PetSystem::Clean() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!CheckCooldown(lastCleanMs_, CLEAN_COOLDOWN_SEC)) {
         ESP_LOGW(TAG, "Clean on cooldown");
         return false;
     }
     
+    UpdateDecay();
+    
     if (state_.cleanliness >= 90) {
         ESP_LOGI(TAG, "🛁 Pet is already clean!");
         return false;
@@ -463,11 +540,14 @@ bool PetSystem::Clean() {
 }
 
 bool PetSystem::Play(const std::string& kind) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!CheckCooldown(lastPlayMs_, PLAY_COOLDOWN_SEC)) {
         ESP_LOGW(TAG, "Play on cooldown");
         return false;
     }
     
+    UpdateDecay();
+    
     state_.mood = Clamp(state_.mood + 8);
     state_.active = Clamp(state_.active + 3);
     state_.satiety = Clamp(state_.satiety - 3);  // 玩耍消耗体力
@@ -494,13 +574,16 @@ bool PetSystem::Play(const std::string& kind) {
 }
 
 bool PetSystem::Hug() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (!CheckCooldown(lastHugMs_, HUG_COOLDOWN_SEC)) {
         return false;
     }
     
+    UpdateDecay();
     state_.mood = Clamp(state_.mood + 5);
     state_.lastInteractionMs = GetCurrentTimeMs();
     lastHugMs_ = state_.lastInteractionMs;
+    RebaseDecay();
     
     // 💝 记录情绪：拥抱行为（增加信任度）
     auto& emotional_memory = xiaozhi::EmotionalMemory::GetInstance();
@@ -511,6 +594,8 @@ bool PetSystem::Hug() {
 }
 
 void PetSystem::RecordChat() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    UpdateDecay();
     chatCountToday_++;
     state_.lastInteractionMs = GetCurrentTimeMs();
     
@@ -521,14 +606,22 @@ void PetSystem::RecordChat() {
         state_.active = Clamp(state_.active + 5);
         ESP_LOGI(TAG, "✅ Daily task: Chat completed! +5 mood, +5 active");
         SaveState();
+    } else {
+        // 互动时间变化会影响心情衰减速率
+        RebaseDecay();
     }
 }
 
 int PetSystem::GetOverallState() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    UpdateDecay();
     return static_cast<int>(0.5f * state_.mood + 0.3f * state_.satiety + 0.2f * state_.cleanliness);
 }
 
 std::string PetSystem::GetRecommendedEmotion() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    UpdateDecay();
+    
     // 优先判断特殊状态
     if (state_.satiety < 20) {
         return "sad";  // 饿了
@@ -553,6 +646,8 @@ std::string PetSystem::GetRecommendedEmotion() const {
 }
 
 std::string PetSystem::GetStatusDescription() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    UpdateDecay();
     cJSON* root = cJSON_CreateObject();
     
     // 宠物类型信息
@@ -595,6 +690,8 @@ std::string PetSystem::GetStatusDescription() const {
 }
 
 std::string PetSystem::GetSuggestions() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    UpdateDecay();
     std::string suggestions;
     
     if (state_.satiety < 30) {
@@ -634,6 +731,8 @@ std::string PetSystem::GetSuggestions() const {
 }
 
 void PetSystem::ResetDaily() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    UpdateDecay();
     state_.dailyDoneMask = 0;
     chatCountToday_ = 0;
     state_.lastResetDayMs = GetCurrentTimeMs();
@@ -642,6 +741,7 @@ void PetSystem::ResetDaily() {
 }
 
 void PetSystem::DebugSet(int mood, int satiety, int cleanliness) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     state_.mood = Clamp(mood);
     state_.satiety = Clamp(satiety);
     state_.cleanliness = Clamp(cleanliness);
@@ -651,19 +751,28 @@ void PetSystem::DebugSet(int mood, int satiety, int cleanliness) {
 }
 
 void PetSystem::LoadState() {
-    Settings settings("pet", true);
-    
-    state_.petType = settings.GetString("pet_type", "cat");
-    state_.mood = settings.GetInt("mood", 70);
-    state_.satiety = settings.GetInt("satiety", 70);
-    state_.cleanliness = settings.GetInt("cleanliness", 70);
-    state_.active = settings.GetInt("active", 50);
-    state_.level = settings.GetInt("level", 1);
-    state_.lastUpdateMs = settings.GetInt64("last_ts", GetCurrentTimeMs());
-    state_.lastInteractionMs = settings.GetInt64("last_interact", GetCurrentTimeMs());
-    state_.dailyDoneMask = settings.GetInt("daily_done", 0);
-    state_.loginStreak = settings.GetInt("login_streak", 0);
-    state_.lastResetDayMs = settings.GetInt64("last_reset_day", GetCurrentTimeMs());
+    xiaozhi::snapshot::Section section;
+    if (xiaozhi::CompanionState::GetInstance().ReadSection(xiaozhi::CompanionState::kSectionPet, section)) {
+        xiaozhi::snapshot::SectionReader reader(section.schema, section.data.data(), section.data.size());
+        int32_t value;
+        uint32_t mask;
+        reader.GetString(kFieldPetType, state_.petType);
+        if (reader.GetI32(kFieldMood, value)) state_.mood = value;
+        if (reader.GetI32(kFieldSatiety, value)) state_.satiety = value;
+        if (reader.GetI32(kFieldCleanliness, value)) state_.cleanliness = value;
+        if (reader.GetI32(kFieldActive, value)) state_.active = value;
+        if (reader.GetI32(kFieldLevel, value)) state_.level = value;
+        if (reader.GetU32(kFieldDailyDone, mask)) state_.dailyDoneMask = mask;
+        if (reader.GetI32(kFieldLoginStreak, value)) state_.loginStreak = value;
+        state_.lastUpdateMs = GetCurrentTimeMs();
+        state_.lastInteractionMs = state_.lastUpdateMs;
+        state_.lastResetDayMs = state_.lastUpdateMs;
+        reader.GetI64(kFieldLastTs, state_.lastUpdateMs);
+        reader.GetI64(kFieldLastInteract, state_.lastInteractionMs);
+        reader.GetI64(kFieldLastResetDay, state_.lastResetDayMs);
+    } else {
+        LoadLegacyState();
+    }
     
     // 验证宠物类型是否存在，不存在则使用默认猫咪
     if (pet_types_.find(state_.petType) == pet_types_.end()) {
@@ -673,26 +782,50 @@ void PetSystem::LoadState() {
     
     ClampState();
     
+    // 关机期间不衰减：以加载的值和当前时间作为衰减基准
+    RebaseDecay();
+    
     auto pet_type = GetCurrentPetType();
     ESP_LOGI(TAG, "📥 Loaded pet state from NVS: %s %s", 
              pet_type ? pet_type->emoji.c_str() : "",
              pet_type ? pet_type->name.c_str() : "");
 }
 
+void PetSystem::LoadLegacyState() {
+    // 旧版本固件按字段逐个保存
+    Settings settings(kPetNamespace, false);
+    
+    state_.petType = settings.GetString("pet_type", "cat");
+    state_.mood = settings.GetInt("mood", 70);
+    state_.satiety = settings.GetInt("satiety", 70);
+    state_.cleanliness = settings.GetInt("cleanliness", 70);
+    state_.active = settings.GetInt("active", 50);
+    state_.level = settings.GetInt("level", 1);
+    state_.lastUpdateMs = settings.GetInt64("last_ts", GetCurrentTimeMs());
+    state_.lastInteractionMs = settings.GetInt64("last_interact", GetCurrentTimeMs());
+    state_.dailyDoneMask = settings.GetInt("daily_done", 0);
+    state_.loginStreak = settings.GetInt("login_streak", 0);
+    state_.lastResetDayMs = settings.GetInt64("last_reset_day", GetCurrentTimeMs());
+}
+
 void PetSystem::SaveState() {
-    Settings settings("pet", true);
-    
-    settings.SetString("pet_type", state_.petType);
-    settings.SetInt("mood", state_.mood);
-    settings.SetInt("satiety", state_.satiety);
-    settings.SetInt("cleanliness", state_.cleanliness);
-    settings.SetInt("active", state_.active);
-    settings.SetInt("level", state_.level);
-    settings.SetInt64("last_ts", GetCurrentTimeMs());
-    settings.SetInt64("last_interact", state_.lastInteractionMs);
-    settings.SetInt("daily_done", state_.dailyDoneMask);
-    settings.SetInt("login_streak", state_.loginStreak);
-    settings.SetInt64("last_reset_day", state_.lastResetDayMs);
+    // 当前值即新的衰减基准，快照中保存的也是基准
+    RebaseDecay();
+    
+    // 编码成快照 section，由 CompanionState 合并后批量写入 Flash
+    xiaozhi::snapshot::SectionWriter writer;
+    writer.PutString(kFieldPetType, state_.petType);
+    writer.PutI32(kFieldMood, state_.mood);
+    writer.PutI32(kFieldSatiety, state_.satiety);
+    writer.PutI32(kFieldCleanliness, state_.cleanliness);
+    writer.PutI32(kFieldActive, state_.active);
+    writer.PutI32(kFieldLevel, state_.level);
+    writer.PutI64(kFieldLastTs, GetCurrentTimeMs());
+    writer.PutI64(kFieldLastInteract, state_.lastInteractionMs);
+    writer.PutU32(kFieldDailyDone, state_.dailyDoneMask);
+    writer.PutI32(kFieldLoginStreak, state_.loginStreak);
+    writer.PutI64(kFieldLastResetDay, state_.lastResetDayMs);
+    xiaozhi::CompanionState::GetInstance().WriteSection(xiaozhi::CompanionState::kSectionPet, kPetSchema, writer);
     
     // 🧠 发布宠物状态变化事件（供学习系统使用）
     xiaozhi::PetStateEventData event_data = {
@@ -701,12 +834,7 @@ void PetSystem::SaveState() {
         .cleanliness = state_.cleanliness,
         .overall = GetOverallState()
     };
-    xiaozhi::EventBus::GetInstance().PublishNonBlocking(
-        xiaozhi::PET_EVENT,
-        xiaozhi::PET_STATE_CHANGED,
-        &event_data,
-        sizeof(event_data)
-    );
+    xiaozhi::EventBus::GetInstance().PublishFast<xiaozhi::EventType::kPetStateChanged>(event_data);
     
     // ESP_LOGI(TAG, "💾 Saved pet state to NVS");
 }
@@ -745,6 +873,7 @@ int PetSystem::GetDaysSince1970(int64_t timestampMs) const {
 }
 
 bool PetSystem::SelectPetType(const std::string& type_name) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     // 🛡️ 输入验证：检查字符串格式
     if (type_name.empty() || type_name.length() > 32) {
         ESP_LOGE(TAG, "❌ Invalid pet type name length: %zu", type_name.length());
@@ -770,6 +899,8 @@ bool PetSystem::SelectPetType(const std::string& type_name) {
         return false;
     }
     
+    // 先按旧类型的衰减速率结算，再切换
+    UpdateDecay();
     std::string old_type = state_.petType;
     state_.petType = type_name;
     SaveState();
@@ -791,6 +922,7 @@ bool PetSystem::SelectPetType(const std::string& type_name) {
 }
 
 const PetSystem::PetType* PetSystem::GetCurrentPetType() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto it = pet_types_.find(state_.petType);
     if (it != pet_types_.end()) {
         return &it->second;
@@ -799,6 +931,7 @@ const PetSystem::PetType* PetSystem::GetCurrentPetType() const {
 }
 
 std::string PetSystem::ListPetTypes() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     cJSON* root = cJSON_CreateObject();
     
     // 按分类组织
@@ -844,6 +977,7 @@ std::string PetSystem::ListPetTypes() const {
 }
 
 std::string PetSystem::GetPetTypeInfo(const std::string& type_name) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto it = pet_types_.find(type_name);
     if (it == pet_types_.end()) {
         return "{\"error\":\"Pet type not found\"}";
@@ -873,11 +1007,13 @@ std::string PetSystem::GetPetTypeInfo(const std::string& type_name) const {
 }
 
 void PetSystem::SetWarningCallback(std::function<void(const std::string&)> callback) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     warning_callback_ = std::move(callback);
     ESP_LOGI(TAG, "Pet warning callback registered");
 }
 
 void PetSystem::TriggerWarning(const std::string& warning) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     if (warning_callback_) {
         ESP_LOGI(TAG, "🎯 Manually triggering pet warning: %s", warning.c_str());
         warning_callback_(warning);
@@ -887,6 +1023,7 @@ void PetSystem::TriggerWarning(const std::string& warning) {
 }
 
 void PetSystem::EnableAutoAnnouncement(bool enable, int interval_min) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto_announcement_enabled_ = enable;
     auto_announcement_interval_min_ = interval_min;
     
@@ -900,11 +1037,14 @@ void PetSystem::EnableAutoAnnouncement(bool enable, int interval_min) {
 }
 
 std::string PetSystem::CheckWarning() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
     auto pet_type = GetCurrentPetType();
     if (!pet_type) {
         return "";
     }
     
+    UpdateDecay();
+    
     // 🧠 时段感知：判断是否应该抑制警告
     auto& adaptive = xiaozhi::AdaptiveBehavior::GetInstance();
     if (adaptive.ShouldSuppressPetWarning()) {
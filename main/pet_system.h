@@ -5,6 +5,7 @@
 #include <string>
 #include <map>
 #include <functional>
+#include <mutex>
 #include <esp_timer.h>
 
 /**
@@ -12,11 +13,11 @@
  * 
  * 特性：
  * - 三维状态：心情(mood)、饱腹(satiety)、清洁(cleanliness)
- * - 自动衰减：久未互动会降低状态
+ * - 自动衰减：久未互动会降低状态（按经过时间解析计算，查询时才更新）
  * - 每日任务：喂食、洗澡、玩耍、聊天
  * - 表情联动：自动根据状态切换表情
  * - NVS 持久化：断电不丢失
- * - CPU 友好：1分钟 tick，简单计算
+ * - CPU 友好：无周期 tick，只在下一次越过警告阈值或每日重置时唤醒
  */
 
 class PetSystem {
@@ -78,9 +79,13 @@ public:
     void Stop();
 
     /**
-     * @brief 获取当前状态
+     * @brief 获取当前状态的副本（衰减按当前时间计算）
      */
-    const State& GetState() const { return state_; }
+    State GetState() const {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        UpdateDecay();
+        return state_;
+    }
 
     /**
      * @brief 选择宠物类型
@@ -201,19 +206,30 @@ private:
     PetSystem();
     ~PetSystem();
 
-    // 定时器回调（1分钟tick）
+    // 单次定时器回调（阈值穿越或每日重置时触发）
     static void TimerCallback(void* arg);
-    void OnTick();
+    void OnTimer();
+    void ScheduleNextWakeup();
     
     // 状态检查和警告
     void CheckAndNotifyWarnings();
 
     // 加载和保存状态
     void LoadState();
+    void LoadLegacyState();
     void SaveState();
 
+    // 每分钟衰减点数（宠物类型倍率 × 自适应倍率）
+    struct DecayRates {
+        float satiety;
+        float cleanliness;
+        float mood;
+    };
+    DecayRates GetDecayRates() const;
+
     // 状态更新
-    void UpdateDecay();      // 衰减计算
+    void UpdateDecay() const;  // 由衰减基准 + 经过时间计算当前状态
+    void RebaseDecay();        // 状态被修改后以当前值作为新的衰减基准
     void CheckDailyReset();  // 检查每日重置
     void ClampState();       // 限制状态范围
 
@@ -232,7 +248,20 @@ private:
     // 🛡️ 安全的消息构建（防止字符串拼接异常）
     std::string BuildWarningMessage(const PetType* pet_type, const std::string& base_message);
 
-    State state_;
+    // 惰性衰减：state_ 中的三维状态由 decay_base_ 在查询时推算
+    struct DecayBase {
+        int64_t timeMs = 0;
+        float mood = 70;
+        float satiety = 70;
+        float cleanliness = 70;
+    };
+
+    // 定时器任务、MCP 工具和主循环都会读写状态，查询也会推算衰减，统一加锁
+    mutable std::recursive_mutex mutex_;
+    mutable State state_;
+    DecayBase decay_base_;
+    // 最近一次推算出的未取整值，重设基准时保留小数部分
+    mutable DecayBase decayed_;
     esp_timer_handle_t timer_handle_ = nullptr;
     bool started_ = false;
 
@@ -268,6 +297,7 @@ private:
     static constexpr int DECAY_MOOD_PER_MIN = 1;       // 每分钟心情衰减（无互动时）
     
     static constexpr int NO_INTERACTION_MIN = 10;      // 10分钟无互动判定
+    static constexpr int64_t MIN_WAKEUP_MS = 60 * 1000;  // 两次唤醒的最小间隔
     
     // 警告阈值
     static constexpr int WARNING_SATIETY_THRESHOLD = 30;     // 饱腹度低于30%警告
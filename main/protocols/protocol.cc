@@ -1,6 +1,7 @@
 #include "protocol.h"
 
 #include <esp_log.h>
+#include <mbedtls/base64.h>
 
 #define TAG "Protocol"
 
@@ -80,7 +81,31 @@ void Protocol::SendStopListeningWithText(const std::string& text) {
 }
 
 void Protocol::SendMcpMessage(const std::string& payload) {
-    std::string message = "{\"session_id\":\"" + session_id_ + "\",\"type\":\"mcp\",\"payload\":" + payload + "}";
+    std::string message = GetMcpMessagePrefix() + payload + "}";
+    SendText(message);
+}
+
+std::string Protocol::GetMcpMessagePrefix() const {
+    return "{\"session_id\":\"" + session_id_ + "\",\"type\":\"mcp\",\"payload\":";
+}
+
+void Protocol::SendMcpMessage(const std::string& head, const std::string& data, const std::string& tail) {
+    // 预先分配最终大小，base64 直接编码进消息，只保留一份编码后的数据
+    std::string prefix = GetMcpMessagePrefix();
+    size_t encoded = (data.size() + 2) / 3 * 4;
+    std::string message;
+    message.reserve(prefix.size() + head.size() + encoded + 1 + tail.size() + 1);
+    message += prefix;
+    message += head;
+    size_t pos = message.size();
+    size_t olen = 0;
+    message.resize(pos + encoded + 1);
+    mbedtls_base64_encode((unsigned char*)&message[pos], encoded + 1, &olen,
+                          (const unsigned char*)data.data(), data.size());
+    message.resize(pos + olen);
+    message += tail;
+    message += "}";
+    ESP_LOGI(TAG, "MCP message with %d bytes data sent in one message of %d bytes", int(data.size()), int(message.size()));
     SendText(message);
 }
 
@@ -74,6 +74,11 @@ public:
     virtual void SendStopListeningWithText(const std::string& text);
     virtual void SendAbortSpeaking(AbortReason reason);
     virtual void SendMcpMessage(const std::string& message);
+    /**
+     * @brief 发送 payload 为 head + base64(data) + tail 的 MCP 消息
+     * 用于图片等大块数据，base64 编码在发送时进行，不生成完整的 payload
+     */
+    virtual void SendMcpMessage(const std::string& head, const std::string& data, const std::string& tail);
 
 protected:
     std::function<void(const cJSON* root)> on_incoming_json_;
@@ -91,6 +96,7 @@ protected:
     std::chrono::time_point<std::chrono::steady_clock> last_incoming_time_;
 
     virtual bool SendText(const std::string& text) = 0;
+    std::string GetMcpMessagePrefix() const;
     virtual void SetError(const std::string& message);
     virtual bool IsTimeout() const;
 };
@@ -7,11 +7,17 @@
 #include <cstring>
 #include <cJSON.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <arpa/inet.h>
+#include <mbedtls/base64.h>
+#include <algorithm>
 #include "assets/lang_config.h"
 
 #define TAG "WS"
 
+// 分片发送 MCP 数据时每个分片编码的原始字节数，3 的倍数保证分片之间没有填充
+#define MCP_FRAGMENT_DATA_SIZE (3 * 1024)
+
 WebsocketProtocol::WebsocketProtocol() {
     event_group_handle_ = xEventGroupCreate();
 }
@@ -26,6 +32,7 @@ bool WebsocketProtocol::Start() {
 }
 
 bool WebsocketProtocol::SendAudio(std::unique_ptr<AudioStreamPacket> packet) {
+    std::lock_guard<std::mutex> lock(send_mutex_);
     if (websocket_ == nullptr || !websocket_->IsConnected()) {
         return false;
     }
@@ -62,7 +69,12 @@ bool WebsocketProtocol::SendText(const std::string& text) {
         return false;
     }
 
-    if (!websocket_->Send(text)) {
+    bool sent;
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        sent = websocket_->Send(text);
+    }
+    if (!sent) {
         ESP_LOGE(TAG, "Failed to send text: %s", text.c_str());
         SetError(Lang::Strings::SERVER_ERROR);
         return false;
@@ -71,6 +83,48 @@ bool WebsocketProtocol::SendText(const std::string& text) {
     return true;
 }
 
+void WebsocketProtocol::SendMcpMessage(const std::string& head, const std::string& data, const std::string& tail) {
+    if (websocket_ == nullptr || !websocket_->IsConnected()) {
+        return;
+    }
+
+    // 以分片的文本帧发送：消息头、逐块编码的 base64、消息尾，内存占用只有一个分片
+    int64_t start_time = esp_timer_get_time();
+    std::string frame = GetMcpMessagePrefix() + head;
+    size_t peak = std::max(frame.size(), (size_t)MCP_FRAGMENT_DATA_SIZE / 3 * 4 + 1);
+    int fragments = 0;
+    bool sent;
+    {
+        std::lock_guard<std::mutex> lock(send_mutex_);
+        sent = websocket_->Send(frame.data(), frame.size(), false, false);
+        fragments++;
+
+        frame.resize(MCP_FRAGMENT_DATA_SIZE / 3 * 4 + 1);
+        for (size_t offset = 0; sent && offset < data.size(); offset += MCP_FRAGMENT_DATA_SIZE) {
+            size_t length = std::min(data.size() - offset, (size_t)MCP_FRAGMENT_DATA_SIZE);
+            size_t olen = 0;
+            mbedtls_base64_encode((unsigned char*)frame.data(), frame.size(), &olen,
+                                  (const unsigned char*)data.data() + offset, length);
+            sent = websocket_->Send(frame.data(), olen, false, false);
+            fragments++;
+        }
+
+        if (sent) {
+            frame = tail + "}";
+            sent = websocket_->Send(frame.data(), frame.size(), false, true);
+            fragments++;
+        }
+    }
+
+    if (!sent) {
+        ESP_LOGE(TAG, "Failed to send MCP message with %d bytes data", int(data.size()));
+        SetError(Lang::Strings::SERVER_ERROR);
+        return;
+    }
+    ESP_LOGI(TAG, "MCP message with %d bytes data sent in %d fragments, peak buffer %d bytes, %d ms",
+             int(data.size()), fragments, int(peak), int((esp_timer_get_time() - start_time) / 1000));
+}
+
 bool WebsocketProtocol::IsAudioChannelOpened() const {
     return websocket_ != nullptr && websocket_->IsConnected() && !error_occurred_ && !IsTimeout();
 }
@@ -8,6 +8,8 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/event_groups.h>
 
+#include <mutex>
+
 #define WEBSOCKET_PROTOCOL_SERVER_HELLO_EVENT (1 << 0)
 
 class WebsocketProtocol : public Protocol {
@@ -20,11 +22,15 @@ public:
     bool OpenAudioChannel() override;
     void CloseAudioChannel() override;
     bool IsAudioChannelOpened() const override;
+    using Protocol::SendMcpMessage;
+    void SendMcpMessage(const std::string& head, const std::string& data, const std::string& tail) override;
 
 private:
     EventGroupHandle_t event_group_handle_;
     std::unique_ptr<WebSocket> websocket_;
     int version_ = 1;
+    // 分片发送的文本消息中间不能插入其他数据帧，所有发送都持有此锁
+    std::mutex send_mutex_;
 
     void ParseServerHello(const cJSON* root);
     bool SendText(const std::string& text) override;
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace xiaozhi {
+
+/**
+ * @brief 差量补丁操作流的流式应用器
+ *
+ * 操作流由 9 字节的操作头 {u8 type, u32 length, u32 src_offset}（小端）和数据组成：
+ * - ADD：输出 base[src_offset + i] + data[i]（按字节取模），length 字节数据
+ * - INSERT：直接输出 length 字节数据，src_offset 忽略
+ * 输入可以任意切分，重建出的镜像攒满输出缓冲区后交给 sink。
+ * 本文件不依赖 ESP-IDF，可以在主机上测试。
+ */
+class DeltaPatcher {
+public:
+    static constexpr uint8_t kOpAdd = 1;
+    static constexpr uint8_t kOpInsert = 2;
+
+    /**
+     * @param base 基准镜像，应用期间必须保持有效
+     * @param output_size 每次交给 sink 的最大字节数
+     */
+    bool Init(const uint8_t* base, size_t base_size, size_t output_size) {
+        if (output_size == 0) {
+            return false;
+        }
+        base_ = base;
+        base_size_ = base_size;
+        output_.reset(new (std::nothrow) uint8_t[output_size]);
+        output_size_ = output_size;
+        output_length_ = 0;
+        header_length_ = 0;
+        remaining_ = 0;
+        invalid_op_ = false;
+        return output_ != nullptr;
+    }
+
+    void Release() {
+        output_.reset();
+        base_ = nullptr;
+    }
+
+    /**
+     * @brief 应用一段操作流
+     * @return 操作非法（类型未知或 ADD 超出基准镜像）或 sink 返回 false 时返回 false
+     */
+    template <typename Sink>
+    bool Feed(const uint8_t* data, size_t length, Sink&& sink) {
+        size_t i = 0;
+        while (i < length) {
+            if (remaining_ == 0) {
+                header_[header_length_++] = data[i++];
+                if (header_length_ < sizeof(header_)) {
+                    continue;
+                }
+                header_length_ = 0;
+                type_ = header_[0];
+                remaining_ = ReadUint32(header_ + 1);
+                source_ = ReadUint32(header_ + 5);
+                if ((type_ != kOpAdd && type_ != kOpInsert) ||
+                    (type_ == kOpAdd && (source_ > base_size_ || remaining_ > base_size_ - source_))) {
+                    invalid_op_ = true;
+                    return false;
+                }
+                continue;
+            }
+
+            size_t count = std::min<size_t>({length - i, remaining_, output_size_ - output_length_});
+            uint8_t* out = output_.get() + output_length_;
+            if (type_ == kOpAdd) {
+                const uint8_t* source = base_ + source_;
+                for (size_t k = 0; k < count; k++) {
+                    out[k] = static_cast<uint8_t>(source[k] + data[i + k]);
+                }
+                source_ += count;
+            } else {
+                memcpy(out, data + i, count);
+            }
+            i += count;
+            remaining_ -= count;
+            output_length_ += count;
+            if (output_length_ == output_size_) {
+                output_length_ = 0;
+                if (!sink(output_.get(), output_size_)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 输出缓冲区中剩余的数据
+     * @return 操作流在操作中间结束时返回 false
+     */
+    template <typename Sink>
+    bool Finish(Sink&& sink) {
+        if (remaining_ != 0 || header_length_ != 0) {
+            return false;
+        }
+        if (output_length_ == 0) {
+            return true;
+        }
+        size_t length = output_length_;
+        output_length_ = 0;
+        return sink(output_.get(), length);
+    }
+
+    bool invalid_op() const { return invalid_op_; }
+
+private:
+    static uint32_t ReadUint32(const uint8_t* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    const uint8_t* base_ = nullptr;
+    size_t base_size_ = 0;
+    std::unique_ptr<uint8_t[]> output_;
+    size_t output_size_ = 0;
+    size_t output_length_ = 0;
+    uint8_t header_[9] = {};
+    size_t header_length_ = 0;
+    uint8_t type_ = 0;
+    uint32_t remaining_ = 0;
+    uint32_t source_ = 0;
+    bool invalid_op_ = false;
+};
+
+}  // namespace xiaozhi
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace xiaozhi {
+
+/**
+ * @brief heatshrink 流式解压器
+ *
+ * 与 heatshrink 的位流格式兼容（高位在前）：
+ * - 标志位 1：后跟 8 位字面量
+ * - 标志位 0：后跟 window_bits 位的回溯距离 - 1 和 lookahead_bits 位的长度 - 1
+ * 只需要 2^window_bits 字节的窗口和一块输出缓冲区，输入可以任意切分。
+ * 本文件不依赖 ESP-IDF，可以在主机上测试。
+ */
+class HeatshrinkDecoder {
+public:
+    static constexpr uint8_t kMinWindowBits = 4;
+    static constexpr uint8_t kMaxWindowBits = 15;
+
+    /**
+     * @brief 分配窗口和输出缓冲区
+     * @param output_size 每次交给 sink 的最大字节数
+     */
+    bool Init(uint8_t window_bits, uint8_t lookahead_bits, size_t output_size) {
+        if (window_bits < kMinWindowBits || window_bits > kMaxWindowBits ||
+            lookahead_bits < 3 || lookahead_bits >= window_bits || output_size == 0) {
+            return false;
+        }
+        window_bits_ = window_bits;
+        lookahead_bits_ = lookahead_bits;
+        window_.reset(new (std::nothrow) uint8_t[1u << window_bits]());
+        output_.reset(new (std::nothrow) uint8_t[output_size]);
+        output_size_ = output_size;
+        output_length_ = 0;
+        head_ = 0;
+        bits_ = 0;
+        bit_count_ = 0;
+        state_ = kTag;
+        return window_ != nullptr && output_ != nullptr;
+    }
+
+    /**
+     * @brief 解压一段输入，输出缓冲区满时调用 sink(data, length)
+     * @return sink 返回 false 时停止并返回 false
+     */
+    template <typename Sink>
+    bool Feed(const uint8_t* data, size_t length, Sink&& sink) {
+        const uint16_t mask = (1u << window_bits_) - 1;
+        for (size_t i = 0; i < length; i++) {
+            bits_ = (bits_ << 8) | data[i];
+            bit_count_ += 8;
+
+            for (;;) {
+                if (state_ == kTag) {
+                    if (bit_count_ < 1) {
+                        break;
+                    }
+                    state_ = TakeBits(1) ? kLiteral : kIndex;
+                } else if (state_ == kLiteral) {
+                    if (bit_count_ < 8) {
+                        break;
+                    }
+                    if (!Emit(static_cast<uint8_t>(TakeBits(8)), mask, sink)) {
+                        return false;
+                    }
+                    state_ = kTag;
+                } else if (state_ == kIndex) {
+                    if (bit_count_ < window_bits_) {
+                        break;
+                    }
+                    distance_ = TakeBits(window_bits_) + 1;
+                    state_ = kCount;
+                } else {
+                    if (bit_count_ < lookahead_bits_) {
+                        break;
+                    }
+                    uint16_t count = TakeBits(lookahead_bits_) + 1;
+                    for (uint16_t n = 0; n < count; n++) {
+                        if (!Emit(window_[(head_ - distance_) & mask], mask, sink)) {
+                            return false;
+                        }
+                    }
+                    state_ = kTag;
+                }
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief 输出缓冲区中剩余的数据；流末尾不足一个记录的填充位被忽略
+     */
+    template <typename Sink>
+    bool Finish(Sink&& sink) {
+        if (output_length_ == 0) {
+            return true;
+        }
+        size_t length = output_length_;
+        output_length_ = 0;
+        return sink(output_.get(), length);
+    }
+
+private:
+    enum State : uint8_t {
+        kTag,
+        kLiteral,
+        kIndex,
+        kCount,
+    };
+
+    uint16_t TakeBits(uint8_t count) {
+        bit_count_ -= count;
+        return static_cast<uint16_t>((bits_ >> bit_count_) & ((1u << count) - 1));
+    }
+
+    template <typename Sink>
+    bool Emit(uint8_t byte, uint16_t mask, Sink& sink) {
+        window_[head_ & mask] = byte;
+        head_++;
+        output_[output_length_++] = byte;
+        if (output_length_ == output_size_) {
+            output_length_ = 0;
+            return sink(output_.get(), output_size_);
+        }
+        return true;
+    }
+
+    uint8_t window_bits_ = 0;
+    uint8_t lookahead_bits_ = 0;
+    std::unique_ptr<uint8_t[]> window_;
+    std::unique_ptr<uint8_t[]> output_;
+    size_t output_size_ = 0;
+    size_t output_length_ = 0;
+    uint16_t head_ = 0;
+    uint16_t distance_ = 0;
+    uint32_t bits_ = 0;
+    uint8_t bit_count_ = 0;
+    State state_ = kTag;
+};
+
+}  // namespace xiaozhi
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""
+Indexed (v2) assets container shared by build_default_assets.py and
+spiffs_assets/spiffs_assets_gen.py. The layout must match main/assets_format.h.
+"""
+
+import struct
+import zlib
+
+# header (32B) + table sorted by name bytes (48B per entry) + aligned data area
+ASSETS_V2_MAGIC = b'AST2'
+ASSETS_V2_VERSION = 2
+ASSETS_V2_HEADER_SIZE = 32
+ASSETS_V2_ENTRY_SIZE = 48
+ASSETS_V2_NAME_LEN = 32
+ASSETS_V2_ALIGNMENT = 16
+
+
+def align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+
+def pack_assets_v2(file_entries, alignment=ASSETS_V2_ALIGNMENT):
+    """
+    Pack (file_name, data, width, height) entries into a v2 image.
+    Returns (image_bytes, table_crc32, sorted_file_names).
+    """
+    encoded = []
+    for file_name, data, width, height in file_entries:
+        name = file_name.encode('utf-8')
+        # Names must stay NUL terminated so the device can compare them in place
+        if len(name) >= ASSETS_V2_NAME_LEN:
+            raise ValueError(f'"{file_name}" must be shorter than {ASSETS_V2_NAME_LEN} bytes')
+        encoded.append((name, data, width, height))
+    encoded.sort(key=lambda entry: entry[0])
+    for i in range(1, len(encoded)):
+        if encoded[i][0] == encoded[i - 1][0]:
+            raise ValueError(f'Duplicated asset name "{encoded[i][0].decode()}"')
+
+    table_offset = ASSETS_V2_HEADER_SIZE
+    data_offset = align_up(table_offset + ASSETS_V2_ENTRY_SIZE * len(encoded), alignment)
+
+    table = bytearray()
+    data_area = bytearray()
+    for name, data, width, height in encoded:
+        data_area.extend(b'\0' * (align_up(len(data_area), alignment) - len(data_area)))
+        table.extend(struct.pack('<32sIIIHH', name, len(data), len(data_area),
+                                 zlib.crc32(data) & 0xFFFFFFFF, width, height))
+        data_area.extend(data)
+
+    table_crc = zlib.crc32(table) & 0xFFFFFFFF
+    header = struct.pack('<4sHHIIIIIHH', ASSETS_V2_MAGIC, ASSETS_V2_VERSION, ASSETS_V2_HEADER_SIZE,
+                         len(encoded), table_offset, data_offset, len(data_area), table_crc, alignment, 0)
+    padding = b'\0' * (data_offset - table_offset - len(table))
+    image = header + table + padding + data_area
+    return image, table_crc, [name.decode('utf-8') for name, _, _, _ in encoded]
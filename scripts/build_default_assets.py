@@ -19,6 +19,8 @@ import json
 import struct
 from datetime import datetime
 
+from assets_format import pack_assets_v2
+
 
 # =============================================================================
 # Pack model functions (from pack_model.py)
@@ -353,11 +355,36 @@ def sort_key(filename):
     return extension, basename
 
 
-def pack_assets_simple(target_path, include_path, out_file, assets_path, max_name_len=32):
+def pack_assets_v1(file_info_list, merged_data, max_name_len):
+    """
+    Legacy layout: files, checksum, length header + unsorted table + "ZZ" prefixed data.
+    Returns (image_bytes, checksum).
+    """
+    mmap_table = bytearray()
+    for file_name, offset, file_size, width, height in file_info_list:
+        if len(file_name) > max_name_len:
+            print(f'Warning: "{file_name}" exceeds {max_name_len} bytes and will be truncated.')
+        fixed_name = file_name.ljust(max_name_len, '\0')[:max_name_len]
+        mmap_table.extend(fixed_name.encode('utf-8'))
+        mmap_table.extend(file_size.to_bytes(4, byteorder='little'))
+        mmap_table.extend(offset.to_bytes(4, byteorder='little'))
+        mmap_table.extend(width.to_bytes(2, byteorder='little'))
+        mmap_table.extend(height.to_bytes(2, byteorder='little'))
+
+    combined_data = mmap_table + merged_data
+    combined_checksum = compute_checksum(combined_data)
+    combined_data_length = len(combined_data).to_bytes(4, byteorder='little')
+    header_data = len(file_info_list).to_bytes(4, byteorder='little') + combined_checksum.to_bytes(4, byteorder='little')
+    return header_data + combined_data_length + combined_data, combined_checksum
+
+
+def pack_assets_simple(target_path, include_path, out_file, assets_path, max_name_len=32, format_version=2):
     """
-    Simplified version of pack_assets that handles basic file packing
+    Simplified version of pack_assets that handles basic file packing.
+    format_version 2 writes the indexed layout, 1 keeps the legacy layout.
     """
     merged_data = bytearray()
+    file_entries = []
     file_info_list = []
     skip_files = ['config.json']
 
@@ -385,25 +412,15 @@ def pack_assets_simple(target_path, include_path, out_file, assets_path, max_nam
             bin_data = bin_file.read()
 
         merged_data.extend(bin_data)
+        file_entries.append((file_name, bin_data, 0, 0))
 
     total_files = len(file_info_list)
 
-    mmap_table = bytearray()
-    for file_name, offset, file_size, width, height in file_info_list:
-        if len(file_name) > max_name_len:
-            print(f'Warning: "{file_name}" exceeds {max_name_len} bytes and will be truncated.')
-        fixed_name = file_name.ljust(max_name_len, '\0')[:max_name_len]
-        mmap_table.extend(fixed_name.encode('utf-8'))
-        mmap_table.extend(file_size.to_bytes(4, byteorder='little'))
-        mmap_table.extend(offset.to_bytes(4, byteorder='little'))
-        mmap_table.extend(width.to_bytes(2, byteorder='little'))
-        mmap_table.extend(height.to_bytes(2, byteorder='little'))
-
-    combined_data = mmap_table + merged_data
-    combined_checksum = compute_checksum(combined_data)
-    combined_data_length = len(combined_data).to_bytes(4, byteorder='little')
-    header_data = total_files.to_bytes(4, byteorder='little') + combined_checksum.to_bytes(4, byteorder='little')
-    final_data = header_data + combined_data_length + combined_data
+    if format_version >= 2:
+        final_data, combined_checksum, file_names = pack_assets_v2(file_entries)
+    else:
+        final_data, combined_checksum = pack_assets_v1(file_info_list, merged_data, max_name_len)
+        file_names = [file_name for file_name, _, _, _, _ in file_info_list]
 
     with open(out_file, 'wb') as output_bin:
         output_bin.write(final_data)
@@ -428,7 +445,7 @@ def pack_assets_simple(target_path, include_path, out_file, assets_path, max_nam
         output_header.write(f'#define MMAP_{asset_name.upper()}_CHECKSUM        0x{combined_checksum:04X}\n\n')
         output_header.write(f'enum MMAP_{asset_name.upper()}_LISTS {{\n')
 
-        for i, (file_name, _, _, _, _) in enumerate(file_info_list):
+        for i, file_name in enumerate(file_names):
             enum_name = file_name.replace('.', '_')
             output_header.write(f'    MMAP_{asset_name.upper()}_{enum_name.upper()} = {i},        /*!< {file_name} */\n')
 
@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+"""
+Compile and simulate servo choreography sequences for Otto and Dog
+
+The binary format is described in main/boards/common/choreography.h: an 8-byte
+header followed by segments, each an 8-byte segment header plus per-servo
+parameters for the servos in its mask:
+
+    magic "XZCH", u8 version, u8 servo_count, u16 segment_count
+    u8 type, u8 ease, u16 mask, u16 duration_ms, u16 period_ms
+    MOVE (0):      i16 target
+    OSCILLATE (1): i16 amplitude, i16 offset, u16 phase (65536 = one turn)
+    HOLD (2):      nothing
+    BEZIER (3):    i16 control1, i16 control2, i16 target
+
+Source files are JSON. Per-servo lists use null for servos a segment leaves
+alone, phases are in degrees:
+
+    {"servos": 4, "segments": [
+        {"move": [120, null, 60, null], "duration": 300, "ease": "in_out"},
+        {"oscillate": {"amplitude": [30, 30, 30, 30], "offset": [0, 0, 0, 0],
+                       "phase": [0, 180, 180, 0]}, "period": 600, "duration": 1200},
+        {"bezier": {"control1": [140, null, 60, null], "control2": [100, null, 90, null],
+                    "target": [90, null, 90, null]}, "duration": 500},
+        {"hold": 200}
+    ]}
+
+A bezier segment moves each servo from where it is through the two control
+points to the target along a cubic Bezier curve; the ease shapes how the curve
+parameter advances with time.
+
+The simulator reproduces the firmware's fixed-point tick (ServoMotionEngine)
+and writes one CSV row per 20 ms tick, so a sequence can be reviewed or
+diffed against a previous render before it is uploaded.
+
+Usage:
+    ./choreography.py compile dance.json -o dance.chor
+    ./choreography.py simulate dance.chor -o dance.csv --repeat 2
+    ./choreography.py base64 dance.chor    # data for self.<robot>.choreography.upload
+
+Ship a sequence in the assets partition by putting <name>.chor in the
+default_assets_extra_files directory; play it with
+self.<robot>.choreography.play {"name": "<name>"}.
+"""
+
+import argparse
+import base64
+import json
+import math
+import struct
+import sys
+
+MAGIC = b'XZCH'
+VERSION = 1
+MAX_SERVOS = 12
+
+TYPE_MOVE = 0
+TYPE_OSCILLATE = 1
+TYPE_HOLD = 2
+TYPE_BEZIER = 3
+
+EASES = ['linear', 'in_out', 'in', 'out', 'in_back', 'out_back', 'out_bounce']
+
+TICK_MS = 20
+
+# Q15 tables, identical to servo_motion_engine.cc
+SIN_TABLE = [round(32767 * math.sin(2 * math.pi * i / 256)) for i in range(257)]
+EASE_TABLES = [
+    [min(i * 1024, 32767) for i in range(33)],
+    [0, 33, 229, 655, 1376, 2425, 3834, 5570, 7667, 9994, 12550, 15106, 17596, 19955, 22150, 24117,
+     25853, 27393, 28671, 29752, 30604, 31292, 31817, 32177, 32439, 32603, 32701, 32734, 32767, 32767, 32767, 32767,
+     32767],
+    [0, 1, 8, 27, 64, 125, 216, 343, 512, 729, 1000, 1331, 1728, 2197, 2744, 3375,
+     4096, 4913, 5832, 6859, 8000, 9261, 10648, 12167, 13824, 15625, 17575, 19682, 21951, 24388, 26999, 29790,
+     32767],
+    [0, 2977, 5768, 8379, 10816, 13085, 15192, 17142, 18943, 20600, 22119, 23506, 24767, 25908, 26935, 27854,
+     28671, 29392, 30023, 30570, 31039, 31436, 31767, 32038, 32255, 32424, 32551, 32642, 32703, 32740, 32759, 32766,
+     32767],
+    [0, -52, -196, -417, -698, -1024, -1377, -1741, -2102, -2441, -2743, -2993, -3172, -3267, -3259, -3133,
+     -2874, -2463, -1886, -1126, -168, 1007, 2412, 4066, 5983, 8180, 10674, 13480, 16615, 20095, 23936, 28155,
+     32767],
+    [0, 4612, 8831, 12672, 16152, 19287, 22093, 24587, 26784, 28701, 30355, 31760, 32935, 33893, 34653, 35230,
+     35641, 35900, 36026, 36034, 35939, 35760, 35510, 35208, 34869, 34508, 34144, 33791, 33465, 33184, 32963, 32819,
+     32767],
+    [0, 242, 968, 2178, 3872, 6050, 8712, 11858, 15488, 19601, 24199, 29281, 31775, 29377, 27463, 26033,
+     25087, 24625, 24647, 25153, 26143, 27617, 29575, 32017, 31871, 31057, 30727, 30881, 31519, 32641, 32327, 32305,
+     32767],
+]
+
+
+def q15_sin(phase):
+    index, frac = phase >> 8, phase & 0xFF
+    a, b = SIN_TABLE[index], SIN_TABLE[index + 1]
+    return a + (((b - a) * frac) >> 8)
+
+
+def q15_ease(ease, t):
+    if t <= 0:
+        return 0
+    if t >= 32768:
+        return 32768
+    table = EASE_TABLES[ease]
+    index, frac = t >> 10, t & 0x3FF
+    a, b = table[index], table[index + 1]
+    return a + (((b - a) * frac) >> 10)
+
+
+def q15_bezier(p0, p1, p2, p3, u):
+    u = min(max(u, 0), 32768)
+    s = 32768 - u
+    total = s * s * s * p0 + 3 * s * s * u * p1 + 3 * s * u * u * p2 + u * u * u * p3
+    return (total + (1 << 44)) >> 45
+
+
+def per_servo(values, servos, name):
+    if len(values) != servos:
+        raise ValueError(f'{name} needs {servos} entries')
+    return values
+
+
+def compile_source(source):
+    servos = source['servos']
+    if not 1 <= servos <= MAX_SERVOS:
+        raise ValueError(f'servos must be 1-{MAX_SERVOS}')
+    out = bytearray(struct.pack('<4sBBH', MAGIC, VERSION, servos, len(source['segments'])))
+    for index, segment in enumerate(source['segments']):
+        try:
+            ease = EASES.index(segment.get('ease', 'linear'))
+            duration = segment.get('duration', 0)
+            if 'move' in segment:
+                targets = per_servo(segment['move'], servos, 'move')
+                mask = sum(1 << i for i, v in enumerate(targets) if v is not None)
+                out += struct.pack('<BBHHH', TYPE_MOVE, ease, mask, duration, 0)
+                for v in targets:
+                    if v is not None:
+                        out += struct.pack('<h', v)
+            elif 'oscillate' in segment:
+                osc = segment['oscillate']
+                amplitude = per_servo(osc['amplitude'], servos, 'amplitude')
+                offset = per_servo(osc.get('offset', [0] * servos), servos, 'offset')
+                phase = per_servo(osc.get('phase', [0] * servos), servos, 'phase')
+                period = segment['period']
+                if period <= 0:
+                    raise ValueError('period must be positive')
+                mask = sum(1 << i for i, v in enumerate(amplitude) if v is not None)
+                out += struct.pack('<BBHHH', TYPE_OSCILLATE, ease, mask, duration, period)
+                for i in range(servos):
+                    if amplitude[i] is not None:
+                        turn = round((phase[i] or 0) % 360 * 65536 / 360) & 0xFFFF
+                        out += struct.pack('<hhH', amplitude[i], offset[i] or 0, turn)
+            elif 'bezier' in segment:
+                curve = segment['bezier']
+                control1 = per_servo(curve['control1'], servos, 'control1')
+                control2 = per_servo(curve['control2'], servos, 'control2')
+                targets = per_servo(curve['target'], servos, 'target')
+                mask = sum(1 << i for i, v in enumerate(targets) if v is not None)
+                out += struct.pack('<BBHHH', TYPE_BEZIER, ease, mask, duration, 0)
+                for i in range(servos):
+                    if targets[i] is not None:
+                        if control1[i] is None or control2[i] is None:
+                            raise ValueError(f'servo {i} needs both control points')
+                        out += struct.pack('<hhh', control1[i], control2[i], targets[i])
+            elif 'hold' in segment:
+                out += struct.pack('<BBHHH', TYPE_HOLD, 0, 0, segment['hold'], 0)
+            else:
+                raise ValueError('expected move, oscillate, bezier or hold')
+        except (KeyError, ValueError, struct.error) as e:
+            raise ValueError(f'segment {index}: {e}') from e
+    return bytes(out)
+
+
+def decode(data):
+    """Parse and validate a sequence the same way ChoreographyPlayer::Validate does"""
+    if len(data) < 8 or data[:4] != MAGIC:
+        raise ValueError('invalid header')
+    _, version, servos, count = struct.unpack_from('<4sBBH', data)
+    if version != VERSION:
+        raise ValueError(f'unsupported version {version}')
+    segments = []
+    pos = 8
+    for index in range(count):
+        if len(data) - pos < 8:
+            raise ValueError(f'truncated segment {index}')
+        seg_type, ease, mask, duration, period = struct.unpack_from('<BBHHH', data, pos)
+        pos += 8
+        if seg_type > TYPE_BEZIER or ease >= len(EASES) or mask >> servos:
+            raise ValueError(f'invalid segment {index}')
+        if seg_type == TYPE_OSCILLATE and period == 0:
+            raise ValueError(f'oscillate segment {index} has no period')
+        params = {}
+        for servo in range(servos):
+            if not mask & (1 << servo):
+                continue
+            if seg_type == TYPE_MOVE:
+                params[servo] = struct.unpack_from('<h', data, pos)
+                pos += 2
+            elif seg_type == TYPE_OSCILLATE:
+                params[servo] = struct.unpack_from('<hhH', data, pos)
+                pos += 6
+            elif seg_type == TYPE_BEZIER:
+                params[servo] = struct.unpack_from('<hhh', data, pos)
+                pos += 6
+        segments.append((seg_type, ease, mask, duration, period, params))
+    if pos != len(data):
+        raise ValueError('trailing data after last segment')
+    return servos, segments
+
+
+def simulate(servos, segments, repeat, start):
+    """Yield (time_ms, positions) for every engine tick"""
+    positions = list(start)
+    queue = [s for _ in range(repeat) for s in segments]
+    now = 0
+    seg_start = 0
+    active = None
+    origin = []
+    while True:
+        if active is None:
+            if not queue:
+                return
+            active = queue.pop(0)
+            seg_start = now
+            origin = list(positions)
+        elapsed = now - seg_start
+        seg_type, ease, mask, duration, period, params = active
+        while elapsed >= duration:
+            if seg_type == TYPE_MOVE:
+                for servo, (target,) in params.items():
+                    positions[servo] = target
+            elif seg_type == TYPE_BEZIER:
+                for servo, (_, _, target) in params.items():
+                    positions[servo] = target
+            end = seg_start + duration
+            if not queue:
+                active = None
+                break
+            active = queue.pop(0)
+            seg_start = end
+            origin = list(positions)
+            elapsed = now - seg_start
+            seg_type, ease, mask, duration, period, params = active
+        if active is not None:
+            if seg_type == TYPE_MOVE:
+                progress = q15_ease(ease, (elapsed << 15) // duration)
+                for servo, (target,) in params.items():
+                    delta = target - origin[servo]
+                    positions[servo] = origin[servo] + ((delta * progress + (1 << 14)) >> 15)
+            elif seg_type == TYPE_BEZIER:
+                progress = q15_ease(ease, (elapsed << 15) // duration)
+                for servo, (control1, control2, target) in params.items():
+                    positions[servo] = q15_bezier(origin[servo], control1, control2, target, progress)
+            elif seg_type == TYPE_OSCILLATE:
+                phase = ((elapsed % period) << 16) // period
+                for servo, (amplitude, offset, phase0) in params.items():
+                    value = amplitude * q15_sin((phase + phase0) & 0xFFFF)
+                    positions[servo] = 90 + offset + ((value + (1 << 14)) >> 15)
+        yield now, list(positions)
+        if active is None:
+            return
+        now += TICK_MS
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile and simulate servo choreography sequences')
+    sub = parser.add_subparsers(dest='command', required=True)
+    p = sub.add_parser('compile', help='Compile a JSON source to a .chor sequence')
+    p.add_argument('source')
+    p.add_argument('-o', '--output', help='Output path (default: <source>.chor)')
+    p = sub.add_parser('simulate', help='Render joint trajectories to CSV')
+    p.add_argument('sequence', help='.chor sequence or JSON source')
+    p.add_argument('-o', '--output', help='Output CSV (default: stdout)')
+    p.add_argument('--repeat', type=int, default=1)
+    p.add_argument('--start', help='Comma separated start positions (default: 90 for every servo)')
+    p = sub.add_parser('base64', help='Print the sequence as base64 for the upload tool')
+    p.add_argument('sequence')
+    args = parser.parse_args()
+
+    try:
+        if args.command == 'compile':
+            with open(args.source) as f:
+                data = compile_source(json.load(f))
+            decode(data)
+            output = args.output or args.source.rsplit('.', 1)[0] + '.chor'
+            with open(output, 'wb') as f:
+                f.write(data)
+            print(f'{output}: {len(data)} bytes')
+        elif args.command == 'simulate':
+            if args.sequence.endswith('.json'):
+                with open(args.sequence) as f:
+                    data = compile_source(json.load(f))
+            else:
+                with open(args.sequence, 'rb') as f:
+                    data = f.read()
+            servos, segments = decode(data)
+            start = [int(v) for v in args.start.split(',')] if args.start else [90] * servos
+            if len(start) != servos:
+                raise ValueError(f'--start needs {servos} positions')
+            out = open(args.output, 'w') if args.output else sys.stdout
+            out.write('time_ms,' + ','.join(f'servo{i}' for i in range(servos)) + '\n')
+            for now, positions in simulate(servos, segments, args.repeat, start):
+                out.write(f'{now},' + ','.join(str(v) for v in positions) + '\n')
+            if args.output:
+                out.close()
+        else:
+            with open(args.sequence, 'rb') as f:
+                data = f.read()
+            decode(data)
+            print(base64.b64encode(data).decode())
+    except ValueError as e:
+        print(f'Error: {e}')
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""
+Compress a firmware image for OTA
+
+The output is a 16-byte header followed by a heatshrink bitstream, which the
+device decompresses while writing it to the OTA partition (see main/ota_writer.h):
+
+    magic "XZHS", u8 version, u8 window_bits, u8 lookahead_bits, u8 reserved,
+    u32 image_size, u32 image_crc32
+
+Serve the output file instead of the plain .bin at the firmware URL. The device
+detects the format by its magic, so uncompressed images keep working.
+
+Usage:
+    ./ota_compress.py build/xiaozhi.bin -o build/xiaozhi.bin.hs
+"""
+
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = b'XZHS'
+VERSION = 1
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.bits = 0
+        self.count = 0
+
+    def write(self, value, count):
+        self.bits = (self.bits << count) | value
+        self.count += count
+        while self.count >= 8:
+            self.count -= 8
+            self.out.append((self.bits >> self.count) & 0xFF)
+        self.bits &= (1 << self.count) - 1
+
+    def finish(self):
+        if self.count > 0:
+            self.out.append((self.bits << (8 - self.count)) & 0xFF)
+            self.count = 0
+        return bytes(self.out)
+
+
+def heatshrink_encode(data, window_bits, lookahead_bits, chain_limit=16):
+    """Greedy LZSS encoder producing the heatshrink bitstream format"""
+    window = 1 << window_bits
+    max_len = 1 << lookahead_bits
+    backref_bits = 1 + window_bits + lookahead_bits
+    writer = BitWriter()
+    heads = {}
+    n = len(data)
+    i = 0
+    while i < n:
+        best_len = 0
+        best_dist = 0
+        if i + 3 <= n:
+            for p in reversed(heads.get(data[i:i + 3], ())):
+                dist = i - p
+                if dist > window:
+                    break
+                limit = min(max_len, n - i)
+                length = 3
+                while length < limit and data[p + length] == data[i + length]:
+                    length += 1
+                if length > best_len:
+                    best_len, best_dist = length, dist
+                    if length == limit:
+                        break
+
+        if best_len * 9 > backref_bits:
+            writer.write(0, 1)
+            writer.write(best_dist - 1, window_bits)
+            writer.write(best_len - 1, lookahead_bits)
+            step = best_len
+        else:
+            writer.write(1, 1)
+            writer.write(data[i], 8)
+            step = 1
+
+        for k in range(i, min(i + step, n - 2)):
+            chain = heads.setdefault(data[k:k + 3], [])
+            chain.append(k)
+            if len(chain) > chain_limit:
+                del chain[0]
+        i += step
+    return writer.finish()
+
+
+def heatshrink_decode(stream, window_bits, lookahead_bits):
+    """Reference decoder, used to verify the output before it is shipped"""
+    out = bytearray()
+    bits = 0
+    count = 0
+    pos = 0
+
+    def take(n):
+        nonlocal bits, count, pos
+        while count < n:
+            if pos >= len(stream):
+                return None
+            bits = (bits << 8) | stream[pos]
+            pos += 1
+            count += 8
+        count -= n
+        value = (bits >> count) & ((1 << n) - 1)
+        bits &= (1 << count) - 1
+        return value
+
+    while True:
+        tag = take(1)
+        if tag is None:
+            break
+        if tag:
+            literal = take(8)
+            if literal is None:
+                break
+            out.append(literal)
+        else:
+            index = take(window_bits)
+            length = take(lookahead_bits)
+            if index is None or length is None:
+                break
+            start = len(out) - index - 1
+            for k in range(length + 1):
+                out.append(out[start + k] if start + k >= 0 else 0)
+    return bytes(out)
+
+
+def compress(data, window_bits, lookahead_bits):
+    try:
+        import heatshrink2
+        return heatshrink2.compress(data, window_sz2=window_bits, lookahead_sz2=lookahead_bits)
+    except ImportError:
+        return heatshrink_encode(data, window_bits, lookahead_bits)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compress a firmware image for OTA')
+    parser.add_argument('input', help='Firmware image (.bin)')
+    parser.add_argument('-o', '--output', help='Output path (default: <input>.hs)')
+    parser.add_argument('--window', type=int, default=12, help='Window size in bits (4-15), device RAM = 2^window')
+    parser.add_argument('--lookahead', type=int, default=4, help='Lookahead size in bits (3 to window-1)')
+    args = parser.parse_args()
+
+    if not 4 <= args.window <= 15 or not 3 <= args.lookahead < args.window:
+        print('Error: invalid window/lookahead bits')
+        sys.exit(1)
+
+    with open(args.input, 'rb') as f:
+        image = f.read()
+    if not image or image[0] != 0xE9:
+        print('Error: input is not an ESP application image')
+        sys.exit(1)
+
+    stream = compress(image, args.window, args.lookahead)
+    if heatshrink_decode(stream, args.window, args.lookahead) != image:
+        print('Error: round trip verification failed')
+        sys.exit(1)
+
+    header = struct.pack('<4sBBBBII', MAGIC, VERSION, args.window, args.lookahead, 0,
+                         len(image), zlib.crc32(image) & 0xFFFFFFFF)
+    output = args.output or args.input + '.hs'
+    with open(output, 'wb') as f:
+        f.write(header + stream)
+
+    ratio = (len(header) + len(stream)) * 100 / len(image)
+    print(f'{args.input}: {len(image)} -> {len(header) + len(stream)} bytes ({ratio:.1f}%), written to {output}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,199 @@
+#!/usr/bin/env python3
+"""
+Generate a delta OTA patch between two firmware images
+
+The device applies the patch against its running partition while writing the
+new image to the next OTA partition (see main/ota_writer.h). The output is an
+80-byte header followed by a heatshrink-compressed op stream:
+
+    magic "XZDP", u8 version, u8 window_bits, u8 lookahead_bits, u8 reserved,
+    u32 base_size, u32 target_size, u8 base_sha256[32], u8 target_sha256[32]
+
+Each op is {u8 type, u32 length, u32 src_offset} followed by length bytes:
+
+    ADD (1):    out = base[src_offset + i] + data[i] (mod 256)
+    INSERT (2): out = data[i]
+
+Matches are approximate like bsdiff: code that only moved keeps most bytes
+equal, so the ADD data is mostly zeros and compresses well.
+
+Advertise the patch next to the full image in the OTA check response:
+
+    "firmware": { "version": "1.1.0", "url": "<full image>",
+                  "patch": { "from": "1.0.0", "url": "<patch>" } }
+
+The device only uses the patch when "from" matches its running version and the
+base hash matches, and falls back to the full image otherwise.
+
+Usage:
+    ./ota_delta.py old/xiaozhi.bin build/xiaozhi.bin -o build/xiaozhi-1.0.0.patch
+"""
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from ota_compress import compress, heatshrink_decode  # noqa: E402
+
+MAGIC = b'XZDP'
+VERSION = 1
+OP_ADD = 1
+OP_INSERT = 2
+
+SEED_LENGTH = 8     # exact match length used to find candidate alignments
+INDEX_STEP = 4      # index every 4th base position, any 12-byte match is found
+MIN_MATCH = 24      # shorter matches are cheaper as literals
+MAX_CANDIDATES = 8
+MISMATCH_SLACK = 32  # stop extending once the score drops this far below its best
+
+
+def build_index(base):
+    index = {}
+    for i in range(0, len(base) - SEED_LENGTH + 1, INDEX_STEP):
+        key = base[i:i + SEED_LENGTH]
+        positions = index.get(key)
+        if positions is None:
+            index[key] = [i]
+        elif len(positions) < MAX_CANDIDATES:
+            positions.append(i)
+    return index
+
+
+def extend(base, target, target_pos, base_pos):
+    """Length of the approximate match maximizing matches - mismatches"""
+    score = best_score = best_length = 0
+    limit = min(len(target) - target_pos, len(base) - base_pos)
+    i = 0
+    while i < limit:
+        score += 1 if target[target_pos + i] == base[base_pos + i] else -1
+        i += 1
+        if score > best_score:
+            best_score, best_length = score, i
+        elif score < best_score - MISMATCH_SLACK:
+            break
+    return best_length
+
+
+def diff(base, target):
+    """Return a list of (type, src_offset, start, length) covering target"""
+    index = build_index(base)
+    ops = []
+    pos = 0
+    literal_start = 0
+    offset = 0  # base_pos - target_pos of the last match
+    while pos < len(target):
+        best_length = 0
+        best_base = 0
+
+        # Continue the previous alignment first, it survives most code changes
+        base_pos = pos + offset
+        if 0 <= base_pos <= len(base) - 4 and target[pos:pos + 4] == base[base_pos:base_pos + 4]:
+            best_length = extend(base, target, pos, base_pos)
+            best_base = base_pos
+
+        if best_length < MIN_MATCH:
+            # Seeds are indexed at aligned base positions, try the nearby shifts too
+            for shift in range(INDEX_STEP):
+                if pos + shift + SEED_LENGTH > len(target):
+                    break
+                for candidate in index.get(target[pos + shift:pos + shift + SEED_LENGTH], ()):
+                    base_pos = candidate - shift
+                    if base_pos < 0:
+                        continue
+                    length = extend(base, target, pos, base_pos)
+                    if length > best_length:
+                        best_length, best_base = length, base_pos
+                if best_length >= MIN_MATCH:
+                    break
+
+        if best_length < MIN_MATCH:
+            pos += 1
+            continue
+
+        if literal_start < pos:
+            ops.append((OP_INSERT, 0, literal_start, pos - literal_start))
+        ops.append((OP_ADD, best_base, pos, best_length))
+        offset = best_base - pos
+        pos += best_length
+        literal_start = pos
+
+    if literal_start < len(target):
+        ops.append((OP_INSERT, 0, literal_start, len(target) - literal_start))
+    return ops
+
+
+def encode_ops(base, target, ops):
+    out = bytearray()
+    for op_type, src, start, length in ops:
+        out += struct.pack('<BII', op_type, length, src)
+        if op_type == OP_ADD:
+            out += bytes((target[start + i] - base[src + i]) & 0xFF for i in range(length))
+        else:
+            out += target[start:start + length]
+    return bytes(out)
+
+
+def apply_ops(base, stream):
+    """Reference implementation of the device side, used to verify the patch"""
+    out = bytearray()
+    pos = 0
+    while pos < len(stream):
+        op_type, length, src = struct.unpack_from('<BII', stream, pos)
+        pos += 9
+        data = stream[pos:pos + length]
+        pos += length
+        if op_type == OP_ADD:
+            out += bytes((base[src + i] + data[i]) & 0xFF for i in range(length))
+        elif op_type == OP_INSERT:
+            out += data
+        else:
+            raise ValueError(f'invalid op {op_type}')
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate a delta OTA patch')
+    parser.add_argument('base', help='Firmware image currently running on the devices (.bin)')
+    parser.add_argument('target', help='New firmware image (.bin)')
+    parser.add_argument('-o', '--output', help='Output path (default: <target>.patch)')
+    parser.add_argument('--window', type=int, default=12, help='Window size in bits (4-15), device RAM = 2^window')
+    parser.add_argument('--lookahead', type=int, default=8, help='Lookahead size in bits (3 to window-1)')
+    args = parser.parse_args()
+
+    if not 4 <= args.window <= 15 or not 3 <= args.lookahead < args.window:
+        print('Error: invalid window/lookahead bits')
+        sys.exit(1)
+
+    with open(args.base, 'rb') as f:
+        base = f.read()
+    with open(args.target, 'rb') as f:
+        target = f.read()
+    for name, image in ((args.base, base), (args.target, target)):
+        if not image or image[0] != 0xE9:
+            print(f'Error: {name} is not an ESP application image')
+            sys.exit(1)
+
+    ops = diff(base, target)
+    stream = encode_ops(base, target, ops)
+    compressed = compress(stream, args.window, args.lookahead)
+    if apply_ops(base, heatshrink_decode(compressed, args.window, args.lookahead)) != target:
+        print('Error: round trip verification failed')
+        sys.exit(1)
+
+    header = struct.pack('<4sBBBBII32s32s', MAGIC, VERSION, args.window, args.lookahead, 0,
+                         len(base), len(target), hashlib.sha256(base).digest(), hashlib.sha256(target).digest())
+    output = args.output or args.target + '.patch'
+    with open(output, 'wb') as f:
+        f.write(header + compressed)
+
+    copied = sum(op[3] for op in ops if op[0] == OP_ADD)
+    ratio = (len(header) + len(compressed)) * 100 / len(target)
+    print(f'{args.target}: {len(target)} bytes, {copied * 100 // max(len(target), 1)}% matched in {args.base}')
+    print(f'Patch: {len(header) + len(compressed)} bytes ({ratio:.1f}%), {len(ops)} ops, written to {output}')
+
+
+if __name__ == '__main__':
+    main()
@@ -20,6 +20,9 @@ from typing import List
 from pathlib import Path
 from packaging import version
 
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+from assets_format import pack_assets_v2
+
 sys.dont_write_bytecode = True
 
 GREEN = '\033[1;32m'
@@ -45,6 +48,7 @@ class PackModelsConfig:
     image_file: str
     assets_path: str
     name_length: int
+    format_version: int = 2
 
 def generate_header_filename(path):
     asset_name = os.path.basename(path)
@@ -388,6 +392,29 @@ def convert_image_to_raw(input_file: str) -> None:
             convert_path=convert_path
         )
 
+def pack_assets_v1(file_info_list, merged_data, max_name_len):
+    """
+    Legacy layout: files, checksum, length header + unsorted table + "ZZ" prefixed data.
+    Returns (image_bytes, checksum).
+    """
+    mmap_table = bytearray()
+    for file_name, offset, file_size, width, height in file_info_list:
+        if len(file_name) > int(max_name_len):
+            print(f'\033[1;33mWarn:\033[0m "{file_name}" exceeds {max_name_len} bytes and will be truncated.')
+        fixed_name = file_name.ljust(int(max_name_len), '\0')[:int(max_name_len)]
+        mmap_table.extend(fixed_name.encode('utf-8'))
+        mmap_table.extend(file_size.to_bytes(4, byteorder='little'))
+        mmap_table.extend(offset.to_bytes(4, byteorder='little'))
+        mmap_table.extend(width.to_bytes(2, byteorder='little'))
+        mmap_table.extend(height.to_bytes(2, byteorder='little'))
+
+    combined_data = mmap_table + merged_data
+    combined_checksum = compute_checksum(combined_data)
+    combined_data_length = len(combined_data).to_bytes(4, byteorder='little')
+    header_data = len(file_info_list).to_bytes(4, byteorder='little') + combined_checksum.to_bytes(4, byteorder='little')
+    return header_data + combined_data_length + combined_data, combined_checksum
+
+
 def pack_assets(config: PackModelsConfig):
     """
     Pack models based on the provided configuration.
@@ -400,6 +427,7 @@ def pack_assets(config: PackModelsConfig):
     max_name_len = config.name_length
 
     merged_data = bytearray()
+    file_entries = []
     file_info_list = []
     skip_files = ['config.json', 'lvgl_image_converter']
 
@@ -437,25 +465,15 @@ def pack_assets(config: PackModelsConfig):
             bin_data = bin_file.read()
 
         merged_data.extend(bin_data)
+        file_entries.append((file_name, bin_data, width, height))
 
     total_files = len(file_info_list)
 
-    mmap_table = bytearray()
-    for file_name, offset, file_size, width, height in file_info_list:
-        if len(file_name) > int(max_name_len):
-            print(f'\033[1;33mWarn:\033[0m "{file_name}" exceeds {max_name_len} bytes and will be truncated.')
-        fixed_name = file_name.ljust(int(max_name_len), '\0')[:int(max_name_len)]
-        mmap_table.extend(fixed_name.encode('utf-8'))
-        mmap_table.extend(file_size.to_bytes(4, byteorder='little'))
-        mmap_table.extend(offset.to_bytes(4, byteorder='little'))
-        mmap_table.extend(width.to_bytes(2, byteorder='little'))
-        mmap_table.extend(height.to_bytes(2, byteorder='little'))
-
-    combined_data = mmap_table + merged_data
-    combined_checksum = compute_checksum(combined_data)
-    combined_data_length = len(combined_data).to_bytes(4, byteorder='little')
-    header_data = total_files.to_bytes(4, byteorder='little') + combined_checksum.to_bytes(4, byteorder='little')
-    final_data = header_data + combined_data_length + combined_data
+    if config.format_version >= 2:
+        final_data, combined_checksum, file_names = pack_assets_v2(file_entries)
+    else:
+        final_data, combined_checksum = pack_assets_v1(file_info_list, merged_data, max_name_len)
+        file_names = [file_name for file_name, _, _, _, _ in file_info_list]
 
     with open(out_file, 'wb') as output_bin:
         output_bin.write(final_data)
@@ -481,7 +499,7 @@ def pack_assets(config: PackModelsConfig):
         output_header.write(f'#define MMAP_{asset_name.upper()}_CHECKSUM        0x{combined_checksum:04X}\n\n')
         output_header.write(f'enum MMAP_{asset_name.upper()}_LISTS {{\n')
 
-        for i, (file_name, _, _, _, _) in enumerate(file_info_list):
+        for i, file_name in enumerate(file_names):
             enum_name = file_name.replace('.', '_')
             output_header.write(f'    MMAP_{asset_name.upper()}_{enum_name.upper()} = {i},        /*!< {file_name} */\n')
 
@@ -557,7 +575,8 @@ def process_assets_build(config_data):
         include_path=include_path,
         image_file=image_file,
         assets_path=assets_path,
-        name_length=name_length
+        name_length=name_length,
+        format_version=int(config_data.get('format_version', 2))
     )
 
     print('--support_format:', support_format)
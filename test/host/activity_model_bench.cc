@@ -0,0 +1,226 @@
+// 回放合成的互动日志，对比增量模型与旧的全量扫描 + strstr 实现的单次开销，
+// 并用双精度的逐桶衰减模型校验增量模型的最大值下标。
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "activity_model.h"
+#include "test_check.h"
+
+using xiaozhi::ActivityModel;
+
+namespace {
+
+constexpr int64_t kStartS = 1700000000;
+constexpr int kEventCount = 200000;
+
+const char* const kPhrases[] = {
+    "what's the weather like tomorrow",
+    "明天天气怎么样",
+    "tell me a story about dragons",
+    "讲个故事吧",
+    "how is my pet doing",
+    "我的宠物饿了吗",
+    "turn on the smart_home lights",
+    "帮我控制一下空调",
+    "let's chat for a while",
+    "陪我聊天",
+    "what time is it",
+    "播放一首歌",
+    "the weather story is about a pet",
+    "",
+};
+constexpr int kPhraseCount = sizeof(kPhrases) / sizeof(kPhrases[0]);
+
+struct Event {
+  int64_t time_s;
+  uint8_t hour;
+  const char* text;
+};
+
+// 固定种子的 LCG，保证每次回放的日志相同
+uint32_t NextRandom(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// 两年的日志：前一年集中在晚上 20 点附近，后一年转到早上 8 点附近，
+// 衰减正确时最活跃时段应跟随转移
+std::vector<Event> GenerateLog() {
+  std::vector<Event> log;
+  log.reserve(kEventCount);
+  uint32_t state = 12345;
+  int64_t span_s = 2 * 365 * 24 * 3600LL;
+  for (int i = 0; i < kEventCount; i++) {
+    int64_t time_s = kStartS + span_s * i / kEventCount;
+    int peak = i < kEventCount / 2 ? 20 : 8;
+    int jitter = static_cast<int>(NextRandom(state) % 5) - 2;
+    uint8_t hour = static_cast<uint8_t>((peak + jitter + 24) % 24);
+    if (NextRandom(state) % 10 == 0) {
+      hour = static_cast<uint8_t>(NextRandom(state) % 24);
+    }
+    log.push_back({time_s, hour, kPhrases[NextRandom(state) % kPhraseCount]});
+  }
+  return log;
+}
+
+// ========== 旧实现（逐项 strstr、累计计数、每次查询全量扫描） ==========
+
+struct LegacyProfile {
+  uint8_t active_hours[24] = {};
+  uint16_t topics[ActivityModel::kTopicCount] = {};
+
+  static ActivityModel::Topic Classify(const char* topic) {
+    if (strstr(topic, "weather") || strstr(topic, "天气")) {
+      return ActivityModel::kTopicWeather;
+    } else if (strstr(topic, "story") || strstr(topic, "故事")) {
+      return ActivityModel::kTopicStory;
+    } else if (strstr(topic, "pet") || strstr(topic, "宠物")) {
+      return ActivityModel::kTopicPet;
+    } else if (strstr(topic, "smart_home") || strstr(topic, "智能家居") ||
+               strstr(topic, "control") || strstr(topic, "控制")) {
+      return ActivityModel::kTopicSmartHome;
+    } else if (strstr(topic, "chat") || strstr(topic, "聊天")) {
+      return ActivityModel::kTopicChat;
+    }
+    return ActivityModel::kTopicOther;
+  }
+
+  void Record(uint8_t hour, const char* text) {
+    if (active_hours[hour] < 255) {
+      active_hours[hour]++;
+    }
+    topics[Classify(text)]++;
+  }
+
+  uint8_t GetMostActiveHour() const {
+    uint8_t max_hour = 0;
+    for (uint8_t i = 1; i < 24; i++) {
+      if (active_hours[i] > active_hours[max_hour]) {
+        max_hour = i;
+      }
+    }
+    return max_hour;
+  }
+
+  int GetFavoriteTopic() const {
+    int favorite = ActivityModel::kTopicChat;
+    for (int i = 0; i < ActivityModel::kTopicCount; i++) {
+      if (topics[i] > topics[favorite]) {
+        favorite = i;
+      }
+    }
+    return favorite;
+  }
+};
+
+// ========== 参考模型：每个事件都把所有桶按精确的指数衰减 ==========
+
+struct ReferenceModel {
+  double hours[24] = {};
+  double topics[ActivityModel::kTopicCount] = {};
+  int64_t last_s = kStartS;
+
+  void Record(uint8_t hour, ActivityModel::Topic topic, int64_t now_s) {
+    double decay = std::exp2(-static_cast<double>(now_s - last_s) / ActivityModel::kHalfLifeS);
+    for (auto& bin : hours) {
+      bin *= decay;
+    }
+    for (auto& bin : topics) {
+      bin *= decay;
+    }
+    last_s = now_s;
+    hours[hour] += 1;
+    topics[topic] += 1;
+  }
+
+  double MaxHour() const {
+    double max = 0;
+    for (double bin : hours) {
+      max = bin > max ? bin : max;
+    }
+    return max;
+  }
+
+  double MaxTopic() const {
+    double max = 0;
+    for (double bin : topics) {
+      max = bin > max ? bin : max;
+    }
+    return max;
+  }
+};
+
+volatile uint32_t g_sink;
+
+template <typename F>
+double NanosPerEvent(const std::vector<Event>& log, F&& replay) {
+  auto start = std::chrono::steady_clock::now();
+  replay();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / log.size();
+}
+
+void CheckClassifier() {
+  for (const char* phrase : kPhrases) {
+    CHECK(ActivityModel::ClassifyTopic(phrase) == LegacyProfile::Classify(phrase));
+  }
+  CHECK(ActivityModel::ClassifyTopic(nullptr) == ActivityModel::kTopicOther);
+}
+
+void CheckAccuracy(const std::vector<Event>& log) {
+  ActivityModel model;
+  model.Reset(kStartS);
+  ReferenceModel reference;
+  for (size_t i = 0; i < log.size(); i++) {
+    const auto& event = log[i];
+    auto topic = ActivityModel::ClassifyTopic(event.text);
+    model.RecordHour(event.hour, event.time_s);
+    model.RecordTopic(topic, event.time_s);
+    reference.Record(event.hour, topic, event.time_s);
+    // 定点近似和整体右移的误差下，模型选出的桶与真正最大的桶相差不超过 2%
+    if (i % 1000 == 999) {
+      CHECK(reference.hours[model.GetMostActiveHour()] >= reference.MaxHour() * 0.98);
+      CHECK(reference.topics[model.GetFavoriteTopic()] >= reference.MaxTopic() * 0.98);
+    }
+  }
+  // 衰减让最活跃时段跟随作息转移
+  CHECK(model.GetMostActiveHour() == 8);
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Event> log = GenerateLog();
+  CheckClassifier();
+  CheckAccuracy(log);
+
+  double legacy_ns = NanosPerEvent(log, [&]() {
+    LegacyProfile legacy;
+    uint32_t sum = 0;
+    for (const auto& event : log) {
+      legacy.Record(event.hour, event.text);
+      sum += legacy.GetMostActiveHour() + legacy.GetFavoriteTopic();
+    }
+    g_sink = sum;
+  });
+  double model_ns = NanosPerEvent(log, [&]() {
+    ActivityModel model;
+    model.Reset(kStartS);
+    uint32_t sum = 0;
+    for (const auto& event : log) {
+      model.RecordHour(event.hour, event.time_s);
+      model.RecordTopic(ActivityModel::ClassifyTopic(event.text), event.time_s);
+      sum += model.GetMostActiveHour() + model.GetFavoriteTopic();
+    }
+    g_sink = sum;
+  });
+
+  std::printf("replayed %d events over 2 years\n", kEventCount);
+  std::printf("  legacy (strstr + full scans): %6.1f ns/event\n", legacy_ns);
+  std::printf("  incremental activity model:   %6.1f ns/event\n", model_ns);
+  return 0;
+}
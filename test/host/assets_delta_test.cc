@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "assets_delta.h"
+#include "test_check.h"
+#include "test_files.h"
+
+// 用 scripts/build_default_assets.py 打包新旧两份资源，检查差量计划跳过的扇区在新旧镜像中逐字节相同
+//   assets_delta_test <python> <scripts 目录> <工作目录>
+
+namespace {
+
+constexpr size_t kSectorSize = 4096;
+
+struct Asset {
+  std::string name;
+  size_t size;
+  uint32_t seed;
+};
+
+std::vector<Asset> BaseAssets() {
+  std::vector<Asset> assets;
+  const size_t sizes[] = {20000, 300, 9000, 4096, 1, 15000, 8192, 700, 12000, 5000};
+  for (int i = 0; i < 10; i++) {
+    assets.push_back({"asset_" + std::to_string(i) + ".bin", sizes[i], (uint32_t)i});
+  }
+  return assets;
+}
+
+std::vector<uint8_t> Pack(const std::string& python, const std::string& scripts, const std::string& dir,
+                          const std::string& name, const std::vector<Asset>& assets) {
+  std::string source = dir + "/" + name;
+  Run("rm -rf " + Quote(source) + " && mkdir -p " + Quote(source));
+  for (const auto& asset : assets) {
+    std::vector<uint8_t> data(asset.size);
+    uint32_t state = asset.seed * 2654435761u + 1;
+    for (auto& byte : data) {
+      state = state * 1664525u + 1013904223u;
+      byte = (uint8_t)(state >> 24);
+    }
+    WriteFile(source + "/" + asset.name, data);
+  }
+  std::string output = dir + "/" + name + ".bin";
+  Run(Quote(python) + " -c \"import sys; sys.path.insert(0, sys.argv[1]); "
+      "from build_default_assets import pack_assets_simple; "
+      "pack_assets_simple(sys.argv[2], sys.argv[3], sys.argv[4], 'assets')\" " +
+      Quote(scripts) + " " + Quote(source) + " " + Quote(source + "_include") + " " + Quote(output));
+  return ReadFile(output);
+}
+
+mmap_assets_header_v2 Header(const std::vector<uint8_t>& image) {
+  mmap_assets_header_v2 header;
+  CHECK(image.size() >= sizeof(header));
+  std::memcpy(&header, image.data(), sizeof(header));
+  CHECK(CheckAssetsHeaderV2(header, image.size()));
+  return header;
+}
+
+// 与 AssetsDownloader::FetchTableSectors 相同：头部和资源表所在的扇区最后写入
+size_t HeadSize(const mmap_assets_header_v2& header, size_t total_size) {
+  size_t table_end = header.table_offset + header.file_count * sizeof(mmap_assets_table_v2);
+  return std::min((table_end + kSectorSize - 1) / kSectorSize * kSectorSize, total_size);
+}
+
+// 返回跳过的扇区数；跳过的扇区必须与旧镜像逐字节相同
+size_t Plan(const std::vector<uint8_t>& old_image, const std::vector<uint8_t>& new_image) {
+  mmap_assets_header_v2 old_header = Header(old_image);
+  mmap_assets_header_v2 new_header = Header(new_image);
+  auto old_entries = reinterpret_cast<const mmap_assets_table_v2*>(old_image.data() + old_header.table_offset);
+  auto new_entries = reinterpret_cast<const mmap_assets_table_v2*>(new_image.data() + new_header.table_offset);
+  size_t total_size = new_image.size();
+  size_t head_size = HeadSize(new_header, total_size);
+
+  std::vector<bool> clean((total_size + kSectorSize - 1) / kSectorSize, false);
+  MarkReusableSectors(new_header, new_entries, old_header, old_entries, kSectorSize, total_size, head_size, clean);
+
+  size_t count = 0;
+  for (size_t sector = 0; sector < clean.size(); sector++) {
+    if (!clean[sector]) {
+      continue;
+    }
+    size_t start = sector * kSectorSize;
+    size_t end = std::min(start + kSectorSize, total_size);
+    CHECK(start >= head_size);
+    CHECK(end <= old_image.size());
+    CHECK(std::memcmp(new_image.data() + start, old_image.data() + start, end - start) == 0);
+    count++;
+  }
+  return count;
+}
+
+void TestPlans(const std::string& python, const std::string& scripts, const std::string& dir) {
+  std::vector<Asset> base = BaseAssets();
+  std::vector<uint8_t> old_image = Pack(python, scripts, dir, "assets_delta_old", base);
+  size_t sectors = (old_image.size() + kSectorSize - 1) / kSectorSize;
+
+  // 内容不变：除头部外全部跳过，只有跨越资源边界的扇区需要重写
+  size_t unchanged = Plan(old_image, old_image);
+  CHECK(unchanged >= sectors * 3 / 4);
+
+  // 一个资源内容变化、大小不变：只有它覆盖的扇区需要下载
+  std::vector<Asset> edited = base;
+  edited[5].seed = 100;
+  size_t edited_clean = Plan(old_image, Pack(python, scripts, dir, "assets_delta_edit", edited));
+  CHECK(edited_clean < unchanged && edited_clean + 6 >= unchanged);
+
+  // 一个资源变大：之后的资源都后移，不能复用
+  std::vector<Asset> resized = base;
+  resized[3].size = 6000;
+  size_t resized_clean = Plan(old_image, Pack(python, scripts, dir, "assets_delta_resize", resized));
+  CHECK(resized_clean > 0 && resized_clean < edited_clean);
+
+  // 新增资源：表变长后数据区整体后移，所有扇区都重新下载
+  std::vector<Asset> added = base;
+  added.push_back({"asset_a.bin", 100, 42});
+  CHECK(Plan(old_image, Pack(python, scripts, dir, "assets_delta_add", added)) == 0);
+
+  // 最后一个资源变小：镜像变短，前面的资源仍可复用
+  std::vector<Asset> truncated = base;
+  truncated.back().size = 3000;
+  std::vector<uint8_t> truncated_image = Pack(python, scripts, dir, "assets_delta_truncate", truncated);
+  CHECK(truncated_image.size() < old_image.size());
+  CHECK(Plan(old_image, truncated_image) + 3 >= unchanged);
+  // 反过来，新镜像比分区中的旧镜像长
+  CHECK(Plan(truncated_image, old_image) + 3 >= unchanged);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CHECK(argc == 4);
+  TestPlans(argv[1], argv[2], argv[3]);
+  std::printf("assets_delta_test passed\n");
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "assets_format.h"
+#include "test_check.h"
+#include "test_files.h"
+
+// 用 scripts/build_default_assets.py 打包一组资源，按固件的方式检查 v2 头部、查找并校验每个资源
+//   assets_format_test <python> <scripts 目录> <工作目录>
+
+namespace {
+
+// 与 esp_rom_crc32_le(0, ...) 和 zlib.crc32 相同
+uint32_t Crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+struct Asset {
+  const char* name;
+  size_t size;
+};
+
+// 名称覆盖扩展名排序与字节序排序不同的情况，以及 31 字节的最长名称
+const Asset kAssets[] = {
+    {"index.json", 120},
+    {"srmodels.bin", 5000},
+    {"font_puhui_16_4.bin", 777},
+    {"emoji_happy.png", 1},
+    {"emoji_sad.png", 0},
+    {"Z.txt", 33},
+    {"a_name_that_is_31_bytes_long.gz", 64},
+};
+
+std::vector<uint8_t> AssetData(const Asset& asset) {
+  std::vector<uint8_t> data(asset.size);
+  for (size_t i = 0; i < asset.size; i++) {
+    data[i] = static_cast<uint8_t>(i * 31 + std::strlen(asset.name));
+  }
+  return data;
+}
+
+std::vector<uint8_t> Pack(const std::string& python, const std::string& scripts, const std::string& dir) {
+  std::string source = dir + "/assets_test";
+  Run("rm -rf " + Quote(source) + " && mkdir -p " + Quote(source));
+  for (const auto& asset : kAssets) {
+    WriteFile(source + "/" + asset.name, AssetData(asset));
+  }
+  // config.json 不进入资源表
+  WriteFile(source + "/config.json", {'{', '}'});
+
+  std::string output = dir + "/assets_test.bin";
+  Run(Quote(python) + " -c \"import sys; sys.path.insert(0, sys.argv[1]); "
+      "from build_default_assets import pack_assets_simple; "
+      "pack_assets_simple(sys.argv[2], sys.argv[3], sys.argv[4], 'assets')\" " +
+      Quote(scripts) + " " + Quote(source) + " " + Quote(dir + "/assets_test_include") + " " + Quote(output));
+  return ReadFile(output);
+}
+
+void TestPackedImage(const std::string& python, const std::string& scripts, const std::string& dir) {
+  std::vector<uint8_t> image = Pack(python, scripts, dir);
+  CHECK(image.size() >= sizeof(mmap_assets_header_v2));
+  mmap_assets_header_v2 header;
+  std::memcpy(&header, image.data(), sizeof(header));
+  CHECK(CheckAssetsHeaderV2(header, image.size()));
+  CHECK(header.file_count == sizeof(kAssets) / sizeof(kAssets[0]));
+  CHECK(header.data_offset + header.data_length == image.size());
+  CHECK(header.alignment >= 4 && header.data_offset % header.alignment == 0);
+
+  const auto* table = reinterpret_cast<const mmap_assets_table_v2*>(image.data() + header.table_offset);
+  CHECK(Crc32(image.data() + header.table_offset, header.file_count * sizeof(mmap_assets_table_v2)) ==
+        header.table_crc32);
+  for (uint32_t i = 1; i < header.file_count; i++) {
+    CHECK(std::strncmp(table[i - 1].asset_name, table[i].asset_name, ASSETS_NAME_MAX_LEN) < 0);
+  }
+
+  const uint8_t* data_area = image.data() + header.data_offset;
+  for (const auto& asset : kAssets) {
+    const mmap_assets_table_v2* item = FindAssetV2(table, header.file_count, asset.name);
+    CHECK(item != nullptr);
+    CHECK(item->asset_size == asset.size);
+    CHECK(item->asset_offset % header.alignment == 0);
+    CHECK((uint64_t)item->asset_offset + item->asset_size <= header.data_length);
+    std::vector<uint8_t> expected = AssetData(asset);
+    CHECK(std::memcmp(data_area + item->asset_offset, expected.data(), expected.size()) == 0);
+    CHECK(Crc32(data_area + item->asset_offset, item->asset_size) == item->asset_crc32);
+  }
+  CHECK(FindAssetV2(table, header.file_count, "config.json") == nullptr);
+  CHECK(FindAssetV2(table, header.file_count, "emoji") == nullptr);
+  CHECK(FindAssetV2(table, header.file_count, "zzz") == nullptr);
+  CHECK(FindAssetV2(table, 0, "index.json") == nullptr);
+
+  // 分区比镜像小，或者表越过数据区时拒绝
+  CHECK(!CheckAssetsHeaderV2(header, image.size() - 1));
+  mmap_assets_header_v2 broken = header;
+  broken.file_count = 0x10000000;
+  CHECK(!CheckAssetsHeaderV2(broken, 0xFFFFFFFF));
+  broken = header;
+  broken.table_offset = 4;
+  CHECK(!CheckAssetsHeaderV2(broken, image.size()));
+  broken = header;
+  broken.version = 1;
+  CHECK(!CheckAssetsHeaderV2(broken, image.size()));
+  broken = header;
+  broken.magic[3] = '1';
+  CHECK(!CheckAssetsHeaderV2(broken, image.size()));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CHECK(argc == 4);
+  TestPackedImage(argv[1], argv[2], argv[3]);
+  std::printf("assets_format_test passed\n");
+  return 0;
+}
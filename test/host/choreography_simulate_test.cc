@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "motion_curve.h"
+#include "test_check.h"
+#include "test_files.h"
+
+// 用 scripts/choreography.py 编译并模拟一段序列，逐节拍与固件的 MotionCurve 比较，
+// 保证离线渲染的 CSV 就是舵机实际走的轨迹
+//   choreography_simulate_test <python> <choreography.py> <工作目录>
+
+namespace {
+
+constexpr int kServos = 4;
+constexpr int kTickMs = 20;
+
+// 覆盖所有段类型、回弹缓动、贝塞尔过冲和不参与的舵机
+const char* kSource = R"({"servos": 4, "segments": [
+  {"move": [120, null, 60, 90], "duration": 300, "ease": "in_out"},
+  {"move": [100, 70, null, 30], "duration": 170, "ease": "out_back"},
+  {"oscillate": {"amplitude": [30, 20, null, 15], "offset": [0, -10, null, 5],
+                 "phase": [0, 180, null, 90]}, "period": 600, "duration": 1210},
+  {"bezier": {"control1": [150, 40, 20, null], "control2": [30, 160, 170, null],
+              "target": [90, 90, 90, null]}, "duration": 530, "ease": "linear"},
+  {"bezier": {"control1": [60, null, null, 120], "control2": [60, null, null, 120],
+              "target": [120, null, null, 60]}, "duration": 450, "ease": "in_back"},
+  {"hold": 90},
+  {"move": [90, 90, 90, 90], "duration": 250, "ease": "out_bounce"}
+]})";
+
+struct Row {
+  int time_ms;
+  int positions[kServos];
+};
+
+int16_t ReadInt16(const uint8_t* p) { return (int16_t)(p[0] | (p[1] << 8)); }
+uint16_t ReadUint16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+// 与 ChoreographyPlayer::Play 相同的解码，偏移为 0
+std::vector<MotionSegment> Decode(const std::vector<uint8_t>& data) {
+  CHECK(data.size() >= 8 && data[0] == 'X' && data[5] == kServos);
+  int count = ReadUint16(&data[6]);
+  std::vector<MotionSegment> segments;
+  const uint8_t* p = data.data() + 8;
+  for (int i = 0; i < count; i++) {
+    MotionSegment segment;
+    segment.type = (MotionSegmentType)p[0];
+    segment.ease = (MotionEase)p[1];
+    segment.mask = ReadUint16(p + 2);
+    segment.duration_ms = ReadUint16(p + 4);
+    segment.period_ms = ReadUint16(p + 6);
+    p += 8;
+    for (int servo = 0; servo < kServos; servo++) {
+      if (!(segment.mask & (1 << servo))) {
+        continue;
+      }
+      if (segment.type == kMotionMove) {
+        segment.target[servo] = ReadInt16(p);
+        p += 2;
+      } else if (segment.type == kMotionOscillate) {
+        segment.amplitude[servo] = ReadInt16(p);
+        segment.offset[servo] = ReadInt16(p + 2);
+        segment.phase[servo] = ReadUint16(p + 4);
+        p += 6;
+      } else if (segment.type == kMotionBezier) {
+        segment.control1[servo] = ReadInt16(p);
+        segment.control2[servo] = ReadInt16(p + 2);
+        segment.target[servo] = ReadInt16(p + 4);
+        p += 6;
+      }
+    }
+    segments.push_back(segment);
+  }
+  CHECK(p == data.data() + data.size());
+  return segments;
+}
+
+// 按 ServoMotionEngine::Tick 的方式推进：时间从段开始时刻算起，下一段紧接着上一段的结束时刻
+std::vector<Row> Simulate(const std::vector<MotionSegment>& segments, const int* start) {
+  std::vector<Row> rows;
+  int16_t positions[MOTION_MAX_SERVOS] = {};
+  int16_t origin[MOTION_MAX_SERVOS] = {};
+  for (int i = 0; i < kServos; i++) {
+    positions[i] = start[i];
+  }
+  size_t next = 0;
+  const MotionSegment* active = nullptr;
+  int64_t now = 0;
+  int64_t segment_start = 0;
+  while (true) {
+    if (active == nullptr) {
+      if (next == segments.size()) {
+        break;
+      }
+      active = &segments[next++];
+      segment_start = now;
+      std::copy(positions, positions + kServos, origin);
+    }
+    int64_t elapsed = now - segment_start;
+    while (elapsed >= (int64_t)active->duration_ms * 1000) {
+      if (MotionCurve::EndsAtTarget(active->type)) {
+        for (int i = 0; i < kServos; i++) {
+          if (active->mask & (1 << i)) {
+            positions[i] = active->target[i];
+          }
+        }
+      }
+      int64_t end = segment_start + (int64_t)active->duration_ms * 1000;
+      if (next == segments.size()) {
+        active = nullptr;
+        break;
+      }
+      active = &segments[next++];
+      segment_start = end;
+      std::copy(positions, positions + kServos, origin);
+      elapsed = now - segment_start;
+    }
+    if (active != nullptr && active->type != kMotionHold) {
+      for (int i = 0; i < kServos; i++) {
+        if (active->mask & (1 << i)) {
+          positions[i] = MotionCurve::Evaluate(*active, origin, elapsed, i);
+        }
+      }
+    }
+    Row row;
+    row.time_ms = (int)(now / 1000);
+    for (int i = 0; i < kServos; i++) {
+      row.positions[i] = positions[i];
+    }
+    rows.push_back(row);
+    if (active == nullptr) {
+      break;
+    }
+    now += kTickMs * 1000;
+  }
+  return rows;
+}
+
+std::vector<Row> ReadCsv(const std::string& path) {
+  std::ifstream in(path);
+  CHECK(in.good());
+  std::string line;
+  CHECK(std::getline(in, line) && line == "time_ms,servo0,servo1,servo2,servo3");
+  std::vector<Row> rows;
+  while (std::getline(in, line)) {
+    std::istringstream fields(line);
+    std::string field;
+    Row row;
+    CHECK(std::getline(fields, field, ','));
+    row.time_ms = std::stoi(field);
+    for (int i = 0; i < kServos; i++) {
+      CHECK(std::getline(fields, field, ','));
+      row.positions[i] = std::stoi(field);
+    }
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+void TestBezier() {
+  // 端点精确落在起点和目标，回弹缓动超出 0..32768 的部分被截断
+  CHECK(MotionCurve::Bezier(30, 150, -20, 120, 0) == 30);
+  CHECK(MotionCurve::Bezier(30, 150, -20, 120, 32768) == 120);
+  CHECK(MotionCurve::Bezier(30, 150, -20, 120, -500) == 30);
+  CHECK(MotionCurve::Bezier(30, 150, -20, 120, 36000) == 120);
+  // 控制点在三等分点上时就是直线
+  for (int32_t u = 0; u <= 32768; u += 512) {
+    int linear = 30 + ((90 * u + (1 << 14)) >> 15);
+    int curve = MotionCurve::Bezier(30, 60, 90, 120, u);
+    CHECK(curve - linear <= 1 && linear - curve <= 1);
+  }
+
+  MotionSegment segment;
+  segment.type = kMotionBezier;
+  segment.duration_ms = 400;
+  segment.control1[0] = 170;
+  segment.control2[0] = 170;
+  segment.target[0] = 90;
+  int16_t start[MOTION_MAX_SERVOS] = {10};
+  CHECK(MotionCurve::Evaluate(segment, start, 0, 0) == 10);
+  // 中点 = (p0 + 3 * c1 + 3 * c2 + p3) / 8
+  CHECK(MotionCurve::Evaluate(segment, start, 200 * 1000, 0) == (10 + 3 * 170 + 3 * 170 + 90) / 8);
+  CHECK(MotionCurve::Evaluate(segment, start, 400 * 1000, 0) == 90);
+  CHECK(MotionCurve::Evaluate(segment, start, 900 * 1000, 0) == 90);
+}
+
+void TestSimulatorMatchesFirmware(const std::string& python, const std::string& script,
+                                  const std::string& dir) {
+  std::string source = dir + "/choreography_test.json";
+  std::string sequence = dir + "/choreography_test.chor";
+  std::string csv = dir + "/choreography_test.csv";
+  std::ofstream(source) << kSource;
+
+  Run(Quote(python) + " " + Quote(script) + " compile " + Quote(source) + " -o " + Quote(sequence));
+  Run(Quote(python) + " " + Quote(script) + " simulate " + Quote(sequence) + " -o " + Quote(csv) +
+      " --repeat 2 --start 80,95,100,90");
+
+  std::vector<MotionSegment> once = Decode(ReadFile(sequence));
+  std::vector<MotionSegment> segments = once;
+  segments.insert(segments.end(), once.begin(), once.end());
+  const int start[kServos] = {80, 95, 100, 90};
+  std::vector<Row> expected = Simulate(segments, start);
+  std::vector<Row> actual = ReadCsv(csv);
+
+  CHECK(actual.size() == expected.size());
+  for (size_t row = 0; row < expected.size(); row++) {
+    CHECK(actual[row].time_ms == expected[row].time_ms);
+    for (int i = 0; i < kServos; i++) {
+      if (actual[row].positions[i] != expected[row].positions[i]) {
+        std::fprintf(stderr, "t=%d servo%d: csv %d, firmware %d\n", expected[row].time_ms, i,
+                     actual[row].positions[i], expected[row].positions[i]);
+      }
+      CHECK(actual[row].positions[i] == expected[row].positions[i]);
+    }
+  }
+  // 序列结束时停在最后一个移动段的目标
+  for (int i = 0; i < kServos; i++) {
+    CHECK(expected.back().positions[i] == 90);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CHECK(argc == 4);
+  TestBezier();
+  TestSimulatorMatchesFirmware(argv[1], argv[2], argv[3]);
+  std::printf("choreography_simulate_test passed\n");
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "test_files.h"
+#include "utils/delta_patcher.h"
+#include "utils/heatshrink_decoder.h"
+
+// 用 scripts/ota_delta.py 生成补丁，固件按 OtaWriter 的流程解压并应用，重建出目标镜像
+//   delta_patcher_test <python> <ota_delta.py> <工作目录>
+
+namespace {
+
+uint32_t ReadUint32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void AppendOp(std::vector<uint8_t>& stream, uint8_t type, uint32_t length, uint32_t source) {
+  stream.push_back(type);
+  for (uint32_t value : {length, source}) {
+    for (int shift = 0; shift < 32; shift += 8) {
+      stream.push_back((uint8_t)(value >> shift));
+    }
+  }
+}
+
+// 模拟一次代码改动：插入一段新代码、修改部分常量、删除一段
+std::vector<uint8_t> EditImage(const std::vector<uint8_t>& base) {
+  std::vector<uint8_t> target(base.begin(), base.begin() + 5000);
+  std::vector<uint8_t> inserted = SyntheticImage(300, 7);
+  target.insert(target.end(), inserted.begin() + 1, inserted.end());
+  for (size_t i = 5000; i < 20000; i++) {
+    target.push_back(base[i] + (i % 1000 == 0 ? 1 : 0));
+  }
+  target.insert(target.end(), base.begin() + 22000, base.end());
+  return target;
+}
+
+struct Result {
+  bool ok;
+  bool invalid_op;
+  std::vector<uint8_t> image;
+};
+
+Result Apply(const std::vector<uint8_t>& base, const std::vector<uint8_t>& stream, size_t input_chunk,
+             size_t output_size) {
+  xiaozhi::DeltaPatcher patcher;
+  CHECK(patcher.Init(base.data(), base.size(), output_size));
+  Result result = {true, false, {}};
+  auto sink = [&](const uint8_t* data, size_t length) {
+    CHECK(length > 0 && length <= output_size);
+    result.image.insert(result.image.end(), data, data + length);
+    return true;
+  };
+  for (size_t offset = 0; offset < stream.size() && result.ok; offset += input_chunk) {
+    size_t length = std::min(input_chunk, stream.size() - offset);
+    result.ok = patcher.Feed(stream.data() + offset, length, sink);
+  }
+  result.ok = result.ok && patcher.Finish(sink);
+  result.invalid_op = patcher.invalid_op();
+  return result;
+}
+
+void TestPatch(const std::string& python, const std::string& script, const std::string& dir) {
+  std::vector<uint8_t> base = SyntheticImage(32 * 1024, 3);
+  std::vector<uint8_t> target = EditImage(base);
+  std::string base_path = dir + "/delta_test_base.bin";
+  std::string target_path = dir + "/delta_test_target.bin";
+  std::string patch_path = dir + "/delta_test.patch";
+  WriteFile(base_path, base);
+  WriteFile(target_path, target);
+  Run(Quote(python) + " " + Quote(script) + " " + Quote(base_path) + " " + Quote(target_path) + " -o " +
+      Quote(patch_path));
+
+  // 头部：magic "XZDP"、版本、窗口位数、前瞻位数、保留、基准大小、目标大小、两个 SHA256
+  std::vector<uint8_t> patch = ReadFile(patch_path);
+  CHECK(patch.size() >= 80 && std::string(patch.begin(), patch.begin() + 4) == "XZDP" && patch[4] == 1);
+  CHECK(ReadUint32(&patch[8]) == base.size());
+  CHECK(ReadUint32(&patch[12]) == target.size());
+  // 大部分内容来自基准镜像，补丁远小于目标镜像
+  CHECK(patch.size() < target.size() / 4);
+
+  // 与 OtaWriter 相同：先解压出操作流
+  xiaozhi::HeatshrinkDecoder decoder;
+  CHECK(decoder.Init(patch[5], patch[6], 4096));
+  std::vector<uint8_t> stream;
+  auto sink = [&](const uint8_t* data, size_t length) {
+    stream.insert(stream.end(), data, data + length);
+    return true;
+  };
+  CHECK(decoder.Feed(patch.data() + 80, patch.size() - 80, sink));
+  CHECK(decoder.Finish(sink));
+
+  for (size_t input_chunk : {1, 5, 9, 4096}) {
+    for (size_t output_size : {1, 100, 4096}) {
+      Result result = Apply(base, stream, input_chunk, output_size);
+      CHECK(result.ok && !result.invalid_op);
+      CHECK(result.image == target);
+    }
+  }
+
+  // 操作流在操作中间结束：Finish 失败
+  std::vector<uint8_t> truncated(stream.begin(), stream.end() - 3);
+  Result result = Apply(base, truncated, 4096, 4096);
+  CHECK(!result.ok && !result.invalid_op);
+  truncated.assign(stream.begin(), stream.begin() + 4);
+  result = Apply(base, truncated, 4096, 4096);
+  CHECK(!result.ok && !result.invalid_op);
+}
+
+void TestInvalidOps() {
+  std::vector<uint8_t> base = SyntheticImage(1000, 5);
+
+  std::vector<uint8_t> stream;
+  AppendOp(stream, xiaozhi::DeltaPatcher::kOpInsert, 2, 0xFFFFFFFF);
+  stream.push_back(0x12);
+  stream.push_back(0x34);
+  AppendOp(stream, xiaozhi::DeltaPatcher::kOpAdd, 3, 10);
+  stream.insert(stream.end(), {0, 1, 0xFF});
+  Result result = Apply(base, stream, 1, 16);
+  CHECK(result.ok);
+  CHECK(result.image == std::vector<uint8_t>({0x12, 0x34, base[10], (uint8_t)(base[11] + 1),
+                                              (uint8_t)(base[12] - 1)}));
+
+  // 未知的操作类型
+  stream.clear();
+  AppendOp(stream, 3, 1, 0);
+  stream.push_back(0);
+  result = Apply(base, stream, 4096, 16);
+  CHECK(!result.ok && result.invalid_op);
+
+  // ADD 超出基准镜像，包括 src_offset + length 溢出
+  const uint32_t ranges[][2] = {{1, 1000}, {1000, 1}, {0xFFFFFFFF, 2}};
+  for (const auto& range : ranges) {
+    stream.clear();
+    AppendOp(stream, xiaozhi::DeltaPatcher::kOpAdd, range[0], range[1]);
+    result = Apply(base, stream, 4096, 16);
+    CHECK(!result.ok && result.invalid_op);
+  }
+
+  // sink 失败时停止
+  xiaozhi::DeltaPatcher patcher;
+  CHECK(patcher.Init(base.data(), base.size(), 1));
+  stream.clear();
+  AppendOp(stream, xiaozhi::DeltaPatcher::kOpInsert, 2, 0);
+  stream.insert(stream.end(), {1, 2});
+  int calls = 0;
+  CHECK(!patcher.Feed(stream.data(), stream.size(), [&](const uint8_t*, size_t) {
+    calls++;
+    return false;
+  }));
+  CHECK(calls == 1 && !patcher.invalid_op());
+  CHECK(!patcher.Init(base.data(), base.size(), 0));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CHECK(argc == 4);
+  TestInvalidOps();
+  TestPatch(argv[1], argv[2], argv[3]);
+  std::printf("delta_patcher_test passed\n");
+  return 0;
+}
@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "fast_event.h"
+#include "test_check.h"
+
+using namespace xiaozhi;
+
+namespace {
+
+int64_t g_now_us = 0;
+int64_t NowUs() { return g_now_us; }
+
+using Channel = FastEventChannel<4, 2, &NowUs>;
+
+struct Received {
+  int inline_calls = 0;
+  int deferred_calls = 0;
+  int last_mood = -1;
+  char last_emotion[32] = {};
+};
+
+void OnInline(const FastEvent& event, void* ctx) {
+  auto* received = static_cast<Received*>(ctx);
+  received->inline_calls++;
+  received->last_mood = event.As<EventType::kPetStateChanged>().mood;
+}
+
+void OnDeferred(const FastEvent& event, void* ctx) {
+  auto* received = static_cast<Received*>(ctx);
+  received->deferred_calls++;
+  if (event.type == EventType::kEmotionSet) {
+    std::strcpy(received->last_emotion, event.As<EventType::kEmotionSet>().emotion);
+  } else {
+    received->last_mood = event.As<EventType::kPetStateChanged>().mood;
+  }
+}
+
+EventPayload PetPayload(int mood) {
+  EventPayload payload = {};
+  payload.pet.mood = mood;
+  return payload;
+}
+
+// 内联订阅者在发布时同步调用，没有异步订阅者的事件不进入队列
+void TestInlineAndDeferred() {
+  Channel channel;
+  Received received;
+  bool queued = true;
+
+  // 没有订阅者：只计数
+  CHECK(channel.Publish(EventType::kPetStateChanged, PetPayload(1), queued) && !queued);
+  CHECK(channel.GetCounters(EventType::kPetStateChanged).published == 1);
+
+  CHECK(channel.Subscribe(EventType::kPetStateChanged, OnInline, &received, DispatchMode::kInline));
+  CHECK(channel.Publish(EventType::kPetStateChanged, PetPayload(42), queued) && !queued);
+  CHECK(received.inline_calls == 1 && received.last_mood == 42);
+  CHECK(channel.Drain() == 0);
+
+  Received deferred;
+  CHECK(channel.Subscribe(EventType::kEmotionSet, OnDeferred, &deferred, DispatchMode::kDeferred));
+  EventPayload payload = {};
+  std::strcpy(payload.emotion.emotion, "happy");
+  g_now_us = 1000;
+  CHECK(channel.Publish(EventType::kEmotionSet, payload, queued) && queued);
+  CHECK(deferred.deferred_calls == 0);
+  g_now_us = 1800;
+  CHECK(channel.Drain() == 1);
+  CHECK(deferred.deferred_calls == 1 && std::strcmp(deferred.last_emotion, "happy") == 0);
+
+  FastEventCounters counters = channel.GetCounters(EventType::kEmotionSet);
+  CHECK(counters.published == 1 && counters.dispatched == 1 && counters.dropped == 0);
+  CHECK(counters.max_latency_us == 800 && counters.avg_latency_us == 100);
+
+  channel.ResetCounters();
+  CHECK(channel.GetCounters(EventType::kEmotionSet).published == 0);
+}
+
+// 队列满时立即失败并计入丢弃，不阻塞发布者
+void TestQueueFull() {
+  Channel channel;
+  Received received;
+  bool queued = false;
+  CHECK(channel.Subscribe(EventType::kPetStateChanged, OnDeferred, &received, DispatchMode::kDeferred));
+  for (int i = 0; i < 4; i++) {
+    CHECK(channel.Publish(EventType::kPetStateChanged, PetPayload(i), queued) && queued);
+  }
+  CHECK(!channel.Publish(EventType::kPetStateChanged, PetPayload(99), queued) && !queued);
+  CHECK(channel.GetCounters(EventType::kPetStateChanged).dropped == 1);
+
+  CHECK(channel.Drain() == 4);
+  CHECK(received.deferred_calls == 4 && received.last_mood == 3);
+  CHECK(channel.Publish(EventType::kPetStateChanged, PetPayload(5), queued) && queued);
+  CHECK(channel.Drain() == 1 && received.last_mood == 5);
+}
+
+void TestSubscribeLimits() {
+  Channel channel;
+  Received received;
+  CHECK(!channel.Subscribe(EventType::kUserFeedback, nullptr, nullptr, DispatchMode::kInline));
+  CHECK(!channel.Subscribe(EventType::kCount, OnInline, &received, DispatchMode::kInline));
+  CHECK(channel.Subscribe(EventType::kUserFeedback, OnDeferred, &received, DispatchMode::kDeferred));
+  CHECK(channel.Subscribe(EventType::kUserFeedback, OnDeferred, &received, DispatchMode::kDeferred));
+  CHECK(!channel.Subscribe(EventType::kUserFeedback, OnDeferred, &received, DispatchMode::kDeferred));
+}
+
+// 多个生产者并发写入，唯一的消费者按每个生产者的发布顺序取出全部元素
+void TestMpscRing() {
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 20000;
+  MpscRing<uint32_t, 64> ring;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.emplace_back([&ring, p]() {
+      for (uint32_t i = 0; i < kPerProducer; i++) {
+        uint32_t value = (p << 24) | i;
+        while (!ring.TryPush(value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  uint32_t next[kProducers] = {};
+  int total = 0;
+  while (total < kProducers * kPerProducer) {
+    uint32_t value;
+    if (!ring.TryPop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t producer = value >> 24;
+    CHECK(producer < kProducers);
+    CHECK((value & 0xFFFFFF) == next[producer]);
+    next[producer]++;
+    total++;
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  uint32_t value;
+  CHECK(!ring.TryPop(value));
+}
+
+}  // namespace
+
+int main() {
+  TestInlineAndDeferred();
+  TestQueueFull();
+  TestSubscribeLimits();
+  TestMpscRing();
+  std::printf("fast_event_test passed\n");
+  return 0;
+}
@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+#include "test_files.h"
+#include "utils/heatshrink_decoder.h"
+
+// 用 scripts/ota_compress.py 压缩合成镜像，固件的解压器按不同的输入切分和输出缓冲区大小还原
+//   heatshrink_decoder_test <python> <ota_compress.py> <工作目录>
+
+namespace {
+
+uint32_t ReadUint32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 与 zlib.crc32 相同的多项式
+uint32_t Crc32(const std::vector<uint8_t>& data) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (uint8_t byte : data) {
+    crc ^= byte;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+struct Stream {
+  uint8_t window_bits;
+  uint8_t lookahead_bits;
+  uint32_t size;
+  uint32_t crc;
+  std::vector<uint8_t> data;
+};
+
+Stream Compress(const std::string& python, const std::string& script, const std::string& dir,
+                const std::vector<uint8_t>& image, int window, int lookahead) {
+  std::string input = dir + "/heatshrink_test.bin";
+  std::string output = dir + "/heatshrink_test.hs";
+  WriteFile(input, image);
+  Run(Quote(python) + " " + Quote(script) + " " + Quote(input) + " -o " + Quote(output) +
+      " --window " + std::to_string(window) + " --lookahead " + std::to_string(lookahead));
+
+  // 头部：magic "XZHS"、版本、窗口位数、前瞻位数、保留、原始大小、CRC32
+  std::vector<uint8_t> file = ReadFile(output);
+  CHECK(file.size() >= 16 && std::string(file.begin(), file.begin() + 4) == "XZHS" && file[4] == 1);
+  Stream stream;
+  stream.window_bits = file[5];
+  stream.lookahead_bits = file[6];
+  stream.size = ReadUint32(&file[8]);
+  stream.crc = ReadUint32(&file[12]);
+  stream.data.assign(file.begin() + 16, file.end());
+  CHECK(stream.window_bits == window && stream.lookahead_bits == lookahead);
+  return stream;
+}
+
+std::vector<uint8_t> Decode(const Stream& stream, size_t input_chunk, size_t output_size) {
+  xiaozhi::HeatshrinkDecoder decoder;
+  CHECK(decoder.Init(stream.window_bits, stream.lookahead_bits, output_size));
+  std::vector<uint8_t> output;
+  auto sink = [&](const uint8_t* data, size_t length) {
+    CHECK(length > 0 && length <= output_size);
+    output.insert(output.end(), data, data + length);
+    return true;
+  };
+  for (size_t offset = 0; offset < stream.data.size(); offset += input_chunk) {
+    size_t length = std::min(input_chunk, stream.data.size() - offset);
+    CHECK(decoder.Feed(stream.data.data() + offset, length, sink));
+  }
+  CHECK(decoder.Finish(sink));
+  return output;
+}
+
+void TestRoundTrip(const std::string& python, const std::string& script, const std::string& dir) {
+  std::vector<uint8_t> image = SyntheticImage(24 * 1024 + 37, 1);
+  CHECK(Crc32({'1', '2', '3', '4', '5', '6', '7', '8', '9'}) == 0xCBF43926);
+
+  const int params[][2] = {{12, 4}, {8, 4}, {15, 7}};
+  for (const auto& param : params) {
+    Stream stream = Compress(python, script, dir, image, param[0], param[1]);
+    CHECK(stream.size == image.size());
+    CHECK(stream.crc == Crc32(image));
+    CHECK(stream.data.size() < image.size());
+    for (size_t input_chunk : {1, 7, 4096}) {
+      for (size_t output_size : {1, 100, 4096}) {
+        CHECK(Decode(stream, input_chunk, output_size) == image);
+      }
+    }
+  }
+}
+
+void TestSinkStops() {
+  // 标志位 1 + 字面量 'A'、'B'，末尾补零
+  Stream stream;
+  stream.window_bits = 8;
+  stream.lookahead_bits = 4;
+  stream.data = {0xA0, 0xD0, 0x80};
+  xiaozhi::HeatshrinkDecoder decoder;
+  CHECK(decoder.Init(stream.window_bits, stream.lookahead_bits, 1));
+  int calls = 0;
+  CHECK(!decoder.Feed(stream.data.data(), stream.data.size(), [&](const uint8_t* data, size_t) {
+    CHECK(data[0] == 'A');
+    calls++;
+    return false;
+  }));
+  CHECK(calls == 1);
+  CHECK(Decode(stream, 1, 4) == std::vector<uint8_t>({'A', 'B'}));
+
+  CHECK(!decoder.Init(3, 2, 16));
+  CHECK(!decoder.Init(8, 8, 16));
+  CHECK(!decoder.Init(8, 4, 0));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  CHECK(argc == 4);
+  TestSinkStops();
+  TestRoundTrip(argv[1], argv[2], argv[3]);
+  std::printf("heatshrink_decoder_test passed\n");
+  return 0;
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "mbedtls/base64.h"
+#include "mcp_result_writer.h"
+#include "test_check.h"
+
+// 工具结果写入器：JSON 转义、图片在缓冲区中的截断位置，以及按协议层方式拼接后的完整回复
+
+namespace {
+
+std::string Base64(const std::string& data) {
+  std::string out(ImageContent::EncodedSize(data.size()) + 1, '\0');
+  size_t olen = 0;
+  CHECK(mbedtls_base64_encode((unsigned char*)&out[0], out.size(), &olen, (const unsigned char*)data.data(),
+                              data.size()) == 0);
+  out.resize(olen);
+  return out;
+}
+
+// 与 Protocol::SendMcpMessage(head, data, tail) 相同：图片数据在发送时编码到 head 和 tail 之间
+std::string Assemble(const std::string& head, McpResultWriter& writer) {
+  if (writer.image() == nullptr) {
+    return head;
+  }
+  return head + Base64(writer.image()->data()) + writer.tail();
+}
+
+void TestEscaping() {
+  static const char kText[] = "a\"b\\c\nd\re\tf\x01\x1f/\xe4\xbd\xa0";
+  std::string out;
+  McpResultWriter::AppendJsonString(out, kText, sizeof(kText) - 1);
+  CHECK(out == "\"a\\\"b\\\\c\\nd\\re\\tf\\u0001\\u001f/\xe4\xbd\xa0\"");
+
+  std::string zero;
+  McpResultWriter::AppendEscaped(zero, "x\0y", 3);
+  CHECK(zero == "x\\u0000y");
+}
+
+void TestTextResults() {
+  std::string out;
+  McpResultWriter writer(out);
+  std::string error;
+  CHECK(writer.Finish(error));
+  CHECK(out == "{\"content\":[{\"type\":\"text\",\"text\":\"true\"}],\"isError\":false}");
+
+  out.clear();
+  McpResultWriter values(out);
+  values.Bool(false);
+  values.Int(-42);
+  values.Text("say \"hi\"");
+  CHECK(values.Finish(error));
+  CHECK(out ==
+        "{\"content\":[{\"type\":\"text\",\"text\":\"false\"},{\"type\":\"text\",\"text\":\"-42\"},"
+        "{\"type\":\"text\",\"text\":\"say \\\"hi\\\"\"}],\"isError\":false}");
+  CHECK(values.image() == nullptr && values.tail().empty());
+
+  out.clear();
+  McpResultWriter failed(out);
+  failed.Text("partial");
+  failed.Error("camera busy");
+  CHECK(!failed.Finish(error));
+  CHECK(error == "camera busy");
+}
+
+// 第一张图片的数据不进入缓冲区，之后的内容写入 tail；第二张图片直接编码进 tail
+void TestImages() {
+  static const char kJpeg[] = "\xff\xd8\xff\xe0\x00\x10JFIF\x00\x01\xff\xd9";
+  static const char kPng[] = "\x89PNG\r\n\x1a\n";
+  const std::string jpeg(kJpeg, sizeof(kJpeg) - 1);
+  const std::string png(kPng, sizeof(kPng) - 1);
+  CHECK(Base64("fo") == "Zm8=" && Base64("foobar") == "Zm9vYmFy");
+
+  std::string out;
+  McpResultWriter writer(out);
+  writer.Text("before");
+  writer.Image(std::make_unique<ImageContent>("image/jpeg", jpeg));
+  writer.Text("after");
+  writer.Image(std::make_unique<ImageContent>("image/png", png));
+  std::string error;
+  CHECK(writer.Finish(error));
+
+  // 缓冲区停在第一张图片的 data 字段开头
+  const std::string image_head = "{\"type\":\"image\",\"image\":\"{\\\"type\\\":\\\"image\\\",\\\"mimeType\\\":";
+  CHECK(out == "{\"content\":[{\"type\":\"text\",\"text\":\"before\"}," + image_head +
+                   "\\\"image/jpeg\\\",\\\"data\\\":\\\"");
+  CHECK(writer.image() != nullptr && writer.image()->data() == jpeg);
+
+  std::string expected = "{\"content\":[{\"type\":\"text\",\"text\":\"before\"}," + image_head +
+                         "\\\"image/jpeg\\\",\\\"data\\\":\\\"" + Base64(jpeg) +
+                         "\\\"}\"},{\"type\":\"text\",\"text\":\"after\"}," + image_head +
+                         "\\\"image/png\\\",\\\"data\\\":\\\"" + Base64(png) + "\\\"}\"}],\"isError\":false}";
+  CHECK(Assemble(out, writer) == expected);
+}
+
+}  // namespace
+
+int main() {
+  TestEscaping();
+  TestTextResults();
+  TestImages();
+  std::printf("mcp_result_writer_test passed\n");
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "cJSON.h"
+#include "mcp_tool.h"
+#include "test_check.h"
+
+// 类型化工具的参数绑定：默认值、缺少参数、类型不匹配和范围错误，与 PropertyList 工具的行为一致
+
+namespace {
+
+struct WalkArgs {
+  int steps;
+  int speed;
+  bool loud;
+  std::string style;
+};
+
+TypedMcpTool<WalkArgs>* MakeTypedTool() {
+  return new TypedMcpTool<WalkArgs>(
+      "self.robot.walk", "Walk",
+      {McpArg("steps", &WalkArgs::steps, 1, 100), McpArg("speed", &WalkArgs::speed, 500, 400, 1500),
+       McpArg("loud", &WalkArgs::loud, false), McpArg("style", &WalkArgs::style, "normal")},
+      [](const WalkArgs& args, McpResultWriter& result) {
+        result.Text(std::to_string(args.steps) + "/" + std::to_string(args.speed) + "/" +
+                    (args.loud ? "loud" : "quiet") + "/" + args.style);
+      });
+}
+
+McpTool* MakeLegacyTool() {
+  PropertyList properties({Property("steps", kPropertyTypeInteger, 1, 100),
+                           Property("speed", kPropertyTypeInteger, 500, 400, 1500),
+                           Property("loud", kPropertyTypeBoolean, false),
+                           Property("style", kPropertyTypeString, std::string("normal"))});
+  return new McpTool("self.robot.walk", "Walk", properties, [](const PropertyList& properties) -> ReturnValue {
+    return std::to_string(properties["steps"].value<int>()) + "/" +
+           std::to_string(properties["speed"].value<int>()) + "/" +
+           (properties["loud"].value<bool>() ? "loud" : "quiet") + "/" + properties["style"].value<std::string>();
+  });
+}
+
+// 绑定并执行一次调用：成功时返回工具写出的文本，失败时返回 "error: " 加错误信息
+std::string Call(McpTool* tool, const char* arguments) {
+  cJSON* json = arguments != nullptr ? cJSON_Parse(arguments) : nullptr;
+  CHECK(arguments == nullptr || json != nullptr);
+  std::string error;
+  auto call = tool->Bind(json, error);
+  cJSON_Delete(json);
+  if (call == nullptr) {
+    CHECK(!error.empty());
+    return "error: " + error;
+  }
+
+  std::string out;
+  McpResultWriter result(out);
+  call->Invoke(result);
+  CHECK(result.Finish(error));
+  const std::string prefix = "{\"content\":[{\"type\":\"text\",\"text\":\"";
+  const std::string suffix = "\"}],\"isError\":false}";
+  CHECK(out.compare(0, prefix.size(), prefix) == 0);
+  CHECK(out.size() >= prefix.size() + suffix.size());
+  return out.substr(prefix.size(), out.size() - prefix.size() - suffix.size());
+}
+
+struct Case {
+  const char* arguments;
+  const char* expected;
+};
+
+const Case kCases[] = {
+    // 只给必填参数，其余取默认值
+    {"{\"steps\":3}", "3/500/quiet/normal"},
+    {"{\"steps\":100,\"speed\":1500,\"loud\":true,\"style\":\"run\"}", "100/1500/loud/run"},
+    // 未知参数被忽略，参数顺序无关
+    {"{\"style\":\"a \\\"b\\\"\",\"extra\":1,\"steps\":1,\"speed\":400}", "1/400/quiet/a \\\"b\\\""},
+    // 缺少必填参数
+    {"{\"speed\":600}", "error: Missing valid argument: steps"},
+    {"{}", "error: Missing valid argument: steps"},
+    {"[1,2]", "error: Missing valid argument: steps"},
+    {nullptr, "error: Missing valid argument: steps"},
+    // 类型不匹配的参数视为未提供：必填参数报错，可选参数取默认值
+    {"{\"steps\":\"3\"}", "error: Missing valid argument: steps"},
+    {"{\"steps\":true}", "error: Missing valid argument: steps"},
+    {"{\"steps\":null}", "error: Missing valid argument: steps"},
+    {"{\"steps\":2,\"speed\":\"fast\",\"loud\":1,\"style\":7}", "2/500/quiet/normal"},
+    // 范围检查包含端点
+    {"{\"steps\":0}", "error: Value is below minimum allowed: 1"},
+    {"{\"steps\":101}", "error: Value exceeds maximum allowed: 100"},
+    {"{\"steps\":5,\"speed\":399}", "error: Value is below minimum allowed: 400"},
+    {"{\"steps\":5,\"speed\":1501}", "error: Value exceeds maximum allowed: 1500"},
+};
+
+void TestBinding() {
+  std::unique_ptr<McpTool> typed(MakeTypedTool());
+  std::unique_ptr<McpTool> legacy(MakeLegacyTool());
+  for (const auto& c : kCases) {
+    std::string result = Call(typed.get(), c.arguments);
+    if (result != c.expected) {
+      std::fprintf(stderr, "%s: got '%s', expected '%s'\n", c.arguments ? c.arguments : "(null)", result.c_str(),
+                   c.expected);
+    }
+    CHECK(result == c.expected);
+    CHECK(Call(legacy.get(), c.arguments) == result);
+  }
+
+  // 每次绑定都从默认值开始，不会残留上一次调用的参数
+  CHECK(Call(typed.get(), "{\"steps\":9,\"loud\":true,\"style\":\"x\"}") == "9/500/loud/x");
+  CHECK(Call(typed.get(), "{\"steps\":9}") == "9/500/quiet/normal");
+
+  // 调用在解析后的消息释放之后才执行，字符串参数必须已经复制
+  cJSON* json = cJSON_Parse("{\"steps\":4,\"style\":\"copied\"}");
+  std::string error;
+  auto call = typed->Bind(json, error);
+  cJSON_Delete(json);
+  CHECK(call != nullptr);
+  std::string out;
+  McpResultWriter result(out);
+  call->Invoke(result);
+  CHECK(result.Finish(error));
+  CHECK(out.find("4/500/quiet/copied") != std::string::npos);
+}
+
+// 注册时由参数描述生成的 schema 与等价的 PropertyList 相同
+void TestSchema() {
+  std::unique_ptr<McpTool> typed(MakeTypedTool());
+  std::unique_ptr<McpTool> legacy(MakeLegacyTool());
+  CHECK(typed->to_json() == legacy->to_json());
+  CHECK(typed->to_json() ==
+        "{\"name\":\"self.robot.walk\",\"description\":\"Walk\",\"inputSchema\":{\"type\":\"object\",\"properties\":{"
+        "\"steps\":{\"type\":\"integer\",\"minimum\":1,\"maximum\":100},"
+        "\"speed\":{\"type\":\"integer\",\"default\":500,\"minimum\":400,\"maximum\":1500},"
+        "\"loud\":{\"type\":\"boolean\",\"default\":false},"
+        "\"style\":{\"type\":\"string\",\"default\":\"normal\"}},"
+        "\"required\":[\"steps\"]}}");
+}
+
+}  // namespace
+
+int main() {
+  TestBinding();
+  TestSchema();
+  std::printf("mcp_tool_test passed\n");
+  return 0;
+}
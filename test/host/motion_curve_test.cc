@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "motion_curve.h"
+#include "test_check.h"
+
+// 运动引擎的 Q15 定点曲线：与浮点参考的误差、端点和段求值
+
+namespace {
+
+void TestSin() {
+  // 256 点线性插值：误差不超过 4/32767
+  for (int phase = 0; phase < 65536; phase += 97) {
+    double expected = std::sin(2 * M_PI * phase / 65536.0) * 32767;
+    CHECK(std::fabs(MotionCurve::Sin((uint16_t)phase) - expected) <= 4);
+  }
+  CHECK(MotionCurve::Sin(0) == 0);
+  CHECK(MotionCurve::Sin(16384) == 32767);
+  CHECK(MotionCurve::Sin(49152) == -32767);
+
+  CHECK(MotionCurve::PhaseFromRadians(0) == 0);
+  CHECK(MotionCurve::PhaseFromRadians(M_PI) == 32768);
+  CHECK(MotionCurve::PhaseFromRadians(-M_PI / 2) == 49152);
+  CHECK(MotionCurve::PhaseFromRadians(5 * M_PI / 2) == 16384);
+}
+
+void TestEase() {
+  for (int ease = 0; ease < kMotionEaseCount; ease++) {
+    // 起点和终点精确，超出范围时截断
+    CHECK(MotionCurve::Ease((MotionEase)ease, 0) == 0);
+    CHECK(MotionCurve::Ease((MotionEase)ease, -100) == 0);
+    CHECK(MotionCurve::Ease((MotionEase)ease, 32768) == 32768);
+    CHECK(MotionCurve::Ease((MotionEase)ease, 40000) == 32768);
+  }
+  for (int32_t t = 0; t < 32768; t += 128) {
+    double x = t / 32768.0;
+    CHECK(std::abs(MotionCurve::Ease(kMotionEaseLinear, t) - t) <= 1);
+    CHECK(std::fabs(MotionCurve::Ease(kMotionEaseIn, t) - x * x * x * 32767) < 80);
+    double out = 1 - (1 - x) * (1 - x) * (1 - x);
+    CHECK(std::fabs(MotionCurve::Ease(kMotionEaseOut, t) - out * 32767) < 80);
+  }
+  // 单调的曲线不回退，回弹曲线会越过终点
+  int32_t previous = 0;
+  int32_t peak = 0;
+  for (int32_t t = 0; t <= 32768; t += 64) {
+    int32_t value = MotionCurve::Ease(kMotionEaseInOut, t);
+    CHECK(value >= previous);
+    previous = value;
+    peak = std::max(peak, MotionCurve::Ease(kMotionEaseOutBack, t));
+  }
+  CHECK(peak > 32768);
+  CHECK(MotionCurve::Ease(kMotionEaseInBack, 8192) < 0);
+  // 未知曲线按 in_out 处理
+  CHECK(MotionCurve::Ease(kMotionEaseCount, 10000) == MotionCurve::Ease(kMotionEaseInOut, 10000));
+}
+
+void TestEvaluate() {
+  MotionSegment move;
+  move.type = kMotionMove;
+  move.ease = kMotionEaseLinear;
+  move.duration_ms = 1000;
+  move.target[0] = 150;
+  move.target[1] = 0;
+  int16_t start[MOTION_MAX_SERVOS] = {30, 180};
+  CHECK(MotionCurve::Evaluate(move, start, 0, 0) == 30);
+  CHECK(MotionCurve::Evaluate(move, start, 500 * 1000, 0) == 90);
+  CHECK(MotionCurve::Evaluate(move, start, 500 * 1000, 1) == 90);
+  CHECK(MotionCurve::Evaluate(move, start, 1000 * 1000, 0) == 150);
+  CHECK(MotionCurve::Evaluate(move, start, 1000 * 1000, 1) == 0);
+  CHECK(MotionCurve::Evaluate(move, start, 5000 * 1000, 0) == 150);
+  CHECK(MotionCurve::EndsAtTarget(kMotionMove) && !MotionCurve::EndsAtTarget(kMotionOscillate));
+
+  MotionSegment oscillate;
+  oscillate.type = kMotionOscillate;
+  oscillate.duration_ms = 2000;
+  oscillate.period_ms = 400;
+  oscillate.amplitude[0] = 30;
+  oscillate.offset[0] = -10;
+  oscillate.phase[0] = 16384;
+  CHECK(MotionCurve::Evaluate(oscillate, start, 0, 0) == 110);
+  CHECK(MotionCurve::Evaluate(oscillate, start, 100 * 1000, 0) == 80);
+  CHECK(MotionCurve::Evaluate(oscillate, start, 200 * 1000, 0) == 50);
+  // 按周期循环，段结束后继续振荡
+  CHECK(MotionCurve::Evaluate(oscillate, start, 2600 * 1000, 0) == 50);
+
+  MotionSegment hold;
+  hold.type = kMotionHold;
+  hold.duration_ms = 100;
+  CHECK(MotionCurve::Evaluate(hold, start, 50 * 1000, 1) == 180);
+}
+
+}  // namespace
+
+int main() {
+  TestSin();
+  TestEase();
+  TestEvaluate();
+  std::printf("motion_curve_test passed\n");
+  return 0;
+}
@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <string>
+
+#include "esp_timer.h"
+#include "motion_safety.h"
+#include "test_check.h"
+
+namespace {
+
+// Otto/Dog 的电量校准：ADC 2150 为 0%，换算后约 3254mV
+constexpr int kEmptyMv = 3254;
+
+int g_supply_mv = 0;
+
+struct Rig {
+  MotionSafety safety;
+  int64_t now_us = 1000000;
+  int16_t current[MOTION_MAX_SERVOS] = {};
+
+  explicit Rig(int servos) : safety(servos) {
+    for (auto& position : current) {
+      position = 90;
+    }
+    safety.SetSupplyVoltageSource([]() { return g_supply_mv; }, kEmptyMv);
+  }
+
+  // 推进一个节拍，返回各舵机这一节拍的步长
+  uint16_t Tick(int16_t* positions, uint16_t mask) {
+    now_us += MOTION_TICK_MS * 1000;
+    FakeTimeUs() = now_us;
+    uint16_t output = safety.Apply(positions, current, mask, now_us);
+    for (int i = 0; i < MOTION_MAX_SERVOS; i++) {
+      if (output & (1 << i)) {
+        current[i] = positions[i];
+      }
+    }
+    return output;
+  }
+
+  void Idle(int ms) {
+    int16_t positions[MOTION_MAX_SERVOS] = {};
+    for (int t = 0; t < ms; t += MOTION_TICK_MS) {
+      Tick(positions, 0);
+    }
+  }
+
+  int ScalePct() const {
+    std::string json = safety.GetTelemetryJson();
+    size_t pos = json.find("\"supply_scale_pct\":");
+    CHECK(pos != std::string::npos);
+    return std::atoi(json.c_str() + pos + 19);
+  }
+};
+
+// 静止电压由电量决定：满电和半电的电池都不降额
+void TestRestingVoltageIsNotDerated() {
+  for (int mv : {4100, 3709, 3480, 3300}) {
+    g_supply_mv = mv;
+    Rig rig(4);
+    rig.Idle(5000);
+    CHECK(rig.ScalePct() == 100);
+  }
+}
+
+void TestSagDerates() {
+  g_supply_mv = 3600;
+  Rig rig(4);
+  rig.Idle(5000);
+  CHECK(rig.ScalePct() == 100);
+
+  // 跌落 50mV 在门限内
+  g_supply_mv = 3550;
+  rig.Idle(200);
+  CHECK(rig.ScalePct() == 100);
+
+  // 跌落 200mV：从 sag_warn 到 sag_limit 的中点，额度约为 (100% + 37.5%) / 2
+  g_supply_mv = 3400;
+  rig.Idle(100);
+  int scale = rig.ScalePct();
+  CHECK(scale >= 66 && scale <= 70);
+
+  // 降额期间单个舵机的步长按额度缩小
+  int16_t positions[MOTION_MAX_SERVOS] = {};
+  positions[0] = 170;
+  int before = rig.current[0];
+  rig.Tick(positions, 1);
+  int step = rig.current[0] - before;
+  CHECK(step > 0 && step < MotionSafety::Config().max_step);
+
+  // 跌落 300mV 以上降到最低额度
+  g_supply_mv = 3280;
+  rig.Idle(100);
+  CHECK(rig.ScalePct() == 37);
+
+  // 电压回升后逐步恢复，不会一个采样就跳回满额
+  g_supply_mv = 3600;
+  rig.Idle(100);
+  int recovering = rig.ScalePct();
+  CHECK(recovering > 37 && recovering < 100);
+  rig.Idle(3000);
+  CHECK(rig.ScalePct() == 100);
+}
+
+// 低于电池空电电压时无论有没有跌落都降到最低额度
+void TestBelowEmptyDerates() {
+  g_supply_mv = kEmptyMv - 20;
+  Rig rig(4);
+  rig.Idle(2000);
+  CHECK(rig.ScalePct() == 37);
+}
+
+void TestStepAndBudget() {
+  g_supply_mv = 0;
+  Rig rig(6);
+  int16_t positions[MOTION_MAX_SERVOS] = {};
+  for (int i = 0; i < 6; i++) {
+    positions[i] = 170;
+  }
+  // 6 个舵机同时启动：每个最多 12 度，总和不超过 48 度
+  rig.Tick(positions, 0x3F);
+  int total = 0;
+  for (int i = 0; i < 6; i++) {
+    int step = rig.current[i] - 90;
+    CHECK(step > 0 && step <= 12);
+    total += step;
+  }
+  CHECK(total <= 48);
+  CHECK(!rig.safety.IsSettled());
+
+  // 不再下发新位置，限幅器继续把舵机送到目标
+  int16_t none[MOTION_MAX_SERVOS] = {};
+  for (int tick = 0; tick < 100 && !rig.safety.IsSettled(); tick++) {
+    rig.Tick(none, 0);
+  }
+  CHECK(rig.safety.IsSettled());
+  for (int i = 0; i < 6; i++) {
+    CHECK(rig.current[i] == 170);
+  }
+}
+
+}  // namespace
+
+int main() {
+  TestRestingVoltageIsNotDerated();
+  TestSagDerates();
+  TestBelowEmptyDerates();
+  TestStepAndBudget();
+  std::printf("motion_safety_test passed\n");
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "snapshot_codec.h"
+#include "test_check.h"
+
+using namespace xiaozhi::snapshot;
+
+namespace {
+
+std::vector<Section> MakeSections() {
+  SectionWriter pet;
+  pet.PutU8(1, 7);
+  pet.PutI32(2, -12345);
+  pet.PutF32(3, 61.25f);
+  pet.PutString(4, "cat");
+
+  SectionWriter profile;
+  const uint32_t bins[3] = {1, 0x01020304, 0xFFFFFFFF};
+  profile.PutU16(1, 0xBEEF);
+  profile.PutI64(2, -1234567890123LL);
+  profile.PutU32Array(3, bins, 3);
+
+  return {{1, 2, pet.data()}, {2, 1, profile.data()}};
+}
+
+void TestRoundTrip() {
+  std::vector<uint8_t> blob;
+  CHECK(Encode(MakeSections(), 42, blob));
+  CHECK(blob.size() > kHeaderSize);
+
+  std::vector<Section> sections;
+  uint32_t sequence = 0;
+  CHECK(Decode(blob.data(), blob.size(), sections, sequence));
+  CHECK(sequence == 42);
+  CHECK(sections.size() == 2);
+  CHECK(sections[0].id == 1 && sections[0].schema == 2);
+  CHECK(sections[1].id == 2 && sections[1].schema == 1);
+
+  SectionReader pet(sections[0].schema, sections[0].data.data(), sections[0].data.size());
+  uint8_t u8 = 0;
+  int32_t i32 = 0;
+  float f32 = 0;
+  std::string str;
+  CHECK(pet.GetU8(1, u8) && u8 == 7);
+  CHECK(pet.GetI32(2, i32) && i32 == -12345);
+  CHECK(pet.GetF32(3, f32) && f32 == 61.25f);
+  CHECK(pet.GetString(4, str) && str == "cat");
+  // 缺失的字段返回 false，调用方保持默认值
+  CHECK(!pet.GetU8(9, u8));
+
+  SectionReader profile(sections[1].schema, sections[1].data.data(),
+                        sections[1].data.size());
+  uint16_t u16 = 0;
+  int64_t i64 = 0;
+  uint32_t bins[3] = {};
+  CHECK(profile.GetU16(1, u16) && u16 == 0xBEEF);
+  CHECK(profile.GetI64(2, i64) && i64 == -1234567890123LL);
+  CHECK(profile.GetU32Array(3, bins, 3));
+  CHECK(bins[0] == 1 && bins[1] == 0x01020304 && bins[2] == 0xFFFFFFFF);
+  // 元素个数不符时不读取
+  CHECK(!profile.GetU32Array(3, bins, 2));
+}
+
+void TestLittleEndianLayout() {
+  SectionWriter writer;
+  const uint32_t value = 0x11223344;
+  writer.PutU32Array(5, &value, 1);
+  const std::vector<uint8_t> expected = {5, 4, 0x44, 0x33, 0x22, 0x11};
+  CHECK(writer.data() == expected);
+
+  std::vector<uint8_t> blob;
+  CHECK(Encode({}, 0x01020304, blob));
+  CHECK(blob.size() == kHeaderSize);
+  CHECK(std::memcmp(blob.data(), "CSNP", 4) == 0);
+  CHECK(blob[8] == 0x04 && blob[11] == 0x01);
+}
+
+void TestCorruption() {
+  std::vector<uint8_t> blob;
+  CHECK(Encode(MakeSections(), 7, blob));
+
+  std::vector<Section> sections;
+  uint32_t sequence = 0;
+  // 任意一位翻转都必须被拒绝
+  for (size_t i = 0; i < blob.size(); i++) {
+    for (int bit = 0; bit < 8; bit++) {
+      std::vector<uint8_t> bad = blob;
+      bad[i] ^= 1 << bit;
+      CHECK(!Decode(bad.data(), bad.size(), sections, sequence));
+    }
+  }
+  // 任意截断都必须被拒绝
+  for (size_t length = 0; length < blob.size(); length++) {
+    CHECK(!Decode(blob.data(), length, sections, sequence));
+  }
+  CHECK(!Decode(nullptr, 0, sections, sequence));
+}
+
+void TestOversize() {
+  // 超过 255 字节的字段不能被截断写入
+  SectionWriter writer;
+  std::string small(kMaxFieldLength, 'a');
+  writer.PutString(1, small);
+  CHECK(writer.ok());
+  writer.PutString(2, std::string(kMaxFieldLength + 1, 'b'));
+  CHECK(!writer.ok());
+  SectionReader reader(1, writer.data().data(), writer.data().size());
+  std::string str;
+  CHECK(reader.GetString(1, str) && str == small);
+  CHECK(!reader.GetString(2, str));
+
+  // 超过 u16 的 section 不能被悄悄截短长度
+  SectionWriter big;
+  std::string field(kMaxFieldLength, 'c');
+  for (int i = 0; i < 300; i++) {
+    big.PutString(static_cast<uint8_t>(i), field);
+  }
+  CHECK(!big.ok());
+  std::vector<uint8_t> blob = {1, 2, 3};
+  CHECK(!Encode({{1, 1, big.data()}}, 1, blob));
+  CHECK(blob.size() == 3);
+
+  std::vector<Section> many(kMaxSections + 1);
+  CHECK(!Encode(many, 1, blob));
+}
+
+}  // namespace
+
+int main() {
+  TestRoundTrip();
+  TestLittleEndianLayout();
+  TestCorruption();
+  TestOversize();
+  std::printf("snapshot_codec_test passed\n");
+  return 0;
+}
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "esp_timer.h"
+#include "speech_analyzer.h"
+#include "test_check.h"
+
+namespace {
+
+constexpr int kRate = 16000;
+
+std::vector<int16_t> Tone(double hz, double amplitude, int samples, int& phase) {
+  std::vector<int16_t> pcm(samples);
+  for (int i = 0; i < samples; i++, phase++) {
+    pcm[i] = (int16_t)std::lround(amplitude * std::sin(2 * M_PI * hz * phase / kRate));
+  }
+  return pcm;
+}
+
+// 帧长不是 20ms 的整数倍时，分析帧跨越帧边界，返回的偏移指向它真正开始的位置
+void TestHopOffsets() {
+  SpeechAnalyzer analyzer;
+  analyzer.Configure(kRate);
+  int phase = 0;
+
+  // 10ms 帧：每两帧完成一个分析帧，它从上一帧开头开始
+  for (int frame = 0; frame < 6; frame++) {
+    std::vector<uint32_t> hops;
+    auto pcm = Tone(200, 8000, kRate / 100, phase);
+    int offset = analyzer.Process(pcm.data(), pcm.size(), hops);
+    if (frame % 2 == 0) {
+      CHECK(hops.empty() && offset == 0);
+    } else {
+      CHECK(hops.size() == 1 && offset == -10);
+    }
+  }
+
+  // 30ms 帧：交替完成一个和两个分析帧
+  analyzer.Reset();
+  const int expected_hops[] = {1, 2, 1, 2};
+  const int expected_offset[] = {0, -10, 0, -10};
+  for (int frame = 0; frame < 4; frame++) {
+    std::vector<uint32_t> hops;
+    auto pcm = Tone(200, 8000, kRate * 3 / 100, phase);
+    int offset = analyzer.Process(pcm.data(), pcm.size(), hops);
+    CHECK((int)hops.size() == expected_hops[frame]);
+    CHECK(offset == expected_offset[frame]);
+  }
+}
+
+void TestFeatures() {
+  SpeechAnalyzer analyzer;
+  analyzer.Configure(kRate);
+  int phase = 0;
+  std::vector<uint32_t> hops;
+  auto pcm = Tone(200, 8000, kRate / 5, phase);
+  analyzer.Process(pcm.data(), pcm.size(), hops);
+  CHECK(hops.size() == 10);
+  SpeechFeatures last = SpeechAnalyzer::Unpack(hops.back());
+  CHECK(last.active);
+  CHECK(last.level > 128);
+  CHECK(last.pitch_hz >= 190 && last.pitch_hz <= 210);
+
+  hops.clear();
+  std::vector<int16_t> silence(kRate / 10, 0);
+  analyzer.Process(silence.data(), silence.size(), hops);
+  CHECK(hops.size() == 5);
+  SpeechFeatures quiet = SpeechAnalyzer::Unpack(hops.back());
+  CHECK(!quiet.active && quiet.level == 0 && quiet.pitch_hz == 0);
+
+  SpeechFeatures features;
+  features.level = 200;
+  features.pitch_hz = 1500;
+  features.onset_count = 77;
+  features.active = true;
+  SpeechFeatures unpacked = SpeechAnalyzer::Unpack(SpeechAnalyzer::Pack(features));
+  CHECK(unpacked.level == 200 && unpacked.pitch_hz == 1023);
+  CHECK(unpacked.onset_count == 77 && unpacked.active);
+}
+
+// 读者按发布的开始时间选取分析帧，开始时间早于帧开头时不会错位
+void TestChannelUsesHopStart() {
+  SpeechFeatureChannel channel;
+  SpeechFeatures first;
+  first.level = 10;
+  first.active = true;
+  SpeechFeatures second;
+  second.level = 20;
+  second.active = true;
+  const uint32_t hops[] = {SpeechAnalyzer::Pack(first), SpeechAnalyzer::Pack(second)};
+
+  int64_t frame_start_us = 5000000;
+  channel.Publish(frame_start_us - 10 * 1000, hops, 2);
+
+  SpeechFeatures out;
+  FakeTimeUs() = frame_start_us + 5 * 1000;
+  CHECK(channel.Read(out) && out.level == 10);
+  FakeTimeUs() = frame_start_us + 15 * 1000;
+  CHECK(channel.Read(out) && out.level == 20);
+  // 播放停止超过 2 个分析帧后不再报告
+  FakeTimeUs() = frame_start_us + 90 * 1000;
+  CHECK(!channel.Read(out));
+
+  channel.Clear();
+  FakeTimeUs() = frame_start_us;
+  CHECK(!channel.Read(out));
+}
+
+}  // namespace
+
+int main() {
+  TestHopOffsets();
+  TestFeatures();
+  TestChannelUsesHopStart();
+  std::printf("speech_analyzer_test passed\n");
+  return 0;
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <strings.h>
+
+// 主机端替身：cJSON 的一个子集，节点结构、类型位和接口语义与 cJSON 相同
+
+#define cJSON_Invalid (0)
+#define cJSON_False (1 << 0)
+#define cJSON_True (1 << 1)
+#define cJSON_NULL (1 << 2)
+#define cJSON_Number (1 << 3)
+#define cJSON_String (1 << 4)
+#define cJSON_Array (1 << 5)
+#define cJSON_Object (1 << 6)
+
+typedef int cJSON_bool;
+
+typedef struct cJSON {
+  struct cJSON* next;
+  struct cJSON* prev;
+  struct cJSON* child;
+  int type;
+  char* valuestring;
+  int valueint;
+  double valuedouble;
+  char* string;
+} cJSON;
+
+inline cJSON* cJSON_New(int type) {
+  cJSON* item = static_cast<cJSON*>(std::calloc(1, sizeof(cJSON)));
+  item->type = type;
+  return item;
+}
+
+inline char* cJSON_Strdup(const char* text) {
+  size_t length = std::strlen(text) + 1;
+  char* copy = static_cast<char*>(std::malloc(length));
+  std::memcpy(copy, text, length);
+  return copy;
+}
+
+inline void cJSON_Delete(cJSON* item) {
+  while (item != nullptr) {
+    cJSON* next = item->next;
+    cJSON_Delete(item->child);
+    std::free(item->valuestring);
+    std::free(item->string);
+    std::free(item);
+    item = next;
+  }
+}
+
+inline void cJSON_free(void* object) { std::free(object); }
+
+inline cJSON* cJSON_CreateObject() { return cJSON_New(cJSON_Object); }
+inline cJSON* cJSON_CreateArray() { return cJSON_New(cJSON_Array); }
+inline cJSON* cJSON_CreateNull() { return cJSON_New(cJSON_NULL); }
+inline cJSON* cJSON_CreateBool(cJSON_bool value) { return cJSON_New(value ? cJSON_True : cJSON_False); }
+
+inline cJSON* cJSON_CreateNumber(double number) {
+  cJSON* item = cJSON_New(cJSON_Number);
+  item->valuedouble = number;
+  item->valueint = number >= 2147483647.0 ? 2147483647 : number <= -2147483648.0 ? -2147483647 - 1 : (int)number;
+  return item;
+}
+
+inline cJSON* cJSON_CreateString(const char* text) {
+  cJSON* item = cJSON_New(cJSON_String);
+  item->valuestring = cJSON_Strdup(text);
+  return item;
+}
+
+inline cJSON_bool cJSON_AddItemToArray(cJSON* array, cJSON* item) {
+  if (array == nullptr || item == nullptr) {
+    return 0;
+  }
+  if (array->child == nullptr) {
+    array->child = item;
+    item->prev = item;
+    return 1;
+  }
+  // 与 cJSON 相同：第一个子节点的 prev 指向最后一个
+  cJSON* last = array->child->prev;
+  last->next = item;
+  item->prev = last;
+  array->child->prev = item;
+  return 1;
+}
+
+inline cJSON_bool cJSON_AddItemToObject(cJSON* object, const char* name, cJSON* item) {
+  if (item == nullptr) {
+    return 0;
+  }
+  std::free(item->string);
+  item->string = cJSON_Strdup(name);
+  return cJSON_AddItemToArray(object, item);
+}
+
+inline cJSON* cJSON_AddStringToObject(cJSON* object, const char* name, const char* text) {
+  cJSON* item = cJSON_CreateString(text);
+  cJSON_AddItemToObject(object, name, item);
+  return item;
+}
+
+inline cJSON* cJSON_AddNumberToObject(cJSON* object, const char* name, double number) {
+  cJSON* item = cJSON_CreateNumber(number);
+  cJSON_AddItemToObject(object, name, item);
+  return item;
+}
+
+inline cJSON* cJSON_AddBoolToObject(cJSON* object, const char* name, cJSON_bool value) {
+  cJSON* item = cJSON_CreateBool(value);
+  cJSON_AddItemToObject(object, name, item);
+  return item;
+}
+
+inline cJSON* cJSON_AddNullToObject(cJSON* object, const char* name) {
+  cJSON* item = cJSON_CreateNull();
+  cJSON_AddItemToObject(object, name, item);
+  return item;
+}
+
+inline cJSON* cJSON_GetObjectItem(const cJSON* object, const char* name) {
+  if (object == nullptr) {
+    return nullptr;
+  }
+  for (cJSON* item = object->child; item != nullptr; item = item->next) {
+    if (item->string != nullptr && strcasecmp(item->string, name) == 0) {
+      return item;
+    }
+  }
+  return nullptr;
+}
+
+inline cJSON_bool cJSON_IsBool(const cJSON* item) { return item != nullptr && (item->type & (cJSON_True | cJSON_False)); }
+inline cJSON_bool cJSON_IsTrue(const cJSON* item) { return item != nullptr && (item->type & cJSON_True); }
+inline cJSON_bool cJSON_IsNumber(const cJSON* item) { return item != nullptr && (item->type & cJSON_Number); }
+inline cJSON_bool cJSON_IsString(const cJSON* item) { return item != nullptr && (item->type & cJSON_String); }
+inline cJSON_bool cJSON_IsArray(const cJSON* item) { return item != nullptr && (item->type & cJSON_Array); }
+inline cJSON_bool cJSON_IsObject(const cJSON* item) { return item != nullptr && (item->type & cJSON_Object); }
+
+inline void cJSON_PrintString(std::string& out, const char* text) {
+  out += '"';
+  for (const unsigned char* p = (const unsigned char*)text; *p != '\0'; p++) {
+    switch (*p) {
+    case '"': out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if (*p < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", *p);
+        out += escaped;
+      } else {
+        out += (char)*p;
+      }
+    }
+  }
+  out += '"';
+}
+
+inline void cJSON_PrintValue(std::string& out, const cJSON* item) {
+  if (item->type & cJSON_False) {
+    out += "false";
+  } else if (item->type & cJSON_True) {
+    out += "true";
+  } else if (item->type & cJSON_NULL) {
+    out += "null";
+  } else if (item->type & cJSON_Number) {
+    char number[32];
+    if (item->valuedouble == (double)item->valueint) {
+      std::snprintf(number, sizeof(number), "%d", item->valueint);
+    } else {
+      std::snprintf(number, sizeof(number), "%.17g", item->valuedouble);
+    }
+    out += number;
+  } else if (item->type & cJSON_String) {
+    cJSON_PrintString(out, item->valuestring);
+  } else {
+    bool object = item->type & cJSON_Object;
+    out += object ? '{' : '[';
+    for (const cJSON* child = item->child; child != nullptr; child = child->next) {
+      if (child != item->child) {
+        out += ',';
+      }
+      if (object) {
+        cJSON_PrintString(out, child->string);
+        out += ':';
+      }
+      cJSON_PrintValue(out, child);
+    }
+    out += object ? '}' : ']';
+  }
+}
+
+inline char* cJSON_PrintUnformatted(const cJSON* item) {
+  std::string out;
+  cJSON_PrintValue(out, item);
+  return cJSON_Strdup(out.c_str());
+}
+
+// 只支持测试用到的输入：不处理 \u 转义
+inline cJSON* cJSON_ParseValue(const char*& p) {
+  while (*p == ' ' || *p == '\n' || *p == '\t' || *p == '\r') {
+    p++;
+  }
+  if (std::strncmp(p, "true", 4) == 0) {
+    p += 4;
+    // 与 cJSON 相同：解析出的 true 的 valueint 为 1，cJSON_CreateBool 不设置
+    cJSON* item = cJSON_CreateBool(1);
+    item->valueint = 1;
+    return item;
+  }
+  if (std::strncmp(p, "false", 5) == 0) {
+    p += 5;
+    return cJSON_CreateBool(0);
+  }
+  if (std::strncmp(p, "null", 4) == 0) {
+    p += 4;
+    return cJSON_CreateNull();
+  }
+  if (*p == '"') {
+    std::string text;
+    for (p++; *p != '"'; p++) {
+      if (*p == '\0') {
+        return nullptr;
+      }
+      if (*p == '\\') {
+        p++;
+        text += *p == 'n' ? '\n' : *p == 't' ? '\t' : *p == 'r' ? '\r' : *p;
+      } else {
+        text += *p;
+      }
+    }
+    p++;
+    return cJSON_CreateString(text.c_str());
+  }
+  if (*p == '{' || *p == '[') {
+    bool object = *p == '{';
+    char close = object ? '}' : ']';
+    cJSON* container = object ? cJSON_CreateObject() : cJSON_CreateArray();
+    p++;
+    while (true) {
+      while (*p == ' ' || *p == ',') {
+        p++;
+      }
+      if (*p == close) {
+        p++;
+        return container;
+      }
+      std::string name;
+      if (object) {
+        cJSON* key = cJSON_ParseValue(p);
+        if (!cJSON_IsString(key)) {
+          cJSON_Delete(key);
+          cJSON_Delete(container);
+          return nullptr;
+        }
+        name = key->valuestring;
+        cJSON_Delete(key);
+        while (*p == ' ' || *p == ':') {
+          p++;
+        }
+      }
+      cJSON* value = cJSON_ParseValue(p);
+      if (value == nullptr) {
+        cJSON_Delete(container);
+        return nullptr;
+      }
+      if (object) {
+        cJSON_AddItemToObject(container, name.c_str(), value);
+      } else {
+        cJSON_AddItemToArray(container, value);
+      }
+    }
+  }
+  char* end = nullptr;
+  double number = std::strtod(p, &end);
+  if (end == p) {
+    return nullptr;
+  }
+  p = end;
+  return cJSON_CreateNumber(number);
+}
+
+inline cJSON* cJSON_Parse(const char* text) { return cJSON_ParseValue(text); }
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// 主机端替身：时间由测试设置
+inline int64_t& FakeTimeUs() {
+  static int64_t now_us = 0;
+  return now_us;
+}
+
+inline int64_t esp_timer_get_time() { return FakeTimeUs(); }
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+// 主机端替身：与 mbedtls_base64_encode 的行为一致，输出末尾写入 '\0'
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL -0x002A
+
+inline int mbedtls_base64_encode(unsigned char* dst, size_t dlen, size_t* olen, const unsigned char* src,
+                                 size_t slen) {
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t needed = (slen + 2) / 3 * 4 + 1;
+  if (dst == nullptr || dlen < needed) {
+    *olen = needed;
+    return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+  }
+  size_t n = 0;
+  for (size_t i = 0; i < slen; i += 3) {
+    unsigned value = src[i] << 16;
+    if (i + 1 < slen) value |= src[i + 1] << 8;
+    if (i + 2 < slen) value |= src[i + 2];
+    dst[n++] = table[(value >> 18) & 63];
+    dst[n++] = table[(value >> 12) & 63];
+    dst[n++] = i + 1 < slen ? table[(value >> 6) & 63] : '=';
+    dst[n++] = i + 2 < slen ? table[value & 63] : '=';
+  }
+  dst[n] = '\0';
+  *olen = n;
+  return 0;
+}
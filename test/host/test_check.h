@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// 最小断言：失败时打印位置并以非零状态退出，交给 ctest 判定
+#define CHECK(cond)                                                          \
+  do {                                                                       \
+    if (!(cond)) {                                                           \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, \
+                   #cond);                                                   \
+      std::exit(1);                                                          \
+    }                                                                        \
+  } while (0)
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "test_check.h"
+
+// 与 scripts/ 下的工具互相校验时用到的文件读写和命令执行
+
+inline std::vector<uint8_t> ReadFile(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  CHECK(in.good());
+  return std::vector<uint8_t>((std::istreambuf_iterator<char>(in)),
+                              std::istreambuf_iterator<char>());
+}
+
+inline void WriteFile(const std::string& path, const std::vector<uint8_t>& data) {
+  std::ofstream out(path, std::ios::binary);
+  CHECK(out.good());
+  out.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+inline void Run(const std::string& command) {
+  std::fprintf(stderr, "%s\n", command.c_str());
+  CHECK(std::system(command.c_str()) == 0);
+}
+
+inline std::string Quote(const std::string& value) { return "\"" + value + "\""; }
+
+// 类似固件镜像的测试数据：以 0xE9 开头，重复的代码片段夹杂伪随机的常量
+inline std::vector<uint8_t> SyntheticImage(size_t size, uint32_t seed) {
+  std::vector<uint8_t> image(size);
+  uint32_t state = seed;
+  for (size_t i = 0; i < size; i++) {
+    state = state * 1664525u + 1013904223u;
+    if ((i / 64) % 3 == 0) {
+      image[i] = static_cast<uint8_t>(state >> 24);
+    } else {
+      image[i] = static_cast<uint8_t>("\x36\x41\x00\x0c\x02\x1d\xf0\x91"[i % 8] + (i / 4096));
+    }
+  }
+  image[0] = 0xE9;
+  return image;
+}
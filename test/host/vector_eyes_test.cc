@@ -0,0 +1,143 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "blink_controller.h"
+#include "esp_timer.h"
+#include "eye_presets.h"
+#include "look_controller.h"
+#include "test_check.h"
+#include "vector_eye.h"
+
+using namespace vector_eyes;
+
+namespace {
+
+void SetNowMs(uint32_t ms) { FakeTimeUs() = (int64_t)ms * 1000; }
+
+void TestFixedPoint() {
+  CHECK(EaseInOutQuadQ16(0) == 0);
+  CHECK(EaseInOutQuadQ16(32768) == 32768);
+  CHECK(EaseInOutQuadQ16(65536) == 65536);
+  uint32_t previous = 0;
+  for (uint32_t t = 0; t <= 65536; t += 256) {
+    uint32_t eased = EaseInOutQuadQ16(t);
+    CHECK(eased >= previous);
+    CHECK(std::fabs(eased / 65536.0f - EaseInOutQuad(t / 65536.0f)) < 0.001f);
+    previous = eased;
+  }
+
+  EyeConfig start = GetPreset(Emotion::Sad);
+  EyeConfig target = GetPreset(Emotion::Happy);
+  CHECK(EyeConfig::LerpQ16(start, target, 0) == start);
+  EyeConfig end = EyeConfig::LerpQ16(start, target, 65536);
+  CHECK(end.height == target.height && end.width == target.width);
+  CHECK(end.offset_y == target.offset_y && end.radius_top == target.radius_top);
+  CHECK(std::fabs(end.slope_top - target.slope_top) < 1e-6f);
+}
+
+void TestKeyframes() {
+  constexpr EyeKeyframe frame = Keyframe(2000, Emotion::Happy, 250);
+  static_assert(sizeof(EyeKeyframe) == 4, "keyframe layout");
+  CHECK(frame.at == 200 && frame.emotion == (uint8_t)Emotion::Happy && frame.tween == 25);
+  // 演示时间轴按时刻升序，最后一个关键帧不晚于总长
+  for (uint8_t i = 1; i < Timeline_Demo.count; i++) {
+    CHECK(Timeline_Demo.frames[i - 1].at < Timeline_Demo.frames[i].at);
+  }
+  CHECK(Timeline_Demo.frames[Timeline_Demo.count - 1].at <= Timeline_Demo.length);
+}
+
+// 过渡结束时精确落到目标预设，过渡期间需要逐帧刷新
+void TestTransition() {
+  SetNowMs(1000);
+  VectorEye eye;
+  eye.ApplyPreset(Preset_Normal);
+  eye.TransitionTo(Preset_Happy, 300);
+  SetNowMs(1150);
+  eye.Update();
+  CHECK(eye.IsTransitioning());
+  CHECK(*eye.GetCurrentConfig() != Preset_Normal && *eye.GetCurrentConfig() != Preset_Happy);
+  SetNowMs(1300);
+  eye.Update();
+  CHECK(!eye.IsTransitioning());
+  CHECK(*eye.GetCurrentConfig() == Preset_Happy);
+
+  // 左眼镜像斜边和视线方向
+  eye.SetMirrored(true);
+  eye.ApplyPreset(GetPreset(Emotion::Angry));
+  eye.ApplyLook(1.0f, 0.0f);
+  eye.Update();
+  CHECK(eye.GetCurrentConfig()->slope_top == -GetPreset(Emotion::Angry).slope_top);
+  CHECK(eye.GetCurrentConfig()->offset_x == GetPreset(Emotion::Angry).offset_x - 10);
+}
+
+// 空闲时报告的延迟正好是下一次眨眼开始的时刻：提前一毫秒不会眨眼
+void TestBlinkDelay() {
+  SetNowMs(5000);
+  BlinkController blink;
+  blink.SetBlinkInterval(400, 400);
+  uint32_t delay = blink.NextEventDelay(5000);
+  CHECK(delay == 401);
+
+  SetNowMs(5000 + delay - 1);
+  blink.Update();
+  CHECK(blink.NextEventDelay(5000 + delay - 1) == 1);
+  SetNowMs(5000 + delay);
+  blink.Update();
+  CHECK(blink.NextEventDelay(5000 + delay) == 0);
+
+  // 眨眼期间逐帧刷新，结束后睁开并重新计时
+  uint32_t now = 5000 + delay;
+  float deepest = 0.0f;
+  while (blink.NextEventDelay(now) == 0) {
+    now += 20;
+    CHECK(now < 5000 + delay + 400);
+    SetNowMs(now);
+    blink.Update();
+    deepest = std::fmax(deepest, blink.GetBlinkFactor());
+  }
+  CHECK(deepest > 0.8f);
+  CHECK(blink.GetBlinkFactor() == 0.0f);
+  CHECK(blink.NextEventDelay(now) == 401);
+
+  blink.SetAutoBlinkEnabled(false);
+  CHECK(blink.NextEventDelay(now) == UINT32_MAX);
+  blink.Blink();
+  CHECK(blink.NextEventDelay(now) == 0);
+}
+
+void TestLookDelay() {
+  SetNowMs(20000);
+  LookController look;
+  look.SetLookInterval(1000, 1000);
+  CHECK(look.NextEventDelay(20000) == 1001);
+  SetNowMs(21000);
+  look.Update();
+  CHECK(look.NextEventDelay(21000) == 1);
+
+  look.SetRandomLookEnabled(false);
+  CHECK(look.NextEventDelay(21000) == UINT32_MAX);
+  look.LookAt(1.0f, -0.5f);
+  CHECK(look.NextEventDelay(21000) == 0);
+  SetNowMs(21100);
+  look.Update();
+  CHECK(look.GetLookX() > 0.0f && look.GetLookX() < 1.0f);
+  SetNowMs(21200);
+  look.Update();
+  CHECK(look.GetLookX() == 1.0f && look.GetLookY() == -0.5f);
+  CHECK(look.NextEventDelay(21200) == UINT32_MAX);
+}
+
+}  // namespace
+
+int main() {
+  std::srand(1);
+  TestFixedPoint();
+  TestKeyframes();
+  TestTransition();
+  TestBlinkDelay();
+  TestLookDelay();
+  std::printf("vector_eyes_test passed\n");
+  return 0;
+}